@@ -516,3 +516,175 @@ int dcreate_matrix(SuperMatrix *A, int nrhs, double **rhs,
 #endif
     return 0;
 }
+
+/* \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * DCREATE_MATRIX_BINARY reads the matrix from a binary file written by
+ * DWRITE_BINARY, in parallel: each process reads only its own block of
+ * rows (see PDREAD_BINARY), so the global matrix is never formed. It also
+ * generates the distributed true solution X and the right-hand side RHS.
+ *
+ *
+ * Arguments
+ * =========
+ *
+ * A     (output) SuperMatrix*
+ *       Local matrix A in NR_loc format.
+ *
+ * NRHS  (input) int_t
+ *       Number of right-hand sides.
+ *
+ * RHS   (output) double**
+ *       The right-hand side matrix.
+ *
+ * LDB   (output) int*
+ *       Leading dimension of the right-hand side matrix.
+ *
+ * X     (output) double**
+ *       The true solution matrix.
+ *
+ * LDX   (output) int*
+ *       The leading dimension of the true solution matrix.
+ *
+ * FNAME (input) char*
+ *       The name of the binary matrix file.
+ *
+ * GRID  (input) gridinof_t*
+ *       The 2D process mesh.
+ *
+ * Return value
+ * ============
+ *   The error code of PDREAD_BINARY, which is 0 on success.
+ * </pre>
+ */
+int dcreate_matrix_binary(SuperMatrix *A, int nrhs, double **rhs,
+                          int *ldb, double **x, int *ldx,
+                          char *fname, gridinfo_t *grid)
+{
+    NRformat_loc *Astore;
+    double   *xtrue_global, *nzval, sum;
+    int_t    *rowptr, *colind;
+    int_t    n, m_loc, fst_row, i, j, k;
+    int      iam, info;
+
+    iam = grid->iam;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Enter dcreate_matrix_binary()");
+#endif
+
+    double t = SuperLU_timer_();
+    if ( (info = pdread_binary(fname, A, grid)) ) {
+	if ( !iam ) fprintf(stderr, "ERROR: INFO = %d returned from pdread_binary()\n", info);
+	return info;
+    }
+    if ( !iam ) {
+	printf("Time to read and distribute matrix %.2f\n",
+	       SuperLU_timer_() - t);  fflush(stdout);
+    }
+
+    Astore = (NRformat_loc *) A->Store;
+    n = A->ncol;
+    m_loc = Astore->m_loc;
+    fst_row = Astore->fst_row;
+    rowptr = Astore->rowptr;
+    colind = Astore->colind;
+    nzval = (double *) Astore->nzval;
+
+    /* Generate the exact solution. */
+    if ( !(xtrue_global = doubleMalloc_dist(n*nrhs)) )
+        ABORT("Malloc fails for xtrue[]");
+    if ( !iam ) dGenXtrue_dist(n, nrhs, xtrue_global, n);
+    MPI_Bcast( xtrue_global, n*nrhs, MPI_DOUBLE, 0, grid->comm );
+
+    /* Compute the local rows of B = A*X. */
+    if ( !((*rhs) = doubleMalloc_dist(m_loc*nrhs)) )
+        ABORT("Malloc fails for rhs[]");
+    for (j = 0; j < nrhs; ++j) {
+	for (i = 0; i < m_loc; ++i) {
+	    sum = 0.0;
+	    for (k = rowptr[i]; k < rowptr[i+1]; ++k)
+		sum += nzval[k] * xtrue_global[colind[k] + j*n];
+	    (*rhs)[j*m_loc+i] = sum;
+	}
+    }
+    *ldb = m_loc;
+
+    /* Get the local part of xtrue_global */
+    *ldx = m_loc;
+    if ( !((*x) = doubleMalloc_dist(*ldx * nrhs)) )
+        ABORT("Malloc fails for x_loc[]");
+    for (j = 0; j < nrhs; ++j) {
+      for (i = 0; i < m_loc; ++i)
+	(*x)[i + j*(*ldx)] = xtrue_global[i + fst_row + j*n];
+    }
+
+    SUPERLU_FREE(xtrue_global);
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit dcreate_matrix_binary()");
+#endif
+    return 0;
+}
+
+/* \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * DPARSE_DRIVER_ARGS parses the command line of an example driver.
+ * -r <int> and -c <int> set the process grid. Any other option -x <value>
+ * is passed to opt(x, value, arg), and -h prints the usage of -r and -c,
+ * then calls opt('h', NULL, arg) for the others and exits.
+ * The last argument is the matrix file. It is opened for reading, and
+ * its name and the suffix after its last '.' are returned in fname and
+ * postfix.
+ * </pre>
+ */
+FILE *dparse_driver_args(char *argv[], int *nprow, int *npcol,
+			 void (*opt)(int, char *, void *), void *arg,
+			 char **fname, char **postfix)
+{
+    char **cpp, c, *s;
+    FILE *fp = NULL;
+
+    for (cpp = argv+1; *cpp; ++cpp) {
+	if ( **cpp == '-' ) {
+	    c = *(*cpp+1);
+	    ++cpp;
+	    switch (c) {
+	      case 'h':
+		  printf("Options:\n");
+		  printf("\t-r <int>: process rows    (default %d)\n", *nprow);
+		  printf("\t-c <int>: process columns (default %d)\n", *npcol);
+		  if ( opt ) opt('h', NULL, arg);
+		  exit(0);
+		  break;
+	      case 'r': *nprow = atoi(*cpp);
+		        break;
+	      case 'c': *npcol = atoi(*cpp);
+		        break;
+	      default: if ( opt && *cpp ) opt(c, *cpp, arg);
+		        break;
+	    }
+	    if ( !*cpp ) break;
+	} else { /* Last arg is considered a filename */
+	    if ( !(fp = fopen(*cpp, "r")) ) {
+                ABORT("File does not exist");
+            }
+	    break;
+	}
+    }
+    if ( !fp ) ABORT("No matrix file given");
+
+    *fname = *cpp;
+    *postfix = *cpp + strlen(*cpp);
+    for (s = *cpp; *s; ++s)
+	if ( *s == '.' ) *postfix = s + 1;
+    return fp;
+}
@@ -0,0 +1,268 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Generate a distributed test matrix and the right-hand side
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+#include <string.h>
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/* Parameters of a generated matrix; see dcreate_matrix_gen(). */
+typedef struct {
+    int   kind;          /* one of the GEN_* values below */
+    int_t k;             /* grid size, or number of block rows */
+    int_t bs;            /* block size of GEN_BLOCK */
+    double p;            /* Peclet number, density, or regularization */
+    int_t n, n1;         /* order of the matrix; of the (1,1) block of KKT */
+    int_t maxnz;         /* max. number of nonzeros in a row */
+} gen_t;
+
+enum { GEN_LAP2D, GEN_LAP3D, GEN_CONVDIFF, GEN_BLOCK, GEN_KKT };
+
+/* Reproducible pseudo-random numbers in [0,1) for the pair (i,j). */
+static double gen_rand(int_t i, int_t j)
+{
+    uint64_t z = (uint64_t) i * 0x9e3779b97f4a7c15ULL + (uint64_t) j;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Sort the entries of a row by column and add up the duplicates. */
+static int_t gen_sort(int_t nz, int_t *col, double *val)
+{
+    int_t i, j, c;
+    double v;
+
+    for (i = 1; i < nz; ++i) {
+	c = col[i];
+	v = val[i];
+	for (j = i; j > 0 && col[j-1] > c; --j) {
+	    col[j] = col[j-1];
+	    val[j] = val[j-1];
+	}
+	col[j] = c;
+	val[j] = v;
+    }
+    for (i = j = 0; i < nz; ++i) {
+	if ( j > 0 && col[j-1] == col[i] ) val[j-1] += val[i];
+	else { col[j] = col[i]; val[j++] = val[i]; }
+    }
+    return j;
+}
+
+#define ENTRY(c, v) { col[nz] = (c); val[nz++] = (v); }
+
+/* Row i of the matrix: returns its number of nonzeros. */
+static int_t gen_row(gen_t *g, int_t i, int_t *col, double *val)
+{
+    int_t k = g->k, nz = 0, x, y, z, I, J, r, c;
+    double b[3], s;
+
+    switch ( g->kind ) {
+      case GEN_LAP2D: /* 5-point Laplacian on a k x k grid */
+	x = i % k;
+	y = i / k;
+	if ( y > 0 )     ENTRY(i - k, -1.0);
+	if ( x > 0 )     ENTRY(i - 1, -1.0);
+	ENTRY(i, 4.0);
+	if ( x < k - 1 ) ENTRY(i + 1, -1.0);
+	if ( y < k - 1 ) ENTRY(i + k, -1.0);
+	break;
+      case GEN_LAP3D: /* 7-point Laplacian on a k x k x k grid */
+      case GEN_CONVDIFF: /* -Laplace(u) + b.grad(u), upwind, b = p*(1,1/2,1/3) */
+	x = i % k;
+	y = (i / k) % k;
+	z = i / (k * k);
+	b[0] = b[1] = b[2] = 0.0;
+	if ( g->kind == GEN_CONVDIFF ) {
+	    b[0] = g->p / (k + 1);
+	    b[1] = b[0] / 2;
+	    b[2] = b[0] / 3;
+	}
+	if ( z > 0 )     ENTRY(i - k * k, -1.0 - b[2]);
+	if ( y > 0 )     ENTRY(i - k, -1.0 - b[1]);
+	if ( x > 0 )     ENTRY(i - 1, -1.0 - b[0]);
+	ENTRY(i, 6.0 + b[0] + b[1] + b[2]);
+	if ( x < k - 1 ) ENTRY(i + 1, -1.0);
+	if ( y < k - 1 ) ENTRY(i + k, -1.0);
+	if ( z < k - 1 ) ENTRY(i + k * k, -1.0);
+	break;
+      case GEN_BLOCK: /* k x k blocks of size bs; block (I,J), I != J, is
+			 dense with probability p; diagonally dominant */
+	I = i / g->bs;
+	s = 1.0;
+	for (J = 0; J < k; ++J) {
+	    if ( J != I && J != (I + 1) % k && gen_rand(I, J) >= g->p )
+		continue;
+	    for (c = J * g->bs; c < (J + 1) * g->bs; ++c) {
+		if ( c == i ) continue;
+		ENTRY(c, gen_rand(i, c) - 0.5);
+		s += fabs(val[nz-1]);
+	    }
+	}
+	ENTRY(i, s);
+	nz = gen_sort(nz, col, val);
+	break;
+      case GEN_KKT: /* [H A'; A -p*I], H the 2D Laplacian on a k x k grid,
+		       A(r,2r) = 1, A(r,2r+1) = -1, A(r,(2r+k) mod n1) = 1/2 */
+	if ( i < g->n1 ) {
+	    x = i % k;
+	    y = i / k;
+	    if ( y > 0 )     ENTRY(i - k, -1.0);
+	    if ( x > 0 )     ENTRY(i - 1, -1.0);
+	    ENTRY(i, 4.0);
+	    if ( x < k - 1 ) ENTRY(i + 1, -1.0);
+	    if ( y < k - 1 ) ENTRY(i + k, -1.0);
+	    if ( i / 2 < g->n - g->n1 )
+		ENTRY(g->n1 + i / 2, (i % 2) ? -1.0 : 1.0);
+	    r = ((i - k) % g->n1 + g->n1) % g->n1;
+	    if ( r % 2 == 0 && r / 2 < g->n - g->n1 )
+		ENTRY(g->n1 + r / 2, 0.5);
+	} else {
+	    r = i - g->n1;
+	    ENTRY(2 * r, 1.0);
+	    ENTRY(2 * r + 1, -1.0);
+	    ENTRY((2 * r + k) % g->n1, 0.5);
+	    ENTRY(i, -g->p);
+	}
+	nz = gen_sort(nz, col, val);
+	break;
+    }
+    return nz;
+}
+
+#undef ENTRY
+
+/*! \brief Parse spec into g; returns 0 if spec is not valid. */
+static int gen_parse(char *spec, gen_t *g)
+{
+    char name[16];
+    long long a = 0, b = 0;
+    double p = -1.0;
+    int cnt;
+
+    if ( sscanf(spec, "%15[a-z0-9]:%lld", name, &a) < 2 || a < 2 ) return 0;
+    g->k = a;
+    g->bs = 1;
+    if ( !strcmp(name, "lap2d") ) {
+	g->kind = GEN_LAP2D;
+	g->n = a * a;
+	g->maxnz = 5;
+    } else if ( !strcmp(name, "lap3d") ) {
+	g->kind = GEN_LAP3D;
+	g->n = a * a * a;
+	g->maxnz = 7;
+    } else if ( !strcmp(name, "convdiff") ) {
+	cnt = sscanf(spec, "%*[a-z]:%lld:%lf", &a, &p);
+	g->kind = GEN_CONVDIFF;
+	g->p = cnt == 2 ? p : 100.0;
+	g->n = a * a * a;
+	g->maxnz = 7;
+    } else if ( !strcmp(name, "block") ) {
+	cnt = sscanf(spec, "%*[a-z]:%lld:%lld:%lf", &a, &b, &p);
+	if ( cnt < 2 || b < 1 ) return 0;
+	g->kind = GEN_BLOCK;
+	g->bs = b;
+	g->p = cnt == 3 ? p : 0.05;
+	g->n = a * b;
+	g->maxnz = g->n;
+    } else if ( !strcmp(name, "kkt") ) {
+	cnt = sscanf(spec, "%*[a-z]:%lld:%lf", &a, &p);
+	g->kind = GEN_KKT;
+	g->p = cnt == 2 ? p : 0.0;
+	g->n1 = a * a;
+	g->n = g->n1 + g->n1 / 2;
+	g->maxnz = 8;
+    } else {
+	return 0;
+    }
+    return 1;
+}
+
+/*! \brief Generate the matrix described by spec, distributed by block
+ * rows over the processes of comm, and a right-hand side whose solution
+ * is all ones.
+ *
+ * <pre>
+ * spec is one of
+ *    lap2d:k               5-point Laplacian on a k x k grid
+ *    lap3d:k               7-point Laplacian on a k x k x k grid
+ *    convdiff:k[:pe]       3D convection-diffusion, upwind, Peclet pe
+ *                          (default 100)
+ *    block:nb:bs[:d]       nb x nb blocks of size bs; an off-diagonal
+ *                          block is dense with probability d (default 0.05)
+ *    kkt:k[:delta]         saddle point matrix [H A'; A -delta*I], H the
+ *                          2D Laplacian on a k x k grid (default delta 0)
+ * The entries only depend on spec, not on the number of processes.
+ * Returns 0 on success, -1 if spec is not valid.
+ * </pre>
+ */
+int dcreate_matrix_gen(SuperMatrix *A, int nrhs, double **rhs, int *ldb,
+		       double **x, int *ldx, char *spec, MPI_Comm comm)
+{
+    gen_t g;
+    int iam, nprocs, j;
+    int_t m_loc, fst_row, nnz_loc, i, k, nz, *rowptr, *colind, *col;
+    double *nzval, *val, *b, *xtrue, s;
+
+    if ( !gen_parse(spec, &g) ) return -1;
+    MPI_Comm_rank(comm, &iam);
+    MPI_Comm_size(comm, &nprocs);
+
+    /* Block rows, as in dcreate_matrix(). */
+    m_loc = g.n / nprocs;
+    fst_row = iam * m_loc;
+    if ( iam == nprocs - 1 ) m_loc = g.n - m_loc * (nprocs - 1);
+
+    if ( !(col = intMalloc_dist(g.maxnz)) ) ABORT("Malloc fails for col[].");
+    if ( !(val = doubleMalloc_dist(g.maxnz)) ) ABORT("Malloc fails for val[].");
+    if ( !(rowptr = intMalloc_dist(m_loc + 1)) )
+	ABORT("Malloc fails for rowptr[].");
+    rowptr[0] = 0;
+    for (i = 0; i < m_loc; ++i)
+	rowptr[i+1] = rowptr[i] + gen_row(&g, fst_row + i, col, val);
+    nnz_loc = rowptr[m_loc];
+    if ( !(colind = intMalloc_dist(nnz_loc)) )
+	ABORT("Malloc fails for colind[].");
+    if ( !(nzval = doubleMalloc_dist(nnz_loc)) )
+	ABORT("Malloc fails for nzval[].");
+
+    if ( !(b = doubleMalloc_dist(m_loc * nrhs)) ) ABORT("Malloc fails for rhs[].");
+    if ( !(xtrue = doubleMalloc_dist(m_loc * nrhs)) ) ABORT("Malloc fails for x[].");
+    for (i = 0; i < m_loc; ++i) {
+	nz = gen_row(&g, fst_row + i, &colind[rowptr[i]], &nzval[rowptr[i]]);
+	for (k = rowptr[i], s = 0.0; k < rowptr[i] + nz; ++k) s += nzval[k];
+	for (j = 0; j < nrhs; ++j) {
+	    b[i + j * m_loc] = s;
+	    xtrue[i + j * m_loc] = 1.0;
+	}
+    }
+    SUPERLU_FREE(col);
+    SUPERLU_FREE(val);
+
+    dCreate_CompRowLoc_Matrix_dist(A, g.n, g.n, nnz_loc, m_loc, fst_row,
+				   nzval, colind, rowptr,
+				   SLU_NR_loc, SLU_D, SLU_GE);
+    *rhs = b;
+    *ldb = m_loc;
+    *x = xtrue;
+    *ldx = m_loc;
+    return 0;
+}
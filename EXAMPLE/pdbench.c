@@ -0,0 +1,390 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Benchmark PDGSSVX and PDGSSVX3D on generated matrices
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <string.h>
+#include <math.h>
+#include "superlu_ddefs.h"
+
+#define MAXLIST 64
+
+typedef struct {
+    int r, c, d;         /* process rows, columns, and layers (d = 0: 2D) */
+} shape_t;
+
+/* Result of one configuration. */
+typedef struct {
+    int_t n, nnz;
+    int info;
+    double utime[NPHASES];   /* max over the processes */
+    double spmv;             /* one pdgsmv(), max over the processes */
+    double flops;            /* flops of the factorization, all processes */
+    double error;            /* ||x - xtrue||_inf / ||xtrue||_inf */
+} result_t;
+
+/* The phases that are reported, in this order. */
+static int phases[] = { EQUIL, ROWPERM, COLPERM, SYMBFAC, DIST, FACT,
+			SOLVE, REFINE };
+#define NREPORT (sizeof(phases) / sizeof(phases[0]))
+
+/* Parse a comma-separated list of positive integers. */
+static int parse_ints(char *s, int *v)
+{
+    int n = 0;
+
+    for ( ; s && *s && n < MAXLIST; ++n) {
+	if ( (v[n] = atoi(s)) < 1 ) ABORT("Invalid list of integers.");
+	if ( (s = strchr(s, ',')) ) ++s;
+    }
+    return n;
+}
+
+/* Parse a comma-separated list of grid shapes RxC or RxCxD. */
+static int parse_shapes(char *s, shape_t *v)
+{
+    int n = 0, cnt;
+
+    for ( ; s && *s && n < MAXLIST; ++n) {
+	v[n].d = 0;
+	cnt = sscanf(s, "%dx%dx%d", &v[n].r, &v[n].c, &v[n].d);
+	if ( cnt < 2 || v[n].r < 1 || v[n].c < 1 || (cnt == 3 && v[n].d < 1) )
+	    ABORT("Invalid grid shape.");
+	if ( (s = strchr(s, ',')) ) ++s;
+    }
+    return n;
+}
+
+/* All 2D shapes r x c = nprocs; with with3d, also all 3D shapes
+   r x c x d = nprocs with d a power of 2 greater than 1. */
+static int default_shapes(int nprocs, int with3d, shape_t *v)
+{
+    int n = 0, r, d;
+
+    for (d = 1; d <= nprocs && n < MAXLIST; d *= 2) {
+	if ( nprocs % d || (d > 1 && !with3d) ) continue;
+	for (r = 1; r <= nprocs / d && n < MAXLIST; ++r) {
+	    if ( (nprocs / d) % r ) continue;
+	    v[n].r = r;
+	    v[n].c = nprocs / d / r;
+	    v[n++].d = d > 1 ? d : 0;
+	}
+    }
+    return n;
+}
+
+/* Reduce the times and the flops of one solve over the processes of
+   comm, and compute the error of the solution x. */
+static void reduce_result(result_t *res, SuperLUStat_t *stat, double spmv,
+			  int_t m_loc, int nrhs, double *x, int ldx,
+			  double *xtrue, int ldxtrue, MPI_Comm comm)
+{
+    double v[NPHASES + 2], err = 0.0, flops;
+    int_t i;
+    int j;
+
+    for (j = 0; j < NPHASES; ++j) v[j] = stat->utime[j];
+    v[NPHASES] = spmv;
+    for (j = 0; j < nrhs; ++j)
+	for (i = 0; i < m_loc; ++i)
+	    err = SUPERLU_MAX(err, fabs(x[i + j * ldx] - xtrue[i + j * ldxtrue]));
+    v[NPHASES + 1] = err; /* xtrue is all ones */
+    MPI_Allreduce(MPI_IN_PLACE, v, NPHASES + 2, MPI_DOUBLE, MPI_MAX, comm);
+    flops = stat->ops[FACT];
+    MPI_Allreduce(MPI_IN_PLACE, &flops, 1, MPI_DOUBLE, MPI_SUM, comm);
+
+    for (j = 0; j < NPHASES; ++j) res->utime[j] = v[j];
+    res->spmv = v[NPHASES];
+    res->error = v[NPHASES + 1];
+    res->flops = flops;
+}
+
+/* Generate the matrix spec, solve it once on a grid of shape sh,
+   and return the timings in res. */
+static void bench_one(char *spec, shape_t *sh, int nrhs, int nspmv,
+		      result_t *res)
+{
+    superlu_dist_options_t options;
+    SuperLUStat_t stat;
+    SuperMatrix A;
+    NRformat_loc *Astore;
+    dScalePermstruct_t ScalePermstruct;
+    dLUstruct_t LUstruct;
+    dSOLVEstruct_t SOLVEstruct;
+    gridinfo_t grid;
+    gridinfo3d_t grid3d;
+    MPI_Comm comm;
+    double *b, *xtrue, *berr, *x, *ax, t, spmv = 0.0;
+    int_t nnz, m_loc;
+    int ldb, ldx, i, info;
+
+    if ( sh->d ) {
+	superlu_gridinit3d(MPI_COMM_WORLD, sh->r, sh->c, sh->d, &grid3d);
+	comm = grid3d.comm;
+    } else {
+	superlu_gridinit(MPI_COMM_WORLD, sh->r, sh->c, &grid);
+	comm = grid.comm;
+    }
+
+    if ( dcreate_matrix_gen(&A, nrhs, &b, &ldb, &xtrue, &ldx, spec, comm) )
+	ABORT("Invalid matrix specification.");
+    Astore = (NRformat_loc *) A.Store;
+    m_loc = Astore->m_loc;
+    nnz = Astore->nnz_loc;
+    MPI_Allreduce(MPI_IN_PLACE, &nnz, 1, mpi_int_t, MPI_SUM, comm);
+    res->n = A.nrow;
+    res->nnz = nnz;
+    if ( !(berr = doubleMalloc_dist(nrhs)) )
+	ABORT("Malloc fails for berr[].");
+
+    set_default_options_dist(&options);
+    options.PrintStat = NO;
+    dScalePermstructInit(A.nrow, A.ncol, &ScalePermstruct);
+    dLUstructInit(A.ncol, &LUstruct);
+    PStatInit(&stat);
+
+    if ( sh->d ) {
+	options.Algo3d = YES;
+	options.IterRefine = NOREFINE;
+	pdgssvx3d(&options, &A, &ScalePermstruct, b, ldb, nrhs, &grid3d,
+		  &LUstruct, &SOLVEstruct, berr, &stat, &info);
+    } else {
+	pdgssvx(&options, &A, &ScalePermstruct, b, ldb, nrhs, &grid,
+		&LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+	/* Time the SpMV with the distributed A set up for the refinement. */
+	if ( !info && nspmv > 0 && options.SolveInitialized ) {
+	    if ( !(x = doubleMalloc_dist(m_loc + 1)) )
+		ABORT("Malloc fails for x[].");
+	    if ( !(ax = doubleMalloc_dist(m_loc + 1)) )
+		ABORT("Malloc fails for ax[].");
+	    for (i = 0; i < m_loc; ++i) x[i] = 1.0;
+	    MPI_Barrier(comm);
+	    t = SuperLU_timer_();
+	    for (i = 0; i < nspmv; ++i)
+		pdgsmv(0, &A, &grid, SOLVEstruct.gsmv_comm, x, ax);
+	    spmv = (SuperLU_timer_() - t) / nspmv;
+	    SUPERLU_FREE(x);
+	    SUPERLU_FREE(ax);
+	}
+    }
+    res->info = info;
+    reduce_result(res, &stat, spmv, m_loc, nrhs, b, ldb, xtrue, ldx, comm);
+
+    if ( sh->d ) {
+	dDestroy_LU(A.ncol, &grid3d.grid2d, &LUstruct);
+	dSolveFinalize(&options, &SOLVEstruct);
+	dDestroy_A3d_gathered_on_2d(&SOLVEstruct, &grid3d);
+    } else {
+	dDestroy_LU(A.ncol, &grid, &LUstruct);
+	if ( options.SolveInitialized ) dSolveFinalize(&options, &SOLVEstruct);
+    }
+    Destroy_CompRowLoc_Matrix_dist(&A);
+    dScalePermstructFree(&ScalePermstruct);
+    dLUstructFree(&LUstruct);
+    PStatFree(&stat);
+    SUPERLU_FREE(b);
+    SUPERLU_FREE(xtrue);
+    SUPERLU_FREE(berr);
+
+    if ( sh->d ) superlu_gridexit3d(&grid3d);
+    else superlu_gridexit(&grid);
+}
+
+/* Write one result as a line of JSON. */
+static void print_result(FILE *fp, char *label, char *spec, shape_t *sh,
+			 int nthreads, int nrhs, int nrep, result_t *res)
+{
+    int j;
+
+    fprintf(fp, "{\"label\":\"%s\",\"matrix\":\"%s\",\"n\":%lld,\"nnz\":%lld,"
+	    "\"nprocs\":%d,\"nprow\":%d,\"npcol\":%d,\"npdep\":%d,"
+	    "\"threads\":%d,\"nrhs\":%d,\"reps\":%d,\"info\":%d,\"time\":{",
+	    label, spec, (long long) res->n, (long long) res->nnz,
+	    sh->r * sh->c * SUPERLU_MAX(sh->d, 1), sh->r, sh->c,
+	    SUPERLU_MAX(sh->d, 1), nthreads, nrhs, nrep, res->info);
+    for (j = 0; j < NREPORT; ++j)
+	fprintf(fp, "%s\"%s\":%.6e", j ? "," : "", superlu_phase_name(phases[j]),
+		res->utime[phases[j]]);
+    if ( !sh->d && res->spmv > 0.0 ) fprintf(fp, ",\"SPMV\":%.6e", res->spmv);
+    fprintf(fp, "},\"fact_flops\":%.6e,\"fact_gflops\":%.6e,\"error\":%.6e}\n",
+	    res->flops,
+	    res->utime[FACT] > 0.0 ? res->flops / res->utime[FACT] * 1e-9 : 0.0,
+	    res->error);
+    fflush(fp);
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * The driver program PDBENCH.
+ *
+ * For each matrix in the comma-separated list of generator specifications
+ * (see dcreate_matrix_gen()), and for each combination of grid shape,
+ * number of threads, and number of right-hand sides, the linear system is
+ * solved from scratch -k times with pdgssvx(), or pdgssvx3d() on a 3D grid.
+ * For each phase the fastest of the -k times is kept. The results are
+ * written by process 0 as one JSON object per line, to stdout or appended
+ * to the file given by -o. The times are in seconds, the maximum over the
+ * processes. SPMV is one pdgsmv() with the distributed matrix, and is only
+ * measured on 2D grids; DIST is the redistribution of A into the L and U
+ * data structures.
+ *
+ * With MPICH, program may be run by typing:
+ *    mpiexec -n 4 pdbench -p 2x2,1x4,1x2x2 -t 1,2 -s 1,8 lap3d:30,kkt:100
+ * </pre>
+ */
+int main(int argc, char *argv[])
+{
+    shape_t shapes[MAXLIST];
+    int threads[MAXLIST], rhs[MAXLIST];
+    int nshapes = 0, nthreads = 0, nnrhs = 1, nrep = 1, nspmv = 10, with3d = 0;
+    int iam, nprocs, s, t, r, k, j, omp_mpi_level;
+    char **cpp, c, *specs = NULL, *spec, *next, *label = "", *outfile = NULL;
+    result_t res, best = {0};
+    FILE *fp = stdout;
+
+    rhs[0] = 1;
+#ifdef _OPENMP
+    threads[0] = omp_get_max_threads();
+#else
+    threads[0] = 1;
+#endif
+
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &omp_mpi_level);
+    MPI_Comm_rank(MPI_COMM_WORLD, &iam);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+    /* Parse command line argv[]. */
+    for (cpp = argv+1; *cpp; ++cpp) {
+	if ( **cpp == '-' ) {
+	    c = *(*cpp+1);
+	    ++cpp;
+	    switch (c) {
+	      case 'h':
+		  if ( !iam ) {
+		      printf("Usage: pdbench [options] spec[,spec...]\n");
+		      printf("Options:\n");
+		      printf("\t-p <list>: grid shapes RxC or RxCxD "
+			     "(default all RxC = #processes)\n");
+		      printf("\t-d <0|1>: with the default shapes, also the "
+			     "3D ones (default %d)\n", with3d);
+		      printf("\t-t <list>: numbers of threads (default %d)\n",
+			     threads[0]);
+		      printf("\t-s <list>: numbers of right-hand sides "
+			     "(default %d)\n", rhs[0]);
+		      printf("\t-k <int>: repetitions (default %d)\n", nrep);
+		      printf("\t-m <int>: SpMVs timed (default %d)\n", nspmv);
+		      printf("\t-o <file>: append the results to file\n");
+		      printf("\t-l <string>: label of the results\n");
+		      printf("spec: lap2d:k lap3d:k convdiff:k[:pe] "
+			     "block:nb:bs[:d] kkt:k[:delta]\n");
+		  }
+		  MPI_Finalize();
+		  exit(0);
+		  break;
+	      case 'p': nshapes = parse_shapes(*cpp, shapes);
+		        break;
+	      case 'd': with3d = atoi(*cpp);
+		        break;
+	      case 't': nthreads = parse_ints(*cpp, threads);
+		        break;
+	      case 's': nnrhs = parse_ints(*cpp, rhs);
+		        break;
+	      case 'k': nrep = atoi(*cpp);
+		        break;
+	      case 'm': nspmv = atoi(*cpp);
+		        break;
+	      case 'o': outfile = *cpp;
+		        break;
+	      case 'l': label = *cpp;
+		        break;
+	    }
+	    if ( !*cpp ) break;
+	} else { /* Last arg is the list of matrices */
+	    specs = *cpp;
+	    break;
+	}
+    }
+    if ( nrep < 1 ) {
+	if ( !iam ) fprintf(stderr, "pdbench: -k must be at least 1\n");
+	MPI_Finalize();
+	exit(1);
+    }
+    if ( !specs ) specs = "lap3d:20";
+    if ( nthreads == 0 ) nthreads = 1;
+    if ( nshapes == 0 ) nshapes = default_shapes(nprocs, with3d, shapes);
+    if ( !iam && outfile && !(fp = fopen(outfile, "a")) )
+	ABORT("Cannot open the output file.");
+
+    /* ------------------------------------------------------------
+       SWEEP OVER MATRICES, GRID SHAPES, THREADS, AND RIGHT-HAND SIDES.
+       ------------------------------------------------------------*/
+    for (spec = specs; spec; spec = next) {
+	if ( (next = strchr(spec, ',')) ) *next++ = '\0';
+	for (s = 0; s < nshapes; ++s) {
+	    if ( shapes[s].r * shapes[s].c * SUPERLU_MAX(shapes[s].d, 1)
+		 != nprocs ) {
+		if ( !iam )
+		    fprintf(stderr, "pdbench: skip grid %dx%dx%d, it does not "
+			    "have %d processes\n", shapes[s].r, shapes[s].c,
+			    SUPERLU_MAX(shapes[s].d, 1), nprocs);
+		continue;
+	    }
+	    for (t = 0; t < nthreads; ++t) {
+#ifdef _OPENMP
+		omp_set_num_threads(threads[t]);
+#endif
+		for (r = 0; r < nnrhs; ++r) {
+		    for (k = 0; k < nrep; ++k) {
+			bench_one(spec, &shapes[s], rhs[r], nspmv, &res);
+			if ( k == 0 ) {
+			    best = res;
+			    continue;
+			}
+			for (j = 0; j < NPHASES; ++j)
+			    best.utime[j] = SUPERLU_MIN(best.utime[j],
+							res.utime[j]);
+			best.spmv = SUPERLU_MIN(best.spmv, res.spmv);
+			best.error = SUPERLU_MAX(best.error, res.error);
+			best.info = best.info ? best.info : res.info;
+		    }
+		    if ( !iam ) {
+			print_result(fp, label, spec, &shapes[s], threads[t],
+				     rhs[r], nrep, &best);
+			if ( fp != stdout )
+			    printf("%s %dx%dx%d threads %d nrhs %d: FACT %8.4f s"
+				   "  SOLVE %8.4f s  error %8.2e\n", spec,
+				   shapes[s].r, shapes[s].c,
+				   SUPERLU_MAX(shapes[s].d, 1), threads[t],
+				   rhs[r], best.utime[FACT], best.utime[SOLVE],
+				   best.error);
+		    }
+		}
+	    }
+	}
+    }
+
+    if ( !iam && fp != stdout ) fclose(fp);
+    MPI_Finalize();
+    return 0;
+}
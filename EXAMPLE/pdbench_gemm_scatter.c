@@ -0,0 +1,169 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Benchmark the fused GEMM and scatter kernel of the Schur
+ * complement update against GEMM followed by a scatter
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * For each block shape m x n x k, the update C(rowmap, colmap) -= A*B,
+ * with the destination rows and columns spread as in a block of L, is
+ * timed with superlu_dgemm_scatter() and with superlu_dgemm() into a
+ * buffer followed by the scatter loop of dscatter_l(). The two results
+ * are compared; the program fails if they differ. Each process runs the
+ * benchmark on its own, and process 0 prints its timings.
+ * </pre>
+ */
+
+#include <string.h>
+#include <math.h>
+#include "superlu_ddefs.h"
+
+#define MAXSHAPES 64
+
+/* Parse a comma-separated list of shapes MxNxK. */
+static int parse_shapes(char *s, int (*v)[3])
+{
+    int n = 0;
+
+    for ( ; s && *s && n < MAXSHAPES; ++n) {
+	if ( sscanf(s, "%dx%dx%d", &v[n][0], &v[n][1], &v[n][2]) != 3
+	     || v[n][0] < 1 || v[n][1] < 1 || v[n][2] < 1 )
+	    ABORT("Invalid list of shapes.");
+	if ( (s = strchr(s, ',')) ) ++s;
+    }
+    return n;
+}
+
+/* Run the update reps times; returns the time of one update. */
+static double time_update(int fused, int reps, int m, int n, int k,
+			  double *A, double *B, double *C, int ldc,
+			  double *V, int_t *rowmap, int_t *colmap)
+{
+    double t = SuperLU_timer_(), *cj;
+    int r, i, j;
+
+    for (r = 0; r < reps; ++r) {
+	if ( fused ) {
+	    superlu_dgemm_scatter(m, n, k, A, m, B, k, C, ldc, rowmap, colmap);
+	} else {
+	    superlu_dgemm("N", "N", m, n, k, 1.0, A, m, B, k, 0.0, V, m);
+	    for (j = 0; j < n; ++j) {
+		cj = &C[(size_t) colmap[j] * ldc];
+		for (i = 0; i < m; ++i) cj[rowmap[i]] -= V[i + (size_t) j * m];
+	    }
+	}
+    }
+    return (SuperLU_timer_() - t) / reps;
+}
+
+int main(int argc, char *argv[])
+{
+    int shapes[MAXSHAPES][3] = { {4,4,4}, {8,8,8}, {16,16,16}, {32,32,32},
+				 {64,64,64}, {128,128,128}, {128,16,16},
+				 {16,128,16}, {256,32,32}, {64,64,8} };
+    int nshapes = 10, iam, s, m, n, k, ldc, i, j, reps, fail = 0;
+    int_t *rowmap, *colmap;
+    double *A, *B, *C, *C0, *V, t0, t1, flops, diff, cmax;
+    double mintime = 0.1;
+    char **cpp, c;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &iam);
+
+    /* Parse command line argv[]. */
+    for (cpp = argv+1; *cpp; ++cpp) {
+	if ( **cpp == '-' ) {
+	    c = *(*cpp+1);
+	    ++cpp;
+	    switch (c) {
+	      case 'h':
+		  if ( !iam ) {
+		      printf("Usage: pdbench_gemm_scatter [options]\n");
+		      printf("Options:\n");
+		      printf("\t-s <list>: block shapes MxNxK "
+			     "(default 4x4x4 to 256x32x32)\n");
+		      printf("\t-t <float>: seconds per shape and kernel "
+			     "(default %.2f)\n", mintime);
+		  }
+		  MPI_Finalize();
+		  exit(0);
+		  break;
+	      case 's': nshapes = parse_shapes(*cpp, shapes);
+		  break;
+	      case 't': mintime = atof(*cpp);
+		  break;
+	    }
+	}
+    }
+
+    if ( !iam )
+	printf("%6s %6s %6s %14s %14s %10s\n", "m", "n", "k",
+	       "GEMM+scatter", "fused", "speedup");
+    for (s = 0; s < nshapes; ++s) {
+	m = shapes[s][0];
+	n = shapes[s][1];
+	k = shapes[s][2];
+	ldc = 2 * m + 1;
+	if ( !(A = doubleMalloc_dist(m * k)) ) ABORT("Malloc fails for A[].");
+	if ( !(B = doubleMalloc_dist(k * n)) ) ABORT("Malloc fails for B[].");
+	if ( !(C = doubleCalloc_dist(ldc * 2 * n)) ) ABORT("Malloc fails for C[].");
+	if ( !(C0 = doubleCalloc_dist(ldc * 2 * n)) ) ABORT("Malloc fails for C0[].");
+	if ( !(V = doubleMalloc_dist(m * n)) ) ABORT("Malloc fails for V[].");
+	if ( !(rowmap = intMalloc_dist(m)) ) ABORT("Malloc fails for rowmap[].");
+	if ( !(colmap = intMalloc_dist(n)) ) ABORT("Malloc fails for colmap[].");
+	for (i = 0; i < m * k; ++i) A[i] = (double) ((i * 7) % 13) / 13.0 - 0.5;
+	for (i = 0; i < k * n; ++i) B[i] = (double) ((i * 5) % 11) / 11.0 - 0.5;
+	/* Every other row and column of the destination, rows reversed
+	   in pairs, as the rows of a block of L need not be sorted. */
+	for (i = 0; i < m; ++i) rowmap[i] = 2 * ((i ^ 1) < m ? i ^ 1 : i);
+	for (j = 0; j < n; ++j) colmap[j] = 2 * j + 1;
+
+	/* One update each, to compare the results. */
+	time_update(1, 1, m, n, k, A, B, C, ldc, V, rowmap, colmap);
+	time_update(0, 1, m, n, k, A, B, C0, ldc, V, rowmap, colmap);
+	for (i = 0, diff = cmax = 0.0; i < ldc * 2 * n; ++i) {
+	    diff = SUPERLU_MAX(diff, fabs(C[i] - C0[i]));
+	    cmax = SUPERLU_MAX(cmax, fabs(C0[i]));
+	}
+	if ( diff > 1e-13 * k * SUPERLU_MAX(cmax, 1.0) ) {
+	    printf("(%d) %d x %d x %d: fused and GEMM+scatter differ by %e\n",
+		   iam, m, n, k, diff);
+	    fail = 1;
+	}
+
+	/* As many updates as fit in mintime. */
+	flops = 2.0 * m * n * k;
+	reps = SUPERLU_MAX(1, (int) (mintime / SUPERLU_MAX(
+	    time_update(0, 1, m, n, k, A, B, C0, ldc, V, rowmap, colmap), 1e-7)));
+	t0 = time_update(0, reps, m, n, k, A, B, C0, ldc, V, rowmap, colmap);
+	t1 = time_update(1, reps, m, n, k, A, B, C, ldc, V, rowmap, colmap);
+	if ( !iam )
+	    printf("%6d %6d %6d %9.2f GF/s %9.2f GF/s %10.2f\n", m, n, k,
+		   flops / t0 * 1e-9, flops / t1 * 1e-9, t0 / t1);
+
+	SUPERLU_FREE(A);
+	SUPERLU_FREE(B);
+	SUPERLU_FREE(C);
+	SUPERLU_FREE(C0);
+	SUPERLU_FREE(V);
+	SUPERLU_FREE(rowmap);
+	SUPERLU_FREE(colmap);
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Finalize();
+    return fail;
+}
@@ -58,11 +58,13 @@ int main(int argc, char *argv[])
     dSOLVEstruct_t SOLVEstruct;
     gridinfo_t grid;
     double   *berr;
+    double   amalg;
     double   *b, *xtrue;
     int    m, n;
-    int      nprow, npcol, lookahead, colperm, rowperm, ir, symbfact, batch;
+    int      nprow, npcol, lookahead, colperm, rowperm, ir, symbfact, batch, commtree, shm, trace, tasks, mixed, nodesymb, autotune;
     int      iam, info, ldb, ldx, nrhs;
     char     **cpp, c, *postfix;;
+    char     *statfile = NULL;
     FILE *fp, *fopen();
     int cpp_defs();
     int ii, omp_mpi_level;
@@ -85,6 +87,14 @@ int main(int argc, char *argv[])
     ir = -1;
     symbfact = -1;
     batch = 0;
+    commtree = -1;
+    shm = -1;
+    trace = -1;
+    tasks = -1;
+    mixed = -1;
+    nodesymb = -1;
+    autotune = -1;
+    amalg = -1.0;
 
     /* ------------------------------------------------------------
        INITIALIZE MPI ENVIRONMENT.
@@ -140,6 +150,15 @@ int main(int argc, char *argv[])
 		  printf("\t-l <int>: lookahead level    (default %4d)\n", options.num_lookaheads);
 		  printf("\t-i <int>: iter. refinement   (default %4d)\n", options.IterRefine);
 		  printf("\t-b <int>: use batch mode?    (default %4d)\n", batch);
+		  printf("\t-t <int>: solve comm. trees  (default %4d)\n", options.CommTree);
+		  printf("\t-m <int>: intra-node shm?    (default %4d)\n", options.IntraNodeShm);
+		  printf("\t-e <int>: write trace?       (default %4d)\n", options.Trace);
+		  printf("\t-g <int>: Schur update tasks? (default %4d)\n", options.SchurTasks);
+		  printf("\t-x <int>: single-precision LU with GMRES refinement? (default %4d)\n", options.MixedPrecLU);
+		  printf("\t-n <int>: serial symbolic once per node? (default %4d)\n", options.NodeSymbFact);
+		  printf("\t-a <int>: autotune relax/maxsup/lookahead? (default %4d)\n", options.AutoTune);
+		  printf("\t-f <float>: supernode amalgamation fill (default %4.2f)\n", options.AmalgFill);
+		  printf("\t-j <file>: write statistics as JSON\n");
 		  exit(0);
 		  break;
 	      case 'r': nprow = atoi(*cpp);
@@ -158,6 +177,24 @@ int main(int argc, char *argv[])
                         break;
               case 'b': batch = atoi(*cpp);
                         break;
+              case 't': commtree = atoi(*cpp);
+                        break;
+              case 'm': shm = atoi(*cpp);
+                        break;
+              case 'e': trace = atoi(*cpp);
+                        break;
+              case 'g': tasks = atoi(*cpp);
+                        break;
+              case 'x': mixed = atoi(*cpp);
+                        break;
+              case 'n': nodesymb = atoi(*cpp);
+                        break;
+              case 'a': autotune = atoi(*cpp);
+                        break;
+              case 'f': amalg = atof(*cpp);
+                        break;
+              case 'j': statfile = *cpp;
+                        break;
 	    }
 	} else { /* Last arg is considered a filename */
 	    if ( !(fp = fopen(*cpp, "r")) ) {
@@ -173,6 +210,14 @@ int main(int argc, char *argv[])
     if (lookahead != -1) options.num_lookaheads = lookahead;
     if (ir != -1) options.IterRefine = ir;
     if (symbfact != -1) options.ParSymbFact = symbfact;
+    if (commtree != -1) options.CommTree = commtree;
+    if (shm != -1) options.IntraNodeShm = shm;
+    if (trace != -1) options.Trace = trace;
+    if (tasks != -1) options.SchurTasks = tasks;
+    if (mixed != -1) options.MixedPrecLU = mixed;
+    if (nodesymb != -1) options.NodeSymbFact = nodesymb;
+    if (autotune != -1) options.AutoTune = autotune;
+    if (amalg >= 0.0) options.AmalgFill = amalg;
 
     int superlu_acc_offload = sp_ienv_dist(10, &options); //get_acc_offload();
     
@@ -344,6 +389,17 @@ int main(int argc, char *argv[])
 
     PStatPrint(&options, &stat, &grid);        /* Print the statistics. */
 
+    if ( statfile ) { /* Statistics of all processes, as JSON. */
+	superlu_dist_stats_t st;
+	FILE *sfp;
+	superlu_stats_query(&stat, LUstruct.Glu_persist, n, &grid, &st);
+	if ( !iam ) {
+	    if ( !(sfp = fopen(statfile, "w")) ) ABORT("Cannot open statistics file");
+	    superlu_stats_json(&st, sfp);
+	    fclose(sfp);
+	}
+    }
+
     /* ------------------------------------------------------------
        DEALLOCATE STORAGE.
        ------------------------------------------------------------*/
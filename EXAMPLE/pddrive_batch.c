@@ -0,0 +1,273 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Driver program for PDGSSVX3D_CSC_BATCH example, solving a batch
+ *  of systems with the same sparsity structure on the CPU
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/* Settings of pddrive_batch that the command line can change. */
+typedef struct {
+    int batchCount, nrhs;
+    superlu_dist_options_t *options;
+} batch_args_t;
+
+/* Options of pddrive_batch besides -r and -c. */
+static void batch_opt(int c, char *val, void *arg)
+{
+    batch_args_t *ba = (batch_args_t *) arg;
+
+    switch (c) {
+      case 'h':
+	  printf("\t-b <int>: systems in the batch (default %d)\n", ba->batchCount);
+	  printf("\t-s <int>: right-hand sides per system (default %d)\n", ba->nrhs);
+	  printf("\t-p <int>: row permutation (default %d)\n", ba->options->RowPerm);
+	  printf("\t-q <int>: column permutation (default %d)\n", ba->options->ColPerm);
+	  break;
+      case 'b': ba->batchCount = atoi(val);
+	        break;
+      case 's': ba->nrhs = atoi(val);
+	        break;
+      case 'p': ba->options->RowPerm = atoi(val);
+	        break;
+      case 'q': ba->options->ColPerm = atoi(val);
+	        break;
+    }
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * The driver program PDDRIVE_BATCH.
+ *
+ * This example illustrates how to use PDGSSVX3D_CSC_BATCH to solve a
+ * batch of linear systems whose matrices have the same sparsity
+ * structure but different values. The matrix read from the file is
+ * perturbed to give the -b matrices of the batch; each system has -s
+ * right-hand sides. Without GPU offload, the batch is factored by the
+ * batched CPU engine, with OpenMP across the batch. Every process solves
+ * its own copy of the batch.
+ *
+ * With MPICH,  program may be run by typing:
+ *    mpiexec -n 1 pddrive_batch -b 100 big.rua
+ * </pre>
+ */
+int main(int argc, char *argv[])
+{
+    superlu_dist_options_t options;
+    SuperLUStat_t stat;
+    SuperMatrix **A;
+    gridinfo3d_t grid;
+    handle_t *SparseMatrix_handles;
+    double   **RHSptr, **ReqPtr, **CeqPtr, **Xptr, **xtrues, **Berrs;
+    double   *nzval, *a, err, xnorm, maxerr = 0.0, maxberr = 0.0, t;
+    int_t    *rowind, *colptr, *rowind_d, *colptr_d, m, n, nnz, i, j;
+    int      **RpivPtr, **CpivPtr, *ldRHS, *ldX;
+    DiagScale_t *DiagScale;
+    int      nprow, npcol, iam, info, nrhs, batchCount, d, k;
+    char     *matfile, *postfix, trans[1];
+    int omp_mpi_level;
+    batch_args_t ba;
+    FILE *fp;
+
+    nprow = 1;  /* Default process rows.      */
+    npcol = 1;  /* Default process columns.   */
+    nrhs  = 1;  /* Number of right-hand side. */
+    batchCount = 64;
+
+    /* ------------------------------------------------------------
+       INITIALIZE MPI ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Init_thread( &argc, &argv, MPI_THREAD_MULTIPLE, &omp_mpi_level);
+
+    /* Set the default input options. */
+    set_default_options_dist(&options);
+
+    /* Parse command line argv[]. */
+    ba.batchCount = batchCount;
+    ba.nrhs = nrhs;
+    ba.options = &options;
+    fp = dparse_driver_args(argv, &nprow, &npcol, batch_opt, &ba,
+			    &matfile, &postfix);
+    batchCount = ba.batchCount;
+    nrhs = ba.nrhs;
+
+    /* ------------------------------------------------------------
+       INITIALIZE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+    superlu_gridinit3d(MPI_COMM_WORLD, nprow, npcol, 1, &grid);
+
+    /* Bail out if I do not belong in the grid. */
+    iam = grid.iam;
+    if ( iam == -1 )	goto out;
+    if ( !iam ) {
+	printf("Input matrix file:\t%s\n", matfile);
+	printf("Batch:\t\t\t%d systems, %d right-hand sides\n", batchCount, nrhs);
+	fflush(stdout);
+    }
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Enter main()");
+#endif
+
+    /* ------------------------------------------------------------
+       READ THE MATRIX, AND MAKE THE BATCH OF PERTURBED COPIES.
+       ------------------------------------------------------------*/
+    if ( !strcmp(postfix, "rb") )
+	dreadrb_dist(iam, fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+    else if ( !strcmp(postfix, "mtx") )
+	dreadMM_dist(fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+    else if ( !strcmp(postfix, "dat") )
+	dreadtriple_dist(fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+    else
+	dreadhb_dist(iam, fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+    fclose(fp);
+
+    A = (SuperMatrix **) SUPERLU_MALLOC(batchCount * sizeof(SuperMatrix *));
+    SparseMatrix_handles = SUPERLU_MALLOC(batchCount * sizeof(handle_t));
+    RHSptr = (double **) SUPERLU_MALLOC(batchCount * sizeof(double *));
+    xtrues = (double **) SUPERLU_MALLOC(batchCount * sizeof(double *));
+    Xptr = (double **) SUPERLU_MALLOC(batchCount * sizeof(double *));
+    Berrs = (double **) SUPERLU_MALLOC(batchCount * sizeof(double *));
+    ReqPtr = (double **) SUPERLU_MALLOC(batchCount * sizeof(double *));
+    CeqPtr = (double **) SUPERLU_MALLOC(batchCount * sizeof(double *));
+    RpivPtr = (int **) SUPERLU_MALLOC(batchCount * sizeof(int *));
+    CpivPtr = (int **) SUPERLU_MALLOC(batchCount * sizeof(int *));
+    DiagScale = (DiagScale_t *) SUPERLU_MALLOC(batchCount * sizeof(DiagScale_t));
+    ldRHS = int32Malloc_dist(batchCount);
+    ldX = int32Malloc_dist(batchCount);
+    *trans = 'N';
+
+    for (d = 0; d < batchCount; ++d) {
+	dallocateA_dist(n, nnz, &a, &rowind_d, &colptr_d);
+	for (j = 0; j <= n; ++j) colptr_d[j] = colptr[j];
+	for (i = 0; i < nnz; ++i) {
+	    rowind_d[i] = rowind[i];
+	    a[i] = nzval[i] * (1.0 + 0.01 * sin((double) (d + 1) * (i + 1)));
+	}
+	A[d] = (SuperMatrix *) SUPERLU_MALLOC(sizeof(SuperMatrix));
+	dCreate_CompCol_Matrix_dist(A[d], m, n, nnz, a, rowind_d, colptr_d,
+				    SLU_NC, SLU_D, SLU_GE);
+	SparseMatrix_handles[d] = (handle_t) A[d];
+
+	RHSptr[d] = doubleMalloc_dist(m * nrhs);
+	xtrues[d] = doubleMalloc_dist(n * nrhs);
+	Xptr[d] = doubleMalloc_dist(n * nrhs);
+	Berrs[d] = doubleMalloc_dist(nrhs);
+	RpivPtr[d] = int32Malloc_dist(m);
+	CpivPtr[d] = int32Malloc_dist(n);
+	ldRHS[d] = m;
+	ldX[d] = n;
+	DiagScale[d] = NOEQUIL;
+	dGenXtrue_dist(n, nrhs, xtrues[d], n);
+	dFillRHS_dist(trans, nrhs, xtrues[d], n, A[d], RHSptr[d], m);
+    }
+    SUPERLU_FREE(nzval);
+    SUPERLU_FREE(rowind);
+    SUPERLU_FREE(colptr);
+
+    /* ------------------------------------------------------------
+       SOLVE THE BATCH.
+       ------------------------------------------------------------*/
+    PStatInit(&stat);
+    t = SuperLU_timer_();
+    pdgssvx3d_csc_batch(&options, batchCount, m, n, nnz, nrhs,
+			SparseMatrix_handles, RHSptr, ldRHS, ReqPtr, CeqPtr,
+			RpivPtr, CpivPtr, DiagScale, NULL, Xptr, ldX, Berrs,
+			&grid, &stat, &info);
+    t = SuperLU_timer_() - t;
+    if ( info ) {
+	printf("ERROR: INFO = %d returned from pdgssvx3d_csc_batch()\n", info);
+	fflush(stdout);
+    }
+
+    /* Check the accuracy of the solutions. */
+    for (d = 0; d < batchCount; ++d)
+	for (k = 0; k < nrhs; ++k) {
+	    for (err = xnorm = 0.0, i = 0; i < n; ++i) {
+		err = SUPERLU_MAX(err, fabs(Xptr[d][i + k * n] - xtrues[d][i + k * n]));
+		xnorm = SUPERLU_MAX(xnorm, fabs(xtrues[d][i + k * n]));
+	    }
+	    maxerr = SUPERLU_MAX(maxerr, err / xnorm);
+	    maxberr = SUPERLU_MAX(maxberr, Berrs[d][k]);
+	}
+    /* Every process holds the solutions of the whole batch. */
+    MPI_Allreduce(MPI_IN_PLACE, &maxerr, 1, MPI_DOUBLE, MPI_MAX, grid.comm);
+    MPI_Allreduce(MPI_IN_PLACE, &maxberr, 1, MPI_DOUBLE, MPI_MAX, grid.comm);
+    if ( !iam ) {
+	printf("\tmax ||X - Xtrue|| / ||X|| = %e\n", maxerr);
+	printf("\tmax Berr                  = %e\n", maxberr);
+	printf("\tTiny pivots replaced      = %d\n", stat.TinyPivots);
+	printf("\tSymbolic %8.4f s, factor %8.4f s, solve %8.4f s\n",
+	       stat.utime[SYMBFAC], stat.utime[FACT], stat.utime[SOLVE]);
+	printf("\tTotal    %8.4f s, %10.1f systems/s\n", t,
+	       t > 0.0 ? batchCount / t : 0.0);
+	fflush(stdout);
+    }
+
+    /* ------------------------------------------------------------
+       DEALLOCATE STORAGE.
+       ------------------------------------------------------------*/
+    PStatFree(&stat);
+    for (d = 0; d < batchCount; ++d) {
+	Destroy_CompCol_Matrix_dist(A[d]);
+	SUPERLU_FREE(A[d]);
+	SUPERLU_FREE(RHSptr[d]);
+	SUPERLU_FREE(xtrues[d]);
+	SUPERLU_FREE(Xptr[d]);
+	SUPERLU_FREE(Berrs[d]);
+	SUPERLU_FREE(RpivPtr[d]);
+	SUPERLU_FREE(CpivPtr[d]);
+	if ( DiagScale[d] == ROW || DiagScale[d] == BOTH ) SUPERLU_FREE(ReqPtr[d]);
+	if ( DiagScale[d] == COL || DiagScale[d] == BOTH ) SUPERLU_FREE(CeqPtr[d]);
+    }
+    SUPERLU_FREE(A);
+    SUPERLU_FREE(SparseMatrix_handles);
+    SUPERLU_FREE(RHSptr);
+    SUPERLU_FREE(xtrues);
+    SUPERLU_FREE(Xptr);
+    SUPERLU_FREE(Berrs);
+    SUPERLU_FREE(ReqPtr);
+    SUPERLU_FREE(CeqPtr);
+    SUPERLU_FREE(RpivPtr);
+    SUPERLU_FREE(CpivPtr);
+    SUPERLU_FREE(DiagScale);
+    SUPERLU_FREE(ldRHS);
+    SUPERLU_FREE(ldX);
+
+    /* ------------------------------------------------------------
+       RELEASE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+out:
+    superlu_gridexit3d(&grid);
+
+    /* ------------------------------------------------------------
+       TERMINATES THE MPI EXECUTION ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Finalize();
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit main()");
+#endif
+
+}
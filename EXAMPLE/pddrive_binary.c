@@ -0,0 +1,220 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Driver program for PDGSSVX example, reading a binary matrix file
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * The driver program PDDRIVE_BINARY.
+ *
+ * This example illustrates how to convert a matrix file to the binary
+ * format with DWRITE_BINARY, and how to read it back in parallel with
+ * DCREATE_MATRIX_BINARY, where each process reads only its own rows.
+ * If the input file is already in binary format (.bin), it is read
+ * directly; otherwise it is read on process 0, written to the file
+ * given by -o, and that file is removed at the end.
+ *
+ * With MPICH,  program may be run by typing:
+ *    mpiexec -n <np> pddrive_binary -r <proc rows> -c <proc columns> big.rua
+ * </pre>
+ */
+int main(int argc, char *argv[])
+{
+    superlu_dist_options_t options;
+    SuperLUStat_t stat;
+    SuperMatrix A;
+    dScalePermstruct_t ScalePermstruct;
+    dLUstruct_t LUstruct;
+    dSOLVEstruct_t SOLVEstruct;
+    gridinfo_t grid;
+    double   *berr;
+    double   *b, *xtrue, *nzval;
+    int_t    m, n, nnz, *rowind, *colptr;
+    int      m_loc;
+    int      nprow, npcol;
+    int      iam, info, ldb, ldx, nrhs;
+    char     **cpp, c, *postfix = "", *fname = NULL;
+    char     *binname = "pddrive_binary.bin";
+    int ii, omp_mpi_level, convert;
+    FILE *fp, *fopen();
+
+    nprow = 1;  /* Default process rows.      */
+    npcol = 1;  /* Default process columns.   */
+    nrhs  = 1;  /* Number of right-hand side. */
+
+    /* ------------------------------------------------------------
+       INITIALIZE MPI ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Init_thread( &argc, &argv, MPI_THREAD_MULTIPLE, &omp_mpi_level);
+
+    /* Parse command line argv[]. */
+    for (cpp = argv+1; *cpp; ++cpp) {
+	if ( **cpp == '-' ) {
+	    c = *(*cpp+1);
+	    ++cpp;
+	    switch (c) {
+	      case 'h':
+		  printf("Options:\n");
+		  printf("\t-r <int>: process rows    (default %d)\n", nprow);
+		  printf("\t-c <int>: process columns (default %d)\n", npcol);
+		  printf("\t-o <char*>: binary file to write (default %s)\n", binname);
+		  exit(0);
+		  break;
+	      case 'r': nprow = atoi(*cpp);
+		        break;
+	      case 'c': npcol = atoi(*cpp);
+		        break;
+	      case 'o': binname = *cpp;
+		        break;
+	    }
+	} else { /* Last arg is considered a filename */
+	    fname = *cpp;
+	    break;
+	}
+    }
+    if ( !fname ) ABORT("No input matrix file");
+
+    /* ------------------------------------------------------------
+       INITIALIZE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+    superlu_gridinit(MPI_COMM_WORLD, nprow, npcol, &grid);
+
+    /* Bail out if I do not belong in the grid. */
+    iam = grid.iam;
+    if ( iam == -1 )	goto out;
+    if ( !iam ) {
+	printf("Input matrix file:\t%s\n", fname);
+        printf("Process grid:\t\t%d X %d\n", (int)grid.nprow, (int)grid.npcol);
+	fflush(stdout);
+    }
+
+    for(ii = 0;ii<strlen(fname);ii++){
+	if(fname[ii]=='.'){
+		postfix = &(fname[ii+1]);
+	}
+    }
+
+    /* ------------------------------------------------------------
+       CONVERT THE MATRIX TO BINARY FORMAT ON PROCESS 0.
+       ------------------------------------------------------------*/
+    convert = strcmp(postfix, "bin");
+    if ( convert ) {
+	info = 0;
+	if ( !iam ) {
+	    if ( !(fp = fopen(fname, "r")) ) ABORT("File does not exist");
+	    if ( !strcmp(postfix, "mtx") )
+		dreadMM_dist(fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	    else if ( !strcmp(postfix, "rb") )
+		dreadrb_dist(iam, fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	    else if ( !strcmp(postfix, "dat") )
+		dreadtriple_dist(fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	    else
+		dreadhb_dist(iam, fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	    fclose(fp);
+
+	    info = dwrite_binary(binname, m, n, nnz, nzval, rowind, colptr);
+	    SUPERLU_FREE(nzval);
+	    SUPERLU_FREE(rowind);
+	    SUPERLU_FREE(colptr);
+	}
+	MPI_Bcast( &info, 1, MPI_INT, 0, grid.comm );
+	if ( info ) {
+	    if ( !iam ) printf("ERROR: INFO = %d returned from dwrite_binary()\n", info);
+	    ABORT("dwrite_binary failed");
+	}
+	fname = binname;
+    }
+
+    /* ------------------------------------------------------------
+       READ THE MATRIX IN PARALLEL AND SETUP THE RIGHT HAND SIDE.
+       ------------------------------------------------------------*/
+    if ( dcreate_matrix_binary(&A, nrhs, &b, &ldb, &xtrue, &ldx, fname, &grid) )
+	ABORT("dcreate_matrix_binary failed");
+
+    if ( !(berr = doubleMalloc_dist(nrhs)) )
+	ABORT("Malloc fails for berr[].");
+
+    m = A.nrow;
+    n = A.ncol;
+    m_loc = ((NRformat_loc *)A.Store)->m_loc;
+
+    /* ------------------------------------------------------------
+       SOLVE THE LINEAR SYSTEM.
+       ------------------------------------------------------------*/
+    set_default_options_dist(&options);
+
+    dScalePermstructInit(m, n, &ScalePermstruct);
+    dLUstructInit(n, &LUstruct);
+    PStatInit(&stat);
+
+    pdgssvx(&options, &A, &ScalePermstruct, b, ldb, nrhs, &grid,
+	    &LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+    if ( info ) {  /* Something is wrong */
+        if ( iam==0 ) {
+	    printf("ERROR: INFO = %d returned from pdgssvx()\n", info);
+	    fflush(stdout);
+	}
+    } else {
+        /* Check the accuracy of the solution. */
+        pdinf_norm_error(iam, m_loc, nrhs, b, ldb, xtrue, ldx, grid.comm);
+    }
+
+    PStatPrint(&options, &stat, &grid);        /* Print the statistics. */
+
+    /* ------------------------------------------------------------
+       DEALLOCATE STORAGE.
+       ------------------------------------------------------------*/
+    PStatFree(&stat);
+    Destroy_CompRowLoc_Matrix_dist(&A);
+    dScalePermstructFree(&ScalePermstruct);
+    dDestroy_LU(n, &grid, &LUstruct);
+    dLUstructFree(&LUstruct);
+    if ( options.SolveInitialized ) {
+        dSolveFinalize(&options, &SOLVEstruct);
+    }
+    SUPERLU_FREE(b);
+    SUPERLU_FREE(xtrue);
+    SUPERLU_FREE(berr);
+
+    if ( convert && !iam ) remove(binname);
+
+    /* ------------------------------------------------------------
+       RELEASE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+out:
+    superlu_gridexit(&grid);
+
+    /* ------------------------------------------------------------
+       TERMINATES THE MPI EXECUTION ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Finalize();
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit main()");
+#endif
+
+}
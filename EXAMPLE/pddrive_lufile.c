@@ -0,0 +1,239 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Driver program for PDGSSVX example, restarting from saved factors
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/* Options of pddrive_lufile besides -r and -c. */
+static void lufile_opt(int c, char *val, void *arg)
+{
+    char **prefix = (char **) arg;
+
+    if ( c == 'h' )
+	printf("\t-f <char*>: prefix of the LU files (default %s)\n", *prefix);
+    else if ( c == 'f' )
+	*prefix = val;
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * The driver program PDDRIVE_LUFILE.
+ *
+ * This example illustrates how to save the L and U factors computed by
+ * PDGSSVX with PDSAVELU, and how a later run on the same process grid
+ * restores them with PDLOADLU, or maps them with PDMAPLU, and solves with
+ * Fact = FACTORED, without refactoring A. All the phases are done in the
+ * same program here; all the SuperLU data structures are released in
+ * between.
+ *
+ * With MPICH,  program may be run by typing:
+ *    mpiexec -n <np> pddrive_lufile -r <proc rows> -c <proc columns> big.rua
+ * </pre>
+ */
+int main(int argc, char *argv[])
+{
+    superlu_dist_options_t options;
+    SuperLUStat_t stat;
+    SuperMatrix A;
+    dScalePermstruct_t ScalePermstruct;
+    dLUstruct_t LUstruct;
+    dSOLVEstruct_t SOLVEstruct;
+    gridinfo_t grid;
+    double   *berr;
+    double   *b, *xtrue;
+    int    m, n, m_loc;
+    int    nprow, npcol;
+    int    iam, info, ldb, ldx, nrhs;
+    char     *matfile, *postfix;
+    char     *prefix = "pddrive_lufile.LU", fname[1024];
+    int omp_mpi_level, map;
+    FILE *fp;
+
+    nprow = 1;  /* Default process rows.      */
+    npcol = 1;  /* Default process columns.   */
+    nrhs  = 1;  /* Number of right-hand side. */
+
+    /* ------------------------------------------------------------
+       INITIALIZE MPI ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Init_thread( &argc, &argv, MPI_THREAD_MULTIPLE, &omp_mpi_level);
+
+    /* Parse command line argv[]. */
+    fp = dparse_driver_args(argv, &nprow, &npcol, lufile_opt, &prefix,
+			    &matfile, &postfix);
+
+    /* ------------------------------------------------------------
+       INITIALIZE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+    superlu_gridinit(MPI_COMM_WORLD, nprow, npcol, &grid);
+
+    /* Bail out if I do not belong in the grid. */
+    iam = grid.iam;
+    if ( iam == -1 )	goto out;
+    if ( !iam ) {
+	printf("Input matrix file:\t%s\n", matfile);
+        printf("Process grid:\t\t%d X %d\n", (int)grid.nprow, (int)grid.npcol);
+	fflush(stdout);
+    }
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Enter main()");
+#endif
+
+    /* ------------------------------------------------------------
+       GET THE MATRIX FROM FILE AND SETUP THE RIGHT HAND SIDE.
+       ------------------------------------------------------------*/
+    dcreate_matrix_postfix(&A, nrhs, &b, &ldb, &xtrue, &ldx, fp, postfix, &grid);
+
+    if ( !(berr = doubleMalloc_dist(nrhs)) )
+	ABORT("Malloc fails for berr[].");
+
+    m = A.nrow;
+    n = A.ncol;
+    m_loc = ((NRformat_loc *)A.Store)->m_loc;
+
+    /* ------------------------------------------------------------
+       1. FACTORIZE AND SOLVE, THEN SAVE THE FACTORS TO DISK.
+       ------------------------------------------------------------*/
+    set_default_options_dist(&options);
+
+    dScalePermstructInit(m, n, &ScalePermstruct);
+    dLUstructInit(n, &LUstruct);
+    PStatInit(&stat);
+
+    pdgssvx(&options, &A, &ScalePermstruct, b, ldb, nrhs, &grid,
+	    &LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+    if ( info ) {  /* Something is wrong */
+        if ( iam==0 ) {
+	    printf("ERROR: INFO = %d returned from pdgssvx()\n", info);
+	    fflush(stdout);
+	}
+    } else {
+        /* Check the accuracy of the solution. */
+        if ( !iam ) printf("\tSolve with the computed factors:\n");
+        pdinf_norm_error(iam, m_loc, nrhs, b, ldb, xtrue, ldx, grid.comm);
+    }
+
+    if ( (info = pdSaveLU(prefix, n, &ScalePermstruct, &LUstruct, &grid)) ) {
+        if ( iam==0 ) printf("ERROR: INFO = %d returned from pdSaveLU()\n", info);
+	ABORT("pdSaveLU failed");
+    }
+
+    /* Release everything, as if the program was restarted. */
+    PStatFree(&stat);
+    dScalePermstructFree(&ScalePermstruct);
+    dDestroy_LU(n, &grid, &LUstruct);
+    dLUstructFree(&LUstruct);
+    if ( options.SolveInitialized ) {
+        dSolveFinalize(&options, &SOLVEstruct);
+    }
+    Destroy_CompRowLoc_Matrix_dist(&A);
+    SUPERLU_FREE(b);
+    SUPERLU_FREE(xtrue);
+
+    /* ------------------------------------------------------------
+       2. LOAD THE FACTORS FROM DISK AND SOLVE WITHOUT FACTORIZATION.
+       3. THE SAME, WITH THE FACTORS MAPPED INTO MEMORY.
+       ------------------------------------------------------------*/
+    for (map = 0; map < 2; ++map) {
+	rewind(fp);
+	dcreate_matrix_postfix(&A, nrhs, &b, &ldb, &xtrue, &ldx, fp, postfix, &grid);
+
+	set_default_options_dist(&options);
+	options.Fact = FACTORED; /* Indicate the factored form of A is supplied. */
+
+	dScalePermstructInit(m, n, &ScalePermstruct);
+	dLUstructInit(n, &LUstruct);
+	PStatInit(&stat);
+
+	if ( map )
+	    info = pdMapLU(prefix, n, &options, &ScalePermstruct, &LUstruct,
+			   &grid, &stat);
+	else
+	    info = pdLoadLU(prefix, n, &options, &ScalePermstruct, &LUstruct,
+			    &grid, &stat);
+	if ( info ) {
+	    if ( iam==0 ) printf("ERROR: INFO = %d returned from %s()\n",
+				 info, map ? "pdMapLU" : "pdLoadLU");
+	    ABORT("Loading the factors failed");
+	}
+
+	/* Iterative refinement needs A in the scaled and permuted form. */
+	pdScalePermA_LUfile(&A, &ScalePermstruct);
+
+	pdgssvx(&options, &A, &ScalePermstruct, b, ldb, nrhs, &grid,
+		&LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+	if ( info ) {  /* Something is wrong */
+	    if ( iam==0 ) {
+		printf("ERROR: INFO = %d returned from pdgssvx()\n", info);
+		fflush(stdout);
+	    }
+	} else {
+	    /* Check the accuracy of the solution. */
+	    if ( !iam ) printf("\tSolve with the factors %s disk:\n",
+			       map ? "mapped from" : "loaded from");
+	    pdinf_norm_error(iam, m_loc, nrhs, b, ldb, xtrue, ldx, grid.comm);
+	}
+
+	PStatPrint(&options, &stat, &grid);        /* Print the statistics. */
+
+	/* --------------------------------------------------------
+	   DEALLOCATE STORAGE.
+	   --------------------------------------------------------*/
+	PStatFree(&stat);
+	Destroy_CompRowLoc_Matrix_dist(&A);
+	dScalePermstructFree(&ScalePermstruct);
+	dDestroy_LU(n, &grid, &LUstruct);
+	dLUstructFree(&LUstruct);
+	if ( options.SolveInitialized ) {
+	    dSolveFinalize(&options, &SOLVEstruct);
+	}
+	SUPERLU_FREE(b);
+	SUPERLU_FREE(xtrue);
+    }
+    SUPERLU_FREE(berr);
+    fclose(fp);
+
+    snprintf(fname, sizeof(fname), "%s.%d", prefix, iam);
+    remove(fname);
+
+    /* ------------------------------------------------------------
+       RELEASE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+out:
+    superlu_gridexit(&grid);
+
+    /* ------------------------------------------------------------
+       TERMINATES THE MPI EXECUTION ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Finalize();
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit main()");
+#endif
+
+}
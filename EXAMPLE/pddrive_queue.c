@@ -0,0 +1,227 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Driver program for PDGSSVX example, solving queued right-hand sides
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/* Options of pddrive_queue besides -r and -c; arg holds nreq, max_nrhs. */
+static void queue_opt(int c, char *val, void *arg)
+{
+    int *par = (int *) arg;
+
+    if ( c == 'h' ) {
+	printf("\t-n <int>: right-hand sides to solve (default %d)\n", par[0]);
+	printf("\t-q <int>: right-hand sides solved together (default %d)\n", par[1]);
+    } else if ( c == 'n' ) {
+	par[0] = atoi(val);
+    } else if ( c == 'q' ) {
+	par[1] = atoi(val);
+    }
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * The driver program PDDRIVE_QUEUE.
+ *
+ * This example illustrates how to solve many right-hand sides arriving
+ * one at a time with the same factors. After A is factored by PDGSSVX,
+ * the right-hand sides are solved first by one call to PDGSSVX each,
+ * then by submitting them to a queue with PDSOLVEQUEUESUBMIT, which
+ * solves up to -q of them together. The time of both is printed.
+ *
+ * With MPICH,  program may be run by typing:
+ *    mpiexec -n <np> pddrive_queue -r <proc rows> -c <proc columns> big.rua
+ * </pre>
+ */
+int main(int argc, char *argv[])
+{
+    superlu_dist_options_t options;
+    SuperLUStat_t stat;
+    SuperMatrix A;
+    dScalePermstruct_t ScalePermstruct;
+    dLUstruct_t LUstruct;
+    dSOLVEstruct_t SOLVEstruct;
+    dSolveQueue_t Q;
+    gridinfo_t grid;
+    double   *berr;
+    double   *b, *xtrue, *x;
+    double   t, t_single, t_queue;
+    int    m, n, m_loc;
+    int    nprow, npcol;
+    int    iam, info, ldb, ldx, nrhs;
+    int    nreq, max_nrhs, *ticket;
+    int    par[2] = {16, 8};  /* defaults of nreq and max_nrhs */
+    char     *matfile, *postfix;
+    int i, k, omp_mpi_level, pass;
+    FILE *fp;
+
+    nprow = 1;  /* Default process rows.      */
+    npcol = 1;  /* Default process columns.   */
+    nrhs  = 1;  /* Number of right-hand side. */
+
+    /* ------------------------------------------------------------
+       INITIALIZE MPI ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Init_thread( &argc, &argv, MPI_THREAD_MULTIPLE, &omp_mpi_level);
+
+    /* Parse command line argv[]. */
+    fp = dparse_driver_args(argv, &nprow, &npcol, queue_opt, par,
+			    &matfile, &postfix);
+    nreq = par[0];
+    max_nrhs = par[1];
+
+    /* ------------------------------------------------------------
+       INITIALIZE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+    superlu_gridinit(MPI_COMM_WORLD, nprow, npcol, &grid);
+
+    /* Bail out if I do not belong in the grid. */
+    iam = grid.iam;
+    if ( iam == -1 )	goto out;
+    if ( !iam ) {
+	printf("Input matrix file:\t%s\n", matfile);
+        printf("Process grid:\t\t%d X %d\n", (int)grid.nprow, (int)grid.npcol);
+	fflush(stdout);
+    }
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Enter main()");
+#endif
+
+    /* ------------------------------------------------------------
+       GET THE MATRIX FROM FILE AND SETUP THE RIGHT HAND SIDE.
+       ------------------------------------------------------------*/
+    dcreate_matrix_postfix(&A, nrhs, &b, &ldb, &xtrue, &ldx, fp, postfix, &grid);
+    fclose(fp);
+
+    if ( !(berr = doubleMalloc_dist(nreq)) )
+	ABORT("Malloc fails for berr[].");
+    if ( !(x = doubleMalloc_dist(ldb * nreq)) )
+	ABORT("Malloc fails for x[].");
+    if ( !(ticket = int32Malloc_dist(nreq)) )
+	ABORT("Malloc fails for ticket[].");
+
+    m = A.nrow;
+    n = A.ncol;
+    m_loc = ((NRformat_loc *)A.Store)->m_loc;
+
+    /* ------------------------------------------------------------
+       FACTORIZE A, AND SOLVE WITH THE FIRST RIGHT-HAND SIDE.
+       ------------------------------------------------------------*/
+    set_default_options_dist(&options);
+    options.PrintStat = NO;
+
+    dScalePermstructInit(m, n, &ScalePermstruct);
+    dLUstructInit(n, &LUstruct);
+    PStatInit(&stat);
+
+    for (i = 0; i < m_loc; ++i) x[i] = b[i];
+    pdgssvx(&options, &A, &ScalePermstruct, x, ldb, nrhs, &grid,
+	    &LUstruct, &SOLVEstruct, berr, &stat, &info);
+    if ( info ) {
+	if ( iam==0 ) printf("ERROR: INFO = %d returned from pdgssvx()\n", info);
+	ABORT("pdgssvx failed");
+    }
+    options.Fact = FACTORED;
+
+    /* ------------------------------------------------------------
+       SOLVE nreq RIGHT-HAND SIDES (k+1)*b, k = 0, ..., nreq-1,
+       1. ONE CALL TO PDGSSVX EACH,
+       2. THROUGH THE QUEUE.
+       ------------------------------------------------------------*/
+    for (pass = 0; pass < 2; ++pass) {
+	for (k = 0; k < nreq; ++k)
+	    for (i = 0; i < m_loc; ++i) x[i + k * ldb] = (k + 1) * b[i];
+
+	MPI_Barrier(grid.comm);
+	t = SuperLU_timer_();
+	if ( pass == 0 ) {
+	    for (k = 0; k < nreq; ++k) {
+		pdgssvx(&options, &A, &ScalePermstruct, &x[k * ldb], ldb, 1,
+			&grid, &LUstruct, &SOLVEstruct, &berr[k], &stat, &info);
+		if ( info ) ABORT("pdgssvx failed");
+	    }
+	} else {
+	    pdSolveQueueInit(&Q, max_nrhs, &options, &A, &ScalePermstruct,
+			    &LUstruct, &SOLVEstruct, &grid, &stat);
+	    /* The requests arrive one at a time ... */
+	    for (k = 0; k < nreq; ++k)
+		ticket[k] = pdSolveQueueSubmit(&Q, &x[k * ldb], ldb, 1, &berr[k]);
+	    /* ... and their solutions are needed later. */
+	    for (k = 0; k < nreq; ++k)
+		if ( (info = pdSolveQueueWait(&Q, ticket[k])) )
+		    ABORT("pdSolveQueueWait failed");
+	    pdSolveQueueFinalize(&Q);
+	}
+	t = SuperLU_timer_() - t;
+	if ( pass == 0 ) t_single = t;
+	else t_queue = t;
+
+	/* Check the accuracy of the last solution, scaled back. */
+	k = nreq - 1;
+	for (i = 0; i < m_loc; ++i) x[i + k * ldb] /= (k + 1);
+	if ( !iam ) printf("\t%s, berr[%d] = %e:\n",
+			   pass ? "Queued solves" : "Single solves", k, berr[k]);
+	pdinf_norm_error(iam, m_loc, 1, &x[k * ldb], ldb, xtrue, ldx, grid.comm);
+    }
+    if ( !iam ) {
+	printf("\t%d solves, one at a time:\t%10.4f s\n", nreq, t_single);
+	printf("\t%d solves, %d at a time:\t%10.4f s\n", nreq, max_nrhs, t_queue);
+	fflush(stdout);
+    }
+
+    /* ------------------------------------------------------------
+       DEALLOCATE STORAGE.
+       ------------------------------------------------------------*/
+    PStatFree(&stat);
+    Destroy_CompRowLoc_Matrix_dist(&A);
+    dScalePermstructFree(&ScalePermstruct);
+    dDestroy_LU(n, &grid, &LUstruct);
+    dLUstructFree(&LUstruct);
+    if ( options.SolveInitialized ) {
+        dSolveFinalize(&options, &SOLVEstruct);
+    }
+    SUPERLU_FREE(b);
+    SUPERLU_FREE(xtrue);
+    SUPERLU_FREE(x);
+    SUPERLU_FREE(berr);
+    SUPERLU_FREE(ticket);
+
+    /* ------------------------------------------------------------
+       RELEASE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+out:
+    superlu_gridexit(&grid);
+
+    /* ------------------------------------------------------------
+       TERMINATES THE MPI EXECUTION ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Finalize();
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit main()");
+#endif
+
+}
@@ -0,0 +1,215 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Driver program for PDGSSVX example, reusing the symbolic analysis
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/* Options of pddrive_symbcache besides -r and -c. */
+static void symbcache_opt(int c, char *val, void *arg)
+{
+    int *npass = (int *) arg;
+
+    if ( c == 'h' )
+	printf("\t-n <int>: factorizations  (default %d)\n", *npass);
+    else if ( c == 'n' )
+	*npass = atoi(val);
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * The driver program PDDRIVE_SYMBCACHE.
+ *
+ * This example illustrates how to use the cache of the symbolic analysis
+ * (options.SymbCache = YES). The same matrix is factored from scratch,
+ * with Fact = DOFACT, -n times; each time the LU structures are freed
+ * first. From the second time on, the column ordering and the symbolic
+ * factorization are taken from the cache, and their time is close to 0.
+ * If SUPERLU_SYMBCACHE_DIR is set, the first factorization of a later
+ * run also finds them in that directory.
+ *
+ * With MPICH,  program may be run by typing:
+ *    mpiexec -n <np> pddrive_symbcache -r <proc rows> -c <proc columns> big.rua
+ * </pre>
+ */
+int main(int argc, char *argv[])
+{
+    superlu_dist_options_t options;
+    SuperLUStat_t stat;
+    SuperMatrix A;
+    NRformat_loc *Astore;
+    dScalePermstruct_t ScalePermstruct;
+    dLUstruct_t LUstruct;
+    dSOLVEstruct_t SOLVEstruct;
+    gridinfo_t grid;
+    double   *berr;
+    double   *b, *b1, *xtrue, *nzval, *nzval1;
+    int_t    *colind, *colind1, *rowptr, *rowptr1;
+    int_t    nnz_loc, fst_row;
+    int    m, n, m_loc;
+    int    nprow, npcol;
+    int    iam, info, ldb, ldx, nrhs;
+    int    npass = 3, pass;
+    char     *matfile, *postfix;
+    int i, omp_mpi_level;
+    FILE *fp;
+
+    nprow = 1;  /* Default process rows.      */
+    npcol = 1;  /* Default process columns.   */
+    nrhs  = 1;  /* Number of right-hand side. */
+
+    /* ------------------------------------------------------------
+       INITIALIZE MPI ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Init_thread( &argc, &argv, MPI_THREAD_MULTIPLE, &omp_mpi_level);
+
+    /* Parse command line argv[]. */
+    fp = dparse_driver_args(argv, &nprow, &npcol, symbcache_opt, &npass,
+			    &matfile, &postfix);
+
+    /* ------------------------------------------------------------
+       INITIALIZE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+    superlu_gridinit(MPI_COMM_WORLD, nprow, npcol, &grid);
+
+    /* Bail out if I do not belong in the grid. */
+    iam = grid.iam;
+    if ( iam == -1 )	goto out;
+    if ( !iam ) {
+	printf("Input matrix file:\t%s\n", matfile);
+        printf("Process grid:\t\t%d X %d\n", (int)grid.nprow, (int)grid.npcol);
+	fflush(stdout);
+    }
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Enter main()");
+#endif
+
+    /* ------------------------------------------------------------
+       GET THE MATRIX FROM FILE AND SETUP THE RIGHT HAND SIDE.
+       ------------------------------------------------------------*/
+    dcreate_matrix_postfix(&A, nrhs, &b, &ldb, &xtrue, &ldx, fp, postfix, &grid);
+    fclose(fp);
+
+    if ( !(b1 = doubleMalloc_dist(ldb * nrhs)) )
+        ABORT("Malloc fails for b1[]");
+    if ( !(berr = doubleMalloc_dist(nrhs)) )
+	ABORT("Malloc fails for berr[].");
+    m = A.nrow;
+    n = A.ncol;
+
+    /* Keep the matrix A; PDGSSVX overwrites it. */
+    Astore = (NRformat_loc *) A.Store;
+    nnz_loc = Astore->nnz_loc;
+    m_loc = Astore->m_loc;
+    fst_row = Astore->fst_row;
+    nzval = Astore->nzval;
+    colind = Astore->colind;
+    rowptr = Astore->rowptr;
+    SUPERLU_FREE(Astore);
+
+    set_default_options_dist(&options);
+    options.SymbCache = YES;
+    options.PrintStat = NO;
+    PStatInit(&stat);
+
+    /* ------------------------------------------------------------
+       FACTOR THE SAME MATRIX FROM SCRATCH npass TIMES.
+       ------------------------------------------------------------*/
+    for (pass = 0; pass < npass; ++pass) {
+	nzval1 = doubleMalloc_dist(nnz_loc);
+	colind1 = intMalloc_dist(nnz_loc);
+	rowptr1 = intMalloc_dist(m_loc+1);
+	for (i = 0; i < nnz_loc; ++i) {
+	    nzval1[i] = nzval[i];
+	    colind1[i] = colind[i];
+	}
+	for (i = 0; i < m_loc+1; ++i) rowptr1[i] = rowptr[i];
+	dCreate_CompRowLoc_Matrix_dist(&A, m, n, nnz_loc, m_loc, fst_row,
+				       nzval1, colind1, rowptr1,
+				       SLU_NR_loc, SLU_D, SLU_GE);
+	for (i = 0; i < ldb * nrhs; ++i) b1[i] = b[i];
+
+	options.Fact = DOFACT;
+	dScalePermstructInit(m, n, &ScalePermstruct);
+	dLUstructInit(n, &LUstruct);
+	PStatClear(&stat);
+
+	pdgssvx(&options, &A, &ScalePermstruct, b1, ldb, nrhs, &grid,
+		&LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+	if ( info ) {  /* Something is wrong */
+	    if ( iam==0 ) {
+		printf("ERROR: INFO = %d returned from pdgssvx()\n", info);
+		fflush(stdout);
+	    }
+	} else {
+	    if ( !iam ) {
+		printf("Factorization %d: COLPERM %8.4f s  SYMBFACT %8.4f s  FACT %8.4f s\n",
+		       pass, stat.utime[COLPERM], stat.utime[SYMBFAC],
+		       stat.utime[FACT]);
+		fflush(stdout);
+	    }
+	    pdinf_norm_error(iam, m_loc, nrhs, b1, ldb, xtrue, ldx, grid.comm);
+	}
+
+	Destroy_CompRowLoc_Matrix_dist(&A);
+	dDestroy_LU(n, &grid, &LUstruct);
+	dScalePermstructFree(&ScalePermstruct);
+	dLUstructFree(&LUstruct);
+	if ( options.SolveInitialized ) {
+	    dSolveFinalize(&options, &SOLVEstruct);
+	    options.SolveInitialized = NO;
+	}
+    }
+
+    /* ------------------------------------------------------------
+       DEALLOCATE STORAGE.
+       ------------------------------------------------------------*/
+    superlu_symbcache_clear();
+    PStatFree(&stat);
+    SUPERLU_FREE(nzval);
+    SUPERLU_FREE(colind);
+    SUPERLU_FREE(rowptr);
+    SUPERLU_FREE(b);
+    SUPERLU_FREE(b1);
+    SUPERLU_FREE(xtrue);
+    SUPERLU_FREE(berr);
+
+    /* ------------------------------------------------------------
+       RELEASE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+out:
+    superlu_gridexit(&grid);
+
+    /* ------------------------------------------------------------
+       TERMINATES THE MPI EXECUTION ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Finalize();
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit main()");
+#endif
+
+}
@@ -0,0 +1,288 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Compare the serial and the parallel Matrix Market readers
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/* Write a matrix in compressed column format in Matrix Market format. */
+static void write_mm(char *fname, int_t n, int_t nnz, double *nzval,
+		     int_t *rowind, int_t *colptr)
+{
+    FILE *fp;
+    int_t i, j;
+
+    if ( !(fp = fopen(fname, "w")) ) ABORT("Cannot create the .mtx file");
+    fprintf(fp, "%%%%MatrixMarket matrix coordinate real general\n");
+    fprintf(fp, IFMT " " IFMT " " IFMT "\n", n, n, nnz);
+    for (j = 0; j < n; ++j)
+	for (i = colptr[j]; i < colptr[j+1]; ++i)
+	    fprintf(fp, IFMT " " IFMT " %.16e\n", rowind[i] + 1, j + 1, nzval[i]);
+    fclose(fp);
+}
+
+/* 7-point Laplacian on a k x k x k grid, in compressed column format. */
+static void laplacian3d(int_t k, int_t *n, int_t *nnz, double **nzval,
+			int_t **rowind, int_t **colptr)
+{
+    int_t x, y, z, j, nz = 0;
+
+    *n = k * k * k;
+    dallocateA_dist(*n, 7 * *n, nzval, rowind, colptr);
+    for (j = 0; j < *n; ++j) {
+	x = j % k;
+	y = (j / k) % k;
+	z = j / (k * k);
+	(*colptr)[j] = nz;
+#define ENTRY(row, v) { (*rowind)[nz] = (row); (*nzval)[nz++] = (v); }
+	if ( z > 0 )     ENTRY(j - k * k, -1.0);
+	if ( y > 0 )     ENTRY(j - k, -1.0);
+	if ( x > 0 )     ENTRY(j - 1, -1.0);
+	ENTRY(j, 6.0);
+	if ( x < k - 1 ) ENTRY(j + 1, -1.0);
+	if ( y < k - 1 ) ENTRY(j + k, -1.0);
+	if ( z < k - 1 ) ENTRY(j + k * k, -1.0);
+#undef ENTRY
+    }
+    (*colptr)[*n] = nz;
+    *nnz = nz;
+}
+
+/* Compute y = A*x for the local rows of A, with x[j] = 1 + j mod 7. */
+static void local_spmv(SuperMatrix *A, double *y)
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    double *a = (double *) Astore->nzval;
+    int_t i, k;
+
+    for (i = 0; i < Astore->m_loc; ++i) {
+	y[i] = 0.0;
+	for (k = Astore->rowptr[i]; k < Astore->rowptr[i+1]; ++k)
+	    y[i] += a[k] * (1 + Astore->colind[k] % 7);
+    }
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * The benchmark program PDREADMM_BENCH.
+ *
+ * It reads a matrix in Matrix Market format into the distributed NR_loc
+ * format in two ways, and prints the time taken by each:
+ *   - serially, with DCREATE_MATRIX_POSTFIX, where process 0 reads the
+ *     whole file with DREADMM_DIST and scatters the rows;
+ *   - in parallel, with PDREADMM_DIST, where each process parses a part
+ *     of the file and the entries are exchanged with MPI_Alltoallv.
+ * The two matrices are checked to be equal, by comparing A*x.
+ *
+ * If the input file is not in Matrix Market format (.mtx), or the
+ * option -g k is given, process 0 first writes a Matrix Market file
+ * (given by -o) from the input matrix, or from the 7-point Laplacian on
+ * a k x k x k grid, and that file is removed at the end.
+ *
+ * With MPICH,  program may be run by typing:
+ *    mpiexec -n <np> pdreadMM_bench -r <proc rows> -c <proc columns> g20.rua
+ *    mpiexec -n <np> pdreadMM_bench -r <proc rows> -c <proc columns> -g 100
+ * </pre>
+ */
+int main(int argc, char *argv[])
+{
+    SuperMatrix A, A2;
+    gridinfo_t grid;
+    double   *b, *xtrue, *nzval, *y, *y2;
+    double   t_serial, t_parallel, err, gerr;
+    int_t    m, n, nnz, *rowind, *colptr, i, k = 0;
+    int      m_loc;
+    int      nprow, npcol;
+    int      iam, info, ldb, ldx, nrhs;
+    char     **cpp, c, *postfix = "", *fname = NULL;
+    char     *mmname = "pdreadMM_bench.mtx";
+    int ii, omp_mpi_level, convert;
+    FILE *fp, *fopen();
+
+    nprow = 1;  /* Default process rows.      */
+    npcol = 1;  /* Default process columns.   */
+    nrhs  = 1;  /* Number of right-hand side. */
+
+    /* ------------------------------------------------------------
+       INITIALIZE MPI ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Init_thread( &argc, &argv, MPI_THREAD_MULTIPLE, &omp_mpi_level);
+
+    /* Parse command line argv[]. */
+    for (cpp = argv+1; *cpp; ++cpp) {
+	if ( **cpp == '-' ) {
+	    c = *(*cpp+1);
+	    ++cpp;
+	    switch (c) {
+	      case 'h':
+		  printf("Options:\n");
+		  printf("\t-r <int>: process rows    (default %d)\n", nprow);
+		  printf("\t-c <int>: process columns (default %d)\n", npcol);
+		  printf("\t-g <int>: generate the 3D Laplacian on a k^3 grid\n");
+		  printf("\t-o <char*>: .mtx file to write (default %s)\n", mmname);
+		  exit(0);
+		  break;
+	      case 'r': nprow = atoi(*cpp);
+		        break;
+	      case 'c': npcol = atoi(*cpp);
+		        break;
+	      case 'g': k = atoi(*cpp);
+		        break;
+	      case 'o': mmname = *cpp;
+		        break;
+	    }
+	} else { /* Last arg is considered a filename */
+	    fname = *cpp;
+	    break;
+	}
+    }
+    if ( !fname && k <= 0 ) ABORT("No input matrix file");
+
+    /* ------------------------------------------------------------
+       INITIALIZE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+    superlu_gridinit(MPI_COMM_WORLD, nprow, npcol, &grid);
+
+    /* Bail out if I do not belong in the grid. */
+    iam = grid.iam;
+    if ( iam == -1 )	goto out;
+    if ( !iam ) {
+	if ( k > 0 ) printf("Laplacian on a grid of size:\t" IFMT "^3\n", k);
+	else printf("Input matrix file:\t%s\n", fname);
+        printf("Process grid:\t\t%d X %d\n", (int)grid.nprow, (int)grid.npcol);
+	fflush(stdout);
+    }
+
+    if ( fname )
+	for(ii = 0;ii<strlen(fname);ii++){
+	    if(fname[ii]=='.'){
+		postfix = &(fname[ii+1]);
+	    }
+	}
+
+    /* ------------------------------------------------------------
+       WRITE THE MATRIX MARKET FILE ON PROCESS 0, IF NEEDED.
+       ------------------------------------------------------------*/
+    convert = k > 0 || strcmp(postfix, "mtx");
+    if ( convert ) {
+	if ( !iam ) {
+	    if ( k > 0 ) {
+		laplacian3d(k, &n, &nnz, &nzval, &rowind, &colptr);
+	    } else {
+		if ( !(fp = fopen(fname, "r")) ) ABORT("File does not exist");
+		if ( !strcmp(postfix, "rb") )
+		    dreadrb_dist(iam, fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+		else if ( !strcmp(postfix, "dat") )
+		    dreadtriple_dist(fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+		else
+		    dreadhb_dist(iam, fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+		fclose(fp);
+	    }
+	    write_mm(mmname, n, nnz, nzval, rowind, colptr);
+	    SUPERLU_FREE(nzval);
+	    SUPERLU_FREE(rowind);
+	    SUPERLU_FREE(colptr);
+	}
+	fname = mmname;
+    }
+    MPI_Barrier(grid.comm);
+
+    /* ------------------------------------------------------------
+       1. SERIAL READER: PROCESS 0 READS, THEN DISTRIBUTES.
+       ------------------------------------------------------------*/
+    t_serial = SuperLU_timer_();
+    if ( !(fp = fopen(fname, "r")) ) ABORT("File does not exist");
+    dcreate_matrix_postfix(&A, nrhs, &b, &ldb, &xtrue, &ldx, fp, "mtx", &grid);
+    fclose(fp);
+    MPI_Barrier(grid.comm);
+    t_serial = SuperLU_timer_() - t_serial;
+
+    /* ------------------------------------------------------------
+       2. PARALLEL READER.
+       ------------------------------------------------------------*/
+    MPI_Barrier(grid.comm);
+    t_parallel = SuperLU_timer_();
+    if ( (info = pdreadMM_dist(fname, &A2, &grid)) ) {
+	if ( !iam ) printf("ERROR: INFO = %d returned from pdreadMM_dist()\n", info);
+	ABORT("pdreadMM_dist failed");
+    }
+    MPI_Barrier(grid.comm);
+    t_parallel = SuperLU_timer_() - t_parallel;
+
+    /* ------------------------------------------------------------
+       CHECK THAT BOTH READERS GIVE THE SAME MATRIX.
+       ------------------------------------------------------------*/
+    m_loc = ((NRformat_loc *)A.Store)->m_loc;
+    if ( m_loc != ((NRformat_loc *)A2.Store)->m_loc
+	 || A.nrow != A2.nrow )
+	ABORT("The two readers distribute the matrix differently");
+    y = doubleMalloc_dist(SUPERLU_MAX(m_loc, 1));
+    y2 = doubleMalloc_dist(SUPERLU_MAX(m_loc, 1));
+    local_spmv(&A, y);
+    local_spmv(&A2, y2);
+    for (err = 0.0, i = 0; i < m_loc; ++i)
+	err = SUPERLU_MAX(err, fabs(y[i] - y2[i]) / SUPERLU_MAX(fabs(y[i]), 1.0));
+    MPI_Allreduce(&err, &gerr, 1, MPI_DOUBLE, MPI_MAX, grid.comm);
+    nnz = ((NRformat_loc *)A2.Store)->nnz_loc;
+    MPI_Allreduce(MPI_IN_PLACE, &nnz, 1, mpi_int_t, MPI_SUM, grid.comm);
+
+    if ( !iam ) {
+	printf("\tn " IFMT ", nnz " IFMT "\n", (int_t) A.nrow, nnz);
+	printf("\tSerial reader (dcreate_matrix_postfix): %10.4f s\n", t_serial);
+	printf("\tParallel reader (pdreadMM_dist):        %10.4f s\n", t_parallel);
+	printf("\tSpeedup:                                %10.2f\n",
+	       t_parallel > 0.0 ? t_serial / t_parallel : 0.0);
+	printf("\tmax relative difference in A*x:         %10.2e\n", gerr);
+	fflush(stdout);
+    }
+    if ( gerr > 1e-12 ) ABORT("The two readers give different matrices");
+
+    /* ------------------------------------------------------------
+       DEALLOCATE STORAGE.
+       ------------------------------------------------------------*/
+    Destroy_CompRowLoc_Matrix_dist(&A);
+    Destroy_CompRowLoc_Matrix_dist(&A2);
+    SUPERLU_FREE(b);
+    SUPERLU_FREE(xtrue);
+    SUPERLU_FREE(y);
+    SUPERLU_FREE(y2);
+
+    if ( convert && !iam ) remove(mmname);
+
+    /* ------------------------------------------------------------
+       RELEASE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+out:
+    superlu_gridexit(&grid);
+
+    /* ------------------------------------------------------------
+       TERMINATES THE MPI EXECUTION ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Finalize();
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit main()");
+#endif
+
+}
@@ -42,7 +42,6 @@ at the top-level directory.
  *    mpiexec -np <p> psdrive3d -r <proc rows> -c <proc columns> \
  *                                   -d <proc Z-dimension> <input_file>
  * NOTE: total number of processes p = r * c * d
- *       d must be a power-of-two, e.g., 1, 2, 4, ...
  *
  * </pre>
  */
@@ -129,7 +128,7 @@ int main (int argc, char *argv[])
 
     nprow = 1;            /* Default process rows.      */
     npcol = 1;            /* Default process columns.   */
-    npdep = 1;            /* replication factor must be power of two */
+    npdep = 1;            /* replication factor */
     nrhs = 1;             /* Number of right-hand side. */
     equil = -1;
     colperm = -1;
@@ -515,6 +514,7 @@ int main (int argc, char *argv[])
 	    printf("ERROR: INFO = %d returned from psgssvx3d()\n", info);
 	    fflush(stdout);
 	}
+	if ( info < 0 ) goto out; /* nothing was set up */
     } else {
         /* Check the accuracy of the solution. */
         psinf_norm_error (iam, ((NRformat_loc *) A.Store)->m_loc,
@@ -1483,6 +1483,7 @@ psgssvx_tracking(superlu_dist_options_t *options, SuperMatrix *A,
 	        SOLVEstruct1->diag_len = SOLVEstruct->diag_len;
 	        SOLVEstruct1->gsmv_comm = SOLVEstruct->gsmv_comm;
 	        SOLVEstruct1->A_colind_gsmv = SOLVEstruct->A_colind_gsmv;
+	        SOLVEstruct1->gstrs_work = SOLVEstruct->gstrs_work;
 
 		/* Initialize the *gstrs_comm for 1 RHS. */
 		if ( !(SOLVEstruct1->gstrs_comm = (pxgstrs_comm_t *)
@@ -515,3 +515,117 @@ int screate_matrix(SuperMatrix *A, int nrhs, float **rhs,
 #endif
     return 0;
 }
+
+/* \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * SCREATE_MATRIX_BINARY reads the matrix from a binary file written by
+ * SWRITE_BINARY, in parallel: each process reads only its own block of
+ * rows (see PSREAD_BINARY), so the global matrix is never formed. It also
+ * generates the distributed true solution X and the right-hand side RHS.
+ *
+ *
+ * Arguments
+ * =========
+ *
+ * A     (output) SuperMatrix*
+ *       Local matrix A in NR_loc format.
+ *
+ * NRHS  (input) int_t
+ *       Number of right-hand sides.
+ *
+ * RHS   (output) float**
+ *       The right-hand side matrix.
+ *
+ * LDB   (output) int*
+ *       Leading dimension of the right-hand side matrix.
+ *
+ * X     (output) float**
+ *       The true solution matrix.
+ *
+ * LDX   (output) int*
+ *       The leading dimension of the true solution matrix.
+ *
+ * FNAME (input) char*
+ *       The name of the binary matrix file.
+ *
+ * GRID  (input) gridinof_t*
+ *       The 2D process mesh.
+ *
+ * Return value
+ * ============
+ *   The error code of PSREAD_BINARY, which is 0 on success.
+ * </pre>
+ */
+int screate_matrix_binary(SuperMatrix *A, int nrhs, float **rhs,
+                          int *ldb, float **x, int *ldx,
+                          char *fname, gridinfo_t *grid)
+{
+    NRformat_loc *Astore;
+    float   *xtrue_global, *nzval, sum;
+    int_t    *rowptr, *colind;
+    int_t    n, m_loc, fst_row, i, j, k;
+    int      iam, info;
+
+    iam = grid->iam;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Enter screate_matrix_binary()");
+#endif
+
+    double t = SuperLU_timer_();
+    if ( (info = psread_binary(fname, A, grid)) ) {
+	if ( !iam ) fprintf(stderr, "ERROR: INFO = %d returned from psread_binary()\n", info);
+	return info;
+    }
+    if ( !iam ) {
+	printf("Time to read and distribute matrix %.2f\n",
+	       SuperLU_timer_() - t);  fflush(stdout);
+    }
+
+    Astore = (NRformat_loc *) A->Store;
+    n = A->ncol;
+    m_loc = Astore->m_loc;
+    fst_row = Astore->fst_row;
+    rowptr = Astore->rowptr;
+    colind = Astore->colind;
+    nzval = (float *) Astore->nzval;
+
+    /* Generate the exact solution. */
+    if ( !(xtrue_global = floatMalloc_dist(n*nrhs)) )
+        ABORT("Malloc fails for xtrue[]");
+    if ( !iam ) sGenXtrue_dist(n, nrhs, xtrue_global, n);
+    MPI_Bcast( xtrue_global, n*nrhs, MPI_FLOAT, 0, grid->comm );
+
+    /* Compute the local rows of B = A*X. */
+    if ( !((*rhs) = floatMalloc_dist(m_loc*nrhs)) )
+        ABORT("Malloc fails for rhs[]");
+    for (j = 0; j < nrhs; ++j) {
+	for (i = 0; i < m_loc; ++i) {
+	    sum = 0.0;
+	    for (k = rowptr[i]; k < rowptr[i+1]; ++k)
+		sum += nzval[k] * xtrue_global[colind[k] + j*n];
+	    (*rhs)[j*m_loc+i] = sum;
+	}
+    }
+    *ldb = m_loc;
+
+    /* Get the local part of xtrue_global */
+    *ldx = m_loc;
+    if ( !((*x) = floatMalloc_dist(*ldx * nrhs)) )
+        ABORT("Malloc fails for x_loc[]");
+    for (j = 0; j < nrhs; ++j) {
+      for (i = 0; i < m_loc; ++i)
+	(*x)[i + j*(*ldx)] = xtrue_global[i + fst_row + j*n];
+    }
+
+    SUPERLU_FREE(xtrue_global);
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit screate_matrix_binary()");
+#endif
+    return 0;
+}
@@ -43,6 +43,7 @@ integer, parameter, public :: &
                       LargeDiag_MC64          = 1, &
                       LargeDiag_HWPM          = 2, &
                       MY_PERMR                = 3, &
+                      LargeDiag_AUCTION       = 4, &
                       NATURAL                 = 0, & ! colperm_t
                       MMD_ATA                 = 1, &
                       MMD_AT_PLUS_A           = 2, &
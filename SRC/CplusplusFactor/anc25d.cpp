@@ -4,7 +4,7 @@
 
 MPI_Comm *anc25d_t::initComm(gridinfo3d_t *grid3d)
 {
-    int maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int myGrid = grid3d->zscp.Iam;
     MPI_Comm *zCommOut = (MPI_Comm *)SUPERLU_MALLOC((maxLvl - 1) * sizeof(MPI_Comm));
     MPI_Comm zComm = grid3d->zscp.comm;
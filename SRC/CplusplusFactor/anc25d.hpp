@@ -20,7 +20,7 @@ struct anc25d_t
 
     anc25d_t(gridinfo3d_t *grid3d)
     {
-        maxLvl = log2i(grid3d->zscp.Np) + 1;
+        maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
         int myGrid = grid3d->zscp.Iam;
 
         comms25d = initComm(grid3d);
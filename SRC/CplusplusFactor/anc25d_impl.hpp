@@ -6,7 +6,7 @@
 // Sherry: moved from anc25d.cpp to here
 MPI_Comm *anc25d_t::initComm(gridinfo3d_t *grid3d)
 {
-    int maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int myGrid = grid3d->zscp.Iam;
     MPI_Comm *zCommOut = (MPI_Comm *)SUPERLU_MALLOC((maxLvl - 1) * sizeof(MPI_Comm));
     MPI_Comm zComm = grid3d->zscp.comm;
@@ -50,7 +50,6 @@ int_t xLUstruct_t<Ftype>::dAncestorFactorBaseline(
     int_t *eTreeTopLims = treeTopoInfo->eTreeTopLims;
 
     /*main loop over all the levels*/
-    int_t numLA = getNumLookAhead(options);
 
     for (int_t topoLvl = 0; topoLvl < maxTopoLevel; ++topoLvl)
     {
@@ -132,7 +131,7 @@ int_t xLUstruct_t<Ftype>::dAncestorFactorBaseline(
                 }
 
 /*=======   Schurcomplement Update      ======*/
-#warning single node only
+// single node only
                 // dSchurComplementUpdate(k, lPanelVec[g2lCol(k)], uPanelVec[g2lRow(k)]);
                 // dSchurComplementUpdate(k, lPanelVec[g2lCol(k)], k_upanel);
                 if (UidxSendCounts[k] > 0 && LidxSendCounts[k] > 0)
@@ -433,7 +433,7 @@ void batchAllocateGemmBuffers(
     int_t mxLeafNode = trf3Dpartition->mxLeafNode;
 
     // TODO: is this necessary if this is being done on a single node?
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     std::vector<int64_t> gemmCsizes(mxLeafNode, 0);
 	int_t mx_fsize = 0;
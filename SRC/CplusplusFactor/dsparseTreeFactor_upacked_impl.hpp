@@ -299,7 +299,7 @@ int_t xLUstruct_t<Ftype>::dsparseTreeFactorBaseline(
             
 
             /*=======   Schurcomplement Update      ======*/
-            #warning single node only 
+            // single node only
             // dSchurComplementUpdate(k, lPanelVec[g2lCol(k)], uPanelVec[g2lRow(k)]);
             // dSchurComplementUpdate(k, lPanelVec[g2lCol(k)], k_upanel);
             if(UidxSendCounts[k]>0 && LidxSendCounts[k]>0)
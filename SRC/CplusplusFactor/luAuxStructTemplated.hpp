@@ -5,6 +5,13 @@
 #include "superlu_ddefs.h"
 #include "superlu_zdefs.h"
 
+/* The complex operators below are also used by the CPU code. */
+#ifdef HAVE_CUDA
+#define SLU_HOST_DEVICE __host__ __device__
+#else
+#define SLU_HOST_DEVICE
+#endif
+
 template<typename Ftype>
 struct diagFactBufs_t {
     Ftype* BlockLFactor;
@@ -196,6 +203,7 @@ inline doublecomplex zeroT<doublecomplex>() {
     return z;
 }
 
+#ifdef HAVE_CUDA
 template <typename T>
 __device__
 inline T atomicAddT(T* address, T val);
@@ -221,28 +229,28 @@ inline doublecomplex atomicAddT<doublecomplex>(doublecomplex* address, doublecom
     atomicAdd (&address->i, val.i);
     return *address;
 }
-
+#endif
 
 // External Operator Overload for '-'
-__host__ __device__
+SLU_HOST_DEVICE
 inline doublecomplex operator-(const doublecomplex& a, const doublecomplex& b) {
     return {a.r - b.r, a.i - b.i};
 }
 
 // External Operator Overload for '=='
-__host__ __device__
+SLU_HOST_DEVICE
 inline bool operator==(const doublecomplex& a, const doublecomplex& b) {
     return (a.r == b.r) && (a.i == b.i);
 }
 
 // External Operator Overload for '/'
-__host__ __device__
+SLU_HOST_DEVICE
 inline doublecomplex operator/(const doublecomplex& a, const doublecomplex& b) {
     double denom = b.r * b.r + b.i * b.i;
     return {(a.r * b.r + a.i * b.i) / denom, (a.i * b.r - a.r * b.i) / denom};
 }
 
-__host__ __device__
+SLU_HOST_DEVICE
 inline doublecomplex operator-(const doublecomplex& a) {
     return {-a.r, -a.i};
 }
@@ -251,7 +259,7 @@ inline doublecomplex operator-(const doublecomplex& a) {
 // It must be a member function.
 
 // External Operator Overload for '*='
-__host__ __device__
+SLU_HOST_DEVICE
 inline doublecomplex& operator*=(doublecomplex& a, const doublecomplex& b) {
     double tr = a.r * b.r - a.i * b.i;
     double ti = a.r * b.i + a.i * b.r;
@@ -261,7 +269,7 @@ inline doublecomplex& operator*=(doublecomplex& a, const doublecomplex& b) {
 }
 
 // External Operator Overload for '-='
-__host__ __device__
+SLU_HOST_DEVICE
 inline doublecomplex& operator-=(doublecomplex& a, const doublecomplex& b) {
     a.r -= b.r;
     a.i -= b.i;
@@ -53,7 +53,7 @@ LUstruct_v100::LUstruct_v100(int_t nsupers_, int_t ldt_,
 			     options(options_), stat(stat_),
 			     thresh(thresh_), info(info_), anc25d(grid3d_in)
 {
-    maxLvl = log2i(grid3d->zscp.Np) + 1;
+    maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     isNodeInMyGrid = getIsNodeInMyGrid(nsupers, maxLvl, trf3Dpartition->myNodeCount, trf3Dpartition->treePerm);
     superlu_acc_offload = sp_ienv_dist(10, options); //get_acc_offload();
 
@@ -401,9 +401,11 @@ struct LUstruct_v100
 
     anc25d_t anc25d;
     
+#ifdef HAVE_CUDA
     // For GPU acceleration
     LUstructGPU_t *dA_gpu; // pointing to memory on GPU
     LUstructGPU_t A_gpu;   // pointing to memory accessible on CPU
+#endif
 
     /////////////////////////////////////////////////////////////////
     // Intermediate for flat batched 
@@ -476,6 +478,7 @@ struct LUstruct_v100
 	
 	for (i = 0; i < numDiagBufs; i++) SUPERLU_FREE(diagFactBufs[i]);
 
+#ifdef HAVE_CUDA
 	/* Sherry added the following, which comes from batch setup */
 	superlu_acc_offload = sp_ienv_dist(10, options); //get_acc_offload();    
     if (superlu_acc_offload){
@@ -493,6 +496,7 @@ struct LUstruct_v100
 
 
     }
+#endif
 
     SUPERLU_FREE(isNodeInMyGrid);
 
@@ -7,7 +7,7 @@
 int_t LUstruct_v100::ancestorReduction3dGPU(int_t ilvl, int_t *myNodeCount,
                                          int_t **treePerm)
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
 
 #if (DEBUGlevel >= 1)
@@ -27,6 +27,10 @@ int_t LUstruct_v100::ancestorReduction3dGPU(int_t ilvl, int_t *myNodeCount,
         receiver = myGrid - (1 << ilvl);
     }
 
+    /* a layer beyond the last one has nothing to reduce */
+    if (sender >= grid3d->zscp.Np)
+        return 0;
+
     /*Reduce all the ancestors*/
     for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
     {
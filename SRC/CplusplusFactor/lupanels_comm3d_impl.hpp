@@ -9,7 +9,7 @@ template <typename Ftype>
 int_t xLUstruct_t<Ftype>::ancestorReduction3d(int_t ilvl, int_t *myNodeCount,
                                          int_t **treePerm)
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
 
     int_t sender, receiver;
@@ -24,6 +24,10 @@ int_t xLUstruct_t<Ftype>::ancestorReduction3d(int_t ilvl, int_t *myNodeCount,
         receiver = myGrid - (1 << ilvl);
     }
 
+    /* a layer beyond the last one has nothing to reduce */
+    if (sender >= grid3d->zscp.Np)
+        return 0;
+
     /*Reduce all the ancestors*/
     for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
     {
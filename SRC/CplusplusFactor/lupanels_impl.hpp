@@ -87,13 +87,14 @@ xLUstruct_t<Ftype>::xLUstruct_t(int_t nsupers_, int_t ldt_,
                              SCT_t *SCT_, superlu_dist_options_t *options_,
                              SuperLUStat_t *stat_, 
                              threshPivValType<Ftype> thresh_, int *info_) :
-                             nsupers(nsupers_), trf3Dpartition(trf3Dpartition_),
+                             grid3d(grid3d_in),
                              ldt(ldt_), /* maximum supernode size */
-			     grid3d(grid3d_in), SCT(SCT_),
+                             nsupers(nsupers_),
+			     thresh(thresh_), info(info_), SCT(SCT_),
 			     options(options_), stat(stat_),
-			     thresh(thresh_), info(info_), anc25d(grid3d_in)
+			     trf3Dpartition(trf3Dpartition_), anc25d(grid3d_in)
 {
-    maxLvl = log2i(grid3d->zscp.Np) + 1;
+    maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     isNodeInMyGrid = getIsNodeInMyGrid(nsupers, maxLvl, trf3Dpartition->myNodeCount, trf3Dpartition->treePerm);
     superlu_acc_offload = sp_ienv_dist(10, options); // get_acc_offload();
 
@@ -219,6 +220,7 @@ xLUstruct_t<Ftype>::xLUstruct_t(int_t nsupers_, int_t ldt_,
     indirect = (int_t *)SUPERLU_MALLOC(nThreads * ldt * sizeof(int_t));
     indirectRow = (int_t *)SUPERLU_MALLOC(nThreads * ldt * sizeof(int_t));
     indirectCol = (int_t *)SUPERLU_MALLOC(nThreads * ldt * sizeof(int_t));
+    fusedMax = sp_ienv_dist(12, options);
 
     // allocating communication buffers
     LvalRecvBufs.resize(options->num_lookaheads);
@@ -238,11 +240,11 @@ xLUstruct_t<Ftype>::xLUstruct_t(int_t nsupers_, int_t ldt_,
         UidxRecvBufs[i] = (int_t *)SUPERLU_MALLOC(sizeof(int_t) * maxUidxCount);
 
         //TODO: check if setup correctly
-        #pragma warning disabling bcaststruct 
+        // bcastStruct is disabled
         #if 0
-        bcastStruct bcLval(grid3d->rscp.comm, MPI_DOUBLE, SYNC);
+        bcastStruct bcLval(grid3d->rscp.comm, get_mpi_type<Ftype>(), SYNC);
         bcastLval[i] = bcLval;
-        bcastStruct bcUval(grid3d->cscp.comm, MPI_DOUBLE, SYNC);
+        bcastStruct bcUval(grid3d->cscp.comm, get_mpi_type<Ftype>(), SYNC);
         bcastUval[i] = bcUval;
         bcastStruct bcLidx(grid3d->rscp.comm, mpi_int_t, SYNC);
         bcastLidx[i] = bcLidx;
@@ -259,9 +261,9 @@ xLUstruct_t<Ftype>::xLUstruct_t(int_t nsupers_, int_t ldt_,
     for (int i = 0; i < numDiagBufs; i++) /* Sherry?? these strcutures not used */
     {
         diagFactBufs[i] = (Ftype *)SUPERLU_MALLOC(sizeof(Ftype) * ldt * ldt);
-        // bcastStruct bcDiagRow(grid3d->rscp.comm, MPI_DOUBLE, SYNC);
+        // bcastStruct bcDiagRow(grid3d->rscp.comm, get_mpi_type<Ftype>(), SYNC);
         // bcastDiagRow[i] = bcDiagRow;
-        // bcastStruct bcDiagCol(grid3d->cscp.comm, MPI_DOUBLE, SYNC);
+        // bcastStruct bcDiagCol(grid3d->cscp.comm, get_mpi_type<Ftype>(), SYNC);
         // bcastDiagCol[i] = bcDiagCol;
     }
 
@@ -324,8 +326,11 @@ int_t xLUstruct_t<Ftype>::dSchurComplementUpdate(
     int_t nlb = lpanel.nblocks();
     int_t nub = upanel.nblocks();
 
+    // All the pairs (ii, jj) form one batch; with supersize(k) at most
+    // GEMM_SCATTER_MAXK, blockUpdate does each by a fused kernel
+    // specialized for the small k, without a GEMM call.
 #pragma omp parallel for
-    for (size_t ij = 0; ij < (nlb - st_lb) * nub; ij++)
+    for (int_t ij = 0; ij < (nlb - st_lb) * nub; ij++)
     {
         int_t ii = ij / nub + st_lb;
         int_t jj = ij % nub;
@@ -423,6 +428,68 @@ int_t xLUstruct_t<Ftype>::dScatter(int_t m, int_t n,
     return 0;
 }
 
+/* Dst(gi,gj) -= A * B, without a buffer for A * B, if the destination
+   rows and columns are contiguous, k is at most GEMM_SCATTER_MAXK or
+   m*n*k is at most fusedMax;
+   returns 0 if the update is left to GEMM and dScatter. */
+template <typename Ftype>
+int xLUstruct_t<Ftype>::gemmScatter(int_t m, int_t n, int_t k,
+                                    int_t gi, int_t gj,
+                                    Ftype *A, int_t lda, Ftype *B, int_t ldb,
+                                    int_t *srcRowList, int_t *srcColList)
+{
+    Ftype *Dst;
+    int_t lddst;
+    int_t dstRowLen, dstColLen;
+    int_t *dstRowList;
+    int_t *dstColList;
+    if (gj > gi) // its in upanel
+    {
+        int li = g2lRow(gi);
+        int lj = uPanelVec[li].find(gj);
+        Dst = uPanelVec[li].blkPtr(lj);
+        lddst = supersize(gi);
+        dstRowLen = supersize(gi);
+        dstRowList = NULL;
+        dstColLen = uPanelVec[li].nbcol(lj);
+        dstColList = uPanelVec[li].colList(lj);
+    }
+    else
+    {
+        int lj = g2lCol(gj);
+        int li = lPanelVec[lj].find(gi);
+        Dst = lPanelVec[lj].blkPtr(li);
+        lddst = lPanelVec[lj].LDA();
+        dstRowLen = lPanelVec[lj].nbrow(li);
+        dstRowList = lPanelVec[lj].rowList(li);
+        dstColLen = supersize(gj);
+        dstColList = NULL;
+    }
+
+    int_t *rowS2D = computeIndirectMap(ROW_MAP, m, srcRowList,
+                                       dstRowLen, dstRowList);
+    int_t *colS2D = computeIndirectMap(COL_MAP, n, srcColList,
+                                       dstColLen, dstColList);
+
+    bool denseRow = true, denseCol = true;
+    for (int_t i = 1; i < m && denseRow; i++)
+        denseRow = rowS2D[i] == rowS2D[0] + i;
+    for (int_t j = 1; j < n && denseCol; j++)
+        denseCol = colS2D[j] == colS2D[0] + j;
+    if (denseRow && denseCol)
+    {
+        superlu_gemm_scatter<Ftype>(m, n, k, A, lda, B, ldb,
+                                    Dst + rowS2D[0] + lddst * colS2D[0], lddst,
+                                    NULL, NULL);
+        return 1;
+    }
+    if (k > GEMM_SCATTER_MAXK && (double)m * n * k > fusedMax)
+        return 0;
+
+    superlu_gemm_scatter<Ftype>(m, n, k, A, lda, B, ldb, Dst, lddst, rowS2D, colS2D);
+    return 1;
+}
+
 template <typename Ftype>
 int_t xLUstruct_t<Ftype>::packedU2skyline(LUStruct_type<Ftype> *LUstruct)
 {
@@ -473,7 +540,7 @@ int_t xLUstruct_t<Ftype>::lookAheadUpdate(
     {
         /*Next lpanelUpdate*/
 #pragma omp for nowait
-        for (size_t ii = st_lb; ii < nlb; ii++)
+        for (int_t ii = st_lb; ii < nlb; ii++)
         {
             int_t jj = laJLoc;
             if (laJLoc != GLOBAL_BLOCK_NOT_FOUND)
@@ -482,7 +549,7 @@ int_t xLUstruct_t<Ftype>::lookAheadUpdate(
 
         /*Next upanelUpdate*/
 #pragma omp for nowait
-        for (size_t jj = 0; jj < nub; jj++)
+        for (int_t jj = 0; jj < nub; jj++)
         {
             int_t ii = laILoc;
             if (laILoc != GLOBAL_BLOCK_NOT_FOUND && jj != laJLoc)
@@ -505,6 +572,15 @@ int_t xLUstruct_t<Ftype>::blockUpdate(int_t k,
 #endif
 
     Ftype *V = bigV + thread_id * ldt * ldt;
+    int_t ib = lpanel.gid(ii);
+    int_t jb = upanel.gid(jj);
+
+    // a small product, or a dense destination, needs no buffer
+    if (gemmScatter(lpanel.nbrow(ii), upanel.nbcol(jj), supersize(k),
+                    ib, jb, lpanel.blkPtr(ii), lpanel.LDA(),
+                    upanel.blkPtr(jj), upanel.LDA(),
+                    lpanel.rowList(ii), upanel.colList(jj)))
+        return 0;
 
     Ftype alpha = one<Ftype>();
     Ftype beta = zeroT<Ftype>();
@@ -515,9 +591,6 @@ int_t xLUstruct_t<Ftype>::blockUpdate(int_t k,
                   V, lpanel.nbrow(ii));
 
     // now do the scatter
-    int_t ib = lpanel.gid(ii);
-    int_t jb = upanel.gid(jj);
-
     dScatter(lpanel.nbrow(ii), upanel.nbcol(jj),
              ib, jb, V, lpanel.nbrow(ii),
              lpanel.rowList(ii), upanel.colList(jj));
@@ -543,7 +616,7 @@ int_t xLUstruct_t<Ftype>::dSchurCompUpdateExcludeOne(
     int_t exJLoc = upanel.find(ex);
 
 #pragma omp parallel for
-    for (size_t ij = 0; ij < (nlb - st_lb) * nub; ij++)
+    for (int_t ij = 0; ij < (nlb - st_lb) * nub; ij++)
     {
         int_t ii = ij / nub + st_lb;
         int_t jj = ij % nub;
@@ -570,10 +643,10 @@ int_t xLUstruct_t<Ftype>::dDiagFactorPanelSolve(int_t k, int_t offset, diagFactB
     /*=======   Diagonal Broadcast          ======*/
     if (myrow == krow(k))
         MPI_Bcast((void *)dFBufs[offset]->BlockLFactor, ksupc * ksupc,
-                  MPI_DOUBLE, kcol(k), (grid->rscp).comm);
+                  get_mpi_type<Ftype>(), kcol(k), (grid->rscp).comm);
     if (mycol == kcol(k))
         MPI_Bcast((void *)dFBufs[offset]->BlockUFactor, ksupc * ksupc,
-                  MPI_DOUBLE, krow(k), (grid->cscp).comm);
+                  get_mpi_type<Ftype>(), krow(k), (grid->cscp).comm);
 
     /*=======   Panel Update                ======*/
     if (myrow == krow(k))
@@ -600,13 +673,13 @@ int_t xLUstruct_t<Ftype>::dPanelBcast(int_t k, int_t offset)
     if (UidxSendCounts[k] > 0)
     {
         MPI_Bcast(k_upanel.index, UidxSendCounts[k], mpi_int_t, krow(k), grid3d->cscp.comm);
-        MPI_Bcast(k_upanel.val, UvalSendCounts[k], MPI_DOUBLE, krow(k), grid3d->cscp.comm);
+        MPI_Bcast(k_upanel.val, UvalSendCounts[k], get_mpi_type<Ftype>(), krow(k), grid3d->cscp.comm);
     }
 
     if (LidxSendCounts[k] > 0)
     {
         MPI_Bcast(k_lpanel.index, LidxSendCounts[k], mpi_int_t, kcol(k), grid3d->rscp.comm);
-        MPI_Bcast(k_lpanel.val, LvalSendCounts[k], MPI_DOUBLE, kcol(k), grid3d->rscp.comm);
+        MPI_Bcast(k_lpanel.val, LvalSendCounts[k], get_mpi_type<Ftype>(), kcol(k), grid3d->rscp.comm);
     }
     return 0;
 }
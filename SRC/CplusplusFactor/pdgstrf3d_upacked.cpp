@@ -53,7 +53,7 @@ int_t pdgstrf3d_upacked(superlu_dist_options_t *options, int m, int n, double an
 
         // tag_ub initialization
         int tag_ub = set_tag_ub();
-        int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+        int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
 #if (PRNTlevel >= 1)
         if (!iam)
@@ -229,6 +229,9 @@ int_t LUstruct_v100::pdgstrf3d()
         int useAnc25D = 0;
         if (getenv("ANC25D"))
             useAnc25D = atoi(getenv("ANC25D"));
+        /* the 2.5D ancestor communicators assume a power-of-two number of layers */
+        if (grid3d->zscp.Np & (grid3d->zscp.Np - 1))
+            useAnc25D = 0;
         if (useAnc25D)
             printf("-- Using ANC25D; ONLY CPU supported \n");
 
@@ -0,0 +1,35 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+/*! @file
+ * \brief 3D LU factorization on CPU with the templated LU panels,
+ * in double precision
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * The code is that of pdgstrf3d_upacked<Ftype>(), shared with the other
+ * precisions; the L and U factors are left in LUstruct as with pdgstrf3d().
+ * </pre>
+ */
+
+#include "pdgstrf3d_upacked_impl.hpp"
+
+extern "C"
+int_t pdgstrf3d_v100(superlu_dist_options_t *options, int m, int n, double anorm,
+                     dtrf3Dpartition_t *trf3Dpartition, SCT_t *SCT,
+                     dLUstruct_t *LUstruct, gridinfo3d_t *grid3d,
+                     SuperLUStat_t *stat, int *info)
+{
+    return pdgstrf3d_upacked<double>(options, m, n, anorm, trf3Dpartition, SCT,
+                                     LUstruct, grid3d, stat, info);
+}
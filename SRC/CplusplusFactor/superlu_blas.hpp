@@ -43,6 +43,27 @@ void superlu_gemm<float>(const char *transa, const char *transb, int m, int n, i
     superlu_sgemm(transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
+// C(rowmap, colmap) -= A * B without a buffer for A * B, see superlu_dgemm_scatter()
+template<typename T>
+void superlu_gemm_scatter(int m, int n, int k, T *A, int lda, T *B, int ldb,
+                          T *C, int ldc, int_t *rowmap, int_t *colmap);
+
+// Specialization for double
+template<>
+void superlu_gemm_scatter<double>(int m, int n, int k, double *A, int lda,
+                                  double *B, int ldb, double *C, int ldc,
+                                  int_t *rowmap, int_t *colmap) {
+    superlu_dgemm_scatter(m, n, k, A, lda, B, ldb, C, ldc, rowmap, colmap);
+}
+
+// Specialization for float
+template<>
+void superlu_gemm_scatter<float>(int m, int n, int k, float *A, int lda,
+                                 float *B, int ldb, float *C, int ldc,
+                                 int_t *rowmap, int_t *colmap) {
+    superlu_sgemm_scatter(m, n, k, A, lda, B, ldb, C, ldc, rowmap, colmap);
+}
+
 // create variant for superlu_dscal, superlu_sscal, superlu_cscal, superlu_zscal
 template<typename T>
 void superlu_scal(int n, T alpha, T *x, int incx);
@@ -123,6 +144,13 @@ void superlu_gemm<doublecomplex>(const char *transa, const char *transb, int m,
     superlu_zgemm(transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
+template<>
+void superlu_gemm_scatter<doublecomplex>(int m, int n, int k, doublecomplex *A, int lda,
+                                         doublecomplex *B, int ldb, doublecomplex *C, int ldc,
+                                         int_t *rowmap, int_t *colmap) {
+    superlu_zgemm_scatter(m, n, k, A, lda, B, ldb, C, ldc, rowmap, colmap);
+}
+
 
 template<>
 void superlu_trsm<doublecomplex>(const char *side, const char *uplo, const char *transa, const char *diag,
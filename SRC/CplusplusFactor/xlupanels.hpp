@@ -344,6 +344,7 @@ struct xLUstruct_t
     int nThreads;
     int_t *indirect, *indirectRow, *indirectCol;
     Ftype *bigV; // size = THREAD_Size*ldt*ldt
+    int fusedMax;     // sp_ienv_dist(12): largest m*n*k of a fused update
     int *isNodeInMyGrid;
     threshPivValType<Ftype> thresh;
     int *info; 
@@ -389,7 +390,7 @@ struct xLUstruct_t
     std::vector<int_t> UidxSendCounts;
 
     //
-    #pragma warning disabling bcastStruct
+    // bcastStruct is disabled
     #if 0
     std::vector<bcastStruct> bcastDiagRow;
     std::vector<bcastStruct> bcastDiagCol;
@@ -407,9 +408,11 @@ struct xLUstruct_t
     int_t g2lCol(int_t k) { return k / Pc; }
 
     anc25d_t anc25d;
+#ifdef HAVE_CUDA
     // For GPU acceleration
     xLUstructGPU_t<Ftype> *dA_gpu; // pointing to memory on GPU
     xLUstructGPU_t<Ftype> A_gpu;   // pointing to memory accessible on CPU
+#endif
 
     /////////////////////////////////////////////////////////////////
     // Intermediate for flat batched
@@ -486,6 +489,7 @@ struct xLUstruct_t
         for (i = 0; i < numDiagBufs; i++)
             SUPERLU_FREE(diagFactBufs[i]);
 
+#ifdef HAVE_CUDA
         /* Sherry added the following, which comes from batch setup */
         superlu_acc_offload = sp_ienv_dist(10, options); //get_acc_offload();
         if (superlu_acc_offload)
@@ -502,6 +506,7 @@ struct xLUstruct_t
                 cublasDestroy(A_gpu.lookAheadUHandle[stream]);
             }
         }
+#endif
 
         SUPERLU_FREE(isNodeInMyGrid);
 
@@ -519,6 +524,10 @@ struct xLUstruct_t
                    int_t gi, int_t gj,
                    Ftype *V, int_t ldv,
                    int_t *srcRowList, int_t *srcColList);
+    int gemmScatter(int_t m, int_t n, int_t k,
+                    int_t gi, int_t gj,
+                    Ftype *A, int_t lda, Ftype *B, int_t ldb,
+                    int_t *srcRowList, int_t *srcColList);
 
     int_t lookAheadUpdate(
         int_t k, int_t laIdx, xlpanel_t<Ftype> &lpanel, xupanel_t<Ftype> &upanel);
@@ -541,6 +550,7 @@ struct xLUstruct_t
         int tag_ub);
 
     diagFactBufs_type<Ftype>** initDiagFactBufsArr(int_t mxLeafNode, int_t ldt);
+    int freeDiagFactBufsArr(int_t num_bufs, diagFactBufs_type<Ftype>** dFBufs);
 
     // Helper routine to marshall batch LU data into the device data in A_gpu
     void marshallBatchedLUData(int k_st, int k_end, int_t *perm_c_supno);
@@ -652,8 +662,6 @@ struct xLUstruct_t
     xlpanelGPU_t<Ftype> *copyLpanelsToGPU();
     xupanelGPU_t<Ftype> *copyUpanelsToGPU();
 
-    int freeDiagFactBufsArr(int_t num_bufs, diagFactBufs_type<Ftype>** dFBufs);
-
     // to perform diagFactOn GPU
     int_t dDFactPSolveGPU(int_t k, int_t offset, diagFactBufs_type<Ftype>** dFBufs);
     int_t dDFactPSolveGPU(int_t k, int_t handle_offset, int buffer_offset, diagFactBufs_type<Ftype>** dFBufs);
@@ -968,6 +968,9 @@ int_t zreduceAncestors3d(int_t sender, int_t receiver,
     doublecomplex alpha = {1.0, 0.0}, beta = {1.0, 0.0};
     int_t myGrid = grid3d->zscp.Iam;
 
+    /* a layer beyond the last one has nothing to exchange */
+    if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
+
     /*first setting the L blocks to zero*/
     for (int_t node = 0; node < nnodes; ++node)   /* for each block column ... */
 	{
@@ -1000,6 +1003,9 @@ int_t zgatherFactoredLU(int_t sender, int_t receiver,
     doublecomplex * Lval_buf  = LUvsb->Lval_buf;
     doublecomplex * Uval_buf  = LUvsb->Uval_buf;
     int_t myGrid = grid3d->zscp.Iam;
+
+    /* a layer beyond the last one has nothing to exchange */
+    if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
     for (int_t node = 0; node < nnodes; ++node)   /* for each block column ... */
 	{
 	    int_t jb = nodeList[node];
@@ -1026,7 +1032,7 @@ int_t zinit3DLUstruct( int_t* myTreeIdxs, int_t* myZeroTrIdxs,
                       int_t* nodeCount, int_t** nodeList, zLUstruct_t* LUstruct,
 		      gridinfo3d_t* grid3d)
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     for (int_t lvl = 0; lvl < maxLvl; lvl++)
 	{
@@ -1048,7 +1054,7 @@ int zreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
 {
     doublecomplex * Lval_buf  = LUvsb->Lval_buf;
     doublecomplex * Uval_buf  = LUvsb->Uval_buf;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
 
     int_t sender, receiver;
@@ -1082,7 +1088,7 @@ int zreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
 int_t zgatherAllFactoredLU( ztrf3Dpartition_t*  trf3Dpartition,
 			   zLUstruct_t* LUstruct, gridinfo3d_t* grid3d, SCT_t* SCT )
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
@@ -1145,7 +1151,7 @@ int_t zbroadcastAncestor3d( ztrf3Dpartition_t*  trf3Dpartition,
 			   zLUstruct_t* LUstruct, gridinfo3d_t* grid3d, SCT_t* SCT )
 {
 
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
@@ -1196,7 +1202,7 @@ int_t zbroadcastAncestor3d( ztrf3Dpartition_t*  trf3Dpartition,
 int_t zgatherAllFactoredLU3d( ztrf3Dpartition_t*  trf3Dpartition,
 			   zLUstruct_t* LUstruct, gridinfo3d_t* grid3d, SCT_t* SCT )
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
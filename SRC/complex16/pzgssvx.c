@@ -329,6 +329,10 @@ at the top-level directory.
  *                        off-diagonal.
  *           = MY_PERMR:  use the ordering given in ScalePermstruct->perm_r
  *                        input by the user.
+ *           = LargeDiag_AUCTION: use a distributed auction algorithm to
+ *                        find an approximate maximum-product matching and
+ *                        the scalings of LargeDiag_MC64, without gathering
+ *                        A on one process.
  *
  *         o ColPerm (colperm_t)
  *           Specifies what type of column permutation to use to reduce fill.
@@ -348,6 +352,25 @@ at the top-level directory.
  *           = SLU_DOUBLE: accumulate residual in double precision.
  *           = SLU_EXTRA:  accumulate residual in extra precision.
  *
+ *         o NodeSymbFact (yes_no_t)
+ *           = YES: with ParSymbFact = NO, gather A and do the serial
+ *                  analysis on one process per node only; the others
+ *                  read its result from shared memory.
+ *
+ *         o AutoTune (yes_no_t)
+ *           = YES: with ParSymbFact = NO, set num_lookaheads from a cost
+ *                  model of the factorization after the symbolic
+ *                  factorization, and superlu_relax and superlu_maxsup
+ *                  for the next one. What it learns is kept in
+ *                  LUstruct->tune while A keeps its order and number of
+ *                  nonzeros. See superlu_tune.c.
+ *
+ *         o AmalgFill (double)
+ *           > 0: with ParSymbFact = NO, merge interior supernodes into
+ *                their parent after the symbolic factorization, if the
+ *                explicit zeros added are at most AmalgFill times the
+ *                entries merged.
+ *
  *         NOTE: all options must be identical on all processes when
  *               calling this routine.
  *
@@ -529,12 +552,12 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	      structures are not used.                                  */
     fact_t  Fact;
     doublecomplex *a;
-    int_t   *colptr, *rowind;
+    int_t   *colptr = NULL, *rowind = NULL;
     int_t   *perm_r; /* row permutations from partial pivoting */
     int_t   *perm_c; /* column permutation vector */
     int_t   *etree;  /* elimination tree */
     int_t   *rowptr, *colind;  /* Local A in NR*/
-    int_t   nnz_loc, nnz;
+    int_t   nnz_loc, nnz = 0;
     int     m_loc, fst_row, icol, iinfo;
     int     colequ, Equil, factored, job, notran, rowequ, need_value;
     int_t   i, j, irow, m, n;
@@ -570,6 +593,14 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
     Pslu_freeable_t Pslu_freeable;
     float  flinfo;
 
+    /* Cache of the symbolic analysis, see superlu_symbcache.c */
+    superlu_symbkey_t symb_key;
+    int   symb_hit = 0;
+
+    /* Serial analysis once per node, see symbfact_node.c */
+    superlu_node_t node;
+    int   node_symb = 0, have_GA = 0;
+
     /* Initialization. */
     m       = A->nrow;
     n       = A->ncol;
@@ -591,7 +622,7 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
     Fact = options->Fact;
     if ( Fact < DOFACT || Fact > FACTORED )
 	*info = -1;
-    else if ( options->RowPerm < NOROWPERM || options->RowPerm > MY_PERMR )
+    else if ( options->RowPerm < NOROWPERM || options->RowPerm > LargeDiag_AUCTION )
 	*info = -1;
     else if ( options->ColPerm < NATURAL || options->ColPerm > MY_PERMC )
 	*info = -1;
@@ -644,6 +675,8 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
     CHECK_MALLOC(iam, "Enter pzgssvx()");
 #endif
 
+    if ( options->Trace == YES ) superlu_trace_start(grid);
+
     /* Not factored & ask for equilibration */
     if ( Equil && Fact != SamePattern_SameRowPerm ) {
 	/* Allocate storage if not done so before. */
@@ -766,13 +799,21 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
          * for large diagonal is sought after.
          */
 	if ( Fact != SamePattern_SameRowPerm &&
-             (parSymbFact == NO || options->RowPerm != NO) ) {
+             (parSymbFact == NO || (options->RowPerm != NO &&
+                                    options->RowPerm != LargeDiag_AUCTION)) ) {
              /* Performs serial symbolic factorzation and/or MC64 */
 
             need_value = (options->RowPerm == LargeDiag_MC64);
 
-            pzCompRow_loc_to_CompCol_global(need_value, A, grid, &GA);
+	    /* With NodeSymbFact, only the node leaders get GA. */
+	    node_symb = ( options->NodeSymbFact == YES && parSymbFact == NO );
+	    if ( node_symb ) superlu_node_init(&node, grid);
+            pzCompRow_loc_to_CompCol_node(need_value, A, grid,
+                                         node_symb ? &node : NULL, &GA);
+	    have_GA = ( GA.Store != NULL );
+	}
 
+	if ( have_GA ) {
             GAstore = (NCformat *) GA.Store;
             colptr = GAstore->colptr;
             rowind = GAstore->rowind;
@@ -794,12 +835,14 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	    if ( Fact != SamePattern_SameRowPerm ) {
 	        if ( options->RowPerm == MY_PERMR ) { /* Use user's perm_r. */
 	            /* Permute the global matrix GA for symbfact() */
+	            if ( have_GA )
 	            for (i = 0; i < colptr[n]; ++i) {
 	            	irow = rowind[i];
 		    	rowind[i] = perm_r[irow];
 	            }
-	        } else if ( options->RowPerm == LargeDiag_MC64 ) {
-	            /* Get a new perm_r[] from MC64 */
+	        } else if ( options->RowPerm == LargeDiag_MC64 ||
+	                    options->RowPerm == LargeDiag_AUCTION ) {
+	            /* Get a new perm_r[] from MC64 or the distributed auction */
 	            if ( job == 5 ) {
 		        /* Allocate storage for scaling factors. */
 		        if ( !(R1 = doubleMalloc_dist(m)) )
@@ -808,7 +851,11 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 		            ABORT("SUPERLU_MALLOC fails for C1[]");
 	            }
 
-	            if ( !iam ) { /* Process 0 finds a row permutation */
+	            if ( options->RowPerm == LargeDiag_AUCTION ) {
+		        /* All processes take part; perm_r, R1 and C1 are
+			   replicated on return. */
+		        iinfo = pzldperm_dist(A, grid, perm_r, R1, C1);
+	            } else if ( !iam ) { /* Process 0 finds a row permutation */
 		        iinfo = zldperm_dist(job, m, nnz, colptr, rowind, a_GA,
 		                perm_r, R1, C1);
 
@@ -882,7 +929,11 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 
 		        } /* end Equil */
 
-                        /* Now permute global GA to prepare for symbfact() */
+                        /* Now permute global GA to prepare for symbfact().
+			   The auction does not need GA, so it is only
+			   there for serial symbfact(), and only on the
+			   node leaders with NodeSymbFact. */
+                        if ( have_GA )
                         for (j = 0; j < n; ++j) {
 		            for (i = colptr[j]; i < colptr[j+1]; ++i) {
 	                        irow = rowind[i];
@@ -892,6 +943,7 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 		        SUPERLU_FREE (R1);
 		        SUPERLU_FREE (C1);
 	              } else { /* job = 2,3,4 */
+		        if ( have_GA )
 		        for (j = 0; j < n; ++j) {
 		            for (i = colptr[j]; i < colptr[j+1]; ++i) {
 			        irow = rowind[i];
@@ -968,6 +1020,14 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	 */
 	permc_spec = options->ColPerm;
 
+	/* The relax and maxsuper advised after the previous analysis are
+	   used from this one on, unless A is a different matrix. */
+	if ( options->AutoTune == YES && parSymbFact == NO ) {
+	    superlu_tune_check(&LUstruct->tune, n, nnz_loc, grid);
+	    if ( Fact != SamePattern_SameRowPerm )
+		superlu_tune_prepare(&LUstruct->tune, options);
+	}
+
 	if ( parSymbFact == YES || permc_spec == PARMETIS ) {
 	    nprocs_num = grid->nprow * grid->npcol;
   	    noDomains = (int) ( pow(2, ((int) LOG2( nprocs_num ))));
@@ -999,7 +1059,17 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	    }
         } /* end preparing for parallel symbolic */
 
-	if ( permc_spec != MY_PERMC && Fact == DOFACT ) {
+	/* Reuse the ordering and symbolic factorization of an earlier
+	   matrix with the same pattern of Pr*A, if they are cached.
+	   The cache is not used with NodeSymbFact. */
+	if ( options->SymbCache == YES && Fact == DOFACT && parSymbFact == NO
+	     && !node_symb ) {
+	    superlu_symbcache_key(options, A, perm_r, perm_c, grid, &symb_key);
+	    symb_hit = superlu_symbcache_get(&symb_key, perm_c, etree,
+					     Glu_persist, &Glu_freeable, grid);
+	}
+
+	if ( permc_spec != MY_PERMC && Fact == DOFACT && !symb_hit ) {
           /* Reuse perm_c if Fact == SamePattern, or SamePattern_SameRowPerm */
 	  if ( permc_spec == PARMETIS ) {
 	// #pragma omp parallel
@@ -1021,7 +1091,7 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 		  *info = flinfo;
 		  return;
      	      }
-	  } else {
+	  } else if ( have_GA ) { /* perm_c is broadcast to the others below */
 	      get_perm_c_dist(iam, permc_spec, &GA, perm_c);
           }
         }
@@ -1030,52 +1100,76 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 
 	/* Symbolic factorization. */
 	if ( Fact != SamePattern_SameRowPerm ) {
-	    if ( parSymbFact == NO ) { /* Perform serial symbolic factorization */
+	    if ( symb_hit ) { /* perm_c, etree, Glu_persist and Glu_freeable
+				 are from the cache */
+		nnzLU = Glu_freeable->nnzLU;
+		stat->utime[SYMBFAC] = 0.0;
+	    } else if ( parSymbFact == NO ) { /* Perform serial symbolic factorization */
 		/* GA = Pr*A, perm_r[] is already applied. */
 	        int_t *GACcolbeg, *GACcolend, *GACrowind;
+		int_t linfo = 0;
 
-	        /* Compute the elimination tree of Pc*(A^T+A)*Pc^T or Pc*A^T*A*Pc^T
-	           (a.k.a. column etree), depending on the choice of ColPerm.
-	           Adjust perm_c[] to be consistent with a postorder of etree.
-	           Permute columns of A to form A*Pc'.
-		   After this routine, GAC = GA*Pc^T.  */
-	        sp_colorder(options, &GA, perm_c, etree, &GAC);
-
-	        /* Form Pc*A*Pc^T to preserve the diagonal of the matrix GAC. */
-	        GACstore = (NCPformat *) GAC.Store;
-	        GACcolbeg = GACstore->colbeg;
-	        GACcolend = GACstore->colend;
-	        GACrowind = GACstore->rowind;
-	        for (j = 0; j < n; ++j) {
-	            for (i = GACcolbeg[j]; i < GACcolend[j]; ++i) {
-		        irow = GACrowind[i];
-		        GACrowind[i] = perm_c[irow];
-	            }
-	        }
-
-	        /* Perform a symbolic factorization on Pc*Pr*A*Pc^T and set up
-                   the nonzero data structures for L & U. */
-#if ( PRNTlevel>=1 )
-                if ( !iam ) {
-		    printf(".. symbfact(): relax %d, maxsuper %d, fill %d\n",
-		          sp_ienv_dist(2,options), sp_ienv_dist(3,options), sp_ienv_dist(6,options));
-		    fflush(stdout);
-	        }
-#endif
-  	        t = SuperLU_timer_();
 	        if ( !(Glu_freeable = (Glu_freeable_t *)
 		      SUPERLU_MALLOC(sizeof(Glu_freeable_t))) )
 		    ABORT("Malloc fails for Glu_freeable.");
 
-	    	/* Every process does this.
-		   returned value (-iinfo) is the size of lsub[], incuding pruned graph.*/
-		int_t linfo;
-	    	linfo = symbfact(options, iam, &GAC, perm_c, etree,
-			     	 Glu_persist, Glu_freeable);
+		t = SuperLU_timer_();
+	        if ( have_GA ) {
+		    /* Compute the elimination tree of Pc*(A^T+A)*Pc^T or Pc*A^T*A*Pc^T
+		       (a.k.a. column etree), depending on the choice of ColPerm.
+		       Adjust perm_c[] to be consistent with a postorder of etree.
+		       Permute columns of A to form A*Pc'.
+		       After this routine, GAC = GA*Pc^T.  */
+		    sp_colorder(options, &GA, perm_c, etree, &GAC);
+
+		    /* Form Pc*A*Pc^T to preserve the diagonal of the matrix GAC. */
+		    GACstore = (NCPformat *) GAC.Store;
+		    GACcolbeg = GACstore->colbeg;
+		    GACcolend = GACstore->colend;
+		    GACrowind = GACstore->rowind;
+		    for (j = 0; j < n; ++j) {
+			for (i = GACcolbeg[j]; i < GACcolend[j]; ++i) {
+			    irow = GACrowind[i];
+			    GACrowind[i] = perm_c[irow];
+			}
+		    }
+
+		    /* Perform a symbolic factorization on Pc*Pr*A*Pc^T and set up
+		       the nonzero data structures for L & U. */
+#if ( PRNTlevel>=1 )
+		    if ( !iam ) {
+			printf(".. symbfact(): relax %d, maxsuper %d, fill %d\n",
+			      sp_ienv_dist(2,options), sp_ienv_dist(3,options), sp_ienv_dist(6,options));
+			fflush(stdout);
+		    }
+#endif
+
+		    /* Every process holding GA does this.
+		       returned value (-iinfo) is the size of lsub[], incuding pruned graph.*/
+		    linfo = symbfact(options, iam, &GAC, perm_c, etree,
+				     Glu_persist, Glu_freeable);
+	        }
+		if ( node_symb ) /* leader's result to the rest of the node */
+		    linfo = superlu_node_share_symbfact(&node, linfo, n, perm_c,
+						etree, Glu_persist, Glu_freeable);
 		nnzLU = Glu_freeable->nnzLU;
 	    	stat->utime[SYMBFAC] = SuperLU_timer_() - t;
 	    	if ( linfo <= 0 ) { /* Successful return */
 		    QuerySpace_dist(n, -linfo, Glu_freeable, &symb_mem_usage);
+		    if ( options->SymbCache == YES && Fact == DOFACT && !node_symb )
+			superlu_symbcache_put(&symb_key, perm_c, etree,
+					      Glu_persist, Glu_freeable, grid);
+		    if ( options->AutoTune == YES ) {
+			/* num_lookaheads for this factorization, relax and
+			   maxsup for the next analysis */
+			superlu_tune_t advice;
+			superlu_tune_advise(&LUstruct->tune, options, n, etree,
+					    Glu_persist, Glu_freeable, grid,
+					    &advice);
+			superlu_tune_apply(&LUstruct->tune, &advice, options);
+			if ( !iam && options->PrintStat == YES )
+			    superlu_tune_print(&advice);
+		    }
 #if ( PRNTlevel>=1 )
 		    if ( !iam ) {
 		    	printf("\tNo of supers " IFMT "\n", Glu_persist->supno[n-1]+1);
@@ -1094,6 +1188,7 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	    	} else { /* symbfact out of memory */
 		    if ( !iam )
 		        fprintf(stderr,"symbfact() error returns " IFMT "\n", linfo);
+		    if ( node_symb ) superlu_node_free(&node);
 		    *info = linfo;
 		    return;
 	        }
@@ -1115,9 +1210,8 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	    }
 
             /* Destroy global GA */
-            if ( parSymbFact == NO || options->RowPerm != NO )
-                Destroy_CompCol_Matrix_dist(&GA);
-            if ( parSymbFact == NO )
+            if ( have_GA ) Destroy_CompCol_Matrix_dist(&GA);
+            if ( parSymbFact == NO && !symb_hit && have_GA )
  	        Destroy_CompCol_Permuted_dist(&GAC);
 
 	} /* end if Fact != SamePattern_SameRowPerm ... */
@@ -1140,10 +1234,15 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	    dist_mem_use = pzdistribute(options, n, A, ScalePermstruct,
                                       Glu_freeable, LUstruct, grid);
 	    stat->utime[DIST] = SuperLU_timer_() - t;
+	    SUPERLU_TRACE(TR_DIST, t, -1);
 
   	    /* Deallocate storage used in symbolic factorization. */
 	    if ( Fact != SamePattern_SameRowPerm ) {
-	        iinfo = symbfact_SubFree(Glu_freeable);
+	        if ( node_symb ) {
+		    superlu_node_free_symbfact(&node, Glu_freeable);
+		    superlu_node_free(&node);
+		} else
+		    iinfo = symbfact_SubFree(Glu_freeable);
 	        SUPERLU_FREE(Glu_freeable);
 	    }
 	} else { /* CASE OF PARALLEL SYMBOLIC */
@@ -1162,12 +1261,14 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	        ABORT ("Not enough memory available for dist_psymbtonum\n");
 
 	    stat->utime[DIST] = SuperLU_timer_() - t;
+	    SUPERLU_TRACE(TR_DIST, t, -1);
 	}
 
 	/*if (!iam) printf ("\tDISTRIBUTE time  %8.2f\n", stat->utime[DIST]);*/
 
-	/* Flatten L metadata into one buffer. */
-	if ( Fact != SamePattern_SameRowPerm ) {
+	/* Flatten L metadata into one buffer; pzdistribute() sets up L
+	   in this form already. */
+	if ( Fact != SamePattern_SameRowPerm && parSymbFact == YES ) {
 		pzflatten_LDATA(options, n, LUstruct, grid, stat);
 	}
 
@@ -1179,6 +1280,10 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	// {
 	pzgstrf(options, m, n, anorm, LUstruct, grid, stat, info);
 	stat->utime[FACT] = SuperLU_timer_() - t;
+	SUPERLU_TRACE(TR_FACT, t, -1);
+	if ( options->AutoTune == YES && parSymbFact == NO )
+	    superlu_tune_update(&LUstruct->tune, stat->utime[FACT],
+				stat->utime[COMM], grid);
 	// }
 	// }
 
@@ -1276,14 +1381,13 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 #endif
 
 	if ( options->PrintStat ) {
-	    int_t TinyPivots;
+	    int TinyPivots;
 	    float for_lu, total, avg, loc_max;
 	    float mem_stage[3];
 	    struct { float val; int rank; } local_struct, global_struct;
 
-	    MPI_Reduce( &stat->TinyPivots, &TinyPivots, 1, mpi_int_t,
+	    MPI_Reduce( &stat->TinyPivots, &TinyPivots, 1, MPI_INT,
 	    		MPI_SUM, 0, grid->comm );
-	    stat->TinyPivots = TinyPivots;
 
             if ( iam==0 ) {
 		printf("\n** Memory Usage **********************************\n");
@@ -1387,7 +1491,7 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 		       lu_max_rank, lu_max_mem,
 		       buffer_peak_rank, buffer_peak);
 		printf("**************************************************\n\n");
-		printf("** number of Tiny Pivots: %8d\n\n", stat->TinyPivots);
+		printf("** number of Tiny Pivots: %8d\n\n", TinyPivots);
 		fflush(stdout);
             }
 	} /* end printing stats */
@@ -1626,6 +1730,7 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	        SOLVEstruct1->diag_len = SOLVEstruct->diag_len;
 	        SOLVEstruct1->gsmv_comm = SOLVEstruct->gsmv_comm;
 	        SOLVEstruct1->A_colind_gsmv = SOLVEstruct->A_colind_gsmv;
+	        SOLVEstruct1->gstrs_work = SOLVEstruct->gstrs_work;
 
 		/* Initialize the *gstrs_comm for 1 RHS. */
 		if ( !(SOLVEstruct1->gstrs_comm = (pxgstrs_comm_t *)
@@ -1722,6 +1827,8 @@ pzgssvx(superlu_dist_options_t *options, SuperMatrix *A,
     if ( !factored && Fact != SamePattern_SameRowPerm && !parSymbFact)
  	Destroy_CompCol_Permuted_dist(&GAC);
 #endif
+    if ( options->Trace == YES ) superlu_trace_dump(grid);
+
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(iam, "Exit pzgssvx()");
 #endif
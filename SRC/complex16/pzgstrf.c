@@ -254,7 +254,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
     int_t *lsub, *lsub1, *usub, *Usub_buf;
     int_t **Lsub_buf_2, **Usub_buf_2;
     doublecomplex **Lval_buf_2, **Uval_buf_2;          /* pointers to starts of bufs */
-    doublecomplex *lusup, *lusup1, *uval, *Uval_buf;   /* pointer to current buf     */
+    doublecomplex *lusup, *lusup1, *uval = NULL, *Uval_buf;   /* pointer to current buf     */
     int_t fnz, i, ib, ijb, ilst, it, iukp, jj, klst,
           ldv, lptr, lptr0, lptrj, luptr, luptr0, luptrj,
           nlb, nub, rel, rukp, il, iu;
@@ -273,6 +273,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
     doublecomplex *nzval;
     doublecomplex *ucol;
     int *indirect, *indirect2;
+    int_t *gsmap, *gsmap2;   /* row and column maps of zgemm_scatter_l/u */
     int_t *tempi;
     doublecomplex *tempu, *tempv, *tempr;
     /*    doublecomplex *tempv2d, *tempU2d;  Sherry */
@@ -333,6 +334,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
     double pdgstrf2_timer       = 0.0;
     double pdgstrs2_timer       = 0.0;
     double lookaheadupdatetimer = 0.0;
+    double tsch;
     double InitTimer            = 0.0; /* including compute schedule, malloc */
     double tt_start, tt_end;
 
@@ -934,8 +936,47 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
         ABORT ("Malloc fails for indirect[].");
     if (!(indirect2 = SUPERLU_MALLOC (iinfo * num_threads * sizeof(int))))
         ABORT ("Malloc fails for indirect[].");
+    /* The fused update maps into a whole block of L or U: int_t. */
+    if (!(gsmap = intMalloc_dist((ldt + CACHELINE/sizeof(int_t)) * num_threads)))
+        ABORT ("Malloc fails for gsmap[].");
+    if (!(gsmap2 = intMalloc_dist((ldt + CACHELINE/sizeof(int_t)) * num_threads)))
+        ABORT ("Malloc fails for gsmap2[].");
+
+    log_memory(2 * ldt*ldt * dword + 2 * iinfo * num_threads * iword
+               + 2 * (ldt + CACHELINE/sizeof(int_t)) * num_threads * iword, stat);
+
+    /* With options->SchurTasks, the update of step k is done by tasks:
+       bigU_la holds the U blocks of the look-ahead window, bigV_task one
+       ldt x ldt GEMM tile per thread, and colsync[] gives each local block
+       column an address for the task dependences. The tasks that call MPI
+       are ordered through mpi_token; they run on the master thread if
+       MPI cannot be called from other threads. */
+    int sched_tasks = 0, mpi_tasks = 0, mpi_level;
+    doublecomplex *bigU_la = NULL, *bigV_task = NULL;
+    char *colsync;
+    char mpi_token = 0;  /* only named in the depend clauses */
+    (void) mpi_token;
+#ifdef _OPENMP
+    sched_tasks = ( options->SchurTasks == YES );
+#ifdef GPU_ACC
+    if ( superlu_acc_offload ) sched_tasks = 0;
+#endif
+#endif
+    if ( sched_tasks ) {
+        MPI_Query_thread(&mpi_level);
+        mpi_tasks = ( mpi_level >= MPI_THREAD_SERIALIZED );
+        if ( !(bigU_la = doublecomplexMalloc_dist(bigu_size)) )
+            ABORT ("Malloc fails for look-ahead U buffer");
+        if ( !(bigV_task = doublecomplexMalloc_dist(ldt * ldt * num_threads)) )
+            ABORT ("Malloc fails for task V buffer");
+        log_memory((bigu_size + ldt * ldt * num_threads) * dword, stat);
+    }
+    if ( !(colsync = SUPERLU_MALLOC(CEILING(nsupers, Pc) * sizeof(char))) )
+        ABORT ("Malloc fails for colsync[].");
 
-    log_memory(2 * ldt*ldt * dword + 2 * iinfo * num_threads * iword, stat);
+    /* A block update of at most fused_max = m*n*k is added to L or U as
+       it is computed, without the bigV buffer; see zgemm_scatter_l/u. */
+    int fused_max = sp_ienv_dist(12, options);
 
     int_t *lookAheadFullRow,*lookAheadStRow,*lookAhead_lptr,*lookAhead_ib,
           *RemainStRow,*Remain_lptr,*Remain_ib;
@@ -1014,6 +1055,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
                   U_diag_blk_send_req, tag_ub, stat, info);
 
         pdgstrf2_timer += SuperLU_timer_()-ttt1;
+        SUPERLU_TRACE(TR_PANEL_L, ttt1, k);
 
         scp = &grid->rscp;      /* The scope of process row. */
 
@@ -1139,6 +1181,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
                               grid, Llu, U_diag_blk_send_req, tag_ub, stat, info);
 
                      pdgstrf2_timer += SuperLU_timer_() - ttt1;
+                     SUPERLU_TRACE(TR_PANEL_L, ttt1, kk);
 
                     /* Multicasts numeric values of L(:,kk) to process rows. */
                     /* ttt1 = SuperLU_timer_(); */
@@ -1307,6 +1350,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
                         }
 
                         pdgstrs2_timer += SuperLU_timer_()-ttt2;
+                        SUPERLU_TRACE(TR_PANEL_U, ttt2, kk);
                         /* stat->time8 += SuperLU_timer_()-ttt2; */
 
                         /* Multicasts U(kk,:) to process columns. */
@@ -1376,6 +1420,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
 #if ( PROFlevel>=1 )
 	    TIC(t1);
 #endif
+            double ttw = SUPERLU_TRACE_TIC();
             for (pj = 0; pj < Pc; ++pj) {
                 /* Wait for Isend to complete before using lsub/lusup buffer. */
                 if (ToSendR[lk][pj] != SLU_EMPTY) {
@@ -1383,6 +1428,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
                     MPI_Wait (&send_req[pj + Pc], &status);
                 }
             }
+            SUPERLU_TRACE(TR_WAIT_SEND, ttw, k);
 #if ( PROFlevel>=1 )
 	    TOC(t2, t1);
 	    stat->utime[COMM] += t2;
@@ -1404,6 +1450,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
 #if ( PROFlevel>=1 )
                 TIC (t1);
 #endif
+                double ttw = SUPERLU_TRACE_TIC();
                 if (recv_req[0] != MPI_REQUEST_NULL) {
                     MPI_Wait (&recv_req[0], &status);
                     MPI_Get_count (&status, mpi_int_t, &msgcnt[0]);
@@ -1427,6 +1474,9 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
 			   iam, k, look_id, msgcnt[1]);
 #endif
                 }
+                SUPERLU_TRACE(TR_WAIT_L, ttw, k);
+                stat->fact_comm_bytes += (double) msgcnt[0] * sizeof(int_t)
+                    + (double) msgcnt[1] * sizeof(doublecomplex);
 
 #if ( PROFlevel>=1 )
                 TOC (t2, t1);
@@ -1472,6 +1522,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
 		                    Ublock_info, stat);
                 }
                 pdgstrs2_timer += SuperLU_timer_() - ttt2;
+                SUPERLU_TRACE(TR_PANEL_U, ttt2, k);
 
 	        /* Sherry -- need to set factoredU[k0] = 1; ?? */
 
@@ -1520,12 +1571,14 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
 #if ( PROFlevel>=1 )
 		    TIC (t1);
 #endif
+                    double ttw = SUPERLU_TRACE_TIC();
                     for (pi = 0; pi < Pr; ++pi) {
                         if (pi != myrow) {
                             MPI_Wait (&send_reqs_u[look_id][pi], &status);
                             MPI_Wait (&send_reqs_u[look_id][pi + Pr], &status);
                         }
                     }
+                    SUPERLU_TRACE(TR_WAIT_SEND, ttw, k);
 #if ( PROFlevel>=1 )
 		    TOC (t2, t1);
 		    stat->utime[COMM] += t2;
@@ -1547,10 +1600,14 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
 #if ( PROFlevel>=1 )
                 TIC (t1);
 #endif
+                double ttw = SUPERLU_TRACE_TIC();
                 MPI_Wait (&recv_reqs_u[look_id][0], &status);
                 MPI_Get_count (&status, mpi_int_t, &msgcnt[2]);
                 MPI_Wait (&recv_reqs_u[look_id][1], &status);
                 MPI_Get_count (&status, SuperLU_MPI_DOUBLE_COMPLEX, &msgcnt[3]);
+                SUPERLU_TRACE(TR_WAIT_U, ttw, k);
+                stat->fact_comm_bytes += (double) msgcnt[2] * sizeof(int_t)
+                    + (double) msgcnt[3] * sizeof(doublecomplex);
 
 #if ( PROFlevel>=1 )
                 TOC (t2, t1);
@@ -1583,6 +1640,18 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
         msg0 = msgcnt[0];
         msg2 = msgcnt[2];
         /* tt1 = SuperLU_timer_(); */
+
+        /* With the task scheduler, the look-ahead update, the panel
+           factorizations and the Schur update below are done in one
+           parallel region: the master thread creates the tasks, and the
+           team runs them until the barrier at the end of the region.
+           Otherwise the region is inactive, and the parallel loops in
+           the included files get all the threads. */
+#ifdef _OPENMP
+#pragma omp parallel if (sched_tasks) default (shared)
+#pragma omp master
+#endif
+      {
         if (msg0 && msg2) {     /* L(:,k) and U(k,:) are not empty. */
             nsupr = lsub[1];    /* LDA of lusup. */
             if (myrow == krow) { /* Skip diagonal block L(k,k). */
@@ -1636,6 +1705,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
 #include "zlook_ahead_update.c"
 
             lookaheadupdatetimer += SuperLU_timer_() - ttx;
+            SUPERLU_TRACE(TR_LOOKAHEAD, ttx, k);
 /************************************************************************/
 
             /*ifdef OMP_LOOK_AHEAD */
@@ -1655,9 +1725,13 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
             if (look_ahead[kk] == k0) {
                 if (mycol != kcol) {
                     if (ToRecv[kk] >= 1) {
-                        scp = &grid->rscp;  /* The scope of process row. */
-
                         look_id = kk0 % (1 + num_look_aheads);
+#ifdef _OPENMP
+#pragma omp task if (mpi_tasks) firstprivate(kk0, kcol, look_id) \
+    private(scp, recv_req) depend(inout: mpi_token)
+#endif
+                      {
+                        scp = &grid->rscp;  /* The scope of process row. */
                         recv_req = recv_reqs[look_id];
 #if ( PROFlevel>=1 )
 			TIC (t1);
@@ -1674,6 +1748,7 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
 			stat->utime[COMM] += t2;
 			stat->utime[COMM_RIGHT] += t2;
 #endif
+                      }
                     }
                 } else {
                     lk = LBj (kk, grid);    /* Local block number. */
@@ -1683,11 +1758,18 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
                         /* Factor diagonal and subdiagonal blocks and
 			   test for exact singularity.  */
                         factored[kk] = 0; /* flag column kk as factored */
+#ifdef _OPENMP
+#pragma omp task if (mpi_tasks) firstprivate(kk, kk0, lk, lsub1, lusup1) \
+    private(look_id, send_req, msgcnt, scp, pj) \
+    depend(inout: colsync[lk]) depend(inout: mpi_token)
+#endif
+                      {
                         double ttt1 = SuperLU_timer_();
                         PZGSTRF2 (options, kk0, kk, thresh,
                                   Glu_persist, grid, Llu, U_diag_blk_send_req,
                                   tag_ub, stat, info);
                         pdgstrf2_timer += SuperLU_timer_() - ttt1;
+                        SUPERLU_TRACE(TR_PANEL_L, ttt1, kk);
 
                         /* Process column *kcol+1* multicasts numeric
 			   values of L(:,k+1) to process rows. */
@@ -1723,12 +1805,13 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
 #endif
                             }
                         } /* end for pj ... */
+                      }
                     } /* if    factored[kk] ... */
                 }
             }
         }
 
-        double tsch = SuperLU_timer_();
+        tsch = SuperLU_timer_();
 
 	/*******************************************************************/
 
@@ -1747,11 +1830,13 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
   #include "zSchCompUdt-2Ddynamic.c"
 
 #endif
+      } /* end of the parallel region of the task scheduler */
 	/*uncomment following to compare against SuperLU 3.3 baseline*/
         /* #include "SchCompUdt--baseline.c"  */
 	/************************************************************************/
 
         NetSchurUpTimer += SuperLU_timer_() - tsch;
+        SUPERLU_TRACE(TR_SCHUR, tsch, k);
 
     }  /* MAIN LOOP for k0 = 0, ... */
 
@@ -1887,6 +1972,14 @@ pzgstrf(superlu_dist_options_t * options, int m, int n, double anorm,
     // SUPERLU_FREE (tempv2d);/* Sherry */
     SUPERLU_FREE (indirect);
     SUPERLU_FREE (indirect2); /* Sherry added */
+    SUPERLU_FREE (gsmap);
+    SUPERLU_FREE (gsmap2);
+    SUPERLU_FREE (colsync);
+    if ( sched_tasks ) {
+        SUPERLU_FREE (bigU_la);
+        SUPERLU_FREE (bigV_task);
+        log_memory(-(bigu_size + ldt * ldt * num_threads) * dword, stat);
+    }
 
     ldt = sp_ienv_dist(3, options);
     log_memory( -(3 * ldt *ldt * dword + 2 * ldt * num_threads * iword), stat );
@@ -160,6 +160,8 @@ pzgstrf2_trsm
     MPI_Status status;
     MPI_Comm comm = (grid->cscp).comm;
     double t1, t2;
+    flops_t ops = 0.0; /* added to stat at the end, see below */
+    int tiny = 0;
 
     /* Initialization. */
     iam = grid->iam;
@@ -227,7 +229,7 @@ pzgstrf2_trsm
 #if ( PRNTlevel>=2 )
                     printf ("replaced by %e\n", lusup[i]);
 #endif
-                    ++(stat->TinyPivots);
+                    ++tiny;
                 }
             }
 
@@ -250,7 +252,7 @@ pzgstrf2_trsm
                 slud_z_div(&temp, &one, &ujrow[0]);
                 for (i = luptr + 1; i < luptr - j + nsupc; ++i)
                     zz_mult(&lusup[i], &lusup[i], &temp);
-                stat->ops[FACT] += 6*(nsupc-j-1) + 10;
+                ops += 6*(nsupc-j-1) + 10;
             }
 
             /* Rank-1 update of the trailing submatrix within diag. block. */
@@ -260,7 +262,7 @@ pzgstrf2_trsm
                 zgeru_(&l, &cols_left, &alpha, &lusup[luptr+1], &incx,
                        &ujrow[ld_ujrow], &incy, &lusup[luptr + nsupr + 1],
                        &nsupr);
-                stat->ops[FACT] += 8 * l * cols_left;
+                ops += 8 * l * cols_left;
             }
 
             /* ujrow = ublk_ptr + u_diag_cnt;  */
@@ -316,7 +318,7 @@ pzgstrf2_trsm
         ztrsm_ ("R", "U", "N", "N", &l, &nsupc,
                 &alpha, ublk_ptr, &ld_ujrow, &lusup[nsupc], &nsupr);
 #endif
-	stat->ops[FACT] += 4.0 * ((flops_t) nsupc * (nsupc+1) * l);
+	ops += 4.0 * ((flops_t) nsupc * (nsupc+1) * l);
     } else {  /* non-diagonal process */
         /* ================================================================== *
          * Receive the diagonal block of U for panel factorization of L(:,k). *
@@ -353,13 +355,24 @@ pzgstrf2_trsm
             ztrsm_ ("R", "U", "N", "N", &nsupr, &nsupc,
                     &alpha, ublk_ptr, &ld_ujrow, lusup, &nsupr);
 #endif
-	    stat->ops[FACT] += 4.0 * ((flops_t) nsupc * (nsupc+1) * nsupr);
+	    ops += 4.0 * ((flops_t) nsupc * (nsupc+1) * nsupr);
         }
 
     } /* end if pkk ... */
 
     /* printf("exiting pzgstrf2 %d \n", grid->iam);  */
 
+    /* With options->SchurTasks, this runs in a task while the master
+       thread adds the flops of the Schur update to stat. */
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    stat->ops[FACT] += ops;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    stat->TinyPivots += tiny;
+
 }  /* PZGSTRF2_trsm */
 
 
@@ -76,7 +76,7 @@ int_t ztrs_B_init3d_newsolve(int_t nsupers, doublecomplex* x, int nrhs, zLUstruc
 	int_t mycol = MYCOL( iam, grid );
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     doublecomplex zero = {0.0, 0.0};
     doublecomplex* xtmp;
     sForest_t** sForests = trf3Dpartition->sForests;
@@ -226,6 +226,15 @@ int ztrs_compute_communication_structure(superlu_dist_options_t *options, int_t
     int *h_recv_cnt;
     int *h_recv_cnt_u;
 
+    /* Shape of the broadcast and reduction trees. The device code of the
+       NVSHMEM solve assumes binary trees. */
+    C_TreeTopo topo;
+#ifdef HAVE_NVSHMEM
+    C_TreeTopo_Init(&topo, BINARY_TREE, grid->comm);
+#else
+    C_TreeTopo_Init(&topo, options->CommTree, grid->comm);
+#endif
+
     /* Reconstruct the global L structure and compute the communication metadata */
 
     if ( !(tmpglo = intCalloc_dist(nsupers)) )
@@ -406,7 +415,7 @@ int ztrs_compute_communication_structure(superlu_dist_options_t *options, int_t
 
                         msgsize = SuperSize( jb );
                         int needrecv=0;
-                        C_BcTree_Create_nv(&LBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'z',&needrecv);
+                        C_BcTree_Create_topo(&LBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'z',&needrecv, &topo);
                         //C_BcTree_Create(&LBtree_ptr[ljb], grid->comm, ranks, rank_cnt, msgsize, 'z');
                         //printf("(%d) HOST create:ljb=%d,msg=%d,needrecv=%d\n",iam,ljb,mysendmsg_num,needrecv);
                         #ifdef GPU_ACC
@@ -520,7 +529,7 @@ int ztrs_compute_communication_structure(superlu_dist_options_t *options, int_t
 
                         int needrecvrd=0;
                         int needsendrd=0;
-                        C_RdTree_Create_nv(&LRtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'z', &needrecvrd, &needsendrd);
+                        C_RdTree_Create_topo(&LRtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'z', &needrecvrd, &needsendrd, &topo);
                         //C_RdTree_Create(&LRtree_ptr[lib], grid->comm, ranks, rank_cnt, msgsize, 'z');
                         #ifdef GPU_ACC
                         #ifdef HAVE_NVSHMEM
@@ -736,7 +745,7 @@ int ztrs_compute_communication_structure(superlu_dist_options_t *options, int_t
                         // C_BcTree_Create(&UBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'z');
 
                         int needrecv=0;
-                        C_BcTree_Create_nv(&UBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'z',&needrecv);
+                        C_BcTree_Create_topo(&UBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'z',&needrecv, &topo);
                         //C_BcTree_Create(&UBtree_ptr[ljb], grid->comm, ranks, rank_cnt, msgsize, 'z');
                         #ifdef GPU_ACC
                         #ifdef HAVE_NVSHMEM
@@ -847,7 +856,7 @@ int ztrs_compute_communication_structure(superlu_dist_options_t *options, int_t
 
                         int needrecvrd=0;
                         int needsendrd=0;
-                        C_RdTree_Create_nv(&URtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'z', &needrecvrd,&needsendrd);
+                        C_RdTree_Create_topo(&URtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'z', &needrecvrd,&needsendrd, &topo);
                         //C_RdTree_Create(&URtree_ptr[lib], grid->comm, ranks, rank_cnt, msgsize, 'z');
                         #ifdef GPU_ACC
                         #ifdef HAVE_NVSHMEM
@@ -1397,6 +1406,7 @@ int ztrs_compute_communication_structure(superlu_dist_options_t *options, int_t
     //     }
     // }
 
+    C_TreeTopo_Free(&topo);
     return 0;
 } // end ztrs_compute_communication_structure
 
@@ -1405,7 +1415,7 @@ int ztrs_compute_communication_structure(superlu_dist_options_t *options, int_t
 int_t ztrs_x_reduction_newsolve(int_t nsupers, doublecomplex* x, int nrhs, zLUstruct_t * LUstruct, gridinfo3d_t *grid3d, ztrf3Dpartition_t*  trf3Dpartition, doublecomplex* recvbuf, xtrsTimer_t *xtrsTimer)
 
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
 	int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
@@ -1449,7 +1459,7 @@ int_t ztrs_x_reduction_newsolve(int_t nsupers, doublecomplex* x, int nrhs, zLUst
 int_t ztrs_x_broadcast_newsolve(int_t nsupers, doublecomplex* x, int nrhs, zLUstruct_t * LUstruct, gridinfo3d_t *grid3d, ztrf3Dpartition_t*  trf3Dpartition, doublecomplex* recvbuf, xtrsTimer_t *xtrsTimer)
 
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
 	int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
@@ -1494,6 +1504,8 @@ int_t zreduceSolvedX_newsolve(int_t treeId, int_t sender, int_t receiver, double
 {
 	sForest_t** sForests = trf3Dpartition->sForests;
 	sForest_t* sforest = sForests[treeId];
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
 	if (!sforest) return 0;
 	int_t nnodes = sforest->nNodes ;
 	int_t *nodeList = sforest->nodeList ;
@@ -1553,7 +1565,7 @@ int_t ztrs_X_gather3d(doublecomplex* x, int nrhs, ztrf3Dpartition_t*  trf3Dparti
                      gridinfo3d_t* grid3d, xtrsTimer_t *xtrsTimer)
 
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
 
@@ -1598,6 +1610,8 @@ int_t zp2pSolvedX3d(int_t treeId, int_t sender, int_t receiver, doublecomplex* x
 {
 	sForest_t** sForests = trf3Dpartition->sForests;
 	sForest_t* sforest = sForests[treeId];
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
 	if (!sforest) return 0;
 	int_t nnodes = sforest->nNodes ;
 	int_t *nodeList = sforest->nodeList ;
@@ -1649,6 +1663,8 @@ int_t zfsolveReduceLsum3d(int_t treeId, int_t sender, int_t receiver, doublecomp
 {
 	sForest_t** sForests = trf3Dpartition->sForests;
 	sForest_t* sforest = sForests[treeId];
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
 	if (!sforest) return 0;
 	int_t nnodes = sforest->nNodes ;
 	int_t *nodeList = sforest->nodeList ;
@@ -1725,7 +1741,7 @@ int_t zbsolve_Xt_bcast(int_t ilvl, zxT_struct *xT_s, int nrhs, ztrf3Dpartition_t
     int_t *ilsum = Llu->ilsum;
     int_t* xsup = Glu_persist->xsup;
 
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	gridinfo_t * grid = &(grid3d->grid2d);
 	int_t myGrid = grid3d->zscp.Iam;
 		int_t iam = grid->iam;
@@ -1751,6 +1767,9 @@ int_t zbsolve_Xt_bcast(int_t ilvl, zxT_struct *xT_s, int nrhs, ztrf3Dpartition_t
 		sender = myGrid - (1 << ilvl);
 	}
 
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
+
 	for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
 	{
 		/* code */
@@ -6789,7 +6808,7 @@ pzgstrs3d (superlu_dist_options_t *options, int_t n, zLUstruct_t * LUstruct,
 
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -6829,7 +6848,7 @@ pzgstrs3d (superlu_dist_options_t *options, int_t n, zLUstruct_t * LUstruct,
 
 
 
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -6872,7 +6891,7 @@ pzgstrs3d (superlu_dist_options_t *options, int_t n, zLUstruct_t * LUstruct,
                        recvbuf, send_req,  nrhs, SOLVEstruct,  stat, &xtrsTimer);
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7123,7 +7142,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7163,7 +7182,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 
     // printf("Llu->SolveMsgSent %10d size %10d\n",Llu->SolveMsgSent,SUPERLU_MAX (Llu->nfsendx, Llu->nbsendx) + nlb);
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7201,7 +7220,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
     xtrsTimer.trs_comm_z += SuperLU_timer_() - tx;
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7246,7 +7265,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 
     // printf("pzgsTrBackSolve3d_newsolve Llu->SolveMsgSent %10d size %10d\n",Llu->SolveMsgSent,SUPERLU_MAX (Llu->nfsendx, Llu->nbsendx) + nlb);
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7354,7 +7373,7 @@ int_t pzgsTrForwardSolve3d(superlu_dist_options_t *options, int_t n, zLUstruct_t
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -7500,7 +7519,7 @@ int_t pzgsTrForwardSolve3d_newsolve(superlu_dist_options_t *options, int_t n, zL
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -7610,7 +7629,7 @@ int_t pzgsTrBackSolve3d(superlu_dist_options_t *options, int_t n, zLUstruct_t *
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -7644,8 +7663,8 @@ int_t pzgsTrBackSolve3d(superlu_dist_options_t *options, int_t n, zLUstruct_t *
     int_t nsupc = sp_ienv_dist (3,options);
     zinitLsumBmod_buff(nsupc, nrhs, &lbmod_buf);
 
-    int_t numTrees = 2 * grid3d->zscp.Np - 1;
-    int_t nLeafTrees = grid3d->zscp.Np;
+    int_t numTrees = (1 << maxLvl) - 1;
+    int_t nLeafTrees = 1 << (maxLvl - 1);
     Llu->SolveMsgSent = 0;
     for (int_t ilvl = maxLvl - 1; ilvl >= 0  ; --ilvl)
     {
@@ -7735,7 +7754,7 @@ int_t pzgsTrBackSolve3d_newsolve(superlu_dist_options_t *options, int_t n, zLUst
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
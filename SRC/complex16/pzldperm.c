@@ -0,0 +1,276 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Finds a row permutation for a large diagonal on the distributed matrix
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <math.h>
+#include <float.h>
+#include "superlu_zdefs.h"
+
+#define AUCTION_EPS_FINAL  1.0e-3  /* final eps, in log(|a_ij|) units */
+#define AUCTION_EPS_FACTOR 4.0     /* eps reduction between phases */
+#define AUCTION_MAXROUND   10000   /* bidding rounds per phase */
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ *   PZLDPERM_DIST is the distributed counterpart of ZLDPERM_DIST with
+ *   JOB = 5. It finds a row permutation that approximately maximizes the
+ *   product of the diagonal entries, and the row and column scalings that
+ *   make the permuted diagonal one in absolute value and all off-diagonal
+ *   entries at most one in absolute value.
+ *
+ *   The matching is computed by a Jacobi-style auction with eps-scaling
+ *   (Bertsekas) directly on the NR_loc pieces of A; A is never gathered.
+ *   Each unmatched local row bids for the column with the best profit
+ *   log|a_ij| - log(max_k |a_kj|) - price_j, where
+ *   |a_ij| = |Re(a_ij)| + |Im(a_ij)| as in ZLDPERM_DIST. In each round the bids of all
+ *   processes are exchanged, and every process resolves them identically,
+ *   so the column prices and owners are replicated. The communication
+ *   volume per round is proportional to the number of unmatched rows.
+ *   Memory per process is O(nnz_loc + n).
+ *
+ *   The final matching is eps-optimal with eps = AUCTION_EPS_FINAL, that
+ *   is, each matched entry of the scaled matrix is at least
+ *   exp(-AUCTION_EPS_FINAL) in absolute value.
+ *
+ * Arguments
+ * =========
+ *
+ * A      (input) SuperMatrix*
+ *        The distributed matrix in NR_loc format. A is not modified.
+ *
+ * grid   (input) gridinfo_t*
+ *        The 2D process grid. All processes in grid->comm must call
+ *        this routine.
+ *
+ * perm   (output) int_t*, of size m, replicated
+ *        The permutation vector. perm[i] = j means row i in the
+ *        original matrix is in row j of the permuted matrix.
+ *
+ * u      (output) double*, of size m, replicated
+ *        If not NULL, the natural logarithms of the row scaling factors.
+ *
+ * v      (output) double*, of size n, replicated
+ *        If not NULL, the natural logarithms of the column scaling factors.
+ *        The scaled matrix B has entries b_ij = a_ij * exp(u_i + v_j).
+ *
+ * Return value
+ * ============
+ *
+ *   = 0: a perfect matching was found.
+ *   > 0: the number of rows left unmatched, either because the matrix is
+ *        structurally singular or because AUCTION_MAXROUND was reached.
+ *        perm is still a valid permutation; the unmatched rows are
+ *        placed on the free columns in increasing order.
+ * </pre>
+ */
+int
+pzldperm_dist(SuperMatrix *A, gridinfo_t *grid, int_t perm[],
+              double u[], double v[])
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    int_t m = A->nrow, n = A->ncol;
+    int_t m_loc = Astore->m_loc, fst_row = Astore->fst_row;
+    int_t *rowptr = Astore->rowptr, *colind = Astore->colind;
+    doublecomplex *a = (doublecomplex *) Astore->nzval;
+    int_t nnz_loc = rowptr[m_loc];
+    int nprocs = grid->nprow * grid->npcol;
+    int_t i, j, k, row, *owner, *mate;
+    double *w, *colmax, *price, *best, *sbuf, *rbuf, *uloc;
+    double aij, crange, eps, v1, v2, bid;
+    int *rcnt, *rdsp, nbids, p;
+    int_t nunmatched, total, round;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Enter pzldperm_dist()");
+#endif
+
+    if ( !(w = doubleMalloc_dist(SUPERLU_MAX(nnz_loc, 1))) )
+        ABORT("SUPERLU_MALLOC fails for w[]");
+    if ( !(colmax = doubleCalloc_dist(n)) )
+        ABORT("SUPERLU_MALLOC fails for colmax[]");
+    if ( !(price = doubleCalloc_dist(n)) )
+        ABORT("SUPERLU_MALLOC fails for price[]");
+    if ( !(best = doubleMalloc_dist(2 * n)) )
+        ABORT("SUPERLU_MALLOC fails for best[]");
+    if ( !(owner = intMalloc_dist(n)) )
+        ABORT("SUPERLU_MALLOC fails for owner[]");
+    if ( !(mate = intMalloc_dist(SUPERLU_MAX(m_loc, 1))) )
+        ABORT("SUPERLU_MALLOC fails for mate[]");
+    /* A bid is the triple (column, row, price), sent as doubles. */
+    if ( !(sbuf = doubleMalloc_dist(3 * SUPERLU_MAX(m_loc, 1))) )
+        ABORT("SUPERLU_MALLOC fails for sbuf[]");
+    if ( !(rbuf = doubleMalloc_dist(3 * m)) )
+        ABORT("SUPERLU_MALLOC fails for rbuf[]");
+    if ( !(rcnt = SUPERLU_MALLOC(2 * nprocs * sizeof(int))) )
+        ABORT("SUPERLU_MALLOC fails for rcnt[]");
+    rdsp = rcnt + nprocs;
+
+    /* Weights are log|a_ij| - log(max_k |a_kj|) <= 0; exact zeros are
+       not eligible. */
+    for (k = 0; k < nnz_loc; ++k) {
+        j = colind[k];
+        aij = slud_z_abs1(&a[k]);
+        colmax[j] = SUPERLU_MAX(colmax[j], aij);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, colmax, n, MPI_DOUBLE, MPI_MAX, grid->comm);
+    for (j = 0; j < n; ++j)
+        colmax[j] = colmax[j] > 0.0 ? log(colmax[j]) : 0.0;
+
+    crange = 0.0;
+    for (k = 0; k < nnz_loc; ++k) {
+        aij = slud_z_abs1(&a[k]);
+        if ( aij == 0.0 ) w[k] = -DBL_MAX;
+        else {
+            w[k] = log(aij) - colmax[colind[k]];
+            crange = SUPERLU_MAX(crange, -w[k]);
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &crange, 1, MPI_DOUBLE, MPI_MAX, grid->comm);
+
+    /* eps-scaling: each phase restarts the assignment from the current
+       prices with a smaller eps. */
+    eps = SUPERLU_MAX(crange / AUCTION_EPS_FACTOR, AUCTION_EPS_FINAL);
+    for (;;) {
+        for (j = 0; j < n; ++j) owner[j] = SLU_EMPTY;
+        for (i = 0; i < m_loc; ++i) mate[i] = SLU_EMPTY;
+
+        for (round = 0; round < AUCTION_MAXROUND; ++round) {
+            /* Each unmatched local row bids for its most profitable
+               column, raising its price by the margin over the second
+               best plus eps. */
+            nbids = 0;
+            for (i = 0; i < m_loc; ++i) {
+                if ( mate[i] != SLU_EMPTY ) continue;
+                v1 = v2 = -DBL_MAX;
+                j = SLU_EMPTY;
+                for (k = rowptr[i]; k < rowptr[i+1]; ++k) {
+                    if ( w[k] == -DBL_MAX ) continue;
+                    bid = w[k] - price[colind[k]];
+                    if ( bid > v1 ) {
+                        v2 = v1; v1 = bid; j = colind[k];
+                    } else if ( bid > v2 ) v2 = bid;
+                }
+                if ( j == SLU_EMPTY ) continue; /* no eligible entry */
+                if ( v2 == -DBL_MAX ) v2 = v1 - crange - 1.0;
+                sbuf[3*nbids] = (double) j;
+                sbuf[3*nbids+1] = (double) (i + fst_row);
+                sbuf[3*nbids+2] = price[j] + v1 - v2 + eps;
+                ++nbids;
+            }
+
+            nbids *= 3;
+            MPI_Allgather(&nbids, 1, MPI_INT, rcnt, 1, MPI_INT, grid->comm);
+            for (total = 0, p = 0; p < nprocs; ++p) {
+                rdsp[p] = total;
+                total += rcnt[p];
+            }
+            if ( total == 0 ) break;
+            MPI_Allgatherv(sbuf, nbids, MPI_DOUBLE, rbuf, rcnt, rdsp,
+                           MPI_DOUBLE, grid->comm);
+
+            /* Every process resolves the bids the same way: the highest
+               bid wins, ties go to the lower row. */
+            for (k = 0; k < total; k += 3) {
+                j = (int_t) rbuf[k];
+                best[2*j] = -DBL_MAX;
+            }
+            for (k = 0; k < total; k += 3) {
+                j = (int_t) rbuf[k];
+                bid = rbuf[k+2];
+                if ( bid > best[2*j] ||
+                     (bid == best[2*j] && rbuf[k+1] < best[2*j+1]) ) {
+                    best[2*j] = bid;
+                    best[2*j+1] = rbuf[k+1];
+                }
+            }
+            for (k = 0; k < total; k += 3) {
+                j = (int_t) rbuf[k];
+                if ( best[2*j] == -DBL_MAX ) continue; /* already done */
+                price[j] = best[2*j];
+                row = owner[j];
+                if ( row >= fst_row && row < fst_row + m_loc )
+                    mate[row - fst_row] = SLU_EMPTY;
+                row = (int_t) best[2*j+1];
+                owner[j] = row;
+                if ( row >= fst_row && row < fst_row + m_loc )
+                    mate[row - fst_row] = j;
+                best[2*j] = -DBL_MAX;
+            }
+        } /* for round ... */
+
+#if ( PRNTlevel>=2 )
+        if ( !grid->iam )
+            printf(".. pzldperm_dist: eps %.3e, %lld rounds\n",
+                   eps, (long long) round);
+#endif
+        /* Out of rounds: A is most likely structurally singular. */
+        if ( eps <= AUCTION_EPS_FINAL || round == AUCTION_MAXROUND ) break;
+        eps = SUPERLU_MAX(eps / AUCTION_EPS_FACTOR, AUCTION_EPS_FINAL);
+    } /* for eps ... */
+
+    /* owner[] is replicated, so every process builds the same perm[]. */
+    for (i = 0; i < m; ++i) perm[i] = SLU_EMPTY;
+    for (j = 0; j < n; ++j)
+        if ( owner[j] != SLU_EMPTY ) perm[owner[j]] = j;
+    nunmatched = 0;
+    for (i = 0, j = 0; i < m; ++i) {
+        if ( perm[i] != SLU_EMPTY ) continue;
+        while ( owner[j] != SLU_EMPTY ) ++j;
+        perm[i] = j++;
+        ++nunmatched;
+    }
+
+    /* Dual variables: u_i = -max_j (w_ij - price_j) and
+       v_j = -price_j - log(max_k |a_kj|), so that every scaled entry is
+       at most one and the matched ones are at least exp(-eps). */
+    if ( u && v ) {
+        uloc = rbuf;
+        for (i = 0; i < m; ++i) uloc[i] = 0.0;
+        for (i = 0; i < m_loc; ++i) {
+            v1 = -DBL_MAX;
+            for (k = rowptr[i]; k < rowptr[i+1]; ++k)
+                if ( w[k] != -DBL_MAX )
+                    v1 = SUPERLU_MAX(v1, w[k] - price[colind[k]]);
+            uloc[i + fst_row] = v1 == -DBL_MAX ? 0.0 : -v1;
+        }
+        MPI_Allreduce(MPI_IN_PLACE, uloc, m, MPI_DOUBLE, MPI_SUM, grid->comm);
+        for (i = 0; i < m; ++i) u[i] = uloc[i];
+        for (j = 0; j < n; ++j) v[j] = -price[j] - colmax[j];
+    }
+
+    SUPERLU_FREE(w);
+    SUPERLU_FREE(colmax);
+    SUPERLU_FREE(price);
+    SUPERLU_FREE(best);
+    SUPERLU_FREE(owner);
+    SUPERLU_FREE(mate);
+    SUPERLU_FREE(sbuf);
+    SUPERLU_FREE(rbuf);
+    SUPERLU_FREE(rcnt);
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Exit pzldperm_dist()");
+#endif
+    return (int) nunmatched;
+}
@@ -37,6 +37,21 @@ int pzCompRow_loc_to_CompCol_global
  gridinfo_t *grid, /* Input */
  SuperMatrix *GA   /* Output */
 )
+{
+    return pzCompRow_loc_to_CompCol_node(need_value, A, grid, NULL, GA);
+}
+
+/*! \brief As pzCompRow_loc_to_CompCol_global(), but if node is not NULL, only the
+ *  leader of each node gets GA; GA->Store is NULL on the other processes.
+ */
+int pzCompRow_loc_to_CompCol_node
+(
+ int_t need_value, /* Input. Whether need to gather numerical values */
+ SuperMatrix *A,   /* Input. Distributed matrix in NRformat_loc format. */
+ gridinfo_t *grid, /* Input */
+ superlu_node_t *node, /* Input. Nodes of grid->comm, or NULL */
+ SuperMatrix *GA   /* Output */
+)
 {
     NRformat_loc *Astore;
     NCformat *GAstore;
@@ -59,6 +74,7 @@ int pzCompRow_loc_to_CompCol_global
     int_t *fst_rows, *n_locs;
     int   *sendcnts, *sdispls, *recvcnts, *rdispls, *itemp_32;
     int   it, n_loc, procs;
+    int   have_GA = !node || node->leader;
 
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Enter pzCompRow_loc_to_CompCol_global");
@@ -226,10 +242,14 @@ int pzCompRow_loc_to_CompCol_global
     for (i = 0, nnz = 0; i < procs; ++i) nnz += itemp[i];
     GAstore->nnz = nnz;
 
-    if ( !(GAstore->rowind = (int_t *) intMalloc_dist (nnz)) )
-        ABORT ("SUPERLU_MALLOC fails for GAstore->rowind[]");
-    if ( !(GAstore->colptr = (int_t *) intMalloc_dist (n+1)) )
-        ABORT ("SUPERLU_MALLOC fails for GAstore->colptr[]");
+    GAstore->rowind = GAstore->colptr = NULL;
+    GAstore->nzval = NULL;
+    if ( have_GA ) {
+      if ( !(GAstore->rowind = (int_t *) intMalloc_dist (nnz)) )
+          ABORT ("SUPERLU_MALLOC fails for GAstore->rowind[]");
+      if ( !(GAstore->colptr = (int_t *) intMalloc_dist (n+1)) )
+          ABORT ("SUPERLU_MALLOC fails for GAstore->colptr[]");
+    }
 
     /* Allgatherv for row indices. */
     rdispls[0] = 0;
@@ -239,14 +259,14 @@ int pzCompRow_loc_to_CompCol_global
     }
     itemp_32[procs-1] = itemp[procs-1];
     it = nnz_loc;
-    MPI_Allgatherv(rowind_buf, it, mpi_int_t, GAstore->rowind,
-		   itemp_32, rdispls, mpi_int_t, grid->comm);
+    superlu_node_allgatherv(node, rowind_buf, it, GAstore->rowind,
+			    itemp_32, rdispls, mpi_int_t, grid);
     if ( need_value ) {
-      if ( !(GAstore->nzval = (doublecomplex *) doublecomplexMalloc_dist (nnz)) )
+      if ( have_GA && !(GAstore->nzval = (doublecomplex *) doublecomplexMalloc_dist (nnz)) )
           ABORT ("SUPERLU_MALLOC fails for GAstore->rnzval[]");
-      MPI_Allgatherv(a_buf, it, SuperLU_MPI_DOUBLE_COMPLEX, GAstore->nzval,
-		     itemp_32, rdispls, SuperLU_MPI_DOUBLE_COMPLEX, grid->comm);
-    } else GAstore->nzval = NULL;
+      superlu_node_allgatherv(node, a_buf, it, GAstore->nzval,
+			      itemp_32, rdispls, SuperLU_MPI_DOUBLE_COMPLEX, grid);
+    }
 
     /* Now gather the column pointers. */
     rdispls[0] = 0;
@@ -255,16 +275,21 @@ int pzCompRow_loc_to_CompCol_global
         itemp_32[i] = n_locs[i];
     }
     itemp_32[procs-1] = n_locs[procs-1];
-    MPI_Allgatherv(colptr_loc, n_loc, mpi_int_t, GAstore->colptr,
-		   itemp_32, rdispls, mpi_int_t, grid->comm);
+    superlu_node_allgatherv(node, colptr_loc, n_loc, GAstore->colptr,
+			    itemp_32, rdispls, mpi_int_t, grid);
 
     /* Recompute column pointers. */
-    for (i = 1; i < procs; ++i) {
+    if ( have_GA ) {
+      for (i = 1; i < procs; ++i) {
         k = rdispls[i];
 	for (j = 0; j < n_locs[i]; ++j) GAstore->colptr[k++] += itemp[i-1];
 	itemp[i] += itemp[i-1]; /* prefix sum */
+      }
+      GAstore->colptr[n] = nnz;
+    } else {
+      SUPERLU_FREE(GAstore);
+      GA->Store = NULL;
     }
-    GAstore->colptr[n] = nnz;
 
 #if ( DEBUGlevel>=2 )
     if ( !grid->iam ) {
@@ -415,6 +440,9 @@ void zLUstructInit(const int_t n, zLUstruct_t *LUstruct)
 	   SUPERLU_MALLOC(sizeof(zLocalLU_t))) )
 	ABORT("Malloc fails for LocalLU_t.");
 	LUstruct->Llu->inv = 0;
+	LUstruct->Llu->LUfile_map = NULL;
+	LUstruct->Llu->Amap = NULL;
+	superlu_tune_reset(&LUstruct->tune);
 }
 
 /*! \brief Deallocate LUstruct */
@@ -467,15 +495,15 @@ zDestroy_LU(int_t n, gridinfo_t *grid, zLUstruct_t *LUstruct)
     //	}
 
     SUPERLU_FREE (Llu->Lrowind_bc_ptr);
-    SUPERLU_FREE (Llu->Lrowind_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE (Llu->Lrowind_bc_dat);
     SUPERLU_FREE (Llu->Lrowind_bc_offset);
     SUPERLU_FREE (Llu->Lnzval_bc_ptr);
-    SUPERLU_FREE (Llu->Lnzval_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE (Llu->Lnzval_bc_dat);
     SUPERLU_FREE (Llu->Lnzval_bc_offset);
 
     /* Following are free'd in distribution routines */
     nb = CEILING(nsupers, grid->nprow);
-    for (i = 0; i < nb; ++i)
+    for (i = 0; i < nb && !Llu->LUfile_map; ++i)
     	if ( Llu->Ufstnz_br_ptr[i] ) {
     	    SUPERLU_FREE (Llu->Ufstnz_br_ptr[i]);
     	    SUPERLU_FREE (Llu->Unzval_br_ptr[i]);
@@ -510,7 +538,7 @@ zDestroy_LU(int_t n, gridinfo_t *grid, zLUstruct_t *LUstruct)
     //	    SUPERLU_FREE (Llu->Lindval_loc_bc_ptr[i]);
     //	}
     SUPERLU_FREE(Llu->Lindval_loc_bc_ptr);
-    SUPERLU_FREE(Llu->Lindval_loc_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Lindval_loc_bc_dat);
     SUPERLU_FREE(Llu->Lindval_loc_bc_offset);
 
     /* Following are free'd in distribution routines */
@@ -524,13 +552,22 @@ zDestroy_LU(int_t n, gridinfo_t *grid, zLUstruct_t *LUstruct)
     //	}
     // }
     SUPERLU_FREE(Llu->Linv_bc_ptr);
-    SUPERLU_FREE(Llu->Linv_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Linv_bc_dat);
     SUPERLU_FREE(Llu->Linv_bc_offset);
     SUPERLU_FREE(Llu->Uinv_bc_ptr);
-    SUPERLU_FREE(Llu->Uinv_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Uinv_bc_dat);
     SUPERLU_FREE(Llu->Uinv_bc_offset);
     SUPERLU_FREE(Llu->Unnz);
 
+    /* The L and U data mapped by pzMapLU() are released by unmapping. */
+    if ( Llu->LUfile_map ) {
+	superlu_LUfile_unmap(Llu->LUfile_map, Llu->LUfile_map_size);
+	Llu->LUfile_map = NULL;
+    }
+
+    zAmapFree(Llu->Amap);
+    Llu->Amap = NULL;
+
     /* Following are free'd in distribution routines */
     nb = CEILING(nsupers, grid->npcol);
     for (i = 0; i < nb; ++i)
@@ -768,6 +805,7 @@ pzgstrs_init(int_t n, int_t m_loc, int_t nrhs, int_t fst_row,
         ABORT("Malloc fails for ptr_to_ibuf[].");
     gstrs_comm->ptr_to_ibuf = ptr_to_ibuf;
     gstrs_comm->ptr_to_dbuf = ptr_to_ibuf + procs;
+    gstrs_comm->nrhs = nrhs;
 
     return 0;
 } /* PZGSTRS_INIT */
@@ -1187,6 +1225,11 @@ int zSolveInit(superlu_dist_options_t *options, SuperMatrix *A,
         ABORT("Malloc fails for gsmv_comm[]");
     SOLVEstruct->A_colind_gsmv = NULL;
 
+    if ( !(SOLVEstruct->gstrs_work = (zgstrs_work_t *)
+           SUPERLU_MALLOC(sizeof(zgstrs_work_t))) )
+        ABORT("Malloc fails for gstrs_work[]");
+    memset(SOLVEstruct->gstrs_work, 0, sizeof(zgstrs_work_t));
+
     options->SolveInitialized = YES;
     return 0;
 } /* zSolveInit */
@@ -1209,6 +1252,25 @@ void zSolveFinalize(superlu_dist_options_t *options, zSOLVEstruct_t *SOLVEstruct
         SUPERLU_FREE(SOLVEstruct->diag_len);
         if ( SOLVEstruct->A_colind_gsmv )
 	    SUPERLU_FREE(SOLVEstruct->A_colind_gsmv);
+        if ( SOLVEstruct->gstrs_work->lsum )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->lsum);
+        if ( SOLVEstruct->gstrs_work->x )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->x);
+        if ( SOLVEstruct->gstrs_work->rtemp )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->rtemp);
+        if ( SOLVEstruct->gstrs_work->recvbuf )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->recvbuf);
+        superlu_shm_free(SOLVEstruct->gstrs_work->shm);
+        superlu_arena_free(&SOLVEstruct->gstrs_work->arena);
+        if ( SOLVEstruct->gstrs_work->redist_ibuf )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_ibuf);
+        if ( SOLVEstruct->gstrs_work->redist_dbuf )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_dbuf);
+        if ( SOLVEstruct->gstrs_work->redist_req ) {
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_req);
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_status);
+        }
+        SUPERLU_FREE(SOLVEstruct->gstrs_work);
         options->SolveInitialized = NO;
     }
 } /* zSolveFinalize */
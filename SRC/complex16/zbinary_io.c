@@ -1,12 +1,91 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+/*! @file
+ * \brief Read and write sparse matrices in binary format
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * The files written by zwrite_binary() start with superlu_binmat_header_t
+ * (see superlu_defs.h) and store the matrix by rows. They can be read
+ * by one process with zread_binary(), or by all processes in parallel
+ * with pzread_binary(), each process reading only its own rows.
+ * zread_binary() also accepts the older headerless files, which hold
+ * n, nnz, colptr[], rowind[] and nzval[] in compressed column format.
+ * </pre>
+ */
+
+#include <string.h>
 #include "superlu_zdefs.h"
 
+/* Read a file written by zwrite_binary() and convert it to compressed
+   column format. */
+static int
+zread_binary_csr(FILE *fp, superlu_binmat_header_t *hdr, int_t *m, int_t *n,
+		 int_t *nnz, doublecomplex **nzval, int_t **rowind, int_t **colptr)
+{
+    int_t *rowptr, *colind;
+    doublecomplex *a;
+    int info;
+
+    *m = hdr->m;
+    *n = hdr->n;
+    *nnz = hdr->nnz;
+    rowptr = intMalloc_dist(*m+1);
+    colind = intMalloc_dist(SUPERLU_MAX(*nnz, 1));
+    a = doublecomplexMalloc_dist(SUPERLU_MAX(*nnz, 1));
+    info = superlu_binmat_fread_index(fp, hdr, hdr->rowptr_off, *m + 1, rowptr);
+    if ( !info )
+	info = superlu_binmat_fread_index(fp, hdr, hdr->colind_off, *nnz, colind);
+    if ( !info )
+	info = superlu_binmat_fread(fp, hdr->nzval_off, a, *nnz * sizeof(doublecomplex));
+    if ( !info )
+	zCompRow_to_CompCol_dist(*m, *n, *nnz, a, colind, rowptr,
+				 nzval, rowind, colptr);
+    SUPERLU_FREE(rowptr);
+    SUPERLU_FREE(colind);
+    SUPERLU_FREE(a);
+    return info;
+}
+
+/*! \brief Read a matrix in binary format on one process.
+ *
+ * <pre>
+ * The matrix is returned in compressed column format. The file is
+ * either written by zwrite_binary(), or a headerless file holding
+ * n, nnz, colptr[n+1], rowind[nnz] and nzval[nnz] of a square matrix.
+ * Returns 0 on success; for files with a header, a nonzero value is
+ * the error code of superlu_binmat_check_header(), or 2 on I/O error.
+ * </pre>
+ */
 int
-zread_binary(FILE *fp, int_t *m, int_t *n, int_t *nnz, 
+zread_binary(FILE *fp, int_t *m, int_t *n, int_t *nnz,
 	     doublecomplex **nzval, int_t **rowind, int_t **colptr)
 {
-    int_t isize = sizeof(int_t), dsize = sizeof(double);
+    superlu_binmat_header_t hdr;
+    int_t isize = sizeof(int_t), dsize = sizeof(doublecomplex);
     int_t nnz_read;
-    int_t i,j;
+    int info;
+
+    if ( fread(&hdr, sizeof(hdr), 1, fp) == 1
+	 && !memcmp(hdr.magic, SLU_BINMAT_MAGIC, sizeof(hdr.magic)) ) {
+	if ( (info = superlu_binmat_check_header(&hdr, 'z')) ) return info;
+	info = zread_binary_csr(fp, &hdr, m, n, nnz, nzval, rowind, colptr);
+	printf("fread m " IFMT "\tn " IFMT "\tnnz " IFMT "\n", *m, *n, *nnz);
+	return info;
+    }
+    rewind(fp);
+
     fread(n, isize, 1, fp);
     fread(nnz, isize, 1, fp);
     printf("fread n " IFMT "\tnnz " IFMT "\n", *n, *nnz);
@@ -16,27 +95,150 @@ zread_binary(FILE *fp, int_t *m, int_t *n, int_t *nnz,
     *nzval  = doublecomplexMalloc_dist(*nnz);
     fread(*colptr, isize, (int_t) (*n + 1), fp);
     fread(*rowind, isize, (int_t) *nnz, fp);
-    nnz_read = fread(*nzval, dsize, (int_t) (2 * (*nnz)), fp);
+    nnz_read = fread(*nzval, dsize, (int_t) (*nnz), fp);
     printf("# of doubles fread: " IFMT "\n", nnz_read);
+
     return 0;
 }
 
+/*! \brief Write a matrix given in compressed column format to the file
+ *  fname in binary format, stored by rows.
+ *
+ * <pre>
+ * Return value
+ * ============
+ *   = 0: successful exit
+ *   = 1: the file could not be created
+ *   = 2: I/O error
+ * </pre>
+ */
 int
-zwrite_binary(int_t n, int_t nnz,
+zwrite_binary(char *fname, int_t m, int_t n, int_t nnz,
 	      doublecomplex *values, int_t *rowind, int_t *colptr)
-{       
+{
+    superlu_binmat_header_t hdr;
     FILE  *fp1;
-    int nnz_written;
-    size_t isize = sizeof(int_t), dsize = sizeof(double);
-    fp1 = fopen("cmatrix.bin", "wb");
-    fwrite(&n, isize, 1, fp1);
-    fwrite(&nnz, isize, 1, fp1);
-    fwrite(colptr, isize, n+1, fp1);
-    fwrite(rowind, isize, nnz, fp1);
-    nnz_written = fwrite(values, dsize, 2*nnz, fp1);
-    printf("n " IFMT ", # of doublecomplex: " IFMT "\n", n, nnz);
-    printf("dump binary file ... # of doubles fwrite: %d\n", nnz_written);
-    assert(nnz_written == 2*nnz);
-    fclose(fp1);
+    int_t *rowptr, *colind;
+    doublecomplex *a;
+    int info = 0;
+
+    zCompCol_to_CompRow_dist(m, n, nnz, values, colptr, rowind,
+			     &a, &rowptr, &colind);
+    superlu_binmat_init_header(&hdr, 'z', sizeof(doublecomplex), m, n, nnz);
+
+    if ( !(fp1 = fopen(fname, "wb")) ) info = 1;
+    else {
+	if ( fwrite(&hdr, sizeof(hdr), 1, fp1) != 1 ) info = 2;
+	if ( !info ) info = superlu_binmat_fwrite(fp1, hdr.rowptr_off, rowptr,
+						  (m + 1) * sizeof(int_t));
+	if ( !info ) info = superlu_binmat_fwrite(fp1, hdr.colind_off, colind,
+						  nnz * sizeof(int_t));
+	if ( !info ) info = superlu_binmat_fwrite(fp1, hdr.nzval_off, a,
+						  nnz * sizeof(doublecomplex));
+	if ( fclose(fp1) && !info ) info = 2;
+    }
+
+    SUPERLU_FREE(a);
+    SUPERLU_FREE(rowptr);
+    SUPERLU_FREE(colind);
+    return info;
+}
+
+/*! \brief Read a matrix in binary format in parallel.
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * pzread_binary() reads the file fname written by zwrite_binary() into
+ * the distributed matrix A in NR_loc format. Each process reads only
+ * its own block of rows, directly from the file with collective MPI-IO,
+ * so the time and the memory used per process are proportional to the
+ * local part of the matrix. The rows are distributed as in
+ * zcreate_matrix(): m/P rows per process, the last process also takes
+ * the remainder. This routine must be called by all processes in the
+ * grid.
+ *
+ * Return value
+ * ============
+ *   = 0: successful exit
+ *   = 1: the file could not be opened
+ *   = 2: I/O error, truncated or inconsistent file
+ *   = 3: not a binary matrix file, or written by an incompatible version
+ *   = 4: precision differs, or the indices do not fit in int_t
+ * The same value is returned on all processes. On error, A is not
+ * created.
+ * </pre>
+ */
+int
+pzread_binary(char *fname, SuperMatrix *A, gridinfo_t *grid)
+{
+    superlu_binmat_header_t hdr;
+    MPI_File fh;
+    int_t m, n, m_loc, fst_row, nnz_loc, i, j;
+    int_t *rowptr, *colind;
+    doublecomplex *nzval;
+    int64_t nnz_beg;
+    int iam = grid->iam, nprocs = grid->nprow * grid->npcol;
+    int info = 0, ginfo;
+
+    if ( MPI_File_open(grid->comm, fname, MPI_MODE_RDONLY, MPI_INFO_NULL,
+		       &fh) != MPI_SUCCESS )
+	return 1;
+    info = superlu_binmat_read_at_all(fh, 0, &hdr, sizeof(hdr), grid->comm);
+    if ( !info ) info = superlu_binmat_check_header(&hdr, 'z');
+    MPI_Allreduce(&info, &ginfo, 1, MPI_INT, MPI_MAX, grid->comm);
+    if ( ginfo ) {
+	MPI_File_close(&fh);
+	return ginfo;
+    }
+
+    /* Same row distribution as in zcreate_matrix(). */
+    m = hdr.m;
+    n = hdr.n;
+    m_loc = m / nprocs;
+    fst_row = iam * m_loc;
+    if ( iam == nprocs - 1 ) m_loc = m - m_loc * (nprocs - 1);
+
+    /* My slice of rowptr[] gives the range of colind[] and nzval[]. */
+    rowptr = intMalloc_dist(m_loc+1);
+    info = superlu_binmat_read_index_at_all(fh, &hdr,
+		  hdr.rowptr_off + (int64_t) fst_row * hdr.index_size,
+		  m_loc + 1, rowptr, grid->comm);
+    nnz_beg = rowptr[0];
+    if ( nnz_beg < 0 ) info = 2;
+    for (i = 0; i <= m_loc && !info; ++i) {
+	rowptr[i] -= nnz_beg;
+	if ( rowptr[i] < (i ? rowptr[i-1] : 0) || nnz_beg + rowptr[i] > hdr.nnz )
+	    info = 2;
+    }
+    nnz_loc = info ? 0 : rowptr[m_loc];
+
+    /* Every process takes part in the collective reads, even on error. */
+    colind = intMalloc_dist(SUPERLU_MAX(nnz_loc, 1));
+    nzval = doublecomplexMalloc_dist(SUPERLU_MAX(nnz_loc, 1));
+    ginfo = superlu_binmat_read_index_at_all(fh, &hdr,
+		  hdr.colind_off + nnz_beg * hdr.index_size,
+		  nnz_loc, colind, grid->comm);
+    if ( !info ) info = ginfo;
+    ginfo = superlu_binmat_read_at_all(fh,
+		  hdr.nzval_off + nnz_beg * hdr.value_size,
+		  nzval, nnz_loc * sizeof(doublecomplex), grid->comm);
+    if ( !info ) info = ginfo;
+    for (j = 0; j < nnz_loc && !info; ++j)
+	if ( colind[j] < 0 || colind[j] >= n ) info = 2;
+    MPI_File_close(&fh);
+
+    MPI_Allreduce(&info, &ginfo, 1, MPI_INT, MPI_MAX, grid->comm);
+    if ( ginfo ) {
+	SUPERLU_FREE(rowptr);
+	SUPERLU_FREE(colind);
+	SUPERLU_FREE(nzval);
+	return ginfo;
+    }
+
+    zCreate_CompRowLoc_Matrix_dist(A, m, n, nnz_loc, m_loc, fst_row,
+				   nzval, colind, rowptr,
+				   SLU_NR_loc, SLU_Z, SLU_GE);
     return 0;
 }
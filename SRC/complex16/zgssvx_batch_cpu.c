@@ -0,0 +1,777 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+/*! @file
+ * \brief Factor and solve a batch of small sparse systems with the same
+ *  sparsity structure on the CPU
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * All the matrices in the batch have the same structure, so the row and
+ * column permutations, the symbolic factorization and the elimination
+ * schedule are computed once, from the first matrix. The values of
+ * ZBATCH_LANES consecutive matrices are interleaved entry by entry, so
+ * every operation of the factorization and of the triangular solves is
+ * a vector operation across the batch; the groups of ZBATCH_LANES
+ * matrices are shared among the OpenMP threads. No block diagonal matrix
+ * is formed. Pivoting is static: tiny pivots are replaced, and the
+ * solutions are improved by iterative refinement.
+ *
+ * This engine is the fallback of pzgssvx3d_csc_batch() when the
+ * factorization is not offloaded to a GPU. pzgssvx_batch_cpu() splits the
+ * batch among the processes, each of which does the analysis above once
+ * for its own block, and broadcasts the results.
+ * </pre>
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "superlu_zdefs.h"
+
+#define ZBATCH_LANES 4   /* matrices interleaved: 4 doublecomplex = 64 bytes */
+#define ZBATCH_ITMAX 5   /* maximum number of refinement steps */
+
+/* Structure shared by all the matrices of the batch.
+ * B = Pc*Pr*A*Pc' is kept in compressed column format, bmap[] maps each
+ * entry of B to its position in nzval[] of A. The filled matrix L+U is in
+ * compressed column format with sorted row indices; diag[j] is the
+ * position of U(j,j), the rows above it are U(:,j), the rows below are
+ * L(:,j).
+ */
+typedef struct {
+    int_t n;
+    int_t *bcolptr, *browind, *bmap;
+    int_t nnz, *colptr, *rowind, *diag;
+    flops_t ops;
+} zbatch_symb_t;
+
+static int zbatch_cmp(const void *a, const void *b)
+{
+    int_t x = *(const int_t *) a, y = *(const int_t *) b;
+    return (x > y) - (x < y);
+}
+
+/* Compute the structure of L+U of B = Pc*A*Pc', where the rows of A are
+   already permuted by Pr. Column j of L+U holds the nodes reachable from
+   the rows of B(:,j) in the graph of L(:,0:j-1). */
+static void zbatch_symbfact(int_t n, NCformat *Astore, int *perm_c,
+			    zbatch_symb_t *S)
+{
+    int_t i, j, k, p, q, nz, cap, sp, cnt, *mark, *stack, *found, *newrow;
+
+    S->n = n;
+    if ( !(S->bcolptr = intCalloc_dist(n + 1)) )
+	ABORT("Malloc fails for bcolptr[].");
+    if ( !(S->browind = intMalloc_dist(SUPERLU_MAX(Astore->nnz, 1))) )
+	ABORT("Malloc fails for browind[].");
+    if ( !(S->bmap = intMalloc_dist(SUPERLU_MAX(Astore->nnz, 1))) )
+	ABORT("Malloc fails for bmap[].");
+    for (j = 0; j < n; ++j)
+	S->bcolptr[perm_c[j] + 1] = Astore->colptr[j+1] - Astore->colptr[j];
+    for (j = 0; j < n; ++j) S->bcolptr[j+1] += S->bcolptr[j];
+    for (j = 0; j < n; ++j) {
+	q = S->bcolptr[perm_c[j]];
+	for (p = Astore->colptr[j]; p < Astore->colptr[j+1]; ++p, ++q) {
+	    S->browind[q] = perm_c[Astore->rowind[p]];
+	    S->bmap[q] = p;
+	}
+    }
+
+    cap = 2 * Astore->nnz + n;
+    if ( !(S->colptr = intMalloc_dist(n + 1)) ) ABORT("Malloc fails for colptr[].");
+    if ( !(S->diag = intMalloc_dist(n)) ) ABORT("Malloc fails for diag[].");
+    if ( !(S->rowind = intMalloc_dist(cap)) ) ABORT("Malloc fails for rowind[].");
+    if ( !(mark = intMalloc_dist(3 * n)) ) ABORT("Malloc fails for mark[].");
+    stack = mark + n;
+    found = stack + n;
+    for (i = 0; i < n; ++i) mark[i] = -1;
+
+    S->ops = 0.;
+    for (j = 0, nz = 0; j < n; ++j) {
+	S->colptr[j] = nz;
+	cnt = 0;
+	mark[j] = j;
+	found[cnt++] = j;
+	for (q = S->bcolptr[j]; q < S->bcolptr[j+1]; ++q) {
+	    if ( mark[S->browind[q]] == j ) continue;
+	    mark[S->browind[q]] = j;
+	    stack[0] = S->browind[q];
+	    for (sp = 1; sp > 0; ) {         /* depth-first search */
+		k = stack[--sp];
+		found[cnt++] = k;
+		if ( k > j ) continue;       /* not eliminated yet */
+		for (p = S->diag[k] + 1; p < S->colptr[k+1]; ++p)
+		    if ( mark[S->rowind[p]] != j ) {
+			mark[S->rowind[p]] = j;
+			stack[sp++] = S->rowind[p];
+		    }
+	    }
+	}
+	qsort(found, cnt, sizeof(int_t), zbatch_cmp);
+
+	if ( nz + cnt > cap ) {
+	    while ( nz + cnt > cap ) cap *= 2;
+	    if ( !(newrow = intMalloc_dist(cap)) ) ABORT("Malloc fails for rowind[].");
+	    for (p = 0; p < nz; ++p) newrow[p] = S->rowind[p];
+	    SUPERLU_FREE(S->rowind);
+	    S->rowind = newrow;
+	}
+	for (p = 0; p < cnt; ++p) {
+	    k = S->rowind[nz + p] = found[p];
+	    if ( k == j ) S->diag[j] = nz + p;
+	    else if ( k < j ) S->ops += 2 * (S->colptr[k+1] - S->diag[k] - 1);
+	}
+	nz += cnt;
+	S->ops += S->colptr[j] + cnt - S->diag[j] - 1;   /* scale L(:,j) */
+    }
+    S->colptr[n] = S->nnz = nz;
+    SUPERLU_FREE(mark);
+}
+
+static void zbatch_symb_free(zbatch_symb_t *S)
+{
+    SUPERLU_FREE(S->bcolptr);
+    SUPERLU_FREE(S->browind);
+    SUPERLU_FREE(S->bmap);
+    SUPERLU_FREE(S->colptr);
+    SUPERLU_FREE(S->rowind);
+    SUPERLU_FREE(S->diag);
+}
+
+/* Left-looking LU of ZBATCH_LANES interleaved matrices, whose entries in
+   the order of B are in a[]. The factors are stored in lu[], w[] is a zero
+   work vector of size n*ZBATCH_LANES and is zero again on return. A pivot
+   of magnitude below thresh[v] is replaced by +-thresh[v]; a zero pivot
+   that is not replaced is recorded in zpiv[v] (column + 1).
+   Returns the number of replaced pivots. */
+static int zbatch_factor(zbatch_symb_t *S, doublecomplex *a, doublecomplex *lu,
+			 doublecomplex *w, double *thresh, int_t *zpiv)
+{
+    const int V = ZBATCH_LANES;
+    int_t j, k, p, q, pl, *rowind = S->rowind, *colptr = S->colptr;
+    doublecomplex *wi, *wk, *l, piv[ZBATCH_LANES], one = {1.0, 0.0};
+    int v, ntiny = 0;
+
+    for (j = 0; j < S->n; ++j) {
+	for (q = S->bcolptr[j]; q < S->bcolptr[j+1]; ++q) {
+	    wi = &w[S->browind[q] * V];
+	    for (v = 0; v < V; ++v) wi[v] = a[q * V + v];
+	}
+
+	/* w -= L(:,k) * U(k,j), for the k's of U(:,j) in increasing order */
+	for (p = colptr[j]; p < S->diag[j]; ++p) {
+	    k = rowind[p];
+	    wk = &w[k * V];
+	    for (pl = S->diag[k] + 1; pl < colptr[k+1]; ++pl) {
+		wi = &w[rowind[pl] * V];
+		l = &lu[pl * V];
+#pragma omp simd
+		for (v = 0; v < V; ++v) {
+		    wi[v].r -= l[v].r * wk[v].r - l[v].i * wk[v].i;
+		    wi[v].i -= l[v].r * wk[v].i + l[v].i * wk[v].r;
+		}
+	    }
+	}
+
+	wk = &w[j * V];
+	for (v = 0; v < V; ++v) {
+	    if ( slud_z_abs1(&wk[v]) < thresh[v] ) {
+		/* Keep the new diagonal entry with the same sign. */
+		wk[v].r = (wk[v].r < 0.) ? -thresh[v] : thresh[v];
+		wk[v].i = 0.;
+		++ntiny;
+	    } else if ( wk[v].r == 0. && wk[v].i == 0. && !zpiv[v] ) {
+		zpiv[v] = j + 1;
+	    }
+	    slud_z_div(&piv[v], &one, &wk[v]);
+	}
+
+	for (p = colptr[j]; p <= S->diag[j]; ++p) {
+	    wi = &w[rowind[p] * V];
+	    for (v = 0; v < V; ++v) {
+		lu[p * V + v] = wi[v];
+		wi[v].r = wi[v].i = 0.;
+	    }
+	}
+	for (p = S->diag[j] + 1; p < colptr[j+1]; ++p) {
+	    wi = &w[rowind[p] * V];
+#pragma omp simd
+	    for (v = 0; v < V; ++v) {
+		lu[p * V + v].r = wi[v].r * piv[v].r - wi[v].i * piv[v].i;
+		lu[p * V + v].i = wi[v].r * piv[v].i + wi[v].i * piv[v].r;
+		wi[v].r = wi[v].i = 0.;
+	    }
+	}
+    }
+    return ntiny;
+}
+
+/* Solve L*U*y = y for ZBATCH_LANES interleaved right-hand sides. */
+static void zbatch_solve(zbatch_symb_t *S, doublecomplex *lu, doublecomplex *y)
+{
+    const int V = ZBATCH_LANES;
+    int_t j, p, *rowind = S->rowind, *colptr = S->colptr;
+    doublecomplex *yi, *yj, *l, t;
+    int v;
+
+    for (j = 0; j < S->n; ++j) {
+	yj = &y[j * V];
+	for (p = S->diag[j] + 1; p < colptr[j+1]; ++p) {
+	    yi = &y[rowind[p] * V];
+	    l = &lu[p * V];
+#pragma omp simd
+	    for (v = 0; v < V; ++v) {
+		yi[v].r -= l[v].r * yj[v].r - l[v].i * yj[v].i;
+		yi[v].i -= l[v].r * yj[v].i + l[v].i * yj[v].r;
+	    }
+	}
+    }
+    for (j = S->n - 1; j >= 0; --j) {
+	yj = &y[j * V];
+	l = &lu[S->diag[j] * V];
+	for (v = 0; v < V; ++v) {
+	    slud_z_div(&t, &yj[v], &l[v]);
+	    yj[v] = t;
+	}
+	for (p = colptr[j]; p < S->diag[j]; ++p) {
+	    yi = &y[rowind[p] * V];
+	    l = &lu[p * V];
+#pragma omp simd
+	    for (v = 0; v < V; ++v) {
+		yi[v].r -= l[v].r * yj[v].r - l[v].i * yj[v].i;
+		yi[v].i -= l[v].r * yj[v].i + l[v].i * yj[v].r;
+	    }
+	}
+    }
+}
+
+/* Find one row permutation for the whole batch, from the first matrix,
+   and apply it to all of them, with the MC64 scaling if Equil = YES. */
+static int zbatch_rowperm(superlu_dist_options_t *options, int batchCount,
+			  int m, int n, SuperMatrix **A, double **ReqPtr,
+			  double **CeqPtr, DiagScale_t *DiagScale, int **RpivPtr)
+{
+    NCformat *Astore = (NCformat *) A[0]->Store;
+    int_t i, j, *perm;
+    double *R1 = NULL, *C1 = NULL;
+    doublecomplex *a;
+    int d, iinfo = 0, scale = 0;
+    int *perm_r = RpivPtr[0];
+
+    if ( options->RowPerm == NOROWPERM ) {
+	for (i = 0; i < m; ++i) perm_r[i] = i;
+    } else if ( options->RowPerm != MY_PERMR ) {
+	/* MC64 on the first matrix; LargeDiag_HWPM falls back to it. */
+	if ( !(perm = intMalloc_dist(m)) ) ABORT("Malloc fails for perm[].");
+	if ( !(R1 = doubleMalloc_dist(m)) ) ABORT("Malloc fails for R1[].");
+	if ( !(C1 = doubleMalloc_dist(n)) ) ABORT("Malloc fails for C1[].");
+	iinfo = zldperm_dist(5, m, Astore->nnz, Astore->colptr, Astore->rowind,
+			     (doublecomplex *) Astore->nzval, perm, R1, C1);
+	if ( iinfo ) {
+	    printf(".. Matrix 0: LDPERM ERROR %d, no row permutation\n", iinfo);
+	    for (i = 0; i < m; ++i) perm_r[i] = i;
+	} else {
+	    for (i = 0; i < m; ++i) perm_r[i] = perm[i];
+	    scale = ( options->Equil == YES );
+	}
+	SUPERLU_FREE(perm);
+	if ( scale ) {
+	    for (i = 0; i < m; ++i) R1[i] = exp(R1[i]);
+	    for (j = 0; j < n; ++j) C1[j] = exp(C1[j]);
+	}
+    }
+
+    for (d = 0; d < batchCount; ++d) {
+	Astore = (NCformat *) A[d]->Store;
+	a = (doublecomplex *) Astore->nzval;
+	if ( d > 0 ) for (i = 0; i < m; ++i) RpivPtr[d][i] = perm_r[i];
+	if ( scale ) {
+	    /* A <-- diag(R1)*A*diag(C1), and merge R1/C1 into R/C. */
+	    for (j = 0; j < n; ++j)
+		for (i = Astore->colptr[j]; i < Astore->colptr[j+1]; ++i)
+		    zd_mult(&a[i], &a[i], R1[Astore->rowind[i]] * C1[j]);
+	    if ( DiagScale[d] == ROW || DiagScale[d] == BOTH ) {
+		for (i = 0; i < m; ++i) ReqPtr[d][i] *= R1[i];
+	    } else {
+		if ( !(ReqPtr[d] = doubleMalloc_dist(m)) ) ABORT("Malloc fails for R[].");
+		for (i = 0; i < m; ++i) ReqPtr[d][i] = R1[i];
+	    }
+	    if ( DiagScale[d] == COL || DiagScale[d] == BOTH ) {
+		for (j = 0; j < n; ++j) CeqPtr[d][j] *= C1[j];
+	    } else {
+		if ( !(CeqPtr[d] = doubleMalloc_dist(n)) ) ABORT("Malloc fails for C[].");
+		for (j = 0; j < n; ++j) CeqPtr[d][j] = C1[j];
+	    }
+	    DiagScale[d] = BOTH;
+	}
+	for (i = 0; i < Astore->nnz; ++i)
+	    Astore->rowind[i] = perm_r[Astore->rowind[i]];
+    }
+
+    SUPERLU_FREE(R1);
+    SUPERLU_FREE(C1);
+    return iinfo;
+}
+
+/*! \brief Solve a batch of linear systems Ai * Xi = Bi, where all the Ai
+ *  have the same sparsity structure, with the batched CPU engine.
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * zgssvx_batch_cpu() is called by pzgssvx_batch_cpu(), the CPU fallback
+ * of pzgssvx3d_csc_batch(), on the block of the batch owned by a process;
+ * the arguments are the same. The computation is local to the calling
+ * process and is parallelized with OpenMP over the batch.
+ *
+ * Each matrix is equilibrated as in zequil_batch(). The row permutation
+ * (with its MC64 scaling) and the column permutation are computed from
+ * the first matrix and applied to all of them, so the symbolic
+ * factorization is done only once. On exit, RpivPtr[d] and CpivPtr[d]
+ * are the same for all d; each A is overwritten by Pr*R*A*C with its row
+ * indices permuted by Pr, and each B by R*B.
+ *
+ * If options->ReplaceTinyPivot = YES, a pivot of magnitude less than
+ * sqrt(eps)*||A||_1 is replaced by that value. Unless options->IterRefine
+ * = NOREFINE, up to ZBATCH_ITMAX steps of iterative refinement are done.
+ * Berrs[d][k] is the normwise backward error ||R*b - R*A*x||/||R*b|| of
+ * the k-th solution of the d-th system.
+ *
+ * Return value
+ * ============
+ *   = 0 : successful exit; on output, info = 0, or info = j > 0 if the
+ *         j-th pivot of one of the matrices is exactly zero and was not
+ *         replaced; the solutions of that matrix are not computed.
+ *   = -1: the matrices do not all have the same structure; info = -7.
+ * </pre>
+ */
+int
+zgssvx_batch_cpu(superlu_dist_options_t *options, int batchCount,
+		 int m, int n, int nnz, int nrhs, handle_t *SparseMatrix_handles,
+		 doublecomplex **RHSptr, int *ldRHS, double **ReqPtr, double **CeqPtr,
+		 int **RpivPtr, int **CpivPtr, DiagScale_t *DiagScale,
+		 doublecomplex **Xptr, int *ldX, double **Berrs,
+		 SuperLUStat_t *stat, int *info)
+{
+    const int V = ZBATCH_LANES;
+    SuperMatrix **A;
+    NCformat *Astore, *A0store;
+    zbatch_symb_t S;
+    doublecomplex *lu;
+    double *thresh, eps, t;
+    int_t i, *zpiv;
+    int d, nchunk, ntiny = 0, refine;
+    int *perm_r, *perm_c;
+
+    *info = 0;
+    if ( batchCount == 0 ) return 0;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(0, "Enter zgssvx_batch_cpu()");
+#endif
+
+    A = SUPERLU_MALLOC(batchCount * sizeof(SuperMatrix *));
+    for (d = 0; d < batchCount; ++d) A[d] = (SuperMatrix *) SparseMatrix_handles[d];
+
+    /* All the matrices must have the structure of the first one. */
+    A0store = (NCformat *) A[0]->Store;
+    for (d = 1; d < batchCount && !*info; ++d) {
+	Astore = (NCformat *) A[d]->Store;
+	if ( A[d]->Stype != SLU_NC || Astore->nnz != A0store->nnz ) *info = -7;
+	for (i = 0; i <= n && !*info; ++i)
+	    if ( Astore->colptr[i] != A0store->colptr[i] ) *info = -7;
+	for (i = 0; i < A0store->nnz && !*info; ++i)
+	    if ( Astore->rowind[i] != A0store->rowind[i] ) *info = -7;
+    }
+    if ( *info ) {
+	SUPERLU_FREE(A);
+	return -1;
+    }
+
+    /**** equilibration, one row and one column permutation ****/
+    t = SuperLU_timer_();
+    zequil_batch(options, batchCount, m, n, SparseMatrix_handles,
+		 ReqPtr, CeqPtr, DiagScale);
+    stat->utime[EQUIL] = SuperLU_timer_() - t;
+
+    t = SuperLU_timer_();
+    zbatch_rowperm(options, batchCount, m, n, A, ReqPtr, CeqPtr, DiagScale,
+		   RpivPtr);
+    stat->utime[ROWPERM] = SuperLU_timer_() - t;
+
+    t = SuperLU_timer_();
+    get_perm_c_batch(options, 1, SparseMatrix_handles, CpivPtr);
+    for (d = 1; d < batchCount; ++d)
+	for (i = 0; i < n; ++i) CpivPtr[d][i] = CpivPtr[0][i];
+    stat->utime[COLPERM] = SuperLU_timer_() - t;
+    perm_r = RpivPtr[0];
+    perm_c = CpivPtr[0];
+
+    /**** symbolic factorization, once ****/
+    t = SuperLU_timer_();
+    zbatch_symbfact(n, A0store, perm_c, &S);
+    stat->utime[SYMBFAC] = SuperLU_timer_() - t;
+
+#if ( PRNTlevel>=1 )
+    printf(".. Batch of %d: nnz(A) " IFMT ", nnz(L+U) " IFMT ", %d lanes\n",
+	   batchCount, A0store->nnz, S.nnz, V);
+#endif
+
+    /**** numerical factorization ****/
+    t = SuperLU_timer_();
+    nchunk = (batchCount + V - 1) / V;
+    if ( !(lu = doublecomplexMalloc_dist((size_t) nchunk * S.nnz * V)) )
+	ABORT("Malloc fails for lu[].");
+    if ( !(thresh = doubleMalloc_dist(nchunk * V)) ) ABORT("Malloc fails for thresh[].");
+    if ( !(zpiv = intCalloc_dist(nchunk * V)) ) ABORT("Malloc fails for zpiv[].");
+    eps = dmach_dist("Epsilon");
+    for (d = 0; d < nchunk * V; ++d)
+	thresh[d] = ( options->ReplaceTinyPivot == YES ) ?
+	    sqrt(eps) * zlangs_dist("1", A[SUPERLU_MIN(d, batchCount - 1)]) : 0.;
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:ntiny)
+#endif
+    {
+	doublecomplex *w, *apack, *ad;
+	int c, v;
+	int_t q;
+
+	if ( !(w = doublecomplexCalloc_dist(n * V)) ) ABORT("Malloc fails for w[].");
+	if ( !(apack = doublecomplexMalloc_dist(SUPERLU_MAX(A0store->nnz, 1) * V)) )
+	    ABORT("Malloc fails for apack[].");
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+	for (c = 0; c < nchunk; ++c) {
+	    /* Interleave the values of the matrices of this group; the
+	       missing ones in the last group are copies of the last matrix. */
+	    for (v = 0; v < V; ++v) {
+		ad = (doublecomplex *) ((NCformat *)
+			 A[SUPERLU_MIN(c * V + v, batchCount - 1)]->Store)->nzval;
+		for (q = 0; q < A0store->nnz; ++q) apack[q * V + v] = ad[S.bmap[q]];
+	    }
+	    ntiny += zbatch_factor(&S, apack, &lu[(size_t) c * S.nnz * V], w,
+				   &thresh[c * V], &zpiv[c * V]);
+	}
+	SUPERLU_FREE(w);
+	SUPERLU_FREE(apack);
+    }
+    stat->utime[FACT] = SuperLU_timer_() - t;
+    stat->ops[FACT] += S.ops * batchCount;
+    stat->TinyPivots += ntiny;
+    for (d = 0; d < batchCount; ++d)
+	if ( zpiv[d] ) {
+	    *info = zpiv[d];
+	    printf(".. Matrix %d: zero pivot at column " IFMT "\n", d, zpiv[d]);
+	    break;
+	}
+
+    /**** solve, with iterative refinement ****/
+    t = SuperLU_timer_();
+    refine = ( options->IterRefine != NOREFINE );
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+	NCformat *As;
+	doublecomplex *y, *r, *rhs, *x, *a, t;
+	double bn, rn;
+	double berr[ZBATCH_LANES], lstres[ZBATCH_LANES];
+	int active[ZBATCH_LANES], c, v, k, it, nact, dd;
+	int_t i, j, p;
+
+	if ( !(y = doublecomplexMalloc_dist(n * V)) ) ABORT("Malloc fails for y[].");
+	if ( !(r = doublecomplexMalloc_dist(n * V)) ) ABORT("Malloc fails for r[].");
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+	for (c = 0; c < nchunk; ++c) {
+	    for (k = 0; k < nrhs; ++k) {
+		/* y = Pc*Pr*R*b */
+		for (v = 0; v < V; ++v) {
+		    dd = c * V + v;
+		    if ( dd >= batchCount || zpiv[dd] ) {
+			for (i = 0; i < n; ++i) y[i * V + v].r = y[i * V + v].i = 0.;
+			active[v] = 0;
+			continue;
+		    }
+		    rhs = &RHSptr[dd][k * ldRHS[dd]];
+		    if ( DiagScale[dd] == ROW || DiagScale[dd] == BOTH )
+			for (i = 0; i < m; ++i) zd_mult(&rhs[i], &rhs[i], ReqPtr[dd][i]);
+		    for (i = 0; i < m; ++i) y[perm_c[perm_r[i]] * V + v] = rhs[i];
+		    active[v] = 1;
+		    lstres[v] = 3.;
+		}
+		zbatch_solve(&S, &lu[(size_t) c * S.nnz * V], y);
+		for (v = 0; v < V; ++v) {
+		    dd = c * V + v;
+		    if ( !active[v] ) continue;
+		    x = &Xptr[dd][k * ldX[dd]];
+		    for (i = 0; i < n; ++i) x[i] = y[perm_c[i] * V + v];
+		}
+
+		for (it = 0; ; ++it) {
+		    /* r = Pr*R*b - (Pr*R*A*C)*x, on each active lane */
+		    for (nact = 0, v = 0; v < V; ++v) {
+			dd = c * V + v;
+			if ( !active[v] ) {
+			    for (i = 0; i < n; ++i) y[i * V + v].r = y[i * V + v].i = 0.;
+			    continue;
+			}
+			As = (NCformat *) A[dd]->Store;
+			a = (doublecomplex *) As->nzval;
+			rhs = &RHSptr[dd][k * ldRHS[dd]];
+			x = &Xptr[dd][k * ldX[dd]];
+			for (bn = 0., i = 0; i < m; ++i) {
+			    r[v * n + perm_r[i]] = rhs[i];
+			    bn = SUPERLU_MAX(bn, slud_z_abs1(&rhs[i]));
+			}
+			for (j = 0; j < n; ++j)
+			    for (p = As->colptr[j]; p < As->colptr[j+1]; ++p) {
+				zz_mult(&t, &a[p], &x[j]);
+				z_sub(&r[v * n + As->rowind[p]], &r[v * n + As->rowind[p]], &t);
+			    }
+			for (rn = 0., i = 0; i < m; ++i)
+			    rn = SUPERLU_MAX(rn, slud_z_abs1(&r[v * n + i]));
+			berr[v] = (bn > 0.) ? rn / bn : rn;
+			Berrs[dd][k] = berr[v];
+
+			if ( !refine || it == ZBATCH_ITMAX || berr[v] <= eps
+			     || berr[v] * 2. > lstres[v] ) {
+			    active[v] = 0;
+			    for (i = 0; i < n; ++i) y[i * V + v].r = y[i * V + v].i = 0.;
+			    continue;
+			}
+			lstres[v] = berr[v];
+			for (i = 0; i < m; ++i) y[perm_c[i] * V + v] = r[v * n + i];
+			++nact;
+		    }
+		    if ( nact == 0 ) break;
+
+		    zbatch_solve(&S, &lu[(size_t) c * S.nnz * V], y);
+		    for (v = 0; v < V; ++v) {
+			if ( !active[v] ) continue;
+			dd = c * V + v;
+			x = &Xptr[dd][k * ldX[dd]];
+			for (i = 0; i < n; ++i) z_add(&x[i], &x[i], &y[perm_c[i] * V + v]);
+		    }
+		} /* end for it ... */
+
+		/* x <= C*x, the solution of the original system */
+		for (v = 0; v < V; ++v) {
+		    dd = c * V + v;
+		    if ( dd >= batchCount || zpiv[dd] ) continue;
+		    if ( DiagScale[dd] == COL || DiagScale[dd] == BOTH ) {
+			x = &Xptr[dd][k * ldX[dd]];
+			for (i = 0; i < n; ++i) zd_mult(&x[i], &x[i], CeqPtr[dd][i]);
+		    }
+		}
+	    } /* end for k ... nrhs */
+	}
+	SUPERLU_FREE(y);
+	SUPERLU_FREE(r);
+    }
+    stat->utime[SOLVE] = SuperLU_timer_() - t;
+    stat->ops[SOLVE] += 2. * S.nnz * batchCount * nrhs;
+
+    zbatch_symb_free(&S);
+    SUPERLU_FREE(lu);
+    SUPERLU_FREE(thresh);
+    SUPERLU_FREE(zpiv);
+    SUPERLU_FREE(A);
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(0, "Exit zgssvx_batch_cpu()");
+#endif
+    return 0;
+}
+
+/* Broadcast the results for the d-th matrix from process owner: DiagScale,
+ * the permutations, the row indices, the scalings, the values of A, B and
+ * X, and the backward errors. ibuf[] and dbuf[] are work arrays; the
+ * complex values are sent as pairs of doubles. */
+static void zbatch_bcast(int d, int owner, int m, int n, int nrhs,
+			 handle_t *SparseMatrix_handles, doublecomplex **RHSptr,
+			 int *ldRHS, double **ReqPtr, double **CeqPtr,
+			 int **RpivPtr, int **CpivPtr, DiagScale_t *DiagScale,
+			 doublecomplex **Xptr, int *ldX, double **Berrs,
+			 int_t *ibuf, double *dbuf, gridinfo3d_t *grid3d)
+{
+    SuperMatrix *A = (SuperMatrix *) SparseMatrix_handles[d];
+    NCformat *Astore = (NCformat *) A->Store;
+    doublecomplex *a = (doublecomplex *) Astore->nzval, *b, *x;
+    int_t i, p, nnz = Astore->nnz;
+    int k, me = (grid3d->iam == owner), rowequ, colequ;
+
+    if ( me ) {
+	p = 0;
+	ibuf[p++] = DiagScale[d];
+	for (i = 0; i < m; ++i) ibuf[p++] = RpivPtr[d][i];
+	for (i = 0; i < n; ++i) ibuf[p++] = CpivPtr[d][i];
+	for (i = 0; i < nnz; ++i) ibuf[p++] = Astore->rowind[i];
+    }
+    MPI_Bcast(ibuf, 1 + m + n + nnz, mpi_int_t, owner, grid3d->comm);
+    rowequ = (ibuf[0] == ROW || ibuf[0] == BOTH);
+    colequ = (ibuf[0] == COL || ibuf[0] == BOTH);
+
+    if ( !me ) {
+	if ( rowequ && DiagScale[d] != ROW && DiagScale[d] != BOTH &&
+	     !(ReqPtr[d] = doubleMalloc_dist(m)) )
+	    ABORT("Malloc fails for R[].");
+	if ( colequ && DiagScale[d] != COL && DiagScale[d] != BOTH &&
+	     !(CeqPtr[d] = doubleMalloc_dist(n)) )
+	    ABORT("Malloc fails for C[].");
+	DiagScale[d] = (DiagScale_t) ibuf[0];
+	p = 1;
+	for (i = 0; i < m; ++i) RpivPtr[d][i] = ibuf[p++];
+	for (i = 0; i < n; ++i) CpivPtr[d][i] = ibuf[p++];
+	for (i = 0; i < nnz; ++i) Astore->rowind[i] = ibuf[p++];
+    }
+
+    p = 0;
+    if ( me ) {
+	if ( rowequ ) for (i = 0; i < m; ++i) dbuf[p++] = ReqPtr[d][i];
+	if ( colequ ) for (i = 0; i < n; ++i) dbuf[p++] = CeqPtr[d][i];
+	for (i = 0; i < nnz; ++i) { dbuf[p++] = a[i].r; dbuf[p++] = a[i].i; }
+	for (k = 0; k < nrhs; ++k) {
+	    b = &RHSptr[d][k * ldRHS[d]];
+	    x = &Xptr[d][k * ldX[d]];
+	    for (i = 0; i < m; ++i) { dbuf[p++] = b[i].r; dbuf[p++] = b[i].i; }
+	    for (i = 0; i < n; ++i) { dbuf[p++] = x[i].r; dbuf[p++] = x[i].i; }
+	    dbuf[p++] = Berrs[d][k];
+	}
+    } else {
+	p = (rowequ ? m : 0) + (colequ ? n : 0) + 2 * nnz
+	    + (int_t) nrhs * (2 * m + 2 * n + 1);
+    }
+    MPI_Bcast(dbuf, p, MPI_DOUBLE, owner, grid3d->comm);
+
+    if ( !me ) {
+	p = 0;
+	if ( rowequ ) for (i = 0; i < m; ++i) ReqPtr[d][i] = dbuf[p++];
+	if ( colequ ) for (i = 0; i < n; ++i) CeqPtr[d][i] = dbuf[p++];
+	for (i = 0; i < nnz; ++i) { a[i].r = dbuf[p++]; a[i].i = dbuf[p++]; }
+	for (k = 0; k < nrhs; ++k) {
+	    b = &RHSptr[d][k * ldRHS[d]];
+	    x = &Xptr[d][k * ldX[d]];
+	    for (i = 0; i < m; ++i) { b[i].r = dbuf[p++]; b[i].i = dbuf[p++]; }
+	    for (i = 0; i < n; ++i) { x[i].r = dbuf[p++]; x[i].i = dbuf[p++]; }
+	    Berrs[d][k] = dbuf[p++];
+	}
+    }
+}
+
+/*! \brief Solve a batch of linear systems with the batched CPU engine,
+ *  the batch being split among the processes of grid3d.
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * pzgssvx_batch_cpu() is the CPU fallback of pzgssvx3d_csc_batch(), used
+ * when the factorization is not offloaded to a GPU; the arguments are the
+ * same. The batch is split into contiguous blocks, one per process of
+ * grid3d->comm, and each process calls zgssvx_batch_cpu() on its block:
+ * the analysis (permutations and symbolic factorization) is done once per
+ * process and shared by the matrices of its block. The owner of each
+ * matrix then broadcasts its results, so on exit every process holds the
+ * outputs for the whole batch, as if it had solved all of it.
+ *
+ * The statistics cover the whole batch: the operation counts and the
+ * number of tiny pivots are summed over the processes, and the times are
+ * the maxima over the processes.
+ *
+ * Return value
+ * ============
+ *   = 0 : successful exit; on output, info = 0, or info = j > 0 if the
+ *         j-th pivot of one of the matrices is exactly zero and was not
+ *         replaced; the solutions of that matrix are not computed.
+ *   = -1: the matrices do not all have the same structure; info = -7.
+ * </pre>
+ */
+int
+pzgssvx_batch_cpu(superlu_dist_options_t *options, int batchCount,
+		  int m, int n, int nnz, int nrhs, handle_t *SparseMatrix_handles,
+		  doublecomplex **RHSptr, int *ldRHS, double **ReqPtr, double **CeqPtr,
+		  int **RpivPtr, int **CpivPtr, DiagScale_t *DiagScale,
+		  doublecomplex **Xptr, int *ldX, double **Berrs,
+		  gridinfo3d_t *grid3d, SuperLUStat_t *stat, int *info)
+{
+    static const int phases[] = {EQUIL, ROWPERM, COLPERM, SYMBFAC, FACT, SOLVE};
+    int nprocs = grid3d->nprow * grid3d->npcol * grid3d->npdep;
+    int iam = grid3d->iam, lo, hi, d, owner, k, iv[2];
+    double ops0[3], ops[3], t[6];
+    int_t *ibuf, annz;
+    double *dbuf;
+
+    lo = (int) ((long) batchCount * iam / nprocs);
+    hi = (int) ((long) batchCount * (iam + 1) / nprocs);
+    if ( nprocs == 1 )
+	return zgssvx_batch_cpu(options, batchCount, m, n, nnz, nrhs,
+				SparseMatrix_handles, RHSptr, ldRHS, ReqPtr,
+				CeqPtr, RpivPtr, CpivPtr, DiagScale, Xptr, ldX,
+				Berrs, stat, info);
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Enter pzgssvx_batch_cpu()");
+#endif
+
+    ops0[0] = stat->ops[FACT];
+    ops0[1] = stat->ops[SOLVE];
+    ops0[2] = stat->TinyPivots;
+    zgssvx_batch_cpu(options, hi - lo, m, n, nnz, nrhs,
+		     &SparseMatrix_handles[lo], &RHSptr[lo], &ldRHS[lo],
+		     &ReqPtr[lo], &CeqPtr[lo], &RpivPtr[lo], &CpivPtr[lo],
+		     &DiagScale[lo], &Xptr[lo], &ldX[lo], &Berrs[lo], stat, info);
+
+    /* An error on any process, else the largest zero pivot. */
+    iv[0] = *info;
+    iv[1] = -*info;
+    MPI_Allreduce(MPI_IN_PLACE, iv, 2, MPI_INT, MPI_MAX, grid3d->comm);
+    *info = ( iv[1] > 0 ) ? -iv[1] : iv[0];
+    if ( *info < 0 ) return -1;
+
+    /* Statistics of the whole batch. */
+    ops[0] = stat->ops[FACT] - ops0[0];
+    ops[1] = stat->ops[SOLVE] - ops0[1];
+    ops[2] = stat->TinyPivots - ops0[2];
+    MPI_Allreduce(MPI_IN_PLACE, ops, 3, MPI_DOUBLE, MPI_SUM, grid3d->comm);
+    stat->ops[FACT] = ops0[0] + ops[0];
+    stat->ops[SOLVE] = ops0[1] + ops[1];
+    stat->TinyPivots = (int) (ops0[2] + ops[2]);
+    for (k = 0; k < 6; ++k) t[k] = stat->utime[phases[k]];
+    MPI_Allreduce(MPI_IN_PLACE, t, 6, MPI_DOUBLE, MPI_MAX, grid3d->comm);
+    for (k = 0; k < 6; ++k) stat->utime[phases[k]] = t[k];
+
+    /* Give every process the results of the whole batch. */
+    annz = ((NCformat *) ((SuperMatrix *) SparseMatrix_handles[0])->Store)->nnz;
+    if ( !(ibuf = intMalloc_dist(1 + m + n + annz)) ) ABORT("Malloc fails for ibuf[].");
+    if ( !(dbuf = doubleMalloc_dist(m + n + 2 * annz
+				      + (int_t) nrhs * (2 * m + 2 * n + 1))) )
+	ABORT("Malloc fails for dbuf[].");
+    for (d = 0, owner = 0; d < batchCount; ++d) {
+	while ( d >= (int) ((long) batchCount * (owner + 1) / nprocs) ) ++owner;
+	zbatch_bcast(d, owner, m, n, nrhs, SparseMatrix_handles, RHSptr,
+		     ldRHS, ReqPtr, CeqPtr, RpivPtr, CpivPtr, DiagScale,
+		     Xptr, ldX, Berrs, ibuf, dbuf, grid3d);
+    }
+    SUPERLU_FREE(ibuf);
+    SUPERLU_FREE(dbuf);
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit pzgssvx_batch_cpu()");
+#endif
+    return 0;
+}
@@ -30,6 +30,7 @@ iukp = iukp0; /* point to the first block in index[] */
 rukp = rukp0; /* point to the start of nzval[] */
 j = jj0 = 0;  /* After the j-loop, jj0 points to the first block in U
                  outside look-ahead window. */
+int_t la_off = 0; /* next free place in bigU_la */
 
 #if 0
 for (jj = 0; jj < nub; ++jj) assert(perm_u[jj] == jj); /* Sherry */
@@ -91,7 +92,11 @@ while (j < nub && perm_u[2 * j] <= k0 + num_look_aheads)
 #endif
 
     /* Now copy one block U(k,j) to bigU for GEMM, padding zeros up to ldu. */
-    tempu = bigU; /* Copy one block U(k,j) to bigU for GEMM */
+    /* With the task scheduler, the tasks of the previous blocks may still
+       read theirs, so each block gets its own place in bigU_la. */
+    doublecomplex *ublk = sched_tasks ? bigU_la + la_off : bigU;
+    la_off += ldu * ncols;
+    tempu = ublk; /* Copy one block U(k,j) to ublk for GEMM */
     for (jj = iukp; jj < iukp + nsupc; ++jj) {
         segsize = klst - usub[jj];
         if (segsize) {
@@ -105,7 +110,7 @@ while (j < nub && perm_u[2 * j] <= k0 + num_look_aheads)
             tempu += segsize;
         }
     }
-    tempu = bigU; /* set back to the beginning of the buffer */
+    tempu = ublk; /* set back to the beginning of the buffer */
 
     nbrow = lsub[1]; /* number of row subscripts in L(:,k) */
     if (myrow == krow) nbrow = lsub[1] - lsub[3]; /* skip diagonal block for those rows. */
@@ -116,6 +121,49 @@ while (j < nub && perm_u[2 * j] <= k0 + num_look_aheads)
     lptr = lptr0; /* point to the start of index[] in supernode L(:,k) */
     luptr = luptr0;
 
+#ifdef _OPENMP
+    if ( sched_tasks ) {
+	/* One task per block L(i,k). The tasks of U(k,j) write different
+	   blocks of column jb; only the factorization of the column below
+	   waits for them. */
+	int_t lptr1 = lptr, luptr1 = luptr;
+	int temp_nbrow;
+
+#pragma omp atomic
+	stat->ops[FACT] += 8.0 * (flops_t)nbrow * ldu * ncols;
+	for (lb = 0; lb < nlb; lb++) {
+	    ib = lsub[lptr1];
+	    temp_nbrow = lsub[lptr1 + 1];
+#pragma omp task firstprivate(ib, jb, ljb, nsupc, iukp, ldu, ncols, tempu, \
+    lptr1, luptr1, temp_nbrow) depend(in: colsync[ljb])
+	    {
+		int thread_id = omp_get_thread_num();
+		int_t lptr2 = lptr1 + LB_DESCRIPTOR;
+		doublecomplex *tempv = bigV_task + ldt*ldt*thread_id;
+		int_t *gsmap_thread  = gsmap + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
+		int_t *gsmap2_thread = gsmap2 + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
+
+		if (ib < jb) {    /* A(i,j) is in U. */
+		    zgemm_scatter_u (ib, jb, nsupc, iukp, xsup, klst, lptr2,
+				     temp_nbrow, ncols, ldu,
+				     &lusup[luptr1 + (knsupc - ldu) * nsupr], nsupr,
+				     tempu, fused_max, lsub, usub, tempv,
+				     gsmap_thread, gsmap2_thread,
+				     Ufstnz_br_ptr, Unzval_br_ptr, grid);
+		} else {          /* A(i,j) is in L. */
+		    zgemm_scatter_l (ib, ljb, nsupc, iukp, xsup, klst, lptr2,
+				     temp_nbrow, ncols, ldu,
+				     &lusup[luptr1 + (knsupc - ldu) * nsupr], nsupr,
+				     tempu, fused_max, usub, lsub, tempv,
+				     gsmap_thread, gsmap2_thread,
+				     Lrowind_bc_ptr, Lnzval_bc_ptr, grid);
+		}
+	    }
+	    lptr1 += LB_DESCRIPTOR + temp_nbrow;
+	    luptr1 += temp_nbrow;
+	}
+    } else
+#endif
 #ifdef _OPENMP
     /* Sherry -- examine all the shared variables ??
        'firstprivate' ensures that the private variables are initialized
@@ -149,8 +197,8 @@ while (j < nub && perm_u[2 * j] <= k0 + num_look_aheads)
 #endif
         doublecomplex * tempv = bigV + ldt*ldt*thread_id;
 
-        int *indirect_thread  = indirect + ldt * thread_id;
-        int *indirect2_thread = indirect2 + ldt * thread_id;
+        int_t *gsmap_thread  = gsmap + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
+        int_t *gsmap2_thread = gsmap2 + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
         ib = lsub[lptr];        /* block number of L(i,k) */
         temp_nbrow = lsub[lptr + 1];    /* Number of full rows. */
 	/* assert (temp_nbrow <= nbrow); */
@@ -159,37 +207,22 @@ while (j < nub && perm_u[2 * j] <= k0 + num_look_aheads)
 
 	/*if (thread_id == 0) tt_start = SuperLU_timer_();*/
 
-        /* calling gemm */
+        /* calling gemm and scattering the output */
 	stat->ops[FACT] += 8.0 * (flops_t)temp_nbrow * ldu * ncols;
-#if defined (USE_VENDOR_BLAS)
-        zgemm_("N", "N", &temp_nbrow, &ncols, &ldu, &alpha,
-                   &lusup[luptr + (knsupc - ldu) * nsupr], &nsupr,
-                   tempu, &ldu, &beta, tempv, &temp_nbrow, 1, 1);
-#else
-        zgemm_("N", "N", &temp_nbrow, &ncols, &ldu, &alpha,
-                   &lusup[luptr + (knsupc - ldu) * nsupr], &nsupr,
-                   tempu, &ldu, &beta, tempv, &temp_nbrow );
-#endif
-
-#if 0
-	if (thread_id == 0) {
-	    tt_end = SuperLU_timer_();
-	    LookAheadGEMMTimer += tt_end - tt_start;
-	    tt_start = tt_end;
-	}
-#endif
-        /* Now scattering the output. */
         if (ib < jb) {    /* A(i,j) is in U. */
-            zscatter_u (ib, jb,
-                       nsupc, iukp, xsup,
-                       klst, temp_nbrow,
-                       lptr, temp_nbrow, lsub,
-                       usub, tempv, Ufstnz_br_ptr, Unzval_br_ptr, grid);
+            zgemm_scatter_u (ib, jb, nsupc, iukp, xsup, klst, lptr,
+                             temp_nbrow, ncols, ldu,
+                             &lusup[luptr + (knsupc - ldu) * nsupr], nsupr,
+                             tempu, fused_max, lsub, usub, tempv,
+                             gsmap_thread, gsmap2_thread,
+                             Ufstnz_br_ptr, Unzval_br_ptr, grid);
         } else {          /* A(i,j) is in L. */
-            zscatter_l (ib, ljb, nsupc, iukp, xsup, klst, temp_nbrow, lptr,
-                       temp_nbrow, usub, lsub, tempv,
-                       indirect_thread, indirect2_thread,
-                       Lrowind_bc_ptr, Lnzval_bc_ptr, grid);
+            zgemm_scatter_l (ib, ljb, nsupc, iukp, xsup, klst, lptr,
+                             temp_nbrow, ncols, ldu,
+                             &lusup[luptr + (knsupc - ldu) * nsupr], nsupr,
+                             tempu, fused_max, usub, lsub, tempv,
+                             gsmap_thread, gsmap2_thread,
+                             Lrowind_bc_ptr, Lnzval_bc_ptr, grid);
         }
 
         ++current_b;         /* Move to next block. */
@@ -226,6 +259,12 @@ while (j < nub && perm_u[2 * j] <= k0 + num_look_aheads)
            singularity.  */
         factored[kk] = 0;
 
+#ifdef _OPENMP
+#pragma omp task if (mpi_tasks) firstprivate(kk, kk0, look_id) \
+    private(lk, lsub1, lusup1, send_req, msgcnt, scp, pj) \
+    depend(inout: colsync[ljb]) depend(inout: mpi_token)
+#endif
+      {
         double tt1 = SuperLU_timer_();
 
         PZGSTRF2(options, kk0, kk, thresh, Glu_persist, grid, Llu,
@@ -275,6 +314,7 @@ while (j < nub && perm_u[2 * j] <= k0 + num_look_aheads)
 #endif
             }  /* end if ( ToSendR[lk][pj] != SLU_EMPTY ) */
         } /* end for pj ... */
+      }
     } /* end if( look_ahead[kk] == k0 && kcol == mycol ) */
 } /* end while j < nub and perm_u[j] <k0+NUM_LOOK_AHEAD */
 
@@ -279,3 +279,173 @@ zscatter_u (int ib,
 
 
 
+/* C(rowmap[i] + colmap[j]*ldc) -= V(i,j), V is m x n with LDA ldv. */
+static void
+zscatter_map (int m, int n, doublecomplex *V, int ldv, doublecomplex *C, int ldc,
+	      int_t *rowmap, int_t *colmap)
+{
+    int i, j;
+    doublecomplex *cj;
+
+    for (j = 0; j < n; ++j) {
+	cj = &C[(size_t) colmap[j] * ldc];
+#if (_OPENMP>=201307)
+#pragma omp simd
+#endif
+	for (i = 0; i < m; ++i)
+	    z_sub(&cj[rowmap[i]], &cj[rowmap[i]], &V[i + (size_t) j * ldv]);
+    }
+}
+
+/*! \brief Block update L(i,j) -= L(i,k) * U(k,j), with the product
+ * scattered as it is computed.
+ *
+ * <pre>
+ * The arguments are those of zscatter_l, except that the product is
+ * given by its factors: lval (LDA ldl) holds the temp_nbrow x ldu block
+ * L(i,k), and uval (LDA ldu) the ncols nonzero columns of U(k,j), padded
+ * with zeros to ldu rows. If the destination is a dense block of L(:,j),
+ * superlu_zgemm_scatter updates it with NULL maps, that is, with one
+ * GEMM unless ldu is small. Otherwise, if ldu <= GEMM_SCATTER_MAXK or
+ * temp_nbrow*ncols*ldu <= fused_max (see sp_ienv_dist(12)),
+ * superlu_zgemm_scatter adds the product through the index maps; a
+ * larger product is computed in tempv[] first.
+ * </pre>
+ */
+void
+zgemm_scatter_l (int ib, int ljb, int nsupc, int_t iukp, int_t* xsup,
+		 int klst, int_t lptr, int temp_nbrow, int ncols, int ldu,
+		 doublecomplex *lval, int ldl, doublecomplex *uval, int fused_max,
+		 int_t* usub, int_t* lsub, doublecomplex *tempv,
+		 int_t* indirect_thread, int_t* indirect2,
+		 int_t ** Lrowind_bc_ptr, doublecomplex **Lnzval_bc_ptr,
+		 gridinfo_t * grid)
+{
+    int_t rel, i, jj;
+    int c, dense_row = 1;
+    doublecomplex *nzval;
+    int_t *index = Lrowind_bc_ptr[ljb];
+    int_t ldv = index[1];       /* LDA of the destination lusup. */
+    int_t lptrj = BC_HEADER;
+    int_t luptrj = 0;
+    int_t ijb = index[lptrj];
+
+    if ( temp_nbrow <= 0 || ncols <= 0 ) return;
+    while (ijb != ib)  /* Search for destination block L(i,j) */
+    {
+        luptrj += index[lptrj + 1];
+        lptrj += LB_DESCRIPTOR + index[lptrj + 1];
+        ijb = index[lptrj];
+    }
+
+    /* Row map, as in zscatter_l. */
+    doublecomplex one = {1.0, 0.0}, zero = {0.0, 0.0};
+    int_t fnz = FstBlockC (ib);
+    int_t dest_nbrow;
+    lptrj += LB_DESCRIPTOR;
+    dest_nbrow=index[lptrj - 1];
+    for (i = 0; i < dest_nbrow; ++i) {
+        rel = index[lptrj + i] - fnz;
+        indirect_thread[rel] = i;
+    }
+    for (i = 0; i < temp_nbrow; ++i) {
+        rel = lsub[lptr + i] - fnz;
+        indirect2[i] = indirect_thread[rel];
+	dense_row &= indirect2[i] == i;
+    }
+
+    /* Column map: the columns of L(:,j) with a nonzero segment in U(k,j). */
+    for (jj = 0, c = 0; jj < nsupc; ++jj)
+        if ( klst - usub[iukp + jj] ) indirect_thread[c++] = jj;
+
+    nzval = Lnzval_bc_ptr[ljb] + luptrj; /* Destination block L(i,j) */
+    if ( dense_row && ncols == nsupc ) {
+	superlu_zgemm_scatter(temp_nbrow, ncols, ldu, lval, ldl, uval, ldu,
+			      nzval, ldv, NULL, NULL);
+    } else if ( ldu <= GEMM_SCATTER_MAXK
+		|| (double) temp_nbrow * ncols * ldu <= fused_max ) {
+	superlu_zgemm_scatter(temp_nbrow, ncols, ldu, lval, ldl, uval, ldu,
+			      nzval, ldv, indirect2, indirect_thread);
+    } else {
+	superlu_zgemm("N", "N", temp_nbrow, ncols, ldu, one, lval, ldl,
+		      uval, ldu, zero, tempv, temp_nbrow);
+	zscatter_map(temp_nbrow, ncols, tempv, temp_nbrow, nzval, ldv,
+		     indirect2, indirect_thread);
+    }
+} /* zgemm_scatter_l */
+
+/*! \brief Block update U(i,j) -= L(i,k) * U(k,j), with the product
+ * scattered as it is computed.
+ *
+ * <pre>
+ * The counterpart of zgemm_scatter_l for a destination block in U;
+ * the arguments are those of zscatter_u, with the factors lval and uval
+ * of the product, and indirect_thread[] and indirect2[] for the maps.
+ * </pre>
+ */
+void
+zgemm_scatter_u (int ib, int jb, int nsupc, int_t iukp, int_t * xsup,
+		 int klst, int_t lptr, int temp_nbrow, int ncols, int ldu,
+		 doublecomplex *lval, int ldl, doublecomplex *uval, int fused_max,
+		 int_t* lsub, int_t* usub, doublecomplex *tempv,
+		 int_t* indirect_thread, int_t* indirect2,
+		 int_t ** Ufstnz_br_ptr, doublecomplex **Unzval_br_ptr,
+		 gridinfo_t * grid)
+{
+    int_t jj, i, fnz, fnz0 = -1, minrow;
+    int c, dense = 1;
+    int_t ilst = FstBlockC (ib + 1);
+    int_t lib = LBi (ib, grid);
+    int_t *index = Ufstnz_br_ptr[lib];
+    int_t iuip_lib, ruip_lib, ruip0 = 0;
+    doublecomplex one = {1.0, 0.0}, zero = {0.0, 0.0};
+
+    if ( temp_nbrow <= 0 || ncols <= 0 ) return;
+    iuip_lib = BR_HEADER;
+    ruip_lib = 0;
+    int_t ijb = index[iuip_lib];
+    while (ijb < jb) {   /* Search for destination block. */
+        ruip_lib += index[iuip_lib + 1];
+        iuip_lib += UB_DESCRIPTOR + SuperSize (ijb);
+        ijb = index[iuip_lib];
+    }
+    /* Skip descriptor. Now point to fstnz index of block U(i,j). */
+    iuip_lib += UB_DESCRIPTOR;
+
+    /* Row map, relative to the first row of L(i,k). */
+    minrow = lsub[lptr];
+    for (i = 1; i < temp_nbrow; ++i) minrow = SUPERLU_MIN(minrow, lsub[lptr + i]);
+    for (i = 0; i < temp_nbrow; ++i) {
+	indirect2[i] = lsub[lptr + i] - minrow;
+	dense &= indirect2[i] == i;
+    }
+
+    /* Column map: where row minrow of each nonzero column would be. */
+    for (jj = 0, c = 0; jj < nsupc; ++jj) {
+        fnz = index[iuip_lib++];
+        if ( klst - usub[iukp + jj] ) {
+	    if ( c == 0 ) {
+		fnz0 = fnz;
+		ruip0 = ruip_lib;
+	    }
+	    dense &= fnz == fnz0;
+	    indirect_thread[c++] = ruip_lib + minrow - fnz;
+	}
+        ruip_lib += ilst - fnz;
+    }
+
+    if ( dense && ncols == nsupc ) {
+	superlu_zgemm_scatter(temp_nbrow, ncols, ldu, lval, ldl, uval, ldu,
+			      &Unzval_br_ptr[lib][ruip0 + minrow - fnz0],
+			      ilst - fnz0, NULL, NULL);
+    } else if ( ldu <= GEMM_SCATTER_MAXK
+		|| (double) temp_nbrow * ncols * ldu <= fused_max ) {
+	superlu_zgemm_scatter(temp_nbrow, ncols, ldu, lval, ldl, uval, ldu,
+			      Unzval_br_ptr[lib], 1, indirect2, indirect_thread);
+    } else {
+	superlu_zgemm("N", "N", temp_nbrow, ncols, ldu, one, lval, ldl,
+		      uval, ldu, zero, tempv, temp_nbrow);
+	zscatter_map(temp_nbrow, ncols, tempv, temp_nbrow, Unzval_br_ptr[lib], 1,
+		     indirect2, indirect_thread);
+    }
+} /* zgemm_scatter_u */
@@ -28,7 +28,7 @@ void validateInput_pzgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
     int Fact = options->Fact;
     if (Fact < 0 || Fact > FACTORED)
         *info = -1;
-    else if (options->RowPerm < 0 || options->RowPerm > MY_PERMR)
+    else if (options->RowPerm < 0 || options->RowPerm > LargeDiag_AUCTION)
         *info = -1;
     else if (options->ColPerm < 0 || options->ColPerm > MY_PERMC)
         *info = -1;
@@ -390,11 +390,17 @@ void zperform_LargeDiag_MC64(
     int_t *rowptr = (Astore)->rowptr;
     int_t *colind = (Astore)->colind;
 
-    NCformat *GAstore = (NCformat *)GA->Store;
-    int_t *colptr = (GAstore)->colptr;
-    int_t *rowind = (GAstore)->rowind;
-    int_t nnz = (GAstore)->nnz;
-    doublecomplex *a_GA = (doublecomplex *)(GAstore)->nzval;
+    /* GA is not gathered for the auction with parallel symbfact. */
+    NCformat *GAstore = NULL;
+    int_t *colptr = NULL, *rowind = NULL, nnz = 0;
+    doublecomplex *a_GA = NULL;
+    if (options->RowPerm == LargeDiag_MC64 || options->ParSymbFact == NO) {
+        GAstore = (NCformat *)GA->Store;
+        colptr = GAstore->colptr;
+        rowind = GAstore->rowind;
+        nnz = GAstore->nnz;
+        a_GA = (doublecomplex *)GAstore->nzval;
+    }
 
     if (job == 5) {
         R1 = doubleMalloc_dist(m);
@@ -406,7 +412,10 @@ void zperform_LargeDiag_MC64(
     }
 
     // int iinfo;
-    zfindRowPerm_MC64(grid, job, m, n, nnz,
+    if (options->RowPerm == LargeDiag_AUCTION)
+        *iinfo = pzldperm_dist(A, grid, perm_r, R1, C1);
+    else
+        zfindRowPerm_MC64(grid, job, m, n, nnz,
 		      colptr, rowind,
 		      a_GA, Equil, perm_r, R1, C1, iinfo);
 
@@ -429,11 +438,11 @@ void zperform_LargeDiag_MC64(
                 ScalePermstruct->DiagScale = BOTH;
                 *rowequ = *colequ = 1;
             } /* end if Equil */
-            zpermute_global_A( m, n, colptr, rowind, perm_r);
+            if (GAstore) zpermute_global_A( m, n, colptr, rowind, perm_r);
             SUPERLU_FREE(R1);
             SUPERLU_FREE(C1);
         } else {
-            zpermute_global_A( m, n, colptr, rowind, perm_r);
+            if (GAstore) zpermute_global_A( m, n, colptr, rowind, perm_r);
         }
     }
     else
@@ -480,12 +489,6 @@ void zperform_row_permutation(
     LOG_FUNC_ENTER();
     #endif
     int_t *perm_r = ScalePermstruct->perm_r;
-    /* Get NC format data from SuperMatrix GA */
-    NCformat* GAstore = (NCformat *)GA->Store;
-    int_t* colptr = GAstore->colptr;
-    int_t* rowind = GAstore->rowind;
-    int_t nnz = GAstore->nnz;
-    doublecomplex* a_GA = (doublecomplex *)GAstore->nzval;
 
     int iam = grid->iam;
     /* ------------------------------------------------------------
@@ -501,9 +504,12 @@ void zperform_row_permutation(
         {
             if (options->RowPerm == MY_PERMR)
             {
-                applyRowPerm(colptr, rowind, perm_r, n);
+                /* Get NC format data from SuperMatrix GA */
+                NCformat *GAstore = (NCformat *)GA->Store;
+                applyRowPerm(GAstore->colptr, GAstore->rowind, perm_r, n);
             }
-            else if (options->RowPerm == LargeDiag_MC64)
+            else if (options->RowPerm == LargeDiag_MC64 ||
+                     options->RowPerm == LargeDiag_AUCTION)
             {
 
                 zperform_LargeDiag_MC64(options, Fact,
@@ -120,3 +120,142 @@ int superlu_ztrsv(char *uplo, char *trans, char *diag,
     return 0;
 }
 
+
+#define GS_MR 4   /* rows of a register tile of superlu_zgemm_scatter */
+#define GS_NR 4   /* columns of a register tile */
+
+/* C(rowmap[i], colmap[j]) -= (A*B)(i,j) with k = K fixed at compile time,
+   two columns of C at a time; a row of A is loaded once for both. */
+#define GS_SMALL_KERNEL(K)                                                \
+static void zgemm_scatter_k##K(int m, int n, doublecomplex *A, int lda,   \
+                               doublecomplex *B, int ldb,                 \
+                               doublecomplex *C, int ldc,                 \
+                               int_t *rowmap, int_t *colmap)              \
+{                                                                         \
+    double br0[K], bi0[K], br1[K], bi1[K], sr0, si0, sr1, si1, ar, ai;    \
+    doublecomplex *c0, *c1;                                               \
+    int_t r;                                                              \
+    int i, j, j1, p;                                                      \
+                                                                          \
+    for (j = 0; j < n; j += 2) {                                          \
+        j1 = SUPERLU_MIN(j + 1, n - 1);                                   \
+        for (p = 0; p < K; ++p) {                                         \
+            br0[p] = B[p + (size_t) j * ldb].r;                           \
+            bi0[p] = B[p + (size_t) j * ldb].i;                           \
+            br1[p] = j1 > j ? B[p + (size_t) j1 * ldb].r : 0.0;           \
+            bi1[p] = j1 > j ? B[p + (size_t) j1 * ldb].i : 0.0;           \
+        }                                                                 \
+        c0 = &C[(size_t) (colmap ? colmap[j] : j) * ldc];                 \
+        c1 = &C[(size_t) (colmap ? colmap[j1] : j1) * ldc];               \
+        GS_SIMD                                                           \
+        for (i = 0; i < m; ++i) {                                         \
+            sr0 = si0 = sr1 = si1 = 0.0;                                  \
+            for (p = 0; p < K; ++p) {                                     \
+                ar = A[i + (size_t) p * lda].r;                           \
+                ai = A[i + (size_t) p * lda].i;                           \
+                sr0 += ar * br0[p] - ai * bi0[p];                         \
+                si0 += ar * bi0[p] + ai * br0[p];                         \
+                sr1 += ar * br1[p] - ai * bi1[p];                         \
+                si1 += ar * bi1[p] + ai * br1[p];                         \
+            }                                                             \
+            r = rowmap ? rowmap[i] : i;                                   \
+            c0[r].r -= sr0;                                               \
+            c0[r].i -= si0;                                               \
+            c1[r].r -= sr1;                                               \
+            c1[r].i -= si1;                                               \
+        }                                                                 \
+    }                                                                     \
+}
+
+#if (_OPENMP>=201307)
+#define GS_SIMD _Pragma("omp simd private(sr0, si0, sr1, si1, ar, ai, p, r)")
+#else
+#define GS_SIMD
+#endif
+GS_SMALL_KERNEL(1)
+GS_SMALL_KERNEL(2)
+GS_SMALL_KERNEL(3)
+GS_SMALL_KERNEL(4)
+GS_SMALL_KERNEL(5)
+GS_SMALL_KERNEL(6)
+GS_SMALL_KERNEL(7)
+GS_SMALL_KERNEL(8)
+#undef GS_SIMD
+
+/*! \brief C(rowmap[i], colmap[j]) -= (A*B)(i,j), without storing A*B.
+ *
+ * <pre>
+ * A is m x k (LDA lda), B is k x n (LDA ldb), and C(r, c) is
+ * C[r + c*ldc]. rowmap = NULL stands for rowmap[i] = i, colmap = NULL
+ * for colmap[j] = j. When both are NULL, the destination is a dense
+ * block and the update is one zgemm. Otherwise, A*B is computed in
+ * GS_MR x GS_NR tiles held in registers, the real and imaginary parts
+ * apart, and each tile is subtracted from C through the maps; the maps
+ * must not repeat an entry. Each k up to GEMM_SCATTER_MAXK = 8, dense
+ * destination or not, has a kernel of its own.
+ * </pre>
+ */
+int superlu_zgemm_scatter(int m, int n, int k, doublecomplex *A, int lda,
+                          doublecomplex *B, int ldb, doublecomplex *C, int ldc,
+                          int_t *rowmap, int_t *colmap)
+{
+    doublecomplex alpha = {-1.0, 0.0}, beta = {1.0, 0.0};
+    double cr[GS_NR][GS_MR], ci[GS_NR][GS_MR], br, bi;
+    doublecomplex *a, *b, *cj, *cij;
+    int i, j, p, ii, jj, mr, nr;
+
+    if ( m <= 0 || n <= 0 || k <= 0 ) return 0;
+    switch ( k ) {
+      case 1: zgemm_scatter_k1(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 2: zgemm_scatter_k2(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 3: zgemm_scatter_k3(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 4: zgemm_scatter_k4(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 5: zgemm_scatter_k5(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 6: zgemm_scatter_k6(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 7: zgemm_scatter_k7(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 8: zgemm_scatter_k8(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+    }
+    if ( !rowmap && !colmap )
+        return superlu_zgemm("N", "N", m, n, k, alpha, A, lda, B, ldb,
+                             beta, C, ldc);
+
+    for (j = 0; j < n; j += GS_NR) {
+        nr = SUPERLU_MIN(GS_NR, n - j);
+        for (i = 0; i < m; i += GS_MR) {
+            mr = SUPERLU_MIN(GS_MR, m - i);
+            for (jj = 0; jj < GS_NR; ++jj)
+                for (ii = 0; ii < GS_MR; ++ii) cr[jj][ii] = ci[jj][ii] = 0.0;
+
+            for (p = 0; p < k; ++p) {
+                a = &A[i + (size_t) p * lda];
+                b = &B[p + (size_t) j * ldb];
+                for (jj = 0; jj < nr; ++jj) {
+                    br = b[(size_t) jj * ldb].r;
+                    bi = b[(size_t) jj * ldb].i;
+                    for (ii = 0; ii < mr; ++ii) {
+                        cr[jj][ii] += a[ii].r * br - a[ii].i * bi;
+                        ci[jj][ii] += a[ii].r * bi + a[ii].i * br;
+                    }
+                }
+            }
+
+            for (jj = 0; jj < nr; ++jj) {
+                cj = &C[(size_t) (colmap ? colmap[j + jj] : j + jj) * ldc];
+                for (ii = 0; ii < mr; ++ii) {
+                    cij = &cj[rowmap ? rowmap[i + ii] : i + ii];
+                    cij->r -= cr[jj][ii];
+                    cij->i -= ci[jj][ii];
+                }
+            }
+        }
+    }
+    return 0;
+}
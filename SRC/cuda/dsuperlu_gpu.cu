@@ -1702,7 +1702,7 @@ int dreduceAllAncestors3d_GPU (
     // first synchronize all gpu streams
     int superlu_acc_offload =   HyP->superlu_acc_offload;
 
-    int_t maxLvl = log2i( (int_t) grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil( (int_t) grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
     gridinfo_t* grid = &(grid3d->grid2d);
     int* gpuLUreduced = factStat->gpuLUreduced;
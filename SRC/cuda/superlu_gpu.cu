@@ -1829,7 +1829,7 @@ int_t reduceAllAncestors3d_GPU(int_t ilvl, int_t* myNodeCount,
 
 
 
-	int_t maxLvl = log2i( (int_t) grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil( (int_t) grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	gridinfo_t* grid = &(grid3d->grid2d);
 	int_t* gpuLUreduced = factStat->gpuLUreduced;
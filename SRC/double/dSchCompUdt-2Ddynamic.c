@@ -245,7 +245,7 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 
          /* Gather U(k,:) into buffer bigU[] to prepare for GEMM */
 #ifdef _OPENMP
-#pragma omp parallel for firstprivate(iukp, rukp) \
+#pragma omp parallel for if (!sched_tasks) firstprivate(iukp, rukp) \
     private(j,tempu, jb, nsupc,ljb,segsize, lead_zero, jj, i) \
     default (shared) schedule(CPU_SCHEDULE_STRATEGY)
 #endif
@@ -305,7 +305,7 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 
      /* Loop through the look-ahead blocks to copy Lval into the buffer */
 #ifdef _OPENMP
-#pragma omp parallel for private(j,jj,tempu,tempv) default (shared)
+#pragma omp parallel for if (!sched_tasks) private(j,jj,tempu,tempv) default (shared)
 #endif
      for (i = 0; i < lookAheadBlk; ++i) {
 	 int StRowDest, temp_nbrow;
@@ -345,8 +345,8 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 
      /* Loop through the remaining blocks to copy Lval into the buffer */
 #ifdef _OPENMP
-#pragma omp parallel for private(i,j,jj,tempu,tempv) default (shared) \
-    schedule(CPU_SCHEDULE_STRATEGY)
+#pragma omp parallel for if (!sched_tasks) private(i,j,jj,tempu,tempv) \
+    default (shared) schedule(CPU_SCHEDULE_STRATEGY)
 #endif
      for (int i = 0; i < RemainBlk; ++i) {
          int StRowDest, temp_nbrow;
@@ -403,9 +403,56 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
  	 flops_t flps = 2.0 * (flops_t)Lnbrow * ldu * ncols;
 	 LookAheadScatterMOP += 3 * Lnbrow * ncols; /* scatter-add */
 	 schur_flop_counter += flps;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
 	 stat->ops[FACT]    += flps;
 	 LookAheadGEMMFlOp  += flps;
 
+#ifdef _OPENMP
+	 if ( sched_tasks ) {
+	     /* One task per block U(k,j), for all the look-ahead rows. */
+	     for (j = jj0; j < nub; ++j) {
+#pragma omp task firstprivate(j, ldu)
+	     {
+		 int thread_id = omp_get_thread_num();
+		 int_t *gsmap_thread  = gsmap + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
+		 int_t *gsmap2_thread = gsmap2 + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
+		 double *tempv1 = bigV_task + ldt*ldt*thread_id;
+		 int_t iukp = Ublock_info[j].iukp;
+		 int jb = Ublock_info[j].jb;
+		 int nsupc = SuperSize(jb);
+		 int ljb = LBj (jb, grid);
+		 int st_col = j > jj0 ? Ublock_info[j-1].full_u_cols : 0;
+		 int ncols = Ublock_info[j].full_u_cols - st_col;
+
+		 for (int lb = 0; lb < lookAheadBlk; ++lb) {
+		     int_t lptr = lookAhead_lptr[lb];
+		     int ib = lookAhead_ib[lb];
+		     int temp_nbrow = lsub[lptr+1];
+		     int cum_nrow = (lb==0 ? 0 : lookAheadFullRow[lb-1]);
+		     lptr += LB_DESCRIPTOR;
+
+		     if ( ib < jb ) {
+			 dgemm_scatter_u (ib, jb, nsupc, iukp, xsup, klst, lptr,
+					  temp_nbrow, ncols, ldu,
+					  &lookAhead_L_buff[cum_nrow], Lnbrow,
+					  &bigU[st_col*ldu], fused_max, lsub, usub,
+					  tempv1, gsmap_thread, gsmap2_thread,
+					  Ufstnz_br_ptr, Unzval_br_ptr, grid);
+		     } else {
+			 dgemm_scatter_l (ib, ljb, nsupc, iukp, xsup, klst, lptr,
+					  temp_nbrow, ncols, ldu,
+					  &lookAhead_L_buff[cum_nrow], Lnbrow,
+					  &bigU[st_col*ldu], fused_max, usub, lsub,
+					  tempv1, gsmap_thread, gsmap2_thread,
+					  Lrowind_bc_ptr, Lnzval_bc_ptr, grid);
+		     }
+		 }
+	     }
+	     }
+	 } else
+#endif
 #ifdef _OPENMP
 #pragma omp parallel default (shared) private(thread_id)
 	 {
@@ -426,17 +473,16 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 	      (# of lookAheadBlk in L(:,k)) X (# of blocks in U(k,:))
 	   */
 
-	   int i = sizeof(int);
-	   int* indirect_thread    = indirect + (ldt + CACHELINE/i) * thread_id;
-	   int* indirect2_thread   = indirect2 + (ldt + CACHELINE/i) * thread_id;
+	   int_t *gsmap_thread  = gsmap + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
+	   int_t *gsmap2_thread = gsmap2 + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
 
 #pragma omp for \
     private (nsupc,ljb,lptr,ib,temp_nbrow,cum_nrow)	\
     schedule(dynamic)
 #else /* not use _OPENMP */
 	   thread_id = 0;
-	   int* indirect_thread    = indirect;
-	   int* indirect2_thread   = indirect2;
+	   int_t *gsmap_thread  = gsmap;
+	   int_t *gsmap2_thread = gsmap2;
 #endif
 	   /* Each thread is assigned one loop index ij, responsible for
 	      block update L(lb,k) * U(k,j) -> tempv[]. */
@@ -484,56 +530,20 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 	    gemm_max_k = SUPERLU_MAX(gemm_max_k, ldu);
 #endif
 
-#if defined (USE_VENDOR_BLAS)
-            dgemm_("N", "N", &temp_nbrow, &ncols, &ldu, &alpha,
-		   //&lookAhead_L_buff[(knsupc-ldu)*Lnbrow+cum_nrow], &Lnbrow,
-		   &lookAhead_L_buff[cum_nrow], &Lnbrow,
-		   &tempu[st_col*ldu], &ldu, &beta, tempv1, &temp_nbrow, 1, 1);
-#else
-            dgemm_("N", "N", &temp_nbrow, &ncols, &ldu, &alpha,
-		   //&lookAhead_L_buff[(knsupc-ldu)*Lnbrow+cum_nrow], &Lnbrow,
-		   &lookAhead_L_buff[cum_nrow], &Lnbrow,
-		   &tempu[st_col*ldu], &ldu, &beta, tempv1, &temp_nbrow);
-#endif
-
-#if (PRNTlevel>=1 )
-	    if (thread_id == 0) {
-		tt_end = SuperLU_timer_();
-		LookAheadGEMMTimer += tt_end - tt_start;
-		tt_start = tt_end;
-	    }
-#endif
             if ( ib < jb ) {
-                dscatter_u (
-				 ib, jb,
-				 nsupc, iukp, xsup,
-				 klst, temp_nbrow,
-				 lptr, temp_nbrow, lsub,
-				 usub, tempv1,
-				 Ufstnz_br_ptr, Unzval_br_ptr,
-				 grid
-			        );
+                dgemm_scatter_u (ib, jb, nsupc, iukp, xsup, klst, lptr,
+				 temp_nbrow, ncols, ldu,
+				 &lookAhead_L_buff[cum_nrow], Lnbrow,
+				 &tempu[st_col*ldu], fused_max, lsub, usub,
+				 tempv1, gsmap_thread, gsmap2_thread,
+				 Ufstnz_br_ptr, Unzval_br_ptr, grid);
             } else {
-#if 0
-		//#ifdef USE_VTUNE
-	    __SSC_MARK(0x111);// start SDE tracing, note uses 2 underscores
-	    __itt_resume(); // start VTune, again use 2 underscores
-#endif
-                dscatter_l (
-				 ib, ljb,
-				 nsupc, iukp, xsup,
- 				 klst, temp_nbrow,
-				 lptr, temp_nbrow,
-				 usub, lsub, tempv1,
-				 indirect_thread, indirect2_thread,
-				 Lrowind_bc_ptr, Lnzval_bc_ptr,
-				 grid
-				);
-#if 0
-		//#ifdef USE_VTUNE
-		__itt_pause(); // stop VTune
-		__SSC_MARK(0x222); // stop SDE tracing
-#endif
+                dgemm_scatter_l (ib, ljb, nsupc, iukp, xsup, klst, lptr,
+				 temp_nbrow, ncols, ldu,
+				 &lookAhead_L_buff[cum_nrow], Lnbrow,
+				 &tempu[st_col*ldu], fused_max, usub, lsub,
+				 tempv1, gsmap_thread, gsmap2_thread,
+				 Lrowind_bc_ptr, Lnzval_bc_ptr, grid);
             }
 
 #if ( PRNTlevel>=1 )
@@ -555,8 +565,90 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
     if ( Rnbrow>0 && ldu>0 ) { /* There are still blocks remaining ... */
 	double flps = 2.0 * (double)Rnbrow * ldu * ncols;
 	schur_flop_counter  += flps;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
 	stat->ops[FACT]     += flps;
 
+	/* With a small ldu, the GEMMs cost more in calls than in flops:
+	   all the pairs (L(lb,k), U(k,j)) are done as one batch by the
+	   fused kernels, which have code for each small k, instead of the
+	   aggregated GEMM into bigV. */
+	int small_k = ( ldu <= GEMM_SCATTER_MAXK );
+
+#ifdef _OPENMP
+	if ( sched_tasks ) {
+	    /* One task per block U(k,j): GEMM of all the remaining rows
+	       into the columns of U(k,j) in bigV, then scatter. */
+	    for (j = jj0; j < jj_cpu; ++j) {
+#pragma omp task firstprivate(j)
+	    {
+		int thread_id = omp_get_thread_num();
+		int *indirect_thread  = indirect + (ldt + CACHELINE/sizeof(int)) * thread_id;
+		int *indirect2_thread = indirect2 + (ldt + CACHELINE/sizeof(int)) * thread_id;
+		int_t *gsmap_thread  = gsmap + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
+		int_t *gsmap2_thread = gsmap2 + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
+		int_t iukp = Ublock_info[j].iukp;
+		int jb = Ublock_info[j].jb;
+		int nsupc = SuperSize(jb);
+		int ljb = LBj (jb, grid);
+		int st_col = j > jj0 ? Ublock_info[j-1].full_u_cols : 0;
+		int ncols = Ublock_info[j].full_u_cols - st_col;
+		double *tempv1 = bigV + st_col * gemm_m_pad;
+
+		if ( !small_k ) {
+#if defined (USE_VENDOR_BLAS)
+		    dgemm_("N", "N", &gemm_m_pad, &ncols, &gemm_k_pad, &alpha,
+		           Remain_L_buff, &gemm_m_pad,
+		           &bigU[st_col*gemm_k_pad], &gemm_k_pad, &beta, tempv1, &gemm_m_pad, 1, 1);
+#else
+		    dgemm_("N", "N", &gemm_m_pad, &ncols, &gemm_k_pad, &alpha,
+		           Remain_L_buff, &gemm_m_pad,
+		           &bigU[st_col*gemm_k_pad], &gemm_k_pad, &beta, tempv1, &gemm_m_pad);
+#endif
+		}
+
+		for (int lb = 0; lb < RemainBlk; ++lb) {
+		    int_t lptr = Remain_info[lb].lptr;
+		    int ib = Remain_info[lb].ib;
+		    int temp_nbrow = lsub[lptr+1];
+		    int cum_nrow = (lb==0 ? 0 : Remain_info[lb-1].FullRow);
+		    lptr += LB_DESCRIPTOR;
+
+		    if ( small_k ) {
+			if ( ib < jb ) {
+			    dgemm_scatter_u (ib, jb, nsupc, iukp, xsup, klst, lptr,
+					     temp_nbrow, ncols, ldu,
+					     &Remain_L_buff[cum_nrow], gemm_m_pad,
+					     &bigU[st_col*gemm_k_pad], fused_max,
+					     lsub, usub, tempv1, gsmap_thread,
+					     gsmap2_thread, Ufstnz_br_ptr,
+					     Unzval_br_ptr, grid);
+			} else {
+			    dgemm_scatter_l (ib, ljb, nsupc, iukp, xsup, klst, lptr,
+					     temp_nbrow, ncols, ldu,
+					     &Remain_L_buff[cum_nrow], gemm_m_pad,
+					     &bigU[st_col*gemm_k_pad], fused_max,
+					     usub, lsub, tempv1, gsmap_thread,
+					     gsmap2_thread, Lrowind_bc_ptr,
+					     Lnzval_bc_ptr, grid);
+			}
+		    } else if ( ib < jb ) {
+			dscatter_u (ib, jb, nsupc, iukp, xsup, klst, gemm_m_pad,
+				    lptr, temp_nbrow, lsub, usub, tempv1 + cum_nrow,
+				    Ufstnz_br_ptr, Unzval_br_ptr, grid);
+		    } else {
+			dscatter_l (ib, ljb, nsupc, iukp, xsup, klst, gemm_m_pad,
+				    lptr, temp_nbrow, usub, lsub, tempv1 + cum_nrow,
+				    indirect_thread, indirect2_thread,
+				    Lrowind_bc_ptr, Lnzval_bc_ptr, grid);
+		    }
+		}
+	    }
+	    }
+	} else {
+#endif
+
 #if ( PRNTlevel>=1 )
 	RemainGEMM_flops += flps;
 	gemm_max_m = SUPERLU_MAX(gemm_max_m, Rnbrow);
@@ -568,19 +660,21 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 	assert( Rnbrow*ncols < bigv_size ); */
 #endif
 	/* calling aggregated large GEMM, result stored in bigV[]. */
+	if ( !small_k ) {
 #if defined (USE_VENDOR_BLAS)
-	//dgemm_("N", "N", &Rnbrow, &ncols, &ldu, &alpha,
-	dgemm_("N", "N", &gemm_m_pad, &gemm_n_pad, &gemm_k_pad, &alpha,
-	       //&Remain_L_buff[(knsupc-ldu)*Rnbrow], &Rnbrow,
-	       &Remain_L_buff[0], &gemm_m_pad,
-	       &bigU[0], &gemm_k_pad, &beta, bigV, &gemm_m_pad, 1, 1);
+	    //dgemm_("N", "N", &Rnbrow, &ncols, &ldu, &alpha,
+	    dgemm_("N", "N", &gemm_m_pad, &gemm_n_pad, &gemm_k_pad, &alpha,
+	           //&Remain_L_buff[(knsupc-ldu)*Rnbrow], &Rnbrow,
+	           &Remain_L_buff[0], &gemm_m_pad,
+	           &bigU[0], &gemm_k_pad, &beta, bigV, &gemm_m_pad, 1, 1);
 #else
-	//dgemm_("N", "N", &Rnbrow, &ncols, &ldu, &alpha,
-	dgemm_("N", "N", &gemm_m_pad, &gemm_n_pad, &gemm_k_pad, &alpha,
-	       //&Remain_L_buff[(knsupc-ldu)*Rnbrow], &Rnbrow,
-	       &Remain_L_buff[0], &gemm_m_pad,
-	       &bigU[0], &gemm_k_pad, &beta, bigV, &gemm_m_pad);
+	    //dgemm_("N", "N", &Rnbrow, &ncols, &ldu, &alpha,
+	    dgemm_("N", "N", &gemm_m_pad, &gemm_n_pad, &gemm_k_pad, &alpha,
+	           //&Remain_L_buff[(knsupc-ldu)*Rnbrow], &Rnbrow,
+	           &Remain_L_buff[0], &gemm_m_pad,
+	           &bigU[0], &gemm_k_pad, &beta, bigV, &gemm_m_pad);
 #endif
+	}
 
 #if ( PRNTlevel>=1 )
 	tt_end = SuperLU_timer_();
@@ -626,6 +720,8 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 	    int i = sizeof(int);
 	    int* indirect_thread = indirect + (ldt + CACHELINE/i) * thread_id;
 	    int* indirect2_thread = indirect2 + (ldt + CACHELINE/i) * thread_id;
+	    int_t *gsmap_thread  = gsmap + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
+	    int_t *gsmap2_thread = gsmap2 + (ldt + CACHELINE/sizeof(int_t)) * thread_id;
 
 #pragma omp for \
     private (j,lb,rukp,iukp,jb,nsupc,ljb,lptr,ib,temp_nbrow,cum_nrow)	\
@@ -634,6 +730,8 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 	    thread_id = 0;
 	    int* indirect_thread = indirect;
 	    int* indirect2_thread = indirect2;
+	    int_t *gsmap_thread  = gsmap;
+	    int_t *gsmap2_thread = gsmap2;
 #endif
 	    /* Each thread is assigned one loop index ij, responsible for
 	       block update L(lb,k) * U(k,j) -> tempv[]. */
@@ -674,7 +772,25 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 
 		/* Now scattering the block */
 
-		if ( ib < jb ) {
+		if ( small_k ) {
+		    if ( ib < jb ) {
+			dgemm_scatter_u (ib, jb, nsupc, iukp, xsup, klst, lptr,
+					 temp_nbrow, ncols, ldu,
+					 &Remain_L_buff[cum_nrow], gemm_m_pad,
+					 &bigU[st_col*gemm_k_pad], fused_max,
+					 lsub, usub, tempv1, gsmap_thread,
+					 gsmap2_thread, Ufstnz_br_ptr,
+					 Unzval_br_ptr, grid);
+		    } else {
+			dgemm_scatter_l (ib, ljb, nsupc, iukp, xsup, klst, lptr,
+					 temp_nbrow, ncols, ldu,
+					 &Remain_L_buff[cum_nrow], gemm_m_pad,
+					 &bigU[st_col*gemm_k_pad], fused_max,
+					 usub, lsub, tempv1, gsmap_thread,
+					 gsmap2_thread, Lrowind_bc_ptr,
+					 Lnzval_bc_ptr, grid);
+		    }
+		} else if ( ib < jb ) {
 		    dscatter_u (
 				ib, jb,
 				nsupc, iukp, xsup,
@@ -714,6 +830,10 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 	__SSC_MARK(0x222); // stop SDE tracing
 #endif
 
+#ifdef _OPENMP
+	} /* end else not the task scheduler */
+#endif
+
     } /* end if Rnbrow>0 ... update remaining block */
 
 }  /* end if L(:,k) and U(k,:) are not empty */
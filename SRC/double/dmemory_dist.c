@@ -249,7 +249,7 @@ void d3D_printMemUse( dtrf3Dpartition_t*  trf3Dpartition,  dLUstruct_t *LUstruct
 
     double memNzLU = 0.0;
     double memzLU = 0.0;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     for (int_t ilvl = 0; ilvl < maxLvl; ++ilvl)
     {
@@ -29,7 +29,7 @@ void validateInput_pdgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
     int Fact = options->Fact;
     if (Fact < 0 || Fact > FACTORED)
         *info = -1;
-    else if (options->RowPerm < 0 || options->RowPerm > MY_PERMR)
+    else if (options->RowPerm < 0 || options->RowPerm > LargeDiag_AUCTION)
         *info = -1;
     else if (options->ColPerm < 0 || options->ColPerm > MY_PERMC)
         *info = -1;
@@ -389,11 +389,17 @@ void dperform_LargeDiag_MC64(
     int_t *rowptr = (Astore)->rowptr;
     int_t *colind = (Astore)->colind;
 
-    NCformat *GAstore = (NCformat *)GA->Store;
-    int_t *colptr = (GAstore)->colptr;
-    int_t *rowind = (GAstore)->rowind;
-    int_t nnz = (GAstore)->nnz;
-    double *a_GA = (double *)(GAstore)->nzval;
+    /* GA is not gathered for the auction with parallel symbfact. */
+    NCformat *GAstore = NULL;
+    int_t *colptr = NULL, *rowind = NULL, nnz = 0;
+    double *a_GA = NULL;
+    if (options->RowPerm == LargeDiag_MC64 || options->ParSymbFact == NO) {
+        GAstore = (NCformat *)GA->Store;
+        colptr = GAstore->colptr;
+        rowind = GAstore->rowind;
+        nnz = GAstore->nnz;
+        a_GA = (double *)GAstore->nzval;
+    }
 
     if (job == 5) {
         R1 = doubleMalloc_dist(m);
@@ -405,7 +411,10 @@ void dperform_LargeDiag_MC64(
     }
 
     // int iinfo;
-    dfindRowPerm_MC64(grid, job, m, n,
+    if (options->RowPerm == LargeDiag_AUCTION)
+        *iinfo = pdldperm_dist(A, grid, perm_r, R1, C1);
+    else
+        dfindRowPerm_MC64(grid, job, m, n,
     nnz,
     colptr,
     rowind,
@@ -430,11 +439,11 @@ void dperform_LargeDiag_MC64(
                 ScalePermstruct->DiagScale = BOTH;
                 *rowequ = *colequ = 1;
             } /* end if Equil */
-            dpermute_global_A( m, n, colptr, rowind, perm_r);
+            if (GAstore) dpermute_global_A( m, n, colptr, rowind, perm_r);
             SUPERLU_FREE(R1);
             SUPERLU_FREE(C1);
         } else {
-            dpermute_global_A( m, n, colptr, rowind, perm_r);
+            if (GAstore) dpermute_global_A( m, n, colptr, rowind, perm_r);
         }
     }
     else
@@ -482,12 +491,6 @@ void dperform_row_permutation(
     LOG_FUNC_ENTER();
     #endif
     int_t *perm_r = ScalePermstruct->perm_r;
-    /* Get NC format data from SuperMatrix GA */
-    NCformat* GAstore = (NCformat *)GA->Store;
-    int_t* colptr = GAstore->colptr;
-    int_t* rowind = GAstore->rowind;
-    int_t nnz = GAstore->nnz;
-    double* a_GA = (double *)GAstore->nzval;
 
     int iam = grid->iam;
     /* ------------------------------------------------------------
@@ -503,9 +506,12 @@ void dperform_row_permutation(
         {
             if (options->RowPerm == MY_PERMR)
             {
-                applyRowPerm(colptr, rowind, perm_r, n);
+                /* Get NC format data from SuperMatrix GA */
+                NCformat *GAstore = (NCformat *)GA->Store;
+                applyRowPerm(GAstore->colptr, GAstore->rowind, perm_r, n);
             }
-            else if (options->RowPerm == LargeDiag_MC64)
+            else if (options->RowPerm == LargeDiag_MC64 ||
+                     options->RowPerm == LargeDiag_AUCTION)
             {
 
                 dperform_LargeDiag_MC64(
@@ -121,3 +121,146 @@ int superlu_dtrsv(char *uplo, char *trans, char *diag,
     return 0;
 }
 
+
+#define GS_MR 8   /* rows of a register tile of superlu_dgemm_scatter */
+#define GS_NR 4   /* columns of a register tile */
+
+/* C(rowmap[i], colmap[j]) -= (A*B)(i,j) with k = K fixed at compile time,
+   two columns of C at a time; a row of A is loaded once for both. */
+#define GS_SMALL_KERNEL(K)                                                \
+static void dgemm_scatter_k##K(int m, int n, double *A, int lda,          \
+                               double *B, int ldb, double *C, int ldc,    \
+                               int_t *rowmap, int_t *colmap)              \
+{                                                                         \
+    double b0[K], b1[K], s0, s1, a, *c0, *c1;                             \
+    int_t r;                                                              \
+    int i, j, j1, p;                                                      \
+                                                                          \
+    for (j = 0; j < n; j += 2) {                                          \
+        j1 = SUPERLU_MIN(j + 1, n - 1);                                   \
+        for (p = 0; p < K; ++p) {                                         \
+            b0[p] = B[p + (size_t) j * ldb];                              \
+            b1[p] = j1 > j ? B[p + (size_t) j1 * ldb] : 0.0;              \
+        }                                                                 \
+        c0 = &C[(size_t) (colmap ? colmap[j] : j) * ldc];                 \
+        c1 = &C[(size_t) (colmap ? colmap[j1] : j1) * ldc];               \
+        GS_SIMD                                                           \
+        for (i = 0; i < m; ++i) {                                         \
+            s0 = s1 = 0.0;                                                \
+            for (p = 0; p < K; ++p) {                                     \
+                a = A[i + (size_t) p * lda];                              \
+                s0 += a * b0[p];                                          \
+                s1 += a * b1[p];                                          \
+            }                                                             \
+            r = rowmap ? rowmap[i] : i;                                   \
+            c0[r] -= s0;                                                  \
+            c1[r] -= s1;                                                  \
+        }                                                                 \
+    }                                                                     \
+}
+
+#if (_OPENMP>=201307)
+#define GS_SIMD _Pragma("omp simd private(s0, s1, a, p, r)")
+#else
+#define GS_SIMD
+#endif
+GS_SMALL_KERNEL(1)
+GS_SMALL_KERNEL(2)
+GS_SMALL_KERNEL(3)
+GS_SMALL_KERNEL(4)
+GS_SMALL_KERNEL(5)
+GS_SMALL_KERNEL(6)
+GS_SMALL_KERNEL(7)
+GS_SMALL_KERNEL(8)
+#undef GS_SIMD
+
+/*! \brief C(rowmap[i], colmap[j]) -= (A*B)(i,j), without storing A*B.
+ *
+ * <pre>
+ * A is m x k (LDA lda), B is k x n (LDA ldb), and C(r, c) is
+ * C[r + c*ldc]. rowmap = NULL stands for rowmap[i] = i, colmap = NULL
+ * for colmap[j] = j. When both are NULL, the destination is a dense
+ * block and the update is one dgemm. Otherwise, A*B is computed in
+ * GS_MR x GS_NR tiles held in registers, and each tile is subtracted
+ * from C through the maps; the maps must not repeat an entry. Each k up
+ * to GEMM_SCATTER_MAXK = 8, dense destination or not, has a kernel of
+ * its own.
+ * </pre>
+ */
+int superlu_dgemm_scatter(int m, int n, int k, double *A, int lda,
+                          double *B, int ldb, double *C, int ldc,
+                          int_t *rowmap, int_t *colmap)
+{
+    double c[GS_NR][GS_MR], b0, b1, b2, b3, *a, *b, *cj;
+    int i, j, p, ii, jj, mr, nr;
+
+    if ( m <= 0 || n <= 0 || k <= 0 ) return 0;
+    switch ( k ) {
+      case 1: dgemm_scatter_k1(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 2: dgemm_scatter_k2(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 3: dgemm_scatter_k3(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 4: dgemm_scatter_k4(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 5: dgemm_scatter_k5(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 6: dgemm_scatter_k6(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 7: dgemm_scatter_k7(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+      case 8: dgemm_scatter_k8(m, n, A, lda, B, ldb, C, ldc, rowmap, colmap);
+	  return 0;
+    }
+    if ( !rowmap && !colmap )
+        return superlu_dgemm("N", "N", m, n, k, -1.0, A, lda, B, ldb,
+                             1.0, C, ldc);
+
+    for (j = 0; j < n; j += GS_NR) {
+        nr = SUPERLU_MIN(GS_NR, n - j);
+        for (i = 0; i < m; i += GS_MR) {
+            mr = SUPERLU_MIN(GS_MR, m - i);
+            for (jj = 0; jj < GS_NR; ++jj)
+                for (ii = 0; ii < GS_MR; ++ii) c[jj][ii] = 0.0;
+
+            if ( mr == GS_MR && nr == GS_NR ) { /* full tile */
+                for (p = 0; p < k; ++p) {
+                    a = &A[i + (size_t) p * lda];
+                    b = &B[p + (size_t) j * ldb];
+                    b0 = b[0];
+                    b1 = b[ldb];
+                    b2 = b[2 * (size_t) ldb];
+                    b3 = b[3 * (size_t) ldb];
+#if (_OPENMP>=201307)
+#pragma omp simd
+#endif
+                    for (ii = 0; ii < GS_MR; ++ii) {
+                        c[0][ii] += a[ii] * b0;
+                        c[1][ii] += a[ii] * b1;
+                        c[2][ii] += a[ii] * b2;
+                        c[3][ii] += a[ii] * b3;
+                    }
+                }
+            } else {                            /* edge tile */
+                for (p = 0; p < k; ++p) {
+                    a = &A[i + (size_t) p * lda];
+                    b = &B[p + (size_t) j * ldb];
+                    for (jj = 0; jj < nr; ++jj)
+                        for (ii = 0; ii < mr; ++ii)
+                            c[jj][ii] += a[ii] * b[(size_t) jj * ldb];
+                }
+            }
+
+            for (jj = 0; jj < nr; ++jj) {
+                cj = &C[(size_t) (colmap ? colmap[j + jj] : j + jj) * ldc];
+                if ( rowmap ) {
+                    for (ii = 0; ii < mr; ++ii) cj[rowmap[i + ii]] -= c[jj][ii];
+                } else {
+                    for (ii = 0; ii < mr; ++ii) cj[i + ii] -= c[jj][ii];
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -74,7 +74,7 @@ void dinit3DLUstructForest( int_t* myTreeIdxs, int_t* myZeroTrIdxs,
                            sForest_t**  sForests, dLUstruct_t* LUstruct,
                            gridinfo3d_t* grid3d)
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t numForests = (1 << maxLvl) - 1;
     int_t* gNodeCount = INT_T_ALLOC (numForests);
     int_t** gNodeLists =  (int_t**) SUPERLU_MALLOC(numForests * sizeof(int_t*));
@@ -618,8 +618,8 @@ dtrf3Dpartition_t* dinitTrf3DpartitionLUstructgrid0(int_t n, superlu_dist_option
         gEtreeInfo.numChildLeft[i] = treeList[i].numChild;
     }
 
-    int maxLvl = log2i(grid3d->zscp.Np) + 1; /* Levels for Pz process layer */
-    sForest_t**  sForests = getForests( maxLvl, nsupers, setree, treeList);
+    int maxLvl = log2i_ceil(grid3d->zscp.Np) + 1; /* Levels for Pz process layer */
+    sForest_t**  sForests = getForests( maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
     /*indexes of trees for my process grid in gNodeList size(maxLvl)*/
     int_t* myTreeIdxs = getGridTrees(grid3d);
     int_t* myZeroTrIdxs = getReplicatedTrees(grid3d);
@@ -737,6 +737,8 @@ dtrf3Dpartition_t* dinitTrf3DpartitionLUstructgrid0(int_t n, superlu_dist_option
     trf3Dpartition->sForests = sForests;
     trf3Dpartition->treePerm = treePerm;
     trf3Dpartition->maxLvl = maxLvl;
+    trf3Dpartition->imbalance = getForestImbalance(maxLvl, grid3d->zscp.Np,
+                                                   sForests, treeList);
     // trf3Dpartition->LUvsb = LUvsb;
     trf3Dpartition->supernode2treeMap = supernode2treeMap;
     trf3Dpartition->supernodeMask = supernodeMask;
@@ -802,8 +804,8 @@ dtrf3Dpartition_t* dinitTrf3Dpartition_allgrid(int_t n, superlu_dist_options_t *
         gEtreeInfo.numChildLeft[i] = treeList[i].numChild;
     }
 
-    int maxLvl = log2i(grid3d->zscp.Np) + 1; /* Levels for Pz process layer */
-    sForest_t**  sForests = getForests( maxLvl, nsupers, setree, treeList);
+    int maxLvl = log2i_ceil(grid3d->zscp.Np) + 1; /* Levels for Pz process layer */
+    sForest_t**  sForests = getForests( maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
     /*indexes of trees for my process grid in gNodeList size(maxLvl)*/
     int_t* myTreeIdxs = getGridTrees(grid3d);
     int_t* myZeroTrIdxs = getReplicatedTrees(grid3d);
@@ -921,6 +923,8 @@ dtrf3Dpartition_t* dinitTrf3Dpartition_allgrid(int_t n, superlu_dist_options_t *
     trf3Dpartition->sForests = sForests;
     trf3Dpartition->treePerm = treePerm;
     trf3Dpartition->maxLvl = maxLvl;
+    trf3Dpartition->imbalance = getForestImbalance(maxLvl, grid3d->zscp.Np,
+                                                   sForests, treeList);
     // trf3Dpartition->LUvsb = LUvsb;
     trf3Dpartition->supernode2treeMap = supernode2treeMap;
     trf3Dpartition->supernodeMask = supernodeMask;
@@ -981,8 +985,8 @@ dtrf3Dpartition_t* dinitTrf3Dpartition(int_t nsupers,
         gEtreeInfo.numChildLeft[i] = treeList[i].numChild;
     }
 
-    int maxLvl = log2i(grid3d->zscp.Np) + 1; /* Levels for Pz process layer */
-    sForest_t**  sForests = getForests( maxLvl, nsupers, setree, treeList);
+    int maxLvl = log2i_ceil(grid3d->zscp.Np) + 1; /* Levels for Pz process layer */
+    sForest_t**  sForests = getForests( maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
     /*indexes of trees for my process grid in gNodeList size(maxLvl)*/
     int_t* myTreeIdxs = getGridTrees(grid3d);
     int_t* myZeroTrIdxs = getReplicatedTrees(grid3d);
@@ -1105,6 +1109,8 @@ dtrf3Dpartition_t* dinitTrf3Dpartition(int_t nsupers,
     trf3Dpartition->sForests = sForests;
     trf3Dpartition->treePerm = treePerm;
     trf3Dpartition->maxLvl = maxLvl;
+    trf3Dpartition->imbalance = getForestImbalance(maxLvl, grid3d->zscp.Np,
+                                                   sForests, treeList);
     trf3Dpartition->LUvsb = LUvsb;
     trf3Dpartition->supernode2treeMap = supernode2treeMap;
     trf3Dpartition->supernodeMask = supernodeMask;
@@ -969,6 +969,9 @@ int_t dreduceAncestors3d(int_t sender, int_t receiver,
     double alpha = 1.0, beta = 1.0;
     int_t myGrid = grid3d->zscp.Iam;
 
+    /* a layer beyond the last one has nothing to exchange */
+    if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
+
     /*first setting the L blocks to zero*/
     for (int_t node = 0; node < nnodes; ++node)   /* for each block column ... */
 	{
@@ -1001,6 +1004,9 @@ int_t dgatherFactoredLU(int_t sender, int_t receiver,
     double * Lval_buf  = LUvsb->Lval_buf;
     double * Uval_buf  = LUvsb->Uval_buf;
     int_t myGrid = grid3d->zscp.Iam;
+
+    /* a layer beyond the last one has nothing to exchange */
+    if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
     for (int_t node = 0; node < nnodes; ++node)   /* for each block column ... */
 	{
 	    int_t jb = nodeList[node];
@@ -1027,7 +1033,7 @@ int_t dinit3DLUstruct( int_t* myTreeIdxs, int_t* myZeroTrIdxs,
                       int_t* nodeCount, int_t** nodeList, dLUstruct_t* LUstruct,
 		      gridinfo3d_t* grid3d)
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     for (int_t lvl = 0; lvl < maxLvl; lvl++)
 	{
@@ -1049,7 +1055,7 @@ int dreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
 {
     double * Lval_buf  = LUvsb->Lval_buf;
     double * Uval_buf  = LUvsb->Uval_buf;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
 
     int_t sender, receiver;
@@ -1083,7 +1089,7 @@ int dreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
 int_t dgatherAllFactoredLU( dtrf3Dpartition_t*  trf3Dpartition,
 			   dLUstruct_t* LUstruct, gridinfo3d_t* grid3d, SCT_t* SCT )
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
@@ -1146,7 +1152,7 @@ int_t dbroadcastAncestor3d( dtrf3Dpartition_t*  trf3Dpartition,
 			   dLUstruct_t* LUstruct, gridinfo3d_t* grid3d, SCT_t* SCT )
 {
 
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
@@ -1197,7 +1203,7 @@ int_t dbroadcastAncestor3d( dtrf3Dpartition_t*  trf3Dpartition,
 int_t dgatherAllFactoredLU3d( dtrf3Dpartition_t*  trf3Dpartition,
 			   dLUstruct_t* LUstruct, gridinfo3d_t* grid3d, SCT_t* SCT )
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
@@ -355,7 +355,7 @@ int_t checkDist3DLUStruct(  dLUstruct_t* LUstruct, gridinfo3d_t* grid3d)
     int iam = grid->iam;
     int myrow = MYROW(iam, grid);
     int mycol = MYCOL(iam, grid);
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     int myGrid = grid3d->zscp.Iam;
 
     sForest_t** sForests = trf3Dpartition->sForests;
@@ -365,7 +365,7 @@ int_t checkDist3DLUStruct(  dLUstruct_t* LUstruct, gridinfo3d_t* grid3d)
 
     for (int grid_id =1 ; grid_id < grid3d->zscp.Np; ++grid_id)
     {
-        int first_tree = grid3d->zscp.Np - 1 + grid_id;
+        int first_tree = (1 << (maxLvl - 1)) - 1 + grid_id;
         while( first_tree >0 )
         {
             int_t* tree = gNodeLists[first_tree];
@@ -0,0 +1,503 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Solves a double-precision system with a single-precision LU
+ * factorization and GMRES-based iterative refinement in double precision
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <math.h>
+#include "superlu_ddefs.h"
+#include "superlu_sdefs.h"
+
+#define ITMAX    10     /* maximum number of refinement steps */
+#define GMRES_M  20     /* maximum dimension of the Krylov space of one
+			   refinement step */
+#define GMRES_TOL 1e-6  /* relative residual of the correction equation
+			   at which GMRES stops */
+
+/*! \brief State of pdgssvx() with options->MixedPrecLU = YES, kept in
+ * LUstruct->mixed across calls.
+ */
+struct dMixedLU {
+    superlu_dist_options_t options; /* options of the calls to psgssvx() */
+    SuperMatrix A;         /* single-precision copy of A */
+    sScalePermstruct_t ScalePermstruct;
+    sLUstruct_t LUstruct;  /* single-precision factors of A */
+    sSOLVEstruct_t SOLVEstruct;
+    SuperMatrix Ad;        /* double-precision copy of A for pdgsmv();
+			      pdgsmv_init() reorders its column indices */
+    int_t *row_to_proc;    /* process of each row of A and of x */
+    pdgsmv_comm_t gsmv_comm;
+    double anorm;          /* infinity norm of A */
+    int_t n;
+    gridinfo_t *grid;
+    int  has_A;            /* A and Ad hold the matrix of the last
+			      factorization */
+    int  factored;         /* LUstruct holds single-precision factors */
+    int  fallback;         /* the factorization is done in double
+			      precision, by pdgssvx() itself */
+};
+
+/* Free the copies of A and the SpMV structure. */
+static void dmp_free_A(struct dMixedLU *mp)
+{
+    if ( !mp->has_A ) return;
+    pdgsmv_finalize(&mp->gsmv_comm);
+    Destroy_CompRowLoc_Matrix_dist(&mp->A);
+    Destroy_CompRowLoc_Matrix_dist(&mp->Ad);
+    SUPERLU_FREE(mp->row_to_proc);
+    mp->has_A = 0;
+}
+
+/* Free all the single-precision data, keeping the permutations. */
+static void dmp_free_factors(struct dMixedLU *mp)
+{
+    if ( mp->factored ) {
+	sDestroy_LU(mp->n, mp->grid, &mp->LUstruct);
+	mp->factored = 0;
+    }
+    if ( mp->options.SolveInitialized == YES )
+	sSolveFinalize(&mp->options, &mp->SOLVEstruct);
+}
+
+/* Copy A into mp->A in single precision, and into mp->Ad for pdgsmv().
+   Returns 1 if an entry of A is too large for single precision. */
+static int dmp_copy_A(SuperMatrix *A, struct dMixedLU *mp)
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    gridinfo_t *grid = mp->grid;
+    int_t m_loc = Astore->m_loc, nnz_loc = Astore->nnz_loc, i, p;
+    int_t *rowptr, *colind, *rowptr_d, *colind_d, *fst_rows;
+    double *a = (double *) Astore->nzval, *a_d, amax = 0.0;
+    float *a_s;
+    int   procs = grid->nprow * grid->npcol;
+
+    for (i = 0; i < nnz_loc; ++i) amax = SUPERLU_MAX(amax, fabs(a[i]));
+    MPI_Allreduce(MPI_IN_PLACE, &amax, 1, MPI_DOUBLE, MPI_MAX, grid->comm);
+    if ( amax > smach_dist("Overflow") ) return 1;
+
+    if ( !(rowptr = intMalloc_dist(m_loc + 1)) )
+	ABORT("Malloc fails for rowptr[].");
+    if ( !(rowptr_d = intMalloc_dist(m_loc + 1)) )
+	ABORT("Malloc fails for rowptr_d[].");
+    if ( !(colind = intMalloc_dist(nnz_loc + 1)) )
+	ABORT("Malloc fails for colind[].");
+    if ( !(colind_d = intMalloc_dist(nnz_loc + 1)) )
+	ABORT("Malloc fails for colind_d[].");
+    if ( !(a_s = floatMalloc_dist(nnz_loc + 1)) )
+	ABORT("Malloc fails for a_s[].");
+    if ( !(a_d = doubleMalloc_dist(nnz_loc + 1)) )
+	ABORT("Malloc fails for a_d[].");
+    for (i = 0; i <= m_loc; ++i) rowptr[i] = rowptr_d[i] = Astore->rowptr[i];
+    for (i = 0; i < nnz_loc; ++i) {
+	colind[i] = colind_d[i] = Astore->colind[i];
+	a_s[i] = (float) a[i];
+	a_d[i] = a[i];
+    }
+    sCreate_CompRowLoc_Matrix_dist(&mp->A, A->nrow, A->ncol, nnz_loc, m_loc,
+				   Astore->fst_row, a_s, colind, rowptr,
+				   SLU_NR_loc, SLU_S, SLU_GE);
+    dCreate_CompRowLoc_Matrix_dist(&mp->Ad, A->nrow, A->ncol, nnz_loc, m_loc,
+				   Astore->fst_row, a_d, colind_d, rowptr_d,
+				   SLU_NR_loc, SLU_D, SLU_GE);
+    mp->anorm = pdlangs("I", &mp->Ad, grid);
+
+    /* x is distributed by block rows, as A and B. */
+    if ( !(fst_rows = intMalloc_dist(procs + 1)) )
+	ABORT("Malloc fails for fst_rows[].");
+    MPI_Allgather(&Astore->fst_row, 1, mpi_int_t, fst_rows, 1, mpi_int_t,
+		  grid->comm);
+    fst_rows[procs] = A->nrow;
+    if ( !(mp->row_to_proc = intMalloc_dist(A->nrow)) )
+	ABORT("Malloc fails for row_to_proc[].");
+    for (p = 0; p < procs; ++p)
+	for (i = fst_rows[p]; i < fst_rows[p+1]; ++i) mp->row_to_proc[i] = p;
+    SUPERLU_FREE(fst_rows);
+
+    pdgsmv_init(&mp->Ad, mp->row_to_proc, grid, &mp->gsmv_comm);
+    mp->has_A = 1;
+    return 0;
+}
+
+/* z = inv(A1)*v, where A1 = L*U is the single-precision factorization.
+   v is scaled to unit norm before it is rounded to single precision. */
+static void dmp_psolve(int_t m_loc, double *v, double *z, float *w,
+		       struct dMixedLU *mp, SuperLUStat_t *stat, int *info)
+{
+    double s = 0.0;
+    float  berr;
+    int_t  i;
+
+    for (i = 0; i < m_loc; ++i) s = SUPERLU_MAX(s, fabs(v[i]));
+    MPI_Allreduce(MPI_IN_PLACE, &s, 1, MPI_DOUBLE, MPI_MAX, mp->grid->comm);
+    if ( s == 0.0 ) {
+	for (i = 0; i < m_loc; ++i) z[i] = 0.0;
+	return;
+    }
+    for (i = 0; i < m_loc; ++i) w[i] = (float) (v[i] / s);
+    psgssvx(&mp->options, &mp->A, &mp->ScalePermstruct, w, m_loc, 1,
+	    mp->grid, &mp->LUstruct, &mp->SOLVEstruct, &berr, stat, info);
+    for (i = 0; i < m_loc; ++i) z[i] = s * w[i];
+}
+
+static double dmp_dot(int_t m_loc, double *x, double *y, gridinfo_t *grid)
+{
+    double s = 0.0;
+    int_t  i;
+
+    for (i = 0; i < m_loc; ++i) s += x[i] * y[i];
+    MPI_Allreduce(MPI_IN_PLACE, &s, 1, MPI_DOUBLE, MPI_SUM, grid->comm);
+    return s;
+}
+
+/* Solve A*x = b by refinement of x0 = inv(A1)*b: each correction
+   A*d = b - A*x is solved by GMRES, right-preconditioned by inv(A1).
+   The refinement goes on while the residual is halved, at most ITMAX
+   steps. Returns 0 if then, as in LAPACK's DSGESV,
+       norm(b - A*x) <= sqrt(n) * eps * norm(A) * norm(x)
+   in the infinity norm, 1 otherwise. */
+static int dmp_gmres_ir(int_t n, int_t m_loc, double *b, double *x,
+			double *work, float *swork, struct dMixedLU *mp,
+			SuperLUStat_t *stat, int *steps, int *info)
+{
+    gridinfo_t *grid = mp->grid;
+    double *r = work, *d = r + m_loc, *V = d + m_loc;
+    double H[GMRES_M+1][GMRES_M], cs[GMRES_M], sn[GMRES_M], g[GMRES_M+1];
+    double cte, rnorm, xnorm, lstres = 0.0, beta, h, t;
+    int_t  i;
+    int    count, j, k, kk;
+
+    cte = mp->anorm * dmach_dist("Epsilon") * sqrt((double) n);
+    dmp_psolve(m_loc, b, x, swork, mp, stat, info);
+
+    for (count = 0; *info == 0; ++count) {
+	pdgsmv(0, &mp->Ad, grid, &mp->gsmv_comm, x, r);
+	rnorm = xnorm = 0.0;
+	for (i = 0; i < m_loc; ++i) {
+	    r[i] = b[i] - r[i];
+	    rnorm = SUPERLU_MAX(rnorm, fabs(r[i]));
+	    xnorm = SUPERLU_MAX(xnorm, fabs(x[i]));
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &rnorm, 1, MPI_DOUBLE, MPI_MAX, grid->comm);
+	MPI_Allreduce(MPI_IN_PLACE, &xnorm, 1, MPI_DOUBLE, MPI_MAX, grid->comm);
+#if ( PRNTlevel>=1 )
+	if ( !grid->iam )
+	    printf(".. GMRES-IR step %d: norm(r) %e, bound %e\n",
+		   count, rnorm, cte * xnorm);
+#endif
+	if ( rnorm == 0.0 || count == ITMAX
+	     || (count && rnorm > 0.5 * lstres) )
+	    return rnorm > cte * xnorm;
+	lstres = rnorm;
+
+	/* GMRES on A*inv(A1)*y = r, from y = 0. */
+	beta = sqrt(dmp_dot(m_loc, r, r, grid));
+	for (i = 0; i < m_loc; ++i) V[i] = r[i] / beta;
+	g[0] = beta;
+	for (k = 0; k < GMRES_M; ) {
+	    double *vk = &V[(size_t) k * m_loc], *w = vk + m_loc;
+
+	    dmp_psolve(m_loc, vk, d, swork, mp, stat, info);
+	    if ( *info ) return 1;
+	    pdgsmv(0, &mp->Ad, grid, &mp->gsmv_comm, d, w);
+	    for (j = 0; j <= k; ++j) { /* modified Gram-Schmidt */
+		double *vj = &V[(size_t) j * m_loc];
+		H[j][k] = h = dmp_dot(m_loc, w, vj, grid);
+		for (i = 0; i < m_loc; ++i) w[i] -= h * vj[i];
+	    }
+	    H[k+1][k] = h = sqrt(dmp_dot(m_loc, w, w, grid));
+	    if ( h != 0.0 ) for (i = 0; i < m_loc; ++i) w[i] /= h;
+
+	    for (j = 0; j < k; ++j) { /* apply the previous rotations */
+		t = cs[j] * H[j][k] + sn[j] * H[j+1][k];
+		H[j+1][k] = -sn[j] * H[j][k] + cs[j] * H[j+1][k];
+		H[j][k] = t;
+	    }
+	    t = sqrt(H[k][k] * H[k][k] + h * h);
+	    if ( t == 0.0 ) break;  /* A*inv(A1)*v = 0 */
+	    cs[k] = H[k][k] / t;
+	    sn[k] = h / t;
+	    H[k][k] = t;
+	    g[k+1] = -sn[k] * g[k];
+	    g[k] = cs[k] * g[k];
+	    ++k;
+	    ++stat->RefineSteps;
+	    if ( fabs(g[k]) <= GMRES_TOL * beta || h == 0.0 ) break;
+	}
+
+	/* d = inv(A1) * V * y, where H*y = g. */
+	for (j = k - 1; j >= 0; --j) {
+	    for (kk = j + 1; kk < k; ++kk) g[j] -= H[j][kk] * g[kk];
+	    g[j] /= H[j][j];
+	}
+	for (i = 0; i < m_loc; ++i) r[i] = 0.0;
+	for (j = 0; j < k; ++j) {
+	    double *vj = &V[(size_t) j * m_loc];
+	    for (i = 0; i < m_loc; ++i) r[i] += g[j] * vj[i];
+	}
+	dmp_psolve(m_loc, r, d, swork, mp, stat, info);
+	for (i = 0; i < m_loc; ++i) x[i] += d[i];
+	++(*steps);
+    }
+    return 1;
+}
+
+/* Componentwise backward error of x, as in pdgsrfs(). */
+static double dmp_berr(int_t n, int_t m_loc, double *b, double *x,
+		       double *work, struct dMixedLU *mp)
+{
+    double *r = work, *temp = work + m_loc, s = 0.0, eps, safe1, safe2;
+    int_t  i;
+
+    eps = dmach_dist("Epsilon");
+    safe1 = (n + 1) * dmach_dist("Safe minimum");
+    safe2 = safe1 / eps;
+    pdgsmv(0, &mp->Ad, mp->grid, &mp->gsmv_comm, x, r);
+    pdgsmv(1, &mp->Ad, mp->grid, &mp->gsmv_comm, x, temp);
+    for (i = 0; i < m_loc; ++i) {
+	r[i] = b[i] - r[i];
+	temp[i] += fabs(b[i]);
+	if ( temp[i] > safe2 )
+	    s = SUPERLU_MAX(s, fabs(r[i]) / temp[i]);
+	else if ( temp[i] != 0.0 )
+	    s = SUPERLU_MAX(s, (safe1 + fabs(r[i])) / temp[i]);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &s, 1, MPI_DOUBLE, MPI_MAX, mp->grid->comm);
+    return s;
+}
+
+/* Solve with pdgssvx() itself, in double precision; if the system was
+   not factored in double precision yet, factor it with Fact = DOFACT. */
+static void dmp_double(superlu_dist_options_t *options, SuperMatrix *A,
+		       dScalePermstruct_t *ScalePermstruct, double B[],
+		       int ldb, int nrhs, gridinfo_t *grid,
+		       dLUstruct_t *LUstruct, dSOLVEstruct_t *SOLVEstruct,
+		       double *berr, SuperLUStat_t *stat, int *info)
+{
+    struct dMixedLU *mp = LUstruct->mixed;
+    fact_t Fact = options->Fact;
+
+    if ( !mp->fallback ) {
+#if ( PRNTlevel>=1 )
+	if ( !grid->iam ) printf(".. pdgssvx_mp: factor in double precision\n");
+#endif
+	dmp_free_factors(mp);
+	dmp_free_A(mp);
+	mp->fallback = 1;
+	options->Fact = DOFACT;
+    }
+    options->MixedPrecLU = NO;
+    pdgssvx(options, A, ScalePermstruct, B, ldb, nrhs, grid, LUstruct,
+	    SOLVEstruct, berr, stat, info);
+    options->MixedPrecLU = YES;
+    options->Fact = Fact;
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * PDGSSVX_MP is called by PDGSSVX when options->MixedPrecLU = YES, with
+ * the same arguments. A copy of A in single precision is factored by
+ * PSGSSVX, so the L and U factors take half the memory of those of
+ * PDGSSVX. Each column x of the solution is then refined in double
+ * precision: the residual b - A*x is computed by PDGSMV, and each
+ * correction is solved by GMRES, preconditioned by the single-precision
+ * factors. As in PDGSRFS, the refinement goes on while the residual is
+ * halved; the solution is accepted if then
+ *     norm(b - A*x) <= sqrt(n) * eps * norm(A) * norm(x),
+ * the test of LAPACK's DSGESV, in the infinity norm.
+ *
+ * If A does not fit in single precision, if its single-precision
+ * factorization breaks down, if the transpose system is asked for, or if
+ * the refinement of a column stagnates or takes more than ITMAX steps,
+ * A is factored again in double precision by PDGSSVX, and the system is
+ * solved as with options->MixedPrecLU = NO. The double-precision factors
+ * are then used by all the later calls with the same LUstruct, until
+ * dLUstructFree().
+ *
+ * The single-precision data are kept in LUstruct->mixed; they are freed
+ * by dDestroy_LU() and dLUstructFree() as usual. Unless it falls back to
+ * double precision, PDGSSVX_MP does not change A, nor ScalePermstruct,
+ * SOLVEstruct and options->SolveInitialized: the scaling, permutations
+ * and solve structures are those of the single-precision factorization.
+ * A is kept twice, in single and in double precision. The routines that
+ * work on the double-precision factors or solve structures themselves,
+ * such as pdSaveLU(), dZeroLblocks() or pdgstrs_init(), do not apply.
+ *
+ * berr[j] is the componentwise relative backward error of column j, as
+ * computed by PDGSRFS, and stat->RefineSteps the total number of GMRES
+ * iterations.
+ * </pre>
+ */
+void
+pdgssvx_mp(superlu_dist_options_t *options, SuperMatrix *A,
+	   dScalePermstruct_t *ScalePermstruct,
+	   double B[], int ldb, int nrhs, gridinfo_t *grid,
+	   dLUstruct_t *LUstruct, dSOLVEstruct_t *SOLVEstruct, double *berr,
+	   SuperLUStat_t *stat, int *info)
+{
+    struct dMixedLU *mp = LUstruct->mixed;
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    int_t  m_loc = Astore->m_loc, n = A->ncol, i;
+    yes_no_t SolveInitialized, RefineInitialized;
+    double *X, *work, t;
+    float  *swork, sberr;
+    int    j, steps = 0, fail = 0;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Enter pdgssvx_mp()");
+#endif
+
+    if ( !mp ) {
+	if ( options->Fact == FACTORED ) { /* factored by pdgssvx() */
+	    options->MixedPrecLU = NO;
+	    pdgssvx(options, A, ScalePermstruct, B, ldb, nrhs, grid,
+		    LUstruct, SOLVEstruct, berr, stat, info);
+	    options->MixedPrecLU = YES;
+	    return;
+	}
+	if ( !(mp = SUPERLU_MALLOC(sizeof(struct dMixedLU))) )
+	    ABORT("Malloc fails for LUstruct->mixed.");
+	LUstruct->mixed = mp;
+	mp->n = n;
+	mp->grid = grid;
+	mp->has_A = mp->factored = mp->fallback = 0;
+	mp->options.SolveInitialized = mp->options.RefineInitialized = NO;
+	sScalePermstructInit(A->nrow, n, &mp->ScalePermstruct);
+	sLUstructInit(n, &mp->LUstruct);
+    }
+    if ( mp->fallback || options->Trans != NOTRANS ) {
+	dmp_double(options, A, ScalePermstruct, B, ldb, nrhs, grid,
+		   LUstruct, SOLVEstruct, berr, stat, info);
+	return;
+    }
+
+    /* ------------------------------------------------------------
+       Factor A in single precision.
+       ------------------------------------------------------------*/
+    if ( options->Fact != FACTORED ) {
+	dmp_free_A(mp);
+	if ( dmp_copy_A(A, mp) ) {
+	    dmp_double(options, A, ScalePermstruct, B, ldb, nrhs, grid,
+		       LUstruct, SOLVEstruct, berr, stat, info);
+	    return;
+	}
+	SolveInitialized = mp->options.SolveInitialized;
+	RefineInitialized = mp->options.RefineInitialized;
+	mp->options = *options;
+	mp->options.MixedPrecLU = NO;
+	mp->options.IterRefine = NOREFINE;
+	mp->options.SolveInitialized = SolveInitialized;
+	mp->options.RefineInitialized = RefineInitialized;
+	if ( options->ColPerm == MY_PERMC )
+	    for (i = 0; i < n; ++i)
+		mp->ScalePermstruct.perm_c[i] = ScalePermstruct->perm_c[i];
+	if ( options->RowPerm == MY_PERMR )
+	    for (i = 0; i < A->nrow; ++i)
+		mp->ScalePermstruct.perm_r[i] = ScalePermstruct->perm_r[i];
+
+	psgssvx(&mp->options, &mp->A, &mp->ScalePermstruct, &sberr, m_loc,
+		0, grid, &mp->LUstruct, &mp->SOLVEstruct, &sberr, stat, info);
+	mp->factored = ( *info == 0 );
+	if ( *info < 0 ) return;
+	if ( *info > 0 ) {
+	    *info = 0;
+	    dmp_double(options, A, ScalePermstruct, B, ldb, nrhs, grid,
+		       LUstruct, SOLVEstruct, berr, stat, info);
+	    return;
+	}
+    }
+    if ( !nrhs ) return;
+
+    /* ------------------------------------------------------------
+       Solve and refine each column in double precision.
+       ------------------------------------------------------------*/
+    t = SuperLU_timer_();
+    mp->options.Fact = FACTORED;
+    mp->options.PrintStat = NO;
+    if ( !(X = doubleMalloc_dist((size_t) m_loc * nrhs + 1)) )
+	ABORT("Malloc fails for X[].");
+    if ( !(work = doubleMalloc_dist((size_t) m_loc * (GMRES_M + 3) + 1)) )
+	ABORT("Malloc fails for work[].");
+    if ( !(swork = floatMalloc_dist(m_loc + 1)) )
+	ABORT("Malloc fails for swork[].");
+    stat->RefineSteps = 0;
+    for (j = 0; j < nrhs && !fail; ++j)
+	fail = dmp_gmres_ir(n, m_loc, &B[(size_t) j * ldb],
+			    &X[(size_t) j * m_loc], work, swork, mp, stat,
+			    &steps, info);
+    if ( !fail ) {
+	for (j = 0; j < nrhs; ++j) {
+	    berr[j] = dmp_berr(n, m_loc, &B[(size_t) j * ldb],
+			       &X[(size_t) j * m_loc], work, mp);
+	    for (i = 0; i < m_loc; ++i)
+		B[i + (size_t) j * ldb] = X[i + (size_t) j * m_loc];
+	}
+    }
+    SUPERLU_FREE(X);
+    SUPERLU_FREE(work);
+    SUPERLU_FREE(swork);
+    stat->utime[REFINE] = SuperLU_timer_() - t;
+#if ( PRNTlevel>=1 )
+    if ( !grid->iam )
+	printf(".. pdgssvx_mp: %d refinement steps, %d GMRES iterations\n",
+	       steps, stat->RefineSteps);
+#endif
+
+    if ( fail && *info >= 0 ) {
+	*info = 0;
+	dmp_double(options, A, ScalePermstruct, B, ldb, nrhs, grid,
+		   LUstruct, SOLVEstruct, berr, stat, info);
+    }
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Exit pdgssvx_mp()");
+#endif
+} /* pdgssvx_mp */
+
+/*! \brief Destroy the single-precision L and U factors of
+ * options->MixedPrecLU. Returns 0 if LUstruct holds double-precision
+ * factors instead, to be destroyed by dDestroy_LU().
+ */
+int dDestroy_LU_mp(dLUstruct_t *LUstruct)
+{
+    struct dMixedLU *mp = LUstruct->mixed;
+
+    if ( mp->fallback ) return 0;
+    if ( mp->factored ) {
+	sDestroy_LU(mp->n, mp->grid, &mp->LUstruct);
+	mp->factored = 0;
+    }
+    return 1;
+}
+
+/*! \brief Free the single-precision data of options->MixedPrecLU. */
+void dLUstructFree_mp(dLUstruct_t *LUstruct)
+{
+    struct dMixedLU *mp = LUstruct->mixed;
+
+    dmp_free_factors(mp);
+    dmp_free_A(mp);
+    sScalePermstructFree(&mp->ScalePermstruct);
+    sLUstructFree(&mp->LUstruct);
+    SUPERLU_FREE(mp);
+    LUstruct->mixed = NULL;
+}
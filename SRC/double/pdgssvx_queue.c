@@ -0,0 +1,190 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+/*! @file
+ * \brief Queue of right-hand sides solved together with the same factors
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * An application that solves many systems with the same factors, one or
+ * a few right-hand sides at a time, pays for each call to PDGSSVX the
+ * redistribution of B and X and the latency of the two triangular sweeps.
+ * The routines in this file let it submit the right-hand sides to a
+ * queue instead. The pending ones are gathered into one block and
+ * solved by a single call to PDGSSVX with Fact = FACTORED when the block
+ * is full, or when the solution of one of them is waited for.
+ *
+ * All the routines are collective: every process in the grid submits
+ * its local rows of the same right-hand sides, and waits for the same
+ * tickets, in the same order.
+ * </pre>
+ */
+
+#include "superlu_ddefs.h"
+
+/*! \brief Create a queue for solving with the factors in LUstruct.
+ *
+ * <pre>
+ * The matrix A must already be factored by PDGSSVX with the given
+ * options, ScalePermstruct, LUstruct and SOLVEstruct; they are used by
+ * every solve, and must stay alive until pdSolveQueueFinalize().
+ * Up to max_nrhs right-hand sides are solved together. The statistics
+ * of the solves are accumulated in stat.
+ *
+ * Returns 0 on success, -1 if max_nrhs < 1.
+ * </pre>
+ */
+int pdSolveQueueInit(dSolveQueue_t *Q, int max_nrhs,
+                    superlu_dist_options_t *options, SuperMatrix *A,
+                    dScalePermstruct_t *ScalePermstruct,
+                    dLUstruct_t *LUstruct, dSOLVEstruct_t *SOLVEstruct,
+                    gridinfo_t *grid, SuperLUStat_t *stat)
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+
+    if ( max_nrhs < 1 ) return -1;
+    Q->options = options;
+    Q->A = A;
+    Q->ScalePermstruct = ScalePermstruct;
+    Q->LUstruct = LUstruct;
+    Q->SOLVEstruct = SOLVEstruct;
+    Q->grid = grid;
+    Q->stat = stat;
+    Q->m_loc = Astore->m_loc;
+    Q->max_nrhs = max_nrhs;
+    Q->nrhs = 0;
+    Q->nreq = 0;
+    Q->first = 0;
+    Q->info = 0;
+    if ( !(Q->B = doubleMalloc_dist(SUPERLU_MAX(Q->m_loc, 1) * max_nrhs)) )
+	ABORT("Malloc fails for Q->B[].");
+    if ( !(Q->berr = doubleMalloc_dist(max_nrhs)) )
+	ABORT("Malloc fails for Q->berr[].");
+    if ( !(Q->req = (dSolveRequest_t *)
+	   SUPERLU_MALLOC(max_nrhs * sizeof(dSolveRequest_t))) )
+	ABORT("Malloc fails for Q->req[].");
+    return 0;
+}
+
+/* Solve nrhs right-hand sides stored in B with leading dimension ldb. */
+static int pdSolveQueue_solve(dSolveQueue_t *Q, double *B, int ldb, int nrhs,
+                             double *berr)
+{
+    int info;
+    fact_t fact = Q->options->Fact;
+
+    Q->options->Fact = FACTORED;
+    pdgssvx(Q->options, Q->A, Q->ScalePermstruct, B, ldb, nrhs, Q->grid,
+	    Q->LUstruct, Q->SOLVEstruct, berr, Q->stat, &info);
+    Q->options->Fact = fact;
+    return info;
+}
+
+/*! \brief Solve all the pending right-hand sides with one call to
+ *  PDGSSVX, and copy the solutions back. Returns the info of PDGSSVX.
+ */
+int pdSolveQueueFlush(dSolveQueue_t *Q)
+{
+    dSolveRequest_t *r;
+    int_t i, m_loc = Q->m_loc, ldB = SUPERLU_MAX(m_loc, 1);
+    int j, k, col;
+
+    if ( Q->nreq == 0 ) return 0;
+
+    /* Gather the pending columns into one block. */
+    for (k = 0, col = 0; k < Q->nreq; ++k) {
+	r = &Q->req[k];
+	for (j = 0; j < r->nrhs; ++j, ++col)
+	    for (i = 0; i < m_loc; ++i)
+		Q->B[i + col * ldB] = r->b[i + j * r->ldb];
+    }
+
+    Q->info = pdSolveQueue_solve(Q, Q->B, ldB, Q->nrhs, Q->berr);
+
+    /* Scatter the solutions back to the callers. */
+    for (k = 0, col = 0; k < Q->nreq; ++k) {
+	r = &Q->req[k];
+	for (j = 0; j < r->nrhs; ++j, ++col) {
+	    for (i = 0; i < m_loc; ++i)
+		r->b[i + j * r->ldb] = Q->B[i + col * ldB];
+	    if ( r->berr ) r->berr[j] = Q->berr[col];
+	}
+    }
+    Q->first += Q->nreq;
+    Q->nreq = 0;
+    Q->nrhs = 0;
+    return Q->info;
+}
+
+/*! \brief Submit nrhs right-hand sides to the queue.
+ *
+ * <pre>
+ * b holds the local rows of the right-hand sides, with leading dimension
+ * ldb; it is overwritten by the solution when the request is solved, and
+ * must not be used before pdSolveQueueWait() has returned for it. If
+ * berr is not NULL, the componentwise relative backward errors are
+ * stored in berr[0:nrhs-1] at the same time.
+ *
+ * If the request does not fit in the queue, the pending requests are
+ * solved first; a request with more than max_nrhs columns is solved
+ * directly. Returns a ticket to be passed to pdSolveQueueWait().
+ * </pre>
+ */
+int pdSolveQueueSubmit(dSolveQueue_t *Q, double *b, int ldb, int nrhs,
+                       double *berr)
+{
+    dSolveRequest_t *r;
+    int ticket;
+
+    if ( Q->nrhs + nrhs > Q->max_nrhs ) pdSolveQueueFlush(Q);
+    ticket = Q->first + Q->nreq;
+    if ( nrhs > Q->max_nrhs ) {
+	double *berr1 = berr;
+	if ( !berr1 && !(berr1 = doubleMalloc_dist(nrhs)) )
+	    ABORT("Malloc fails for berr1[].");
+	Q->info = pdSolveQueue_solve(Q, b, ldb, nrhs, berr1);
+	if ( berr1 != berr ) SUPERLU_FREE(berr1);
+	++Q->first;
+	return ticket;
+    }
+
+    r = &Q->req[Q->nreq++];
+    r->b = b;
+    r->ldb = ldb;
+    r->nrhs = nrhs;
+    r->berr = berr;
+    Q->nrhs += nrhs;
+    return ticket;
+}
+
+/*! \brief Wait until the request with the given ticket is solved.
+ *
+ * Solves the pending requests if the ticket is among them. Returns the
+ * info of the last call to PDGSSVX.
+ */
+int pdSolveQueueWait(dSolveQueue_t *Q, int ticket)
+{
+    if ( ticket >= Q->first ) pdSolveQueueFlush(Q);
+    return Q->info;
+}
+
+/*! \brief Solve the pending requests, and free the storage of the queue.
+ *  The structures given to pdSolveQueueInit() are not freed.
+ */
+void pdSolveQueueFinalize(dSolveQueue_t *Q)
+{
+    pdSolveQueueFlush(Q);
+    SUPERLU_FREE(Q->B);
+    SUPERLU_FREE(Q->berr);
+    SUPERLU_FREE(Q->req);
+}
@@ -161,6 +161,8 @@ pdgstrf2_trsm
     MPI_Status status;
     MPI_Comm comm = (grid->cscp).comm;
     double t1, t2;
+    flops_t ops = 0.0; /* added to stat at the end, see below */
+    int tiny = 0;
 
     /* Initialization. */
     iam = grid->iam;
@@ -228,7 +230,7 @@ pdgstrf2_trsm
 #if ( PRNTlevel>=2 )
                     printf ("replaced by %e\n", lusup[i]);
 #endif
-                    ++(stat->TinyPivots);
+                    ++tiny;
                 }
             }
 
@@ -250,7 +252,7 @@ pdgstrf2_trsm
                 temp = 1.0 / ujrow[0];
                 for (i = luptr + 1; i < luptr - j + nsupc; ++i)
 		    lusup[i] *= temp;
-                stat->ops[FACT] += nsupc - j - 1;
+                ops += nsupc - j - 1;
             }
 
             /* Rank-1 update of the trailing submatrix within diag. block. */
@@ -260,7 +262,7 @@ pdgstrf2_trsm
                 dger_ (&l, &cols_left, &alpha, &lusup[luptr + 1], &incx,
                        &ujrow[ld_ujrow], &incy, &lusup[luptr + nsupr + 1],
                        &nsupr);
-                stat->ops[FACT] += 2 * l * cols_left;
+                ops += 2 * l * cols_left;
             }
 
             /* ujrow = ublk_ptr + u_diag_cnt;  */
@@ -316,7 +318,7 @@ pdgstrf2_trsm
         dtrsm_ ("R", "U", "N", "N", &l, &nsupc,
                 &alpha, ublk_ptr, &ld_ujrow, &lusup[nsupc], &nsupr);
 #endif
-	stat->ops[FACT] += (flops_t) nsupc * (nsupc+1) * l;
+	ops += (flops_t) nsupc * (nsupc+1) * l;
     } else {  /* non-diagonal process */
         /* ================================================================== *
          * Receive the diagonal block of U for panel factorization of L(:,k). *
@@ -353,13 +355,24 @@ pdgstrf2_trsm
             dtrsm_ ("R", "U", "N", "N", &nsupr, &nsupc,
                     &alpha, ublk_ptr, &ld_ujrow, lusup, &nsupr);
 #endif
-	    stat->ops[FACT] += (flops_t) nsupc * (nsupc+1) * nsupr;
+	    ops += (flops_t) nsupc * (nsupc+1) * nsupr;
         }
 
     } /* end if pkk ... */
 
     /* printf("exiting pdgstrf2 %d \n", grid->iam);  */
 
+    /* With options->SchurTasks, this runs in a task while the master
+       thread adds the flops of the Schur update to stat. */
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    stat->ops[FACT] += ops;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    stat->TinyPivots += tiny;
+
 }  /* PDGSTRF2_trsm */
 
 
@@ -179,7 +179,7 @@ int_t pdgstrf3d(superlu_dist_options_t *options, int m, int n, double anorm,
 
     // tag_ub initialization
     int tag_ub = set_tag_ub();
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
 #if ( PRNTlevel>=1 )
     if (grid3d->iam == 0) {
@@ -77,7 +77,7 @@ int_t dtrs_B_init3d_newsolve(int_t nsupers, double* x, int nrhs, dLUstruct_t * L
 	int_t mycol = MYCOL( iam, grid );
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     double zero = 0.0;
     double* xtmp;
     sForest_t** sForests = trf3Dpartition->sForests;
@@ -227,6 +227,15 @@ int dtrs_compute_communication_structure(superlu_dist_options_t *options, int_t
     int *h_recv_cnt;
     int *h_recv_cnt_u;
 
+    /* Shape of the broadcast and reduction trees. The device code of the
+       NVSHMEM solve assumes binary trees. */
+    C_TreeTopo topo;
+#ifdef HAVE_NVSHMEM
+    C_TreeTopo_Init(&topo, BINARY_TREE, grid->comm);
+#else
+    C_TreeTopo_Init(&topo, options->CommTree, grid->comm);
+#endif
+
     /* Reconstruct the global L structure and compute the communication metadata */
 
     if ( !(tmpglo = intCalloc_dist(nsupers)) )
@@ -407,7 +416,7 @@ int dtrs_compute_communication_structure(superlu_dist_options_t *options, int_t
 
                         msgsize = SuperSize( jb );
                         int needrecv=0;
-                        C_BcTree_Create_nv(&LBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'd',&needrecv);
+                        C_BcTree_Create_topo(&LBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'd',&needrecv, &topo);
                         //C_BcTree_Create(&LBtree_ptr[ljb], grid->comm, ranks, rank_cnt, msgsize, 'd');
                         //printf("(%d) HOST create:ljb=%d,msg=%d,needrecv=%d\n",iam,ljb,mysendmsg_num,needrecv);
                         #ifdef GPU_ACC
@@ -521,7 +530,7 @@ int dtrs_compute_communication_structure(superlu_dist_options_t *options, int_t
 
                         int needrecvrd=0;
                         int needsendrd=0;
-                        C_RdTree_Create_nv(&LRtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'd', &needrecvrd, &needsendrd);
+                        C_RdTree_Create_topo(&LRtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'd', &needrecvrd, &needsendrd, &topo);
                         //C_RdTree_Create(&LRtree_ptr[lib], grid->comm, ranks, rank_cnt, msgsize, 'd');
                         #ifdef GPU_ACC
                         #ifdef HAVE_NVSHMEM
@@ -737,7 +746,7 @@ int dtrs_compute_communication_structure(superlu_dist_options_t *options, int_t
                         // C_BcTree_Create(&UBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'd');
 
                         int needrecv=0;
-                        C_BcTree_Create_nv(&UBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'd',&needrecv);
+                        C_BcTree_Create_topo(&UBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'd',&needrecv, &topo);
                         //C_BcTree_Create(&UBtree_ptr[ljb], grid->comm, ranks, rank_cnt, msgsize, 'd');
                         #ifdef GPU_ACC
                         #ifdef HAVE_NVSHMEM
@@ -848,7 +857,7 @@ int dtrs_compute_communication_structure(superlu_dist_options_t *options, int_t
 
                         int needrecvrd=0;
                         int needsendrd=0;
-                        C_RdTree_Create_nv(&URtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'd', &needrecvrd,&needsendrd);
+                        C_RdTree_Create_topo(&URtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 'd', &needrecvrd,&needsendrd, &topo);
                         //C_RdTree_Create(&URtree_ptr[lib], grid->comm, ranks, rank_cnt, msgsize, 'd');
                         #ifdef GPU_ACC
                         #ifdef HAVE_NVSHMEM
@@ -1398,6 +1407,7 @@ int dtrs_compute_communication_structure(superlu_dist_options_t *options, int_t
     //     }
     // }
 
+    C_TreeTopo_Free(&topo);
     return 0;
 } // end dtrs_compute_communication_structure
 
@@ -1406,7 +1416,7 @@ int dtrs_compute_communication_structure(superlu_dist_options_t *options, int_t
 int_t dtrs_x_reduction_newsolve(int_t nsupers, double* x, int nrhs, dLUstruct_t * LUstruct, gridinfo3d_t *grid3d, dtrf3Dpartition_t*  trf3Dpartition, double* recvbuf, xtrsTimer_t *xtrsTimer)
 
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
 	int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
@@ -1450,7 +1460,7 @@ int_t dtrs_x_reduction_newsolve(int_t nsupers, double* x, int nrhs, dLUstruct_t
 int_t dtrs_x_broadcast_newsolve(int_t nsupers, double* x, int nrhs, dLUstruct_t * LUstruct, gridinfo3d_t *grid3d, dtrf3Dpartition_t*  trf3Dpartition, double* recvbuf, xtrsTimer_t *xtrsTimer)
 
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
 	int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
@@ -1495,6 +1505,8 @@ int_t dreduceSolvedX_newsolve(int_t treeId, int_t sender, int_t receiver, double
 {
 	sForest_t** sForests = trf3Dpartition->sForests;
 	sForest_t* sforest = sForests[treeId];
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
 	if (!sforest) return 0;
 	int_t nnodes = sforest->nNodes ;
 	int_t *nodeList = sforest->nodeList ;
@@ -1554,7 +1566,7 @@ int_t dtrs_X_gather3d(double* x, int nrhs, dtrf3Dpartition_t*  trf3Dpartition,
                      gridinfo3d_t* grid3d, xtrsTimer_t *xtrsTimer)
 
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
 
@@ -1599,6 +1611,8 @@ int_t dp2pSolvedX3d(int_t treeId, int_t sender, int_t receiver, double* x, int n
 {
 	sForest_t** sForests = trf3Dpartition->sForests;
 	sForest_t* sforest = sForests[treeId];
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
 	if (!sforest) return 0;
 	int_t nnodes = sforest->nNodes ;
 	int_t *nodeList = sforest->nodeList ;
@@ -1650,6 +1664,8 @@ int_t dfsolveReduceLsum3d(int_t treeId, int_t sender, int_t receiver, double* ls
 {
 	sForest_t** sForests = trf3Dpartition->sForests;
 	sForest_t* sforest = sForests[treeId];
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
 	if (!sforest) return 0;
 	int_t nnodes = sforest->nNodes ;
 	int_t *nodeList = sforest->nodeList ;
@@ -1726,7 +1742,7 @@ int_t dbsolve_Xt_bcast(int_t ilvl, dxT_struct *xT_s, int nrhs, dtrf3Dpartition_t
     int_t *ilsum = Llu->ilsum;
     int_t* xsup = Glu_persist->xsup;
 
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	gridinfo_t * grid = &(grid3d->grid2d);
 	int_t myGrid = grid3d->zscp.Iam;
 		int_t iam = grid->iam;
@@ -1752,6 +1768,9 @@ int_t dbsolve_Xt_bcast(int_t ilvl, dxT_struct *xT_s, int nrhs, dtrf3Dpartition_t
 		sender = myGrid - (1 << ilvl);
 	}
 
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
+
 	for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
 	{
 		/* code */
@@ -6774,7 +6793,7 @@ pdgstrs3d (superlu_dist_options_t *options, int_t n, dLUstruct_t * LUstruct,
 
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -6814,7 +6833,7 @@ pdgstrs3d (superlu_dist_options_t *options, int_t n, dLUstruct_t * LUstruct,
 
 
 
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -6857,7 +6876,7 @@ pdgstrs3d (superlu_dist_options_t *options, int_t n, dLUstruct_t * LUstruct,
                        recvbuf, send_req,  nrhs, SOLVEstruct,  stat, &xtrsTimer);
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7105,7 +7124,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7145,7 +7164,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 
     // printf("Llu->SolveMsgSent %10d size %10d\n",Llu->SolveMsgSent,SUPERLU_MAX (Llu->nfsendx, Llu->nbsendx) + nlb);
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7183,7 +7202,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
     xtrsTimer.trs_comm_z += SuperLU_timer_() - tx;
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7228,7 +7247,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 
     // printf("pdgsTrBackSolve3d_newsolve Llu->SolveMsgSent %10d size %10d\n",Llu->SolveMsgSent,SUPERLU_MAX (Llu->nfsendx, Llu->nbsendx) + nlb);
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7335,7 +7354,7 @@ int_t pdgsTrForwardSolve3d(superlu_dist_options_t *options, int_t n, dLUstruct_t
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -7480,7 +7499,7 @@ int_t pdgsTrForwardSolve3d_newsolve(superlu_dist_options_t *options, int_t n, dL
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -7589,7 +7608,7 @@ int_t pdgsTrBackSolve3d(superlu_dist_options_t *options, int_t n, dLUstruct_t *
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -7623,8 +7642,8 @@ int_t pdgsTrBackSolve3d(superlu_dist_options_t *options, int_t n, dLUstruct_t *
     int_t nsupc = sp_ienv_dist (3,options);
     dinitLsumBmod_buff(nsupc, nrhs, &lbmod_buf);
 
-    int_t numTrees = 2 * grid3d->zscp.Np - 1;
-    int_t nLeafTrees = grid3d->zscp.Np;
+    int_t numTrees = (1 << maxLvl) - 1;
+    int_t nLeafTrees = 1 << (maxLvl - 1);
     Llu->SolveMsgSent = 0;
     for (int_t ilvl = maxLvl - 1; ilvl >= 0  ; --ilvl)
     {
@@ -7714,7 +7733,7 @@ int_t pdgsTrBackSolve3d_newsolve(superlu_dist_options_t *options, int_t n, dLUst
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
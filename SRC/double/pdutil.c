@@ -38,6 +38,21 @@ int pdCompRow_loc_to_CompCol_global
  gridinfo_t *grid, /* Input */
  SuperMatrix *GA   /* Output */
 )
+{
+    return pdCompRow_loc_to_CompCol_node(need_value, A, grid, NULL, GA);
+}
+
+/*! \brief As pdCompRow_loc_to_CompCol_global(), but if node is not NULL, only the
+ *  leader of each node gets GA; GA->Store is NULL on the other processes.
+ */
+int pdCompRow_loc_to_CompCol_node
+(
+ int_t need_value, /* Input. Whether need to gather numerical values */
+ SuperMatrix *A,   /* Input. Distributed matrix in NRformat_loc format. */
+ gridinfo_t *grid, /* Input */
+ superlu_node_t *node, /* Input. Nodes of grid->comm, or NULL */
+ SuperMatrix *GA   /* Output */
+)
 {
     NRformat_loc *Astore;
     NCformat *GAstore;
@@ -60,6 +75,7 @@ int pdCompRow_loc_to_CompCol_global
     int_t *fst_rows, *n_locs;
     int   *sendcnts, *sdispls, *recvcnts, *rdispls, *itemp_32;
     int   it, n_loc, procs;
+    int   have_GA = !node || node->leader;
 
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Enter pdCompRow_loc_to_CompCol_global");
@@ -227,10 +243,14 @@ int pdCompRow_loc_to_CompCol_global
     for (i = 0, nnz = 0; i < procs; ++i) nnz += itemp[i];
     GAstore->nnz = nnz;
 
-    if ( !(GAstore->rowind = (int_t *) intMalloc_dist (nnz)) )
-        ABORT ("SUPERLU_MALLOC fails for GAstore->rowind[]");
-    if ( !(GAstore->colptr = (int_t *) intMalloc_dist (n+1)) )
-        ABORT ("SUPERLU_MALLOC fails for GAstore->colptr[]");
+    GAstore->rowind = GAstore->colptr = NULL;
+    GAstore->nzval = NULL;
+    if ( have_GA ) {
+      if ( !(GAstore->rowind = (int_t *) intMalloc_dist (nnz)) )
+          ABORT ("SUPERLU_MALLOC fails for GAstore->rowind[]");
+      if ( !(GAstore->colptr = (int_t *) intMalloc_dist (n+1)) )
+          ABORT ("SUPERLU_MALLOC fails for GAstore->colptr[]");
+    }
 
     /* Allgatherv for row indices. */
     rdispls[0] = 0;
@@ -240,14 +260,14 @@ int pdCompRow_loc_to_CompCol_global
     }
     itemp_32[procs-1] = itemp[procs-1];
     it = nnz_loc;
-    MPI_Allgatherv(rowind_buf, it, mpi_int_t, GAstore->rowind,
-		   itemp_32, rdispls, mpi_int_t, grid->comm);
+    superlu_node_allgatherv(node, rowind_buf, it, GAstore->rowind,
+			    itemp_32, rdispls, mpi_int_t, grid);
     if ( need_value ) {
-      if ( !(GAstore->nzval = (double *) doubleMalloc_dist (nnz)) )
+      if ( have_GA && !(GAstore->nzval = (double *) doubleMalloc_dist (nnz)) )
           ABORT ("SUPERLU_MALLOC fails for GAstore->rnzval[]");
-      MPI_Allgatherv(a_buf, it, MPI_DOUBLE, GAstore->nzval,
-		     itemp_32, rdispls, MPI_DOUBLE, grid->comm);
-    } else GAstore->nzval = NULL;
+      superlu_node_allgatherv(node, a_buf, it, GAstore->nzval,
+			      itemp_32, rdispls, MPI_DOUBLE, grid);
+    }
 
     /* Now gather the column pointers. */
     rdispls[0] = 0;
@@ -256,16 +276,21 @@ int pdCompRow_loc_to_CompCol_global
         itemp_32[i] = n_locs[i];
     }
     itemp_32[procs-1] = n_locs[procs-1];
-    MPI_Allgatherv(colptr_loc, n_loc, mpi_int_t, GAstore->colptr,
-		   itemp_32, rdispls, mpi_int_t, grid->comm);
+    superlu_node_allgatherv(node, colptr_loc, n_loc, GAstore->colptr,
+			    itemp_32, rdispls, mpi_int_t, grid);
 
     /* Recompute column pointers. */
-    for (i = 1; i < procs; ++i) {
+    if ( have_GA ) {
+      for (i = 1; i < procs; ++i) {
         k = rdispls[i];
 	for (j = 0; j < n_locs[i]; ++j) GAstore->colptr[k++] += itemp[i-1];
 	itemp[i] += itemp[i-1]; /* prefix sum */
+      }
+      GAstore->colptr[n] = nnz;
+    } else {
+      SUPERLU_FREE(GAstore);
+      GA->Store = NULL;
     }
-    GAstore->colptr[n] = nnz;
 
 #if ( DEBUGlevel>=2 )
     if ( !grid->iam ) {
@@ -416,6 +441,11 @@ void dLUstructInit(const int_t n, dLUstruct_t *LUstruct)
 	   SUPERLU_MALLOC(sizeof(dLocalLU_t))) )
 	ABORT("Malloc fails for LocalLU_t.");
 	LUstruct->Llu->inv = 0;
+	LUstruct->Llu->LUfile_map = NULL;
+	LUstruct->Llu->Amap = NULL;
+	LUstruct->trf3Dpart = NULL;
+	LUstruct->mixed = NULL;
+	superlu_tune_reset(&LUstruct->tune);
 }
 
 /*! \brief Deallocate LUstruct */
@@ -427,6 +457,7 @@ void dLUstructFree(dLUstruct_t *LUstruct)
     CHECK_MALLOC(iam, "Enter dLUstructFree()");
 #endif
 
+    if ( LUstruct->mixed ) dLUstructFree_mp(LUstruct);
     SUPERLU_FREE(LUstruct->etree);
     SUPERLU_FREE(LUstruct->Glu_persist);
     SUPERLU_FREE(LUstruct->Llu);
@@ -451,6 +482,9 @@ dDestroy_LU(int_t n, gridinfo_t *grid, dLUstruct_t *LUstruct)
     CHECK_MALLOC(iam, "Enter dDestroy_LU()");
 #endif
 
+    /* The factors of options->MixedPrecLU are in single precision. */
+    if ( LUstruct->mixed && dDestroy_LU_mp(LUstruct) ) return;
+
     dDestroy_Tree(n, grid, LUstruct);
 
     nsupers = Glu_persist->supno[n-1] + 1;
@@ -468,15 +502,15 @@ dDestroy_LU(int_t n, gridinfo_t *grid, dLUstruct_t *LUstruct)
     //	}
 
     SUPERLU_FREE (Llu->Lrowind_bc_ptr);
-    SUPERLU_FREE (Llu->Lrowind_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE (Llu->Lrowind_bc_dat);
     SUPERLU_FREE (Llu->Lrowind_bc_offset);
     SUPERLU_FREE (Llu->Lnzval_bc_ptr);
-    SUPERLU_FREE (Llu->Lnzval_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE (Llu->Lnzval_bc_dat);
     SUPERLU_FREE (Llu->Lnzval_bc_offset);
 
     /* Following are free'd in distribution routines */
     nb = CEILING(nsupers, grid->nprow);
-    for (i = 0; i < nb; ++i)
+    for (i = 0; i < nb && !Llu->LUfile_map; ++i)
     	if ( Llu->Ufstnz_br_ptr[i] ) {
     	    SUPERLU_FREE (Llu->Ufstnz_br_ptr[i]);
     	    SUPERLU_FREE (Llu->Unzval_br_ptr[i]);
@@ -511,7 +545,7 @@ dDestroy_LU(int_t n, gridinfo_t *grid, dLUstruct_t *LUstruct)
     //	    SUPERLU_FREE (Llu->Lindval_loc_bc_ptr[i]);
     //	}
     SUPERLU_FREE(Llu->Lindval_loc_bc_ptr);
-    SUPERLU_FREE(Llu->Lindval_loc_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Lindval_loc_bc_dat);
     SUPERLU_FREE(Llu->Lindval_loc_bc_offset);
 
     /* Following are free'd in distribution routines */
@@ -525,13 +559,22 @@ dDestroy_LU(int_t n, gridinfo_t *grid, dLUstruct_t *LUstruct)
     //	}
     // }
     SUPERLU_FREE(Llu->Linv_bc_ptr);
-    SUPERLU_FREE(Llu->Linv_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Linv_bc_dat);
     SUPERLU_FREE(Llu->Linv_bc_offset);
     SUPERLU_FREE(Llu->Uinv_bc_ptr);
-    SUPERLU_FREE(Llu->Uinv_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Uinv_bc_dat);
     SUPERLU_FREE(Llu->Uinv_bc_offset);
     SUPERLU_FREE(Llu->Unnz);
 
+    /* The L and U data mapped by pdMapLU() are released by unmapping. */
+    if ( Llu->LUfile_map ) {
+	superlu_LUfile_unmap(Llu->LUfile_map, Llu->LUfile_map_size);
+	Llu->LUfile_map = NULL;
+    }
+
+    dAmapFree(Llu->Amap);
+    Llu->Amap = NULL;
+
     /* Following are free'd in distribution routines */
     nb = CEILING(nsupers, grid->npcol);
     for (i = 0; i < nb; ++i)
@@ -769,6 +812,7 @@ pdgstrs_init(int_t n, int_t m_loc, int_t nrhs, int_t fst_row,
         ABORT("Malloc fails for ptr_to_ibuf[].");
     gstrs_comm->ptr_to_ibuf = ptr_to_ibuf;
     gstrs_comm->ptr_to_dbuf = ptr_to_ibuf + procs;
+    gstrs_comm->nrhs = nrhs;
 
     return 0;
 } /* PDGSTRS_INIT */
@@ -1187,6 +1231,11 @@ int dSolveInit(superlu_dist_options_t *options, SuperMatrix *A,
         ABORT("Malloc fails for gsmv_comm[]");
     SOLVEstruct->A_colind_gsmv = NULL;
 
+    if ( !(SOLVEstruct->gstrs_work = (dgstrs_work_t *)
+           SUPERLU_MALLOC(sizeof(dgstrs_work_t))) )
+        ABORT("Malloc fails for gstrs_work[]");
+    memset(SOLVEstruct->gstrs_work, 0, sizeof(dgstrs_work_t));
+
     options->SolveInitialized = YES;
     return 0;
 } /* dSolveInit */
@@ -1209,6 +1258,25 @@ void dSolveFinalize(superlu_dist_options_t *options, dSOLVEstruct_t *SOLVEstruct
         SUPERLU_FREE(SOLVEstruct->diag_len);
         if ( SOLVEstruct->A_colind_gsmv )
 	    SUPERLU_FREE(SOLVEstruct->A_colind_gsmv);
+        if ( SOLVEstruct->gstrs_work->lsum )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->lsum);
+        if ( SOLVEstruct->gstrs_work->x )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->x);
+        if ( SOLVEstruct->gstrs_work->rtemp )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->rtemp);
+        if ( SOLVEstruct->gstrs_work->recvbuf )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->recvbuf);
+        superlu_shm_free(SOLVEstruct->gstrs_work->shm);
+        superlu_arena_free(&SOLVEstruct->gstrs_work->arena);
+        if ( SOLVEstruct->gstrs_work->redist_ibuf )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_ibuf);
+        if ( SOLVEstruct->gstrs_work->redist_dbuf )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_dbuf);
+        if ( SOLVEstruct->gstrs_work->redist_req ) {
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_req);
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_status);
+        }
+        SUPERLU_FREE(SOLVEstruct->gstrs_work);
         options->SolveInitialized = NO;
     }
 } /* dSolveFinalize */
@@ -89,6 +89,22 @@ typedef struct {
 } Ucb_indptr_t;
 #endif
 
+/*
+ * Map of the local nonzeros of A into the L and U factors, built by
+ * pddistribute() on the first call with Fact = SamePattern_SameRowPerm,
+ * and used by the later ones to move only the values of A.
+ */
+typedef struct {
+    int_t  nnz_loc, m_loc, fst_row; /* local part of A the map is for      */
+    int_t  *sendpos;    /* nzval[j] of A goes to sendbuf[sendpos[j]]       */
+    int    *sendcnt, *sdispls, *recvcnt, *rdispls; /* for MPI_Alltoallv    */
+    int_t  nrecv;       /* number of values received                      */
+    int_t  *blk;        /* recvbuf[k] goes to Lnzval_bc_ptr[blk[k]] if
+			   blk[k] >= 0, to Unzval_br_ptr[-blk[k]-1] if not */
+    int_t  *off;        /* ... at offset off[k]                           */
+    double *sendbuf, *recvbuf;
+} dAmap_t;
+
 /*
  * On each processor, the blocks in L are stored in compressed block
  * column format, the blocks in U are stored in compressed block row format.
@@ -171,6 +187,12 @@ typedef struct {
     long int *Unzval_br_offset;  /* size ceil(NSUPERS/Pr)    */
     long int Unzval_br_cnt;
 
+    void    *LUfile_map;      /* Non-NULL if the L and U arrays point into the
+				 file mapped by pdMapLU(); they are then
+				 released by unmapping, not freed */
+    size_t  LUfile_map_size;
+    dAmap_t *Amap;            /* see pddistribute(); NULL until built */
+
         /*-- Data structures used for broadcast and reduction trees. --*/
     C_Tree  *LBtree_ptr;       /* size ceil(NSUPERS/Pc)                */
     C_Tree  *LRtree_ptr;       /* size ceil(NSUPERS/Pr)                */
@@ -329,6 +351,7 @@ typedef struct
     dLUValSubBuf_t  *LUvsb;
     SupernodeToGridMap_t* superGridMap;
     int maxLvl; // YL: store this to avoid the use of grid3d
+    double imbalance; /* predicted by getForestImbalance() */
 
     /* Sherry added the following 3 for variable size batch. 2/17/23 */
     int mxLeafNode; /* number of leaf nodes. */
@@ -343,6 +366,9 @@ typedef struct {
     dLocalLU_t *Llu;
     dtrf3Dpartition_t *trf3Dpart;
     char dt;
+    struct dMixedLU *mixed; /* single-precision factors of
+			       options->MixedPrecLU, see pdgssvx_mp.c */
+    superlu_tune_state_t tune; /* options->AutoTune, see superlu_tune.c */
 } dLUstruct_t;
 
 
@@ -367,6 +393,21 @@ typedef struct {
 			     (also total number of indices to be received) */
 } pdgsmv_comm_t;
 
+/*-- Work arrays of pdgstrs(), kept across calls in dSOLVEstruct_t --*/
+typedef struct {
+    double *lsum, *x, *rtemp, *recvbuf;
+    size_t lsum_size, x_size, rtemp_size, recvbuf_size;
+    superlu_shm_t *shm;  /* intra-node channel, see options->IntraNodeShm */
+    int    shm_tried;      /* whether shm was created (may be NULL) */
+    size_t shm_slotsize;   /* slot size agreed by all processes     */
+    superlu_arena_t arena; /* other work arrays of one call, reset at exit */
+    int_t  *redist_ibuf;   /* send/receive buffers of pdReDistribute_*() */
+    double *redist_dbuf;
+    size_t redist_isize, redist_dsize;
+    MPI_Request *redist_req;    /* 2*procs: sends, then receives */
+    MPI_Status  *redist_status;
+} dgstrs_work_t;
+
 /*-- Data structure holding the information for the solution phase --*/
 typedef struct {
     int_t *row_to_proc;
@@ -383,6 +424,8 @@ typedef struct {
     NRformat_loc3d* A3d; /* Point to 3D {A, B} gathered on 2D layer 0.
                             This needs to be peresistent between
 			    3D factorization and solve.  */
+    dgstrs_work_t *gstrs_work; /* Work arrays of pdgstrs(), kept across
+				 calls and enlarged when nrhs grows. */
     #ifdef GPU_ACC
     double *d_lsum, *d_lsum_save;      /* used for device lsum*/
     double *d_x;         /* used for device solution vector*/
@@ -391,6 +434,34 @@ typedef struct {
     #endif
 } dSOLVEstruct_t;
 
+/*-- A right-hand side waiting in a dSolveQueue_t --*/
+typedef struct {
+    double *b;     /* local rows of the right-hand sides, overwritten by X */
+    int    ldb;
+    int    nrhs;
+    double *berr;  /* backward errors, may be NULL */
+} dSolveRequest_t;
+
+/*-- Queue of right-hand sides solved together, see pdgssvx_queue.c --*/
+typedef struct {
+    superlu_dist_options_t *options;
+    SuperMatrix *A;
+    dScalePermstruct_t *ScalePermstruct;
+    dLUstruct_t *LUstruct;
+    dSOLVEstruct_t *SOLVEstruct;
+    gridinfo_t *grid;
+    SuperLUStat_t *stat;
+    int_t  m_loc;
+    int    max_nrhs;  /* most columns solved by one call to pdgssvx */
+    int    nrhs;      /* pending columns */
+    int    nreq;      /* pending requests */
+    int    first;     /* ticket of the first pending request */
+    int    info;      /* info of the last call to pdgssvx */
+    double *B;        /* m_loc x max_nrhs block of the pending columns */
+    double *berr;
+    dSolveRequest_t *req;
+} dSolveQueue_t;
+
 
 
 /*==== For 3D code ====*/
@@ -513,6 +584,9 @@ dCompCol_to_CompRow_dist(int_t m, int_t n, int_t nnz,
 extern int
 pdCompRow_loc_to_CompCol_global(int_t, SuperMatrix *, gridinfo_t *,
 	 		        SuperMatrix *);
+extern int
+pdCompRow_loc_to_CompCol_node(int_t, SuperMatrix *, gridinfo_t *,
+			      superlu_node_t *, SuperMatrix *);
 extern void
 dCopy_CompCol_Matrix_dist(SuperMatrix *, SuperMatrix *);
 extern void
@@ -538,6 +612,13 @@ extern int     dcreate_matrix_dat(SuperMatrix *, int, double **, int *,
 			      double **, int *, FILE *, gridinfo_t *);
 extern int dcreate_matrix_postfix(SuperMatrix *, int, double **, int *,
 				  double **, int *, FILE *, char *, gridinfo_t *);
+extern int dcreate_matrix_binary(SuperMatrix *, int, double **, int *,
+				  double **, int *, char *, gridinfo_t *);
+extern FILE *dparse_driver_args(char *[], int *, int *,
+				void (*)(int, char *, void *), void *,
+				char **, char **);
+extern int dcreate_matrix_gen(SuperMatrix *, int, double **, int *,
+			      double **, int *, char *, MPI_Comm);
 
 extern void   dScalePermstructInit(const int_t, const int_t,
                                       dScalePermstruct_t *);
@@ -575,6 +656,7 @@ extern void  pdgssvx_ABglobal(superlu_dist_options_t *, SuperMatrix *,
 extern float pddistribute(superlu_dist_options_t *, int_t, SuperMatrix *,
 			 dScalePermstruct_t *, Glu_freeable_t *,
 			 dLUstruct_t *, gridinfo_t *);
+extern void  dAmapFree(dAmap_t *);
 extern float pddistribute_allgrid(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 	     dScalePermstruct_t *ScalePermstruct,
 	     Glu_freeable_t *Glu_freeable, dLUstruct_t *LUstruct,
@@ -588,10 +670,23 @@ extern void  pdgssvx(superlu_dist_options_t *, SuperMatrix *,
 		     dScalePermstruct_t *, double *,
 		     int, int, gridinfo_t *, dLUstruct_t *,
 		     dSOLVEstruct_t *, double *, SuperLUStat_t *, int *);
+extern void  pdgssvx_mp(superlu_dist_options_t *, SuperMatrix *,
+			dScalePermstruct_t *, double *,
+			int, int, gridinfo_t *, dLUstruct_t *,
+			dSOLVEstruct_t *, double *, SuperLUStat_t *, int *);
+extern int   dDestroy_LU_mp(dLUstruct_t *);
+extern void  dLUstructFree_mp(dLUstruct_t *);
 extern void  pdCompute_Diag_Inv(int_t, dLUstruct_t *,gridinfo_t *, SuperLUStat_t *, int *);
 extern int  dSolveInit(superlu_dist_options_t *, SuperMatrix *, int_t [], int_t [],
 		       int_t, dLUstruct_t *, gridinfo_t *, dSOLVEstruct_t *);
 extern void dSolveFinalize(superlu_dist_options_t *, dSOLVEstruct_t *);
+extern int  pdSolveQueueInit(dSolveQueue_t *, int, superlu_dist_options_t *,
+                            SuperMatrix *, dScalePermstruct_t *, dLUstruct_t *,
+                            dSOLVEstruct_t *, gridinfo_t *, SuperLUStat_t *);
+extern int  pdSolveQueueSubmit(dSolveQueue_t *, double *, int, int, double *);
+extern int  pdSolveQueueWait(dSolveQueue_t *, int);
+extern int  pdSolveQueueFlush(dSolveQueue_t *);
+extern void pdSolveQueueFinalize(dSolveQueue_t *);
 extern void dDestroy_A3d_gathered_on_2d(dSOLVEstruct_t *, gridinfo3d_t *);
 extern int_t pdgstrs_init(int_t, int_t, int_t, int_t,
                           int_t [], int_t [], gridinfo_t *grid,
@@ -600,8 +695,11 @@ extern int_t pdgstrs_init_device_lsum_x(superlu_dist_options_t *, int_t , int_t
 	     dLUstruct_t *, dSOLVEstruct_t *, int*);
 extern int_t pdgstrs_delete_device_lsum_x(dSOLVEstruct_t *);
 extern void pxgstrs_finalize(pxgstrs_comm_t *);
+extern void pxgstrs_comm_set_nrhs(pxgstrs_comm_t *, int, int);
 extern int  dldperm_dist(int, int, int_t, int_t [], int_t [],
 		    double [], int_t *, double [], double []);
+extern int  pdldperm_dist(SuperMatrix *, gridinfo_t *, int_t [],
+		    double [], double []);
 extern int  dstatic_schedule(superlu_dist_options_t *, int, int,
 		            dLUstruct_t *, gridinfo_t *, SuperLUStat_t *,
 			    int_t *, int_t *, int *);
@@ -609,6 +707,15 @@ extern void dLUstructInit(const int_t, dLUstruct_t *);
 extern void dLUstructFree(dLUstruct_t *);
 extern void dDestroy_LU(int_t, gridinfo_t *, dLUstruct_t *);
 extern void dDestroy_Tree(int_t, gridinfo_t *, dLUstruct_t *);
+extern int  pdSaveLU(char *, int_t, dScalePermstruct_t *, dLUstruct_t *,
+                     gridinfo_t *);
+extern int  pdLoadLU(char *, int_t, superlu_dist_options_t *,
+                     dScalePermstruct_t *, dLUstruct_t *, gridinfo_t *,
+                     SuperLUStat_t *);
+extern int  pdMapLU(char *, int_t, superlu_dist_options_t *,
+                    dScalePermstruct_t *, dLUstruct_t *, gridinfo_t *,
+                    SuperLUStat_t *);
+extern void pdScalePermA_LUfile(SuperMatrix *, dScalePermstruct_t *);
 extern void dscatter_l (int ib, int ljb, int nsupc, int_t iukp, int_t* xsup,
 			int klst, int nbrow, int_t lptr, int temp_nbrow,
 			int_t* usub, int_t* lsub, double *tempv,
@@ -620,6 +727,22 @@ extern void dscatter_u (int ib, int jb, int nsupc, int_t iukp, int_t * xsup,
                         int_t* lsub, int_t* usub, double* tempv,
                         int_t ** Ufstnz_br_ptr, double **Unzval_br_ptr,
                         gridinfo_t * grid);
+extern void dgemm_scatter_l (int ib, int ljb, int nsupc, int_t iukp,
+			int_t* xsup, int klst, int_t lptr, int temp_nbrow,
+			int ncols, int ldu, double *lval, int ldl,
+			double *uval, int fused_max, int_t* usub,
+			int_t* lsub, double *tempv,
+			int_t* indirect_thread, int_t* indirect2,
+			int_t ** Lrowind_bc_ptr, double **Lnzval_bc_ptr,
+			gridinfo_t * grid);
+extern void dgemm_scatter_u (int ib, int jb, int nsupc, int_t iukp,
+			int_t * xsup, int klst, int_t lptr, int temp_nbrow,
+			int ncols, int ldu, double *lval, int ldl,
+			double *uval, int fused_max, int_t* lsub,
+			int_t* usub, double *tempv,
+			int_t* indirect_thread, int_t* indirect2,
+			int_t ** Ufstnz_br_ptr, double **Unzval_br_ptr,
+			gridinfo_t * grid);
 extern int_t pdgstrf(superlu_dist_options_t *, int, int, double anorm,
 		    dLUstruct_t*, gridinfo_t*, SuperLUStat_t*, int*);
 
@@ -977,8 +1100,12 @@ extern void  dreadrb_dist(int, FILE *, int_t *, int_t *, int_t *,
 		     double **, int_t **, int_t **);
 extern void  dreadMM_dist(FILE *, int_t *, int_t *, int_t *,
 	                  double **, int_t **, int_t **);
+extern int   pdreadMM_dist(char *, SuperMatrix *, gridinfo_t *);
 extern int  dread_binary(FILE *, int_t *, int_t *, int_t *,
 	                  double **, int_t **, int_t **);
+extern int  dwrite_binary(char *, int_t, int_t, int_t,
+	                  double *, int_t *, int_t *);
+extern int  pdread_binary(char *, SuperMatrix *, gridinfo_t *);
 
 extern void validateInput_pdgssvx3d(superlu_dist_options_t *, SuperMatrix *A,
        int ldb, int nrhs, gridinfo3d_t *, int *info);
@@ -1071,6 +1198,9 @@ extern int daxpy_(const int *n, const double *alpha, const double *x,
 extern int superlu_dgemm(const char *transa, const char *transb,
                   int m, int n, int k, double alpha, double *a,
                   int lda, double *b, int ldb, double beta, double *c, int ldc);
+extern int superlu_dgemm_scatter(int m, int n, int k, double *A, int lda,
+                  double *B, int ldb, double *C, int ldc,
+                  int_t *rowmap, int_t *colmap);
 extern int superlu_dtrsm(const char *sideRL, const char *uplo,
                   const char *transa, const char *diag, const int m, const int n,
                   const double alpha, const double *a,
@@ -1608,6 +1738,18 @@ extern int dpivot_batch(
     double **ReqPtr, double **CeqPtr, DiagScale_t *, int **RpivPtr
     //    DeviceContext context /* device context including queues, events, dependencies */
     );
+extern int dgssvx_batch_cpu(
+    superlu_dist_options_t *, int batchCount, int m, int n, int nnz,
+    int nrhs, handle_t *, double **RHSptr, int *ldRHS,
+    double **ReqPtr, double **CeqPtr, int **RpivPtr, int **CpivPtr,
+    DiagScale_t *DiagScale, double **Xptr, int *ldX, double **Berrs,
+    SuperLUStat_t *stat, int *info);
+extern int pdgssvx_batch_cpu(
+    superlu_dist_options_t *, int batchCount, int m, int n, int nnz,
+    int nrhs, handle_t *, double **RHSptr, int *ldRHS,
+    double **ReqPtr, double **CeqPtr, int **RpivPtr, int **CpivPtr,
+    DiagScale_t *DiagScale, double **Xptr, int *ldX, double **Berrs,
+    gridinfo3d_t *, SuperLUStat_t *stat, int *info);
 
 extern int dwriteLUtoDisk(int nsupers, int_t *xsup, dLUstruct_t *LUstruct);
 extern int dcheckArr(double *A, double *B, int n);
@@ -149,6 +149,10 @@ typedef MPI_C_DOUBLE_COMPLEX  SuperLU_MPI_DOUBLE_COMPLEX;
  ***********************************************************************/
 
 #define MAX_SUPER_SIZE 512   /* Sherry: moved from superlu_gpu.cu */
+#define GEMM_SCATTER_MAXK 8  /* a block update of the Schur complement with
+                                at most this inner dimension is always done
+                                by superlu_[sdz]gemm_scatter(), see
+                                [sdz]gemm_scatter_l/u */
 
 /*
  * For each block column of L, the index[] array contains both the row
@@ -568,6 +572,7 @@ typedef struct {
     int  *B_to_X_SendCnt;
     int  *X_to_B_SendCnt;
     int  *ptr_to_ibuf, *ptr_to_dbuf;
+    int  nrhs;  /* number of RHS the *_nrhs counts above are set for */
 
     /* the following are needed in the hybrid solver PDSLin */
     int *X_to_B_iSendCnt;
@@ -724,6 +729,73 @@ typedef struct {
  *        Gives the scheduling algorithm a hint whether the matrix
  *        would have symmetric pattern.
  *
+ * CommTree (commtree_t) (only for SuperLU_DIST)
+ *        Specifies the broadcast and reduction trees of the triangular solve.
+ *        = BINARY_TREE: binary tree over the processes in list order
+ *        = RADIX_TREE: the radix of each tree is chosen from its message
+ *              size and number of processes
+ *        = NODE_TREE: as RADIX_TREE, but the processes on the same node
+ *              (MPI_COMM_TYPE_SHARED) form a subtree, so that only one
+ *              message per node crosses the network
+ *
+ * IntraNodeShm (yes_no_t) (only for SuperLU_DIST)
+ *        Specifies whether the messages of the triangular solve between
+ *        processes on the same node go through an MPI-3 shared window
+ *        instead of MPI point-to-point messages.
+ *
+ * SymbCache (yes_no_t) (only for SuperLU_DIST)
+ *        Specifies whether the results of the serial symbolic analysis
+ *        (perm_c, etree, supernode partition and structure of L and U)
+ *        are kept in a cache keyed by a hash of the pattern of Pr*A, and
+ *        reused by a later factorization with Fact = DOFACT of a matrix
+ *        with the same pattern. If the environment variable
+ *        SUPERLU_SYMBCACHE_DIR is set, the cache is also kept in files in
+ *        that directory, so that it is shared by different runs.
+ *
+ * Trace (yes_no_t) (only for SuperLU_DIST)
+ *        Specifies whether each process records the time line of the
+ *        factorization and the solve (panel factorizations, Schur
+ *        updates, waits for messages, lsum updates, ...) and writes it
+ *        in the Chrome trace-event format, see superlu_trace.c.
+ *
+ * SchurTasks (yes_no_t) (only for SuperLU_DIST)
+ *        Specifies whether each step of the 2D factorization p[sdz]gstrf
+ *        runs the look-ahead updates, the look-ahead panel factorizations
+ *        and sends, and the remaining Schur-complement update as OpenMP
+ *        tasks with dependences on the block columns, instead of one
+ *        parallel loop after the other. A panel is then factored and sent
+ *        as soon as its own column is updated, while the other threads
+ *        go on with the rest of the update.
+ *
+ * MixedPrecLU (yes_no_t) (only for pdgssvx)
+ *        Specifies whether pdgssvx factors a single-precision copy of A,
+ *        and recovers double-precision accuracy by GMRES-based iterative
+ *        refinement, see pdgssvx_mp.c. The factors take half the memory.
+ *        If the refinement does not converge, A is factored again in
+ *        double precision.
+ *
+ * NodeSymbFact (yes_no_t) (only for SuperLU_DIST, with ParSymbFact = NO)
+ *        Specifies whether the serial analysis (gathering A, ordering and
+ *        symbolic factorization) is done by one process per node instead
+ *        of by every process. The structure of L and U is then kept once
+ *        per node in an MPI-3 shared window, see symbfact_node.c.
+ *
+ * AutoTune (yes_no_t) (only for SuperLU_DIST, with ParSymbFact = NO)
+ *        Specifies whether the symbolic factorization is followed by a
+ *        cost model of the factorization, which sets num_lookaheads for
+ *        this factorization, and superlu_relax and superlu_maxsup for the
+ *        next symbolic factorization. The model is refined with the
+ *        measured times of each factorization. The advised grid shape is
+ *        returned by superlu_tune_last(&LUstruct->tune, ...), see
+ *        superlu_tune.c.
+ *
+ * AmalgFill (double) (only for SuperLU_DIST, with ParSymbFact = NO)
+ *        Specifies whether the serial symbolic factorization merges the
+ *        supernodes of the interior of the etree into their parent,
+ *        up to superlu_maxsup columns. A merge is done if the explicit
+ *        zeros it adds to L and U are at most AmalgFill times the
+ *        entries of the supernodes merged; 0 disables it.
+ *
  */
 typedef struct {
     fact_t        Fact;
@@ -768,6 +840,15 @@ typedef struct {
     yes_no_t      SymPattern;      /* symmetric factorization          */
     yes_no_t      Use_TensorCore;  /* Use Tensor Core or not  */
     yes_no_t      Algo3d;          /* use 3D factorization/solve algorithms */
+    commtree_t    CommTree;        /* shape of the solve communication trees */
+    yes_no_t      IntraNodeShm;    /* intra-node solve messages in shared memory */
+    yes_no_t      SymbCache;       /* reuse the symbolic analysis of a pattern */
+    yes_no_t      Trace;           /* write a trace of factor and solve */
+    yes_no_t      SchurTasks;      /* task-based Schur update in p[sdz]gstrf */
+    yes_no_t      MixedPrecLU;     /* single-precision LU + GMRES-IR in pdgssvx */
+    yes_no_t      NodeSymbFact;    /* serial analysis once per node */
+    yes_no_t      AutoTune;        /* model-driven relax, maxsup, look-ahead */
+    double        AmalgFill;       /* max. fill ratio of supernode amalgamation */
 } superlu_dist_options_t;
 
 typedef struct {
@@ -783,6 +864,107 @@ typedef struct {
     int_t indpos; /* Starting position in Uindex[]. */
 } Ucb_indptr_t;
 
+/*-- Per-rank on-disk image of the distributed LU factors,
+ *   written by pxSaveLU() and read back by pxLoadLU() or mapped
+ *   into memory by pxMapLU().
+ *   The file starts with superlu_LUfile_header_t, followed by the
+ *   sections listed in superlu_LUfile_sect_t. Each section starts at
+ *   a multiple of SLU_LUFILE_ALIGN bytes.
+ */
+#define SLU_LUFILE_MAGIC    "SLUDLUF"
+#define SLU_LUFILE_VERSION  1
+#define SLU_LUFILE_ALIGN    64
+
+typedef enum {
+    LUFILE_XSUP,         /* Glu_persist->xsup[nsupers+1]          */
+    LUFILE_SUPNO,        /* Glu_persist->supno[n]                 */
+    LUFILE_ETREE,        /* LUstruct->etree[n]                    */
+    LUFILE_PERM_R,       /* ScalePermstruct->perm_r[n]            */
+    LUFILE_PERM_C,       /* ScalePermstruct->perm_c[n]            */
+    LUFILE_R,            /* ScalePermstruct->R[n], if row scaled  */
+    LUFILE_C,            /* ScalePermstruct->C[n], if col scaled  */
+    LUFILE_ILSUM,        /* Llu->ilsum[nlb+1]                     */
+    LUFILE_TORECV,       /* Llu->ToRecv[nsupers]                  */
+    LUFILE_TOSENDD,      /* Llu->ToSendD[nlb]                     */
+    LUFILE_TOSENDR,      /* Llu->ToSendR[0][nub*npcol]            */
+    LUFILE_FMOD,         /* Llu->fmod[nlb]                        */
+    LUFILE_BMOD,         /* Llu->bmod[nlb]                        */
+    LUFILE_FSENDX,       /* Llu->fsendx_plist[0][nub*nprow]       */
+    LUFILE_BSENDX,       /* Llu->bsendx_plist[0][nub*nprow]       */
+    LUFILE_UNNZ,         /* Llu->Unnz[nub]                        */
+    LUFILE_LROWIND_OFF,  /* Llu->Lrowind_bc_offset[nub]           */
+    LUFILE_LROWIND,      /* Llu->Lrowind_bc_dat[]                 */
+    LUFILE_LNZVAL_OFF,   /* Llu->Lnzval_bc_offset[nub]            */
+    LUFILE_LNZVAL,       /* Llu->Lnzval_bc_dat[]                  */
+    LUFILE_LINDVAL_OFF,  /* Llu->Lindval_loc_bc_offset[nub]       */
+    LUFILE_LINDVAL,      /* Llu->Lindval_loc_bc_dat[]             */
+    LUFILE_LINV_OFF,     /* Llu->Linv_bc_offset[nub]              */
+    LUFILE_LINV,         /* Llu->Linv_bc_dat[]                    */
+    LUFILE_UINV_OFF,     /* Llu->Uinv_bc_offset[nub]              */
+    LUFILE_UINV,         /* Llu->Uinv_bc_dat[]                    */
+    LUFILE_UFSTNZ_OFF,   /* offsets of Llu->Ufstnz_br_ptr[nlb]    */
+    LUFILE_UFSTNZ,       /* Llu->Ufstnz_br_ptr[*], concatenated   */
+    LUFILE_UNZVAL_OFF,   /* offsets of Llu->Unzval_br_ptr[nlb]    */
+    LUFILE_UNZVAL,       /* Llu->Unzval_br_ptr[*], concatenated   */
+    LUFILE_NSECT
+} superlu_LUfile_sect_t;
+
+typedef struct {
+    char    magic[8];    /* SLU_LUFILE_MAGIC                          */
+    int32_t version;     /* SLU_LUFILE_VERSION                        */
+    int32_t hdr_size;    /* sizeof(superlu_LUfile_header_t)           */
+    char    dtype;       /* precision of the factors: 'd', 's' or 'z' */
+    char    pad[3];
+    int32_t int_t_size;  /* sizeof(int_t) of the writer               */
+    int32_t nprow;       /* 2D process grid of the writer             */
+    int32_t npcol;
+    int32_t iam;
+    int32_t DiagScale;
+    int32_t inv;         /* Llu->inv                                  */
+    int32_t nfrecvx;
+    int32_t nfsendx;
+    int32_t nbrecvx;
+    int32_t nbsendx;
+    int32_t long_size;   /* sizeof(long int) of the writer            */
+    int64_t n;
+    int64_t nsupers;
+    int64_t ldalsum;
+    int64_t bufmax[NBUFFERS];
+    int64_t sect_off[LUFILE_NSECT]; /* byte offset of each section */
+    int64_t sect_len[LUFILE_NSECT]; /* byte length of each section */
+} superlu_LUfile_header_t;
+
+/*-- Self-describing binary sparse matrix file, written by xwrite_binary()
+ *   and read in parallel by pxread_binary().
+ *   The matrix is stored by rows: rowptr[m+1], colind[nnz] and nzval[nnz],
+ *   each section starting at a multiple of SLU_BINMAT_ALIGN bytes.
+ *   rowptr[] holds 0-based offsets into colind[] and nzval[], so it also
+ *   gives the position of any block of rows; a process owning rows
+ *   [fst_row, fst_row+m_loc) reads only those slices of the file.
+ */
+#define SLU_BINMAT_MAGIC    "SLUBMAT"
+#define SLU_BINMAT_VERSION  1
+#define SLU_BINMAT_ALIGN    64
+#define SLU_BINMAT_CHUNK    (1 << 30) /* Maximum bytes per read call */
+
+typedef struct {
+    char    magic[8];    /* SLU_BINMAT_MAGIC                          */
+    int32_t version;     /* SLU_BINMAT_VERSION                        */
+    int32_t hdr_size;    /* sizeof(superlu_binmat_header_t)           */
+    char    dtype;       /* 's', 'd' or 'z'                           */
+    char    format;      /* 'R': compressed rows                      */
+    char    pad[2];
+    int32_t index_size;  /* Bytes per entry of rowptr[] and colind[]: 4 or 8 */
+    int32_t value_size;  /* Bytes per entry of nzval[]                */
+    int32_t pad1;
+    int64_t m;
+    int64_t n;
+    int64_t nnz;
+    int64_t rowptr_off;  /* Byte offsets of the three sections        */
+    int64_t colind_off;
+    int64_t nzval_off;
+} superlu_binmat_header_t;
+
 /*
  *-- The new structures added in the hybrid GPU + OpenMP + MPI code.
  */
@@ -964,6 +1146,8 @@ typedef struct{
 	double weight; 		// weight of the supernode
 	double iWeight; 	// weight of the whole subtree below
 	double scuWeight; 	// weight of schur complement update = max|n_k||L_k||U_k|
+	double cmFlops; 	// flops of the supernode, estimated from depth (SUPERLU_LBS=CM)
+	double cmWords; 	// words of L(:,k) and U(k,:), reduced if k is replicated
 } treeList_t;
 
 typedef struct
@@ -1067,6 +1251,14 @@ typedef struct xtrsTimer_t
 
 /*==== end For 3D code ====*/
 
+/*-- Arena of memory blocks released all at once, see superlu_pool.c --*/
+typedef struct superlu_arena_chunk superlu_arena_chunk_t;
+typedef struct {
+    superlu_arena_chunk_t *head, *tail, *cur; /* chunks, and the one in use */
+    size_t off;         /* bytes used in cur */
+    size_t used;        /* bytes handed out since the last reset */
+} superlu_arena_t;
+
 /*====================*/
 
 /***********************************************************************
@@ -1121,6 +1313,86 @@ extern int_t symbfact_SubInit(superlu_dist_options_t *options,
 extern int_t symbfact_SubXpand(int_t, int_t, int_t, MemType, int_t *,
 			       Glu_freeable_t *);
 extern int symbfact_SubFree(Glu_freeable_t *);
+/* Number of symbolic analyses kept in memory, see superlu_symbcache.c. */
+#ifndef SUPERLU_SYMBCACHE_ENTRIES
+#define SUPERLU_SYMBCACHE_ENTRIES 4
+#endif
+typedef struct {
+    uint64_t key;    /* hash of the pattern of Pr*A and of the options */
+    uint64_t check;  /* second hash of the pattern, compared on a hit */
+    int64_t  n, nnz; /* order and number of nonzeros of A */
+} superlu_symbkey_t;
+extern void  superlu_symbcache_key(superlu_dist_options_t *, SuperMatrix *,
+				   int_t *, int_t *, gridinfo_t *,
+				   superlu_symbkey_t *);
+extern int   superlu_symbcache_get(superlu_symbkey_t *, int_t *, int_t *,
+				   Glu_persist_t *, Glu_freeable_t **,
+				   gridinfo_t *);
+extern void  superlu_symbcache_put(superlu_symbkey_t *, int_t *, int_t *,
+				   Glu_persist_t *, Glu_freeable_t *,
+				   gridinfo_t *);
+extern void  superlu_symbcache_clear(void);
+
+/* Processes of a 2D grid on the same node, for the serial analysis done
+   once per node, see options->NodeSymbFact and symbfact_node.c. */
+typedef struct {
+    MPI_Comm shmcomm;   /* processes of grid->comm on my node            */
+    MPI_Comm leadcomm;  /* the leaders of all nodes, or MPI_COMM_NULL    */
+    int leader;         /* whether I am the leader (rank 0 in shmcomm)   */
+    int lead_iam;       /* rank in grid->comm of the leader of my node   */
+    int *lead_of;       /* lead_of[p]: rank in leadcomm of the leader of
+			   process p of grid->comm                       */
+    MPI_Win win;        /* shared window of the structure of L and U     */
+} superlu_node_t;
+
+extern void  superlu_node_init(superlu_node_t *, gridinfo_t *);
+extern void  superlu_node_free(superlu_node_t *);
+extern void  superlu_node_allgatherv(superlu_node_t *, void *, int, void *,
+				     int *, int *, MPI_Datatype, gridinfo_t *);
+extern int_t superlu_node_share_symbfact(superlu_node_t *, int_t, int_t,
+				         int_t *, int_t *, Glu_persist_t *,
+				         Glu_freeable_t *);
+extern void  superlu_node_free_symbfact(superlu_node_t *, Glu_freeable_t *);
+
+/* Parameters advised by the cost model, see options->AutoTune and
+   superlu_tune.c. */
+typedef struct {
+    int superlu_relax;
+    int superlu_maxsup;
+    int num_lookaheads;
+    int nprow, npcol, npdep; /* process grid; npdep > 1 for the 3D code */
+    yes_no_t Algo3d;
+    double time;             /* predicted factorization time              */
+    double time_cur;         /* the same, with the current settings       */
+} superlu_tune_t;
+
+/* State of the cost model for one matrix, kept in the LUstruct. */
+typedef struct {
+    int_t n;                 /* order and number of nonzeros of the matrix */
+    int64_t nnz;
+    double kf, kc;           /* scales of computation and communication   */
+    double last_tf, last_tc; /* unscaled prediction of the last advice    */
+    superlu_tune_t last;
+    int have_last;
+    int relax, maxsup;       /* for superlu_tune_prepare()                */
+    int have_pending;
+} superlu_tune_state_t;
+
+extern void  superlu_tune_advise(superlu_tune_state_t *,
+				 superlu_dist_options_t *, int_t, int_t *,
+				 Glu_persist_t *, Glu_freeable_t *,
+				 gridinfo_t *, superlu_tune_t *);
+extern void  superlu_tune_update(superlu_tune_state_t *, double, double,
+				 gridinfo_t *);
+extern void  superlu_tune_apply(superlu_tune_state_t *, superlu_tune_t *,
+				superlu_dist_options_t *);
+extern void  superlu_tune_prepare(superlu_tune_state_t *,
+				  superlu_dist_options_t *);
+extern int   superlu_tune_last(superlu_tune_state_t *, superlu_tune_t *);
+extern void  superlu_tune_reset(superlu_tune_state_t *);
+extern void  superlu_tune_check(superlu_tune_state_t *, int_t, int_t,
+				gridinfo_t *);
+extern void  superlu_tune_print(superlu_tune_t *);
 extern int_t ilu_level_symbfact(superlu_dist_options_t *, SuperMatrix *, int_t *,
 			      int_t *, Glu_persist_t *, Glu_freeable_t *);
 extern void    countnz_dist (const int_t, int_t *, int_t *, int_t *,
@@ -1132,6 +1404,15 @@ extern float   smach_dist(const char *);
 extern double  dmach_dist(const char *);
 extern void    *superlu_malloc_dist (size_t);
 extern void    superlu_free_dist (void*);
+extern int     superlu_pool_init (void);
+extern int     superlu_pool_enabled (void);
+extern void    *superlu_pool_malloc (size_t);
+extern void    superlu_pool_free (void*);
+extern size_t  superlu_pool_trim (void);
+extern void    *superlu_arena_malloc (superlu_arena_t *, size_t);
+extern void    *superlu_arena_calloc (superlu_arena_t *, size_t);
+extern void    superlu_arena_reset (superlu_arena_t *);
+extern void    superlu_arena_free (superlu_arena_t *);
 extern int   *int32Malloc_dist (int);
 extern int   *int32Calloc_dist (int);
 extern int_t   *intMalloc_dist (int_t);
@@ -1157,9 +1438,41 @@ extern void  PStatInit(SuperLUStat_t *);
 extern void  PStatClear(SuperLUStat_t *);
 extern void  PStatFree(SuperLUStat_t *);
 extern void  PStatPrint(superlu_dist_options_t *, SuperLUStat_t *, gridinfo_t *);
+extern void  superlu_stats_query(SuperLUStat_t *, Glu_persist_t *, int_t,
+				 gridinfo_t *, superlu_dist_stats_t *);
+extern void  superlu_stats_json(superlu_dist_stats_t *, FILE *);
+extern const char *superlu_phase_name(int);
 extern void  log_memory(int64_t, SuperLUStat_t *);
 extern void  print_memorylog(SuperLUStat_t *, char *);
 extern int   superlu_dist_GetVersionNumber(int *, int *, int *);
+extern FILE *superlu_LUfile_open(const char *, int, const char *);
+extern void  superlu_LUfile_init_header(superlu_LUfile_header_t *, char,
+                                        int_t, int_t, gridinfo_t *);
+extern void  superlu_LUfile_layout(superlu_LUfile_header_t *);
+extern int   superlu_LUfile_check_header(superlu_LUfile_header_t *, char,
+                                         int_t, gridinfo_t *);
+extern int   superlu_LUfile_check_sections(FILE *, superlu_LUfile_header_t *);
+extern int   superlu_LUfile_write(FILE *, superlu_LUfile_header_t *, int,
+                                  int64_t, const void *, size_t);
+extern int   superlu_LUfile_read(FILE *, superlu_LUfile_header_t *, int,
+                                 int64_t, void *, size_t);
+extern void *superlu_LUfile_map(const char *, int, size_t *);
+extern void  superlu_LUfile_unmap(void *, size_t);
+extern void  superlu_binmat_init_header(superlu_binmat_header_t *, char,
+                                        size_t, int64_t, int64_t, int64_t);
+extern int   superlu_binmat_check_header(superlu_binmat_header_t *, char);
+extern int   superlu_binmat_fwrite(FILE *, int64_t, const void *, size_t);
+extern int   superlu_binmat_fread(FILE *, int64_t, void *, size_t);
+extern int   superlu_binmat_fread_index(FILE *, superlu_binmat_header_t *,
+                                        int64_t, int64_t, int_t *);
+extern int   superlu_binmat_read_at_all(MPI_File, MPI_Offset, void *, int64_t,
+                                        MPI_Comm);
+extern int   superlu_binmat_read_index_at_all(MPI_File, superlu_binmat_header_t *,
+                                              int64_t, int64_t, int_t *, MPI_Comm);
+extern int   superlu_readMM_header(FILE *, const char *, int_t *, int_t *,
+                                   int_t *, int *, int64_t *);
+extern char *superlu_readMM_chunk(const char *, int64_t, int, int, int64_t *);
+extern int   superlu_readMM_int(char **, int_t *);
 extern void  quickSort( int_t*, int_t, int_t, int_t);
 extern void  quickSortM( int_t*, int_t, int_t, int_t, int_t, int_t);
 extern int_t partition( int_t*, int_t, int_t, int_t);
@@ -1254,24 +1567,61 @@ extern int   file_PrintLong10(FILE *, char *, int_t, int_t *);
 
 #ifndef __SUPERLU_ASYNC_TREE /* allow multiple inclusions */
 #define __SUPERLU_ASYNC_TREE
+#ifndef DEG_TREE
+#define DEG_TREE 2
+#endif
+
+/* Max. number of children of a process in a tree. */
+#ifndef MAX_DEG_TREE
+#define MAX_DEG_TREE 4
+#endif
+
+/* Shared-memory channel for the messages between processes on the same
+   node, see superlu_shm.c. */
+typedef struct
+{
+    MPI_Comm comm;      /* communicator of the messages                */
+    MPI_Comm shmcomm;   /* processes of comm on my node                */
+    MPI_Win win;        /* shared window holding the rings             */
+    int iam, myshm;     /* my rank in comm and in shmcomm              */
+    int *local;         /* local[p]: rank in shmcomm of p, or -1       */
+    char **ring;        /* ring[q]: ring of process q of shmcomm       */
+    int nslots;         /* number of slots in a ring                   */
+    size_t slotsize;    /* max. bytes of a message in a slot           */
+    size_t stride;      /* bytes between two slots                     */
+} superlu_shm_t;
+
+/* Number of message slots of each process in a superlu_shm_t. */
+#ifndef SUPERLU_SHM_SLOTS
+#define SUPERLU_SHM_SLOTS 64
+#endif
+
 typedef struct
 {
-    MPI_Request sendRequests_[2];
+    MPI_Request sendRequests_[MAX_DEG_TREE];
     MPI_Comm comm_;
     int myRoot_;
     int destCnt_;
-    int myDests_[2];
+    int myDests_[MAX_DEG_TREE];
     int myRank_;
     int msgSize_;
     int tag_;
     yes_no_t empty_;
     MPI_Datatype type_;
     int myIdx;
+    superlu_shm_t *shm_;  /* intra-node channel of the solve, or NULL */
 } C_Tree;
 
-#ifndef DEG_TREE
-#define DEG_TREE 2
-#endif
+/* Shape of the trees built by C_BcTree_Create_topo() and
+   C_RdTree_Create_topo(), see options->CommTree. */
+typedef struct
+{
+    commtree_t kind;
+    int nprocs;
+    int *node_of;  /* node_of[p]: lowest rank on the node of rank p  */
+    int *first;    /* workspace, size nprocs, all -1 between calls   */
+    int *work;     /* workspace, size 2*nprocs                       */
+} C_TreeTopo;
 
 #endif
 
@@ -1288,6 +1638,39 @@ extern void C_BcTree_Nullify(C_Tree* tree);
 extern yes_no_t C_BcTree_IsRoot(C_Tree* tree);
 extern void C_BcTree_forwardMessageSimple(C_Tree* tree, void* localBuffer, int msgSize);
 extern void C_BcTree_waitSendRequest(C_Tree* tree);
+extern void C_TreeTopo_Init(C_TreeTopo* topo, commtree_t kind, MPI_Comm comm);
+extern void C_TreeTopo_Free(C_TreeTopo* topo);
+extern int  C_Tree_Radix(C_TreeTopo* topo, int rank_cnt, int msgSize);
+extern void C_RdTree_Create_topo(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, int msgSize, char precision, int* needrecvrd, int* needsendrd, C_TreeTopo* topo);
+extern void C_BcTree_Create_topo(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, int msgSize, char precision, int* needrecv, C_TreeTopo* topo);
+extern void C_Tree_SetShm(C_Tree* trees, int_t ntrees, superlu_shm_t* shm);
+extern superlu_shm_t *superlu_shm_create(MPI_Comm comm, int nslots, size_t slotsize);
+extern void superlu_shm_free(superlu_shm_t *shm);
+extern int  superlu_shm_send(superlu_shm_t *shm, int dest, int tag, void *buf, int count, MPI_Datatype type);
+extern void superlu_shm_recv(superlu_shm_t *shm, void *buf, int count, MPI_Datatype type, MPI_Comm comm, MPI_Status *status);
+
+/* Events of the trace of factor and solve, see superlu_trace.c. */
+typedef enum {
+    TR_DIST, TR_FACT, TR_PANEL_L, TR_PANEL_U, TR_LOOKAHEAD, TR_SCHUR,
+    TR_WAIT_SEND, TR_WAIT_L, TR_WAIT_U, TR_SOLVE, TR_LSOLVE, TR_USOLVE,
+    TR_X, TR_LSUM, TR_RECV, TR_NEVENTS
+} trace_event_t;
+
+/* Number of events kept for each thread. */
+#ifndef SUPERLU_TRACE_EVENTS
+#define SUPERLU_TRACE_EVENTS 65536
+#endif
+
+extern int superlu_trace_on;
+extern void superlu_trace_start(gridinfo_t *grid);
+extern void superlu_trace_event(int ev, double t0, int64_t arg);
+extern void superlu_trace_dump(gridinfo_t *grid);
+
+/* Start time of an event, and record of the event; cost a test when
+   the trace is off. */
+#define SUPERLU_TRACE_TIC() ( superlu_trace_on ? SuperLU_timer_() : 0.0 )
+#define SUPERLU_TRACE(ev, t0, arg) \
+    do { if ( superlu_trace_on ) superlu_trace_event(ev, t0, arg); } while (0)
 
 /*==== For 3D code ====*/
 typedef enum {
@@ -1377,6 +1760,7 @@ extern int_t* merg_perms(int_t nperms, int_t* nnodes, int_t** perms);
 extern int_t* getGlobal_iperm(int_t nsupers, int_t nperms, int_t** perms,
 			      int_t* nnodes);
 extern int_t log2i(int_t index);
+extern int_t log2i_ceil(int_t index);
 extern int_t *supernodal_etree(int_t nsuper, int_t * etree, int_t* supno, int_t *xsup);
 extern int_t testSubtreeNodelist(int_t nsupers, int_t numList, int_t** nodeList, int_t* nodeCount);
 extern int_t testListPerm(int_t nodeCount, int_t* nodeList, int_t* permList, int_t* gTopLevel);
@@ -1439,7 +1823,10 @@ extern int_t*  getNodeCountsFr(int_t maxLvl, sForest_t**  sForests);
 extern int* getIsNodeInMyGrid(int_t nsupers, int_t maxLvl, int_t* myNodeCount, int_t** treePerm);
 extern void printForestWeightCost(sForest_t**  sForests, SCT_t* SCT, gridinfo3d_t* grid3d);
 extern sForest_t**  getGreedyLoadBalForests( int_t maxLvl, int_t nsupers, int_t* setree, treeList_t* treeList);
-extern sForest_t**  getForests( int_t maxLvl, int_t nsupers, int_t*setree, treeList_t* treeList);
+extern sForest_t**  getCostModelForests( int_t maxLvl, int_t nLayers, int_t nsupers, int_t* setree, treeList_t* treeList);
+extern double getForestImbalance(int_t maxLvl, int_t nLayers, sForest_t** sForests, treeList_t* treeList);
+extern void printForestPrediction(int_t maxLvl, int_t nLayers, sForest_t** sForests, treeList_t* treeList, gridinfo3d_t* grid3d);
+extern sForest_t**  getForests( int_t maxLvl, int_t nLayers, int_t nsupers, int_t*setree, treeList_t* treeList);
 
     /* from trfAux.h */
 extern int_t getBigUSize(superlu_dist_options_t *, int_t nsupers,
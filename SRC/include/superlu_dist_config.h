@@ -1,28 +1,28 @@
 /* superlu_dist_config.h.in */
 
 /* Enable CUDA */
-#define HAVE_CUDA TRUE
+/* #undef HAVE_CUDA */
 
 /* Enable NVSHMEM */
-#define HAVE_NVSHMEM TRUE
+/* #undef HAVE_NVSHMEM */
 
 /* Enable HIP */
 /* #undef HAVE_HIP */
 
 /* Enable parmetis */
-#define HAVE_PARMETIS TRUE
+/* #undef HAVE_PARMETIS */
 
 /* Enable colamd */
 /* #undef HAVE_COLAMD */
 
 /* Enable LAPACK */
-#define SLU_HAVE_LAPACK TRUE
+/* #undef SLU_HAVE_LAPACK */
 
 /* Enable CombBLAS */
 /* #undef HAVE_COMBBLAS */
 
 /* Enable MAGMA */
-#define HAVE_MAGMA TRUE
+/* #undef HAVE_MAGMA */
 
 /* enable 64bit index mode */
 /* #undef XSDK_INDEX_SIZE */
@@ -28,7 +28,8 @@ at the top-level directory.
  ***********************************************************************/
 typedef enum {NO, YES}                                          yes_no_t;
 typedef enum {DOFACT, SamePattern, SamePattern_SameRowPerm, FACTORED} fact_t;
-typedef enum {NOROWPERM, LargeDiag_MC64, LargeDiag_HWPM, MY_PERMR} rowperm_t;
+typedef enum {NOROWPERM, LargeDiag_MC64, LargeDiag_HWPM, MY_PERMR,
+              LargeDiag_AUCTION}                              rowperm_t;
 typedef enum {NATURAL, MMD_ATA, MMD_AT_PLUS_A, COLAMD,
 	      METIS_AT_PLUS_A, PARMETIS, METIS_ATA, ZOLTAN, MY_PERMC} colperm_t;
 typedef enum {NOTRANS, TRANS, CONJ}                             trans_t;
@@ -44,6 +45,7 @@ typedef enum {ONE_NORM, TWO_NORM, INF_NORM}			norm_t;
  * The following are for ILUTP in serial SuperLU
  */
 typedef enum {SILU, SMILU_1, SMILU_2, SMILU_3}			milu_t;
+typedef enum {BINARY_TREE, RADIX_TREE, NODE_TREE}              commtree_t;
 typedef enum {NODROP		= 0x0000,
 	      DROP_BASIC	= 0x0001, /* ILU(tau) */
 	      DROP_PROWS	= 0x0002, /* ILUTP: keep p maximum rows */
@@ -89,6 +89,22 @@ typedef struct {
 } Ucb_indptr_t;
 #endif
 
+/*
+ * Map of the local nonzeros of A into the L and U factors, built by
+ * psdistribute() on the first call with Fact = SamePattern_SameRowPerm,
+ * and used by the later ones to move only the values of A.
+ */
+typedef struct {
+    int_t  nnz_loc, m_loc, fst_row; /* local part of A the map is for      */
+    int_t  *sendpos;    /* nzval[j] of A goes to sendbuf[sendpos[j]]       */
+    int    *sendcnt, *sdispls, *recvcnt, *rdispls; /* for MPI_Alltoallv    */
+    int_t  nrecv;       /* number of values received                      */
+    int_t  *blk;        /* recvbuf[k] goes to Lnzval_bc_ptr[blk[k]] if
+			   blk[k] >= 0, to Unzval_br_ptr[-blk[k]-1] if not */
+    int_t  *off;        /* ... at offset off[k]                           */
+    float *sendbuf, *recvbuf;
+} sAmap_t;
+
 /*
  * On each processor, the blocks in L are stored in compressed block
  * column format, the blocks in U are stored in compressed block row format.
@@ -171,6 +187,12 @@ typedef struct {
     long int *Unzval_br_offset;  /* size ceil(NSUPERS/Pr)    */
     long int Unzval_br_cnt;
 
+    void    *LUfile_map;      /* Non-NULL if the L and U arrays point into the
+				 file mapped by psMapLU(); they are then
+				 released by unmapping, not freed */
+    size_t  LUfile_map_size;
+    sAmap_t *Amap;            /* see psdistribute(); NULL until built */
+
         /*-- Data structures used for broadcast and reduction trees. --*/
     C_Tree  *LBtree_ptr;       /* size ceil(NSUPERS/Pc)                */
     C_Tree  *LRtree_ptr;       /* size ceil(NSUPERS/Pr)                */
@@ -329,6 +351,7 @@ typedef struct
     sLUValSubBuf_t  *LUvsb;
     SupernodeToGridMap_t* superGridMap;
     int maxLvl; // YL: store this to avoid the use of grid3d
+    double imbalance; /* predicted by getForestImbalance() */
 
     /* Sherry added the following 3 for variable size batch. 2/17/23 */
     int mxLeafNode; /* number of leaf nodes. */
@@ -343,6 +366,7 @@ typedef struct {
     sLocalLU_t *Llu;
     strf3Dpartition_t *trf3Dpart;
     char dt;
+    superlu_tune_state_t tune; /* options->AutoTune, see superlu_tune.c */
 } sLUstruct_t;
 
 
@@ -367,6 +391,21 @@ typedef struct {
 			     (also total number of indices to be received) */
 } psgsmv_comm_t;
 
+/*-- Work arrays of psgstrs(), kept across calls in sSOLVEstruct_t --*/
+typedef struct {
+    float *lsum, *x, *rtemp, *recvbuf;
+    size_t lsum_size, x_size, rtemp_size, recvbuf_size;
+    superlu_shm_t *shm;  /* intra-node channel, see options->IntraNodeShm */
+    int    shm_tried;      /* whether shm was created (may be NULL) */
+    size_t shm_slotsize;   /* slot size agreed by all processes     */
+    superlu_arena_t arena; /* other work arrays of one call, reset at exit */
+    int_t  *redist_ibuf;   /* send/receive buffers of psReDistribute_*() */
+    float  *redist_dbuf;
+    size_t redist_isize, redist_dsize;
+    MPI_Request *redist_req;    /* 2*procs: sends, then receives */
+    MPI_Status  *redist_status;
+} sgstrs_work_t;
+
 /*-- Data structure holding the information for the solution phase --*/
 typedef struct {
     int_t *row_to_proc;
@@ -383,6 +422,8 @@ typedef struct {
     NRformat_loc3d* A3d; /* Point to 3D {A, B} gathered on 2D layer 0.
                             This needs to be peresistent between
 			    3D factorization and solve.  */
+    sgstrs_work_t *gstrs_work; /* Work arrays of psgstrs(), kept across
+				 calls and enlarged when nrhs grows. */
     #ifdef GPU_ACC
     float *d_lsum, *d_lsum_save;      /* used for device lsum*/
     float *d_x;         /* used for device solution vector*/
@@ -391,6 +432,34 @@ typedef struct {
     #endif
 } sSOLVEstruct_t;
 
+/*-- A right-hand side waiting in a sSolveQueue_t --*/
+typedef struct {
+    float *b;     /* local rows of the right-hand sides, overwritten by X */
+    int    ldb;
+    int    nrhs;
+    float *berr;  /* backward errors, may be NULL */
+} sSolveRequest_t;
+
+/*-- Queue of right-hand sides solved together, see psgssvx_queue.c --*/
+typedef struct {
+    superlu_dist_options_t *options;
+    SuperMatrix *A;
+    sScalePermstruct_t *ScalePermstruct;
+    sLUstruct_t *LUstruct;
+    sSOLVEstruct_t *SOLVEstruct;
+    gridinfo_t *grid;
+    SuperLUStat_t *stat;
+    int_t  m_loc;
+    int    max_nrhs;  /* most columns solved by one call to psgssvx */
+    int    nrhs;      /* pending columns */
+    int    nreq;      /* pending requests */
+    int    first;     /* ticket of the first pending request */
+    int    info;      /* info of the last call to psgssvx */
+    float *B;        /* m_loc x max_nrhs block of the pending columns */
+    float *berr;
+    sSolveRequest_t *req;
+} sSolveQueue_t;
+
 
 
 /*==== For 3D code ====*/
@@ -513,6 +582,9 @@ sCompCol_to_CompRow_dist(int_t m, int_t n, int_t nnz,
 extern int
 psCompRow_loc_to_CompCol_global(int_t, SuperMatrix *, gridinfo_t *,
 	 		        SuperMatrix *);
+extern int
+psCompRow_loc_to_CompCol_node(int_t, SuperMatrix *, gridinfo_t *,
+			      superlu_node_t *, SuperMatrix *);
 extern void
 sCopy_CompCol_Matrix_dist(SuperMatrix *, SuperMatrix *);
 extern void
@@ -538,6 +610,8 @@ extern int     screate_matrix_dat(SuperMatrix *, int, float **, int *,
 			      float **, int *, FILE *, gridinfo_t *);
 extern int screate_matrix_postfix(SuperMatrix *, int, float **, int *,
 				  float **, int *, FILE *, char *, gridinfo_t *);
+extern int screate_matrix_binary(SuperMatrix *, int, float **, int *,
+				  float **, int *, char *, gridinfo_t *);
 
 extern void   sScalePermstructInit(const int_t, const int_t,
                                       sScalePermstruct_t *);
@@ -575,6 +649,7 @@ extern void  psgssvx_ABglobal(superlu_dist_options_t *, SuperMatrix *,
 extern float psdistribute(superlu_dist_options_t *, int_t, SuperMatrix *,
 			 sScalePermstruct_t *, Glu_freeable_t *,
 			 sLUstruct_t *, gridinfo_t *);
+extern void  sAmapFree(sAmap_t *);
 extern float psdistribute_allgrid(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 	     sScalePermstruct_t *ScalePermstruct,
 	     Glu_freeable_t *Glu_freeable, sLUstruct_t *LUstruct,
@@ -592,6 +667,13 @@ extern void  psCompute_Diag_Inv(int_t, sLUstruct_t *,gridinfo_t *, SuperLUStat_t
 extern int  sSolveInit(superlu_dist_options_t *, SuperMatrix *, int_t [], int_t [],
 		       int_t, sLUstruct_t *, gridinfo_t *, sSOLVEstruct_t *);
 extern void sSolveFinalize(superlu_dist_options_t *, sSOLVEstruct_t *);
+extern int  psSolveQueueInit(sSolveQueue_t *, int, superlu_dist_options_t *,
+                            SuperMatrix *, sScalePermstruct_t *, sLUstruct_t *,
+                            sSOLVEstruct_t *, gridinfo_t *, SuperLUStat_t *);
+extern int  psSolveQueueSubmit(sSolveQueue_t *, float *, int, int, float *);
+extern int  psSolveQueueWait(sSolveQueue_t *, int);
+extern int  psSolveQueueFlush(sSolveQueue_t *);
+extern void psSolveQueueFinalize(sSolveQueue_t *);
 extern void sDestroy_A3d_gathered_on_2d(sSOLVEstruct_t *, gridinfo3d_t *);
 extern int_t psgstrs_init(int_t, int_t, int_t, int_t,
                           int_t [], int_t [], gridinfo_t *grid,
@@ -600,8 +682,11 @@ extern int_t psgstrs_init_device_lsum_x(superlu_dist_options_t *, int_t , int_t
 	     sLUstruct_t *, sSOLVEstruct_t *, int*);
 extern int_t psgstrs_delete_device_lsum_x(sSOLVEstruct_t *);
 extern void pxgstrs_finalize(pxgstrs_comm_t *);
+extern void pxgstrs_comm_set_nrhs(pxgstrs_comm_t *, int, int);
 extern int  sldperm_dist(int, int, int_t, int_t [], int_t [],
 		    float [], int_t *, float [], float []);
+extern int  psldperm_dist(SuperMatrix *, gridinfo_t *, int_t [],
+		    float [], float []);
 extern int  sstatic_schedule(superlu_dist_options_t *, int, int,
 		            sLUstruct_t *, gridinfo_t *, SuperLUStat_t *,
 			    int_t *, int_t *, int *);
@@ -609,6 +694,15 @@ extern void sLUstructInit(const int_t, sLUstruct_t *);
 extern void sLUstructFree(sLUstruct_t *);
 extern void sDestroy_LU(int_t, gridinfo_t *, sLUstruct_t *);
 extern void sDestroy_Tree(int_t, gridinfo_t *, sLUstruct_t *);
+extern int  psSaveLU(char *, int_t, sScalePermstruct_t *, sLUstruct_t *,
+                     gridinfo_t *);
+extern int  psLoadLU(char *, int_t, superlu_dist_options_t *,
+                     sScalePermstruct_t *, sLUstruct_t *, gridinfo_t *,
+                     SuperLUStat_t *);
+extern int  psMapLU(char *, int_t, superlu_dist_options_t *,
+                    sScalePermstruct_t *, sLUstruct_t *, gridinfo_t *,
+                    SuperLUStat_t *);
+extern void psScalePermA_LUfile(SuperMatrix *, sScalePermstruct_t *);
 extern void sscatter_l (int ib, int ljb, int nsupc, int_t iukp, int_t* xsup,
 			int klst, int nbrow, int_t lptr, int temp_nbrow,
 			int_t* usub, int_t* lsub, float *tempv,
@@ -620,6 +714,22 @@ extern void sscatter_u (int ib, int jb, int nsupc, int_t iukp, int_t * xsup,
                         int_t* lsub, int_t* usub, float* tempv,
                         int_t ** Ufstnz_br_ptr, float **Unzval_br_ptr,
                         gridinfo_t * grid);
+extern void sgemm_scatter_l (int ib, int ljb, int nsupc, int_t iukp,
+			int_t* xsup, int klst, int_t lptr, int temp_nbrow,
+			int ncols, int ldu, float *lval, int ldl,
+			float *uval, int fused_max, int_t* usub,
+			int_t* lsub, float *tempv,
+			int_t* indirect_thread, int_t* indirect2,
+			int_t ** Lrowind_bc_ptr, float **Lnzval_bc_ptr,
+			gridinfo_t * grid);
+extern void sgemm_scatter_u (int ib, int jb, int nsupc, int_t iukp,
+			int_t * xsup, int klst, int_t lptr, int temp_nbrow,
+			int ncols, int ldu, float *lval, int ldl,
+			float *uval, int fused_max, int_t* lsub,
+			int_t* usub, float *tempv,
+			int_t* indirect_thread, int_t* indirect2,
+			int_t ** Ufstnz_br_ptr, float **Unzval_br_ptr,
+			gridinfo_t * grid);
 extern int_t psgstrf(superlu_dist_options_t *, int, int, float anorm,
 		    sLUstruct_t*, gridinfo_t*, SuperLUStat_t*, int*);
 
@@ -977,8 +1087,12 @@ extern void  sreadrb_dist(int, FILE *, int_t *, int_t *, int_t *,
 		     float **, int_t **, int_t **);
 extern void  sreadMM_dist(FILE *, int_t *, int_t *, int_t *,
 	                  float **, int_t **, int_t **);
+extern int   psreadMM_dist(char *, SuperMatrix *, gridinfo_t *);
 extern int  sread_binary(FILE *, int_t *, int_t *, int_t *,
 	                  float **, int_t **, int_t **);
+extern int  swrite_binary(char *, int_t, int_t, int_t,
+	                  float *, int_t *, int_t *);
+extern int  psread_binary(char *, SuperMatrix *, gridinfo_t *);
 
 extern void validateInput_psgssvx3d(superlu_dist_options_t *, SuperMatrix *A,
        int ldb, int nrhs, gridinfo3d_t *, int *info);
@@ -1071,6 +1185,9 @@ extern int saxpy_(const int *n, const float *alpha, const float *x,
 extern int superlu_sgemm(const char *transa, const char *transb,
                   int m, int n, int k, float alpha, float *a,
                   int lda, float *b, int ldb, float beta, float *c, int ldc);
+extern int superlu_sgemm_scatter(int m, int n, int k, float *A, int lda,
+                  float *B, int ldb, float *C, int ldc,
+                  int_t *rowmap, int_t *colmap);
 extern int superlu_strsm(const char *sideRL, const char *uplo,
                   const char *transa, const char *diag, const int m, const int n,
                   const float alpha, const float *a,
@@ -1608,6 +1725,18 @@ extern int spivot_batch(
     float **ReqPtr, float **CeqPtr, DiagScale_t *, int **RpivPtr
     //    DeviceContext context /* device context including queues, events, dependencies */
     );
+extern int sgssvx_batch_cpu(
+    superlu_dist_options_t *, int batchCount, int m, int n, int nnz,
+    int nrhs, handle_t *, float **RHSptr, int *ldRHS,
+    float **ReqPtr, float **CeqPtr, int **RpivPtr, int **CpivPtr,
+    DiagScale_t *DiagScale, float **Xptr, int *ldX, float **Berrs,
+    SuperLUStat_t *stat, int *info);
+extern int psgssvx_batch_cpu(
+    superlu_dist_options_t *, int batchCount, int m, int n, int nnz,
+    int nrhs, handle_t *, float **RHSptr, int *ldRHS,
+    float **ReqPtr, float **CeqPtr, int **RpivPtr, int **CpivPtr,
+    DiagScale_t *DiagScale, float **Xptr, int *ldX, float **Berrs,
+    gridinfo3d_t *, SuperLUStat_t *stat, int *info);
 
 extern int swriteLUtoDisk(int nsupers, int_t *xsup, sLUstruct_t *LUstruct);
 extern int scheckArr(float *A, float *B, int n);
@@ -4,16 +4,26 @@
 #include "superlu_zdefs.h"
 #include "superlu_sdefs.h"
 
-int_t pdgstrf3d_v100(superlu_dist_options_t *options, int m, int n, double anorm,
-                     dtrf3Dpartition_t *trf3Dpartition, SCT_t *SCT,
-                     dLUstruct_t *LUstruct, gridinfo3d_t *grid3d,
-                     SuperLUStat_t *stat, int *info);
-
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+    // 3D factorization on CPU with the templated LU panels, instantiated
+    // from pdgstrf3d_upacked<Ftype>() in CplusplusFactor/
+    extern int_t psgstrf3d_v100(superlu_dist_options_t *options, int m, int n, float anorm,
+                                strf3Dpartition_t *trf3Dpartition, SCT_t *SCT,
+                                sLUstruct_t *LUstruct, gridinfo3d_t *grid3d,
+                                SuperLUStat_t *stat, int *info);
+    extern int_t pdgstrf3d_v100(superlu_dist_options_t *options, int m, int n, double anorm,
+                                dtrf3Dpartition_t *trf3Dpartition, SCT_t *SCT,
+                                dLUstruct_t *LUstruct, gridinfo3d_t *grid3d,
+                                SuperLUStat_t *stat, int *info);
+    extern int_t pzgstrf3d_v100(superlu_dist_options_t *options, int m, int n, double anorm,
+                                ztrf3Dpartition_t *trf3Dpartition, SCT_t *SCT,
+                                zLUstruct_t *LUstruct, gridinfo3d_t *grid3d,
+                                SuperLUStat_t *stat, int *info);
+
     // Left for backward compatibility
     struct LUstruct_v100;
     typedef struct LUstruct_v100 *LUgpu_Handle;
@@ -89,6 +89,22 @@ typedef struct {
 } Ucb_indptr_t;
 #endif
 
+/*
+ * Map of the local nonzeros of A into the L and U factors, built by
+ * pzdistribute() on the first call with Fact = SamePattern_SameRowPerm,
+ * and used by the later ones to move only the values of A.
+ */
+typedef struct {
+    int_t  nnz_loc, m_loc, fst_row; /* local part of A the map is for      */
+    int_t  *sendpos;    /* nzval[j] of A goes to sendbuf[sendpos[j]]       */
+    int    *sendcnt, *sdispls, *recvcnt, *rdispls; /* for MPI_Alltoallv    */
+    int_t  nrecv;       /* number of values received                      */
+    int_t  *blk;        /* recvbuf[k] goes to Lnzval_bc_ptr[blk[k]] if
+			   blk[k] >= 0, to Unzval_br_ptr[-blk[k]-1] if not */
+    int_t  *off;        /* ... at offset off[k]                           */
+    doublecomplex *sendbuf, *recvbuf;
+} zAmap_t;
+
 /*
  * On each processor, the blocks in L are stored in compressed block
  * column format, the blocks in U are stored in compressed block row format.
@@ -171,6 +187,12 @@ typedef struct {
     long int *Unzval_br_offset;  /* size ceil(NSUPERS/Pr)    */
     long int Unzval_br_cnt;
 
+    void    *LUfile_map;      /* Non-NULL if the L and U arrays point into the
+				 file mapped by pzMapLU(); they are then
+				 released by unmapping, not freed */
+    size_t  LUfile_map_size;
+    zAmap_t *Amap;            /* see pzdistribute(); NULL until built */
+
         /*-- Data structures used for broadcast and reduction trees. --*/
     C_Tree  *LBtree_ptr;       /* size ceil(NSUPERS/Pc)                */
     C_Tree  *LRtree_ptr;       /* size ceil(NSUPERS/Pr)                */
@@ -329,6 +351,7 @@ typedef struct
     zLUValSubBuf_t  *LUvsb;
     SupernodeToGridMap_t* superGridMap;
     int maxLvl; // YL: store this to avoid the use of grid3d
+    double imbalance; /* predicted by getForestImbalance() */
 
     /* Sherry added the following 3 for variable size batch. 2/17/23 */
     int mxLeafNode; /* number of leaf nodes. */
@@ -343,6 +366,7 @@ typedef struct {
     zLocalLU_t *Llu;
     ztrf3Dpartition_t *trf3Dpart;
     char dt;
+    superlu_tune_state_t tune; /* options->AutoTune, see superlu_tune.c */
 } zLUstruct_t;
 
 
@@ -367,6 +391,21 @@ typedef struct {
 			     (also total number of indices to be received) */
 } pzgsmv_comm_t;
 
+/*-- Work arrays of pzgstrs(), kept across calls in zSOLVEstruct_t --*/
+typedef struct {
+    doublecomplex *lsum, *x, *rtemp, *recvbuf;
+    size_t lsum_size, x_size, rtemp_size, recvbuf_size;
+    superlu_shm_t *shm;  /* intra-node channel, see options->IntraNodeShm */
+    int    shm_tried;      /* whether shm was created (may be NULL) */
+    size_t shm_slotsize;   /* slot size agreed by all processes     */
+    superlu_arena_t arena; /* other work arrays of one call, reset at exit */
+    int_t  *redist_ibuf;   /* send/receive buffers of pzReDistribute_*() */
+    doublecomplex *redist_dbuf;
+    size_t redist_isize, redist_dsize;
+    MPI_Request *redist_req;    /* 2*procs: sends, then receives */
+    MPI_Status  *redist_status;
+} zgstrs_work_t;
+
 /*-- Data structure holding the information for the solution phase --*/
 typedef struct {
     int_t *row_to_proc;
@@ -383,6 +422,8 @@ typedef struct {
     NRformat_loc3d* A3d; /* Point to 3D {A, B} gathered on 2D layer 0.
                             This needs to be peresistent between
 			    3D factorization and solve.  */
+    zgstrs_work_t *gstrs_work; /* Work arrays of pzgstrs(), kept across
+				 calls and enlarged when nrhs grows. */
     #ifdef GPU_ACC
     doublecomplex *d_lsum, *d_lsum_save;      /* used for device lsum*/
     doublecomplex *d_x;         /* used for device solution vector*/
@@ -391,6 +432,34 @@ typedef struct {
     #endif
 } zSOLVEstruct_t;
 
+/*-- A right-hand side waiting in a zSolveQueue_t --*/
+typedef struct {
+    doublecomplex *b;  /* local rows of the right-hand sides, overwritten by X */
+    int    ldb;
+    int    nrhs;
+    double *berr;  /* backward errors, may be NULL */
+} zSolveRequest_t;
+
+/*-- Queue of right-hand sides solved together, see pzgssvx_queue.c --*/
+typedef struct {
+    superlu_dist_options_t *options;
+    SuperMatrix *A;
+    zScalePermstruct_t *ScalePermstruct;
+    zLUstruct_t *LUstruct;
+    zSOLVEstruct_t *SOLVEstruct;
+    gridinfo_t *grid;
+    SuperLUStat_t *stat;
+    int_t  m_loc;
+    int    max_nrhs;  /* most columns solved by one call to pzgssvx */
+    int    nrhs;      /* pending columns */
+    int    nreq;      /* pending requests */
+    int    first;     /* ticket of the first pending request */
+    int    info;      /* info of the last call to pzgssvx */
+    doublecomplex *B;        /* m_loc x max_nrhs block of the pending columns */
+    double *berr;
+    zSolveRequest_t *req;
+} zSolveQueue_t;
+
 
 
 /*==== For 3D code ====*/
@@ -513,6 +582,9 @@ zCompCol_to_CompRow_dist(int_t m, int_t n, int_t nnz,
 extern int
 pzCompRow_loc_to_CompCol_global(int_t, SuperMatrix *, gridinfo_t *,
 	 		        SuperMatrix *);
+extern int
+pzCompRow_loc_to_CompCol_node(int_t, SuperMatrix *, gridinfo_t *,
+			      superlu_node_t *, SuperMatrix *);
 extern void
 zCopy_CompCol_Matrix_dist(SuperMatrix *, SuperMatrix *);
 extern void
@@ -538,6 +610,8 @@ extern int     zcreate_matrix_dat(SuperMatrix *, int, doublecomplex **, int *,
 			      doublecomplex **, int *, FILE *, gridinfo_t *);
 extern int zcreate_matrix_postfix(SuperMatrix *, int, doublecomplex **, int *,
 				  doublecomplex **, int *, FILE *, char *, gridinfo_t *);
+extern int zcreate_matrix_binary(SuperMatrix *, int, doublecomplex **, int *,
+				  doublecomplex **, int *, char *, gridinfo_t *);
 
 extern void   zScalePermstructInit(const int_t, const int_t,
                                       zScalePermstruct_t *);
@@ -575,6 +649,7 @@ extern void  pzgssvx_ABglobal(superlu_dist_options_t *, SuperMatrix *,
 extern float pzdistribute(superlu_dist_options_t *, int_t, SuperMatrix *,
 			 zScalePermstruct_t *, Glu_freeable_t *,
 			 zLUstruct_t *, gridinfo_t *);
+extern void  zAmapFree(zAmap_t *);
 extern float pzdistribute_allgrid(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 	     zScalePermstruct_t *ScalePermstruct,
 	     Glu_freeable_t *Glu_freeable, zLUstruct_t *LUstruct,
@@ -592,6 +667,13 @@ extern void  pzCompute_Diag_Inv(int_t, zLUstruct_t *,gridinfo_t *, SuperLUStat_t
 extern int  zSolveInit(superlu_dist_options_t *, SuperMatrix *, int_t [], int_t [],
 		       int_t, zLUstruct_t *, gridinfo_t *, zSOLVEstruct_t *);
 extern void zSolveFinalize(superlu_dist_options_t *, zSOLVEstruct_t *);
+extern int  pzSolveQueueInit(zSolveQueue_t *, int, superlu_dist_options_t *,
+                            SuperMatrix *, zScalePermstruct_t *, zLUstruct_t *,
+                            zSOLVEstruct_t *, gridinfo_t *, SuperLUStat_t *);
+extern int  pzSolveQueueSubmit(zSolveQueue_t *, doublecomplex *, int, int, double *);
+extern int  pzSolveQueueWait(zSolveQueue_t *, int);
+extern int  pzSolveQueueFlush(zSolveQueue_t *);
+extern void pzSolveQueueFinalize(zSolveQueue_t *);
 extern void zDestroy_A3d_gathered_on_2d(zSOLVEstruct_t *, gridinfo3d_t *);
 extern int_t pzgstrs_init(int_t, int_t, int_t, int_t,
                           int_t [], int_t [], gridinfo_t *grid,
@@ -600,8 +682,11 @@ extern int_t pzgstrs_init_device_lsum_x(superlu_dist_options_t *, int_t , int_t
 	     zLUstruct_t *, zSOLVEstruct_t *, int*);
 extern int_t pzgstrs_delete_device_lsum_x(zSOLVEstruct_t *);
 extern void pxgstrs_finalize(pxgstrs_comm_t *);
+extern void pxgstrs_comm_set_nrhs(pxgstrs_comm_t *, int, int);
 extern int  zldperm_dist(int, int, int_t, int_t [], int_t [],
 		    doublecomplex [], int_t *, double [], double []);
+extern int  pzldperm_dist(SuperMatrix *, gridinfo_t *, int_t [],
+		    double [], double []);
 extern int  zstatic_schedule(superlu_dist_options_t *, int, int,
 		            zLUstruct_t *, gridinfo_t *, SuperLUStat_t *,
 			    int_t *, int_t *, int *);
@@ -609,6 +694,15 @@ extern void zLUstructInit(const int_t, zLUstruct_t *);
 extern void zLUstructFree(zLUstruct_t *);
 extern void zDestroy_LU(int_t, gridinfo_t *, zLUstruct_t *);
 extern void zDestroy_Tree(int_t, gridinfo_t *, zLUstruct_t *);
+extern int  pzSaveLU(char *, int_t, zScalePermstruct_t *, zLUstruct_t *,
+                     gridinfo_t *);
+extern int  pzLoadLU(char *, int_t, superlu_dist_options_t *,
+                     zScalePermstruct_t *, zLUstruct_t *, gridinfo_t *,
+                     SuperLUStat_t *);
+extern int  pzMapLU(char *, int_t, superlu_dist_options_t *,
+                    zScalePermstruct_t *, zLUstruct_t *, gridinfo_t *,
+                    SuperLUStat_t *);
+extern void pzScalePermA_LUfile(SuperMatrix *, zScalePermstruct_t *);
 extern void zscatter_l (int ib, int ljb, int nsupc, int_t iukp, int_t* xsup,
 			int klst, int nbrow, int_t lptr, int temp_nbrow,
 			int_t* usub, int_t* lsub, doublecomplex *tempv,
@@ -620,6 +714,22 @@ extern void zscatter_u (int ib, int jb, int nsupc, int_t iukp, int_t * xsup,
                         int_t* lsub, int_t* usub, doublecomplex* tempv,
                         int_t ** Ufstnz_br_ptr, doublecomplex **Unzval_br_ptr,
                         gridinfo_t * grid);
+extern void zgemm_scatter_l (int ib, int ljb, int nsupc, int_t iukp,
+			int_t* xsup, int klst, int_t lptr, int temp_nbrow,
+			int ncols, int ldu, doublecomplex *lval, int ldl,
+			doublecomplex *uval, int fused_max, int_t* usub,
+			int_t* lsub, doublecomplex *tempv,
+			int_t* indirect_thread, int_t* indirect2,
+			int_t ** Lrowind_bc_ptr, doublecomplex **Lnzval_bc_ptr,
+			gridinfo_t * grid);
+extern void zgemm_scatter_u (int ib, int jb, int nsupc, int_t iukp,
+			int_t * xsup, int klst, int_t lptr, int temp_nbrow,
+			int ncols, int ldu, doublecomplex *lval, int ldl,
+			doublecomplex *uval, int fused_max, int_t* lsub,
+			int_t* usub, doublecomplex *tempv,
+			int_t* indirect_thread, int_t* indirect2,
+			int_t ** Ufstnz_br_ptr, doublecomplex **Unzval_br_ptr,
+			gridinfo_t * grid);
 extern int_t pzgstrf(superlu_dist_options_t *, int, int, double anorm,
 		    zLUstruct_t*, gridinfo_t*, SuperLUStat_t*, int*);
 
@@ -979,8 +1089,12 @@ extern void  zreadrb_dist(int, FILE *, int_t *, int_t *, int_t *,
 		     doublecomplex **, int_t **, int_t **);
 extern void  zreadMM_dist(FILE *, int_t *, int_t *, int_t *,
 	                  doublecomplex **, int_t **, int_t **);
+extern int   pzreadMM_dist(char *, SuperMatrix *, gridinfo_t *);
 extern int  zread_binary(FILE *, int_t *, int_t *, int_t *,
 	                  doublecomplex **, int_t **, int_t **);
+extern int  zwrite_binary(char *, int_t, int_t, int_t,
+	                  doublecomplex *, int_t *, int_t *);
+extern int  pzread_binary(char *, SuperMatrix *, gridinfo_t *);
 
 extern void validateInput_pzgssvx3d(superlu_dist_options_t *, SuperMatrix *A,
        int ldb, int nrhs, gridinfo3d_t *, int *info);
@@ -1073,6 +1187,9 @@ extern int zaxpy_(const int *n, const doublecomplex *alpha, const doublecomplex
 extern int superlu_zgemm(const char *transa, const char *transb,
                   int m, int n, int k, doublecomplex alpha, doublecomplex *a,
                   int lda, doublecomplex *b, int ldb, doublecomplex beta, doublecomplex *c, int ldc);
+extern int superlu_zgemm_scatter(int m, int n, int k, doublecomplex *A, int lda,
+                  doublecomplex *B, int ldb, doublecomplex *C, int ldc,
+                  int_t *rowmap, int_t *colmap);
 extern int superlu_ztrsm(const char *sideRL, const char *uplo,
                   const char *transa, const char *diag, const int m, const int n,
                   const doublecomplex alpha, const doublecomplex *a,
@@ -1610,6 +1727,18 @@ extern int zpivot_batch(
     double **ReqPtr, double **CeqPtr, DiagScale_t *, int **RpivPtr
     //    DeviceContext context /* device context including queues, events, dependencies */
     );
+extern int zgssvx_batch_cpu(
+    superlu_dist_options_t *, int batchCount, int m, int n, int nnz,
+    int nrhs, handle_t *, doublecomplex **RHSptr, int *ldRHS,
+    double **ReqPtr, double **CeqPtr, int **RpivPtr, int **CpivPtr,
+    DiagScale_t *DiagScale, doublecomplex **Xptr, int *ldX, double **Berrs,
+    SuperLUStat_t *stat, int *info);
+extern int pzgssvx_batch_cpu(
+    superlu_dist_options_t *, int batchCount, int m, int n, int nnz,
+    int nrhs, handle_t *, doublecomplex **RHSptr, int *ldRHS,
+    double **ReqPtr, double **CeqPtr, int **RpivPtr, int **CpivPtr,
+    DiagScale_t *DiagScale, doublecomplex **Xptr, int *ldX, double **Berrs,
+    gridinfo3d_t *, SuperLUStat_t *stat, int *info);
 
 extern int zwriteLUtoDisk(int nsupers, int_t *xsup, zLUstruct_t *LUstruct);
 extern int zcheckArr(doublecomplex *A, doublecomplex *B, int n);
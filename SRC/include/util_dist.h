@@ -67,6 +67,12 @@ at the top-level directory.
 #define MPI_REQ_ALLOC(x)  ((MPI_Request *) SUPERLU_MALLOC ( (x) * sizeof (MPI_Request)))
 #define INT_T_ALLOC(x)  ((int_t *) SUPERLU_MALLOC ( (x) * sizeof (int_t)))
 #define DOUBLE_ALLOC(x)  ((double *) SUPERLU_MALLOC ( (x) * sizeof (double)))
+/* n objects of the given type from a superlu_arena_t; SUPERLU_FREE of
+   the block is optional when the memory pool is on (see superlu_pool.c) */
+#define SUPERLU_ARENA_MALLOC(a, n, type) \
+    ((type *) superlu_arena_malloc(a, (size_t) SUPERLU_MAX(1, n) * sizeof(type)))
+#define SUPERLU_ARENA_CALLOC(a, n, type) \
+    ((type *) superlu_arena_calloc(a, (size_t) SUPERLU_MAX(1, n) * sizeof(type)))
 
 /* 
  * Constants 
@@ -111,6 +117,10 @@ typedef struct {
     float   gpu_buffer;     /* monitor the buffer allocated on GPU (bytes) */
     int_t MaxActiveBTrees;
     int_t MaxActiveRTrees;
+    double  fact_comm_bytes;  /* bytes of L and U panels received in factorization */
+    double  solve_comm_bytes; /* bytes of messages received in triangular solve */
+    double  forest_imbalance; /* largest imbalance between sibling Z-layer
+				 subtrees predicted by the 3D partitioner */
 
 #ifdef GPU_ACC  /*-- For GPU --*/
     double ScatterMOPCounter;
@@ -133,6 +143,29 @@ typedef struct {
     
 } SuperLUStat_t;
 
+/* Minimum, maximum, average and sum of a quantity over the processes. */
+typedef struct {
+    double min, max, avg, sum;
+} superlu_dist_range_t;
+
+/* Statistics of a solve gathered over the processes of the grid,
+   see superlu_stats_query(). */
+typedef struct {
+    int    nprocs, nprow, npcol;
+    superlu_dist_range_t utime[NPHASES]; /* seconds, indexed by PhaseType */
+    superlu_dist_range_t ops[NPHASES];   /* flops, indexed by PhaseType */
+    superlu_dist_range_t fact_comm_bytes;
+    superlu_dist_range_t solve_comm_bytes;
+    superlu_dist_range_t peak_buffer;    /* bytes, see log_memory() */
+    double forest_imbalance; /* in [0, 1], 0 for a 2D grid */
+    int    TinyPivots;     /* summed over the processes */
+    int    RefineSteps;
+    int_t  nsupers;        /* supernode statistics, 0 if not known */
+    int_t  max_supersize;
+    int_t  singletons;     /* number of supernodes of size 1 */
+    double avg_supersize;
+} superlu_dist_stats_t;
+
 
 /* Headers for 2 types of dynamatically managed memory */
 typedef struct e_node {
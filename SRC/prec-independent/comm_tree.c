@@ -2,21 +2,193 @@
 #include "dcomplex.h"
 #include "superlu_defs.h"
 
+/* Cost of a message, in words, that does not depend on its size. It is
+   the latency divided by the time to send one word. */
+#define TREE_LATENCY_WORDS 1024
+
+/*! \brief Send the messages of the trees[0:ntrees-1] to processes on the
+ *  same node through shm, or only through MPI if shm is NULL.
+ *
+ * <pre>
+ * A solve sets its channel on its trees when it starts, and resets it
+ * to NULL when it ends.
+ * </pre>
+ */
+void C_Tree_SetShm(C_Tree* trees, int_t ntrees, superlu_shm_t* shm)
+{
+    for (int_t i = 0; i < ntrees; ++i)
+	if ( trees[i].empty_ == NO ) trees[i].shm_ = shm;
+}
+
+/*! \brief Set up the shape of the communication trees over comm.
+ *
+ * <pre>
+ * For NODE_TREE, this finds the processes of comm sharing a node with
+ * MPI_Comm_split_type(MPI_COMM_TYPE_SHARED), and must be called by all
+ * processes in comm. The other kinds need no communication.
+ * </pre>
+ */
+void C_TreeTopo_Init(C_TreeTopo* topo, commtree_t kind, MPI_Comm comm)
+{
+    MPI_Comm shm;
+    int iam, leader, p;
+
+    topo->kind = kind;
+    topo->node_of = topo->first = topo->work = NULL;
+    MPI_Comm_size(comm, &topo->nprocs);
+    if ( kind != NODE_TREE ) return;
+
+    MPI_Comm_rank(comm, &iam);
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &shm);
+    MPI_Allreduce(&iam, &leader, 1, MPI_INT, MPI_MIN, shm);
+    MPI_Comm_free(&shm);
+
+    if ( !(topo->node_of = SUPERLU_MALLOC(4 * topo->nprocs * sizeof(int))) )
+	ABORT("Malloc fails for topo->node_of[].");
+    topo->first = topo->node_of + topo->nprocs;
+    topo->work = topo->first + topo->nprocs;
+    MPI_Allgather(&leader, 1, MPI_INT, topo->node_of, 1, MPI_INT, comm);
+    for (p = 0; p < topo->nprocs; ++p) topo->first[p] = -1;
+}
+
+void C_TreeTopo_Free(C_TreeTopo* topo)
+{
+    if ( topo->node_of ) SUPERLU_FREE(topo->node_of);
+    topo->node_of = topo->first = topo->work = NULL;
+}
+
+/* Number of levels below the root of a deg-ary heap with n nodes. */
+static int C_Tree_depth(int n, int deg)
+{
+    int depth = 0, last = 0, width = 1;
+
+    while ( last < n - 1 ) {
+	width *= deg;
+	last += width;
+	++depth;
+    }
+    return depth;
+}
+
+/*! \brief Radix of a tree over rank_cnt processes sending msgSize words.
+ *
+ * <pre>
+ * A parent sends to its children one after the other, so a level of a
+ * deg-ary tree costs about TREE_LATENCY_WORDS + deg*msgSize, and the
+ * radix minimizing the depth times this cost is used: wide trees for
+ * short, latency-bound messages, binary ones for long messages.
+ * In a NODE_TREE, a node leader also has one child on its own node, so
+ * the radix is at most MAX_DEG_TREE-1.
+ * </pre>
+ */
+int C_Tree_Radix(C_TreeTopo* topo, int rank_cnt, int msgSize)
+{
+    int deg, best = DEG_TREE, maxdeg;
+    double cost, bestcost = -1.0;
+
+    if ( !topo || topo->kind == BINARY_TREE ) return DEG_TREE;
+    maxdeg = (topo->kind == NODE_TREE) ? MAX_DEG_TREE - 1 : MAX_DEG_TREE;
+    for (deg = 2; deg <= maxdeg; ++deg) {
+	cost = C_Tree_depth(rank_cnt, deg)
+	       * ((double) TREE_LATENCY_WORDS + (double) deg * msgSize);
+	if ( bestcost < 0.0 || cost < bestcost ) {
+	    best = deg;
+	    bestcost = cost;
+	}
+	if ( deg >= rank_cnt - 1 ) break;
+    }
+    return best;
+}
+
+/* Children and parent of a process in a deg-ary heap over list[0:n-1],
+   where the process is list[me]. */
+static void C_Tree_heapDests(C_Tree* tree, int* list, int n, int me, int deg)
+{
+    int ii;
+
+    for (ii = 0; ii < deg && me*deg+1+ii < n; ii++)
+	tree->myDests_[tree->destCnt_++] = list[me*deg+1+ii];
+    tree->myRoot_ = me ? list[(me-1)/deg] : tree->myRank_;
+}
+
+/*! \brief Set myIdx, myDests_, destCnt_ and myRoot_ of the tree over
+ *  ranks[0:rank_cnt-1], rooted at ranks[0].
+ *
+ * <pre>
+ * Without a NODE_TREE, the tree is a heap over ranks[] in list order.
+ * With a NODE_TREE, the first process of each node in ranks[] is the
+ * leader of the node. The leaders form a heap in list order, and the
+ * other processes of a node form a heap rooted at a child of the leader.
+ * A reduction thus combines the contributions within a node before one
+ * message leaves it, and a broadcast sends one message to each node,
+ * which is then forwarded within the node.
+ * </pre>
+ */
+static void C_Tree_setDests(C_Tree* tree, int* ranks, int rank_cnt, C_TreeTopo* topo)
+{
+    int deg = C_Tree_Radix(topo, rank_cnt, tree->msgSize_);
+    int ii, nd, mynode, nlead = 0, nmem = 0, me = -1, t = -1;
+    int *lead, *mem;
+
+    tree->myIdx = 0;
+    for (ii = 0; ii < rank_cnt; ii++)
+	if ( tree->myRank_ == ranks[ii] ) {
+	    tree->myIdx = ii;
+	    break;
+	}
+
+    if ( !topo || topo->kind != NODE_TREE ) {
+	C_Tree_heapDests(tree, ranks, rank_cnt, tree->myIdx, deg);
+	return;
+    }
+
+    /* Leaders in list order, and the processes of my node. */
+    lead = topo->work;
+    mem = topo->work + topo->nprocs;
+    mynode = topo->node_of[tree->myRank_];
+    for (ii = 0; ii < rank_cnt; ii++) {
+	nd = topo->node_of[ranks[ii]];
+	if ( topo->first[nd] < 0 ) {
+	    topo->first[nd] = ii;
+	    if ( ranks[ii] == tree->myRank_ ) me = nlead;
+	    lead[nlead++] = ranks[ii];
+	}
+	if ( nd == mynode ) {
+	    if ( ranks[ii] == tree->myRank_ ) t = nmem;
+	    mem[nmem++] = ranks[ii];
+	}
+    }
+    for (ii = 0; ii < rank_cnt; ii++) topo->first[topo->node_of[ranks[ii]]] = -1;
+
+    if ( t == 0 ) {          /* Node leader */
+	C_Tree_heapDests(tree, lead, nlead, me, deg);
+	if ( nmem > 1 ) tree->myDests_[tree->destCnt_++] = mem[1];
+    } else {                 /* Heap over mem[1:nmem-1] */
+	C_Tree_heapDests(tree, mem + 1, nmem - 1, t - 1, deg);
+	if ( t == 1 ) tree->myRoot_ = mem[0];
+    }
+}
+
 	void C_BcTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, int msgSize, char precision, int* needrecv){
+		C_BcTree_Create_topo(tree, comm, ranks, rank_cnt, msgSize, precision, needrecv, NULL);
+	}
+
+	void C_BcTree_Create_topo(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, int msgSize, char precision, int* needrecv, C_TreeTopo* topo){
 		assert(msgSize>0);
 
       int nprocs = 0;
       MPI_Comm_size(comm, &nprocs);
 	  tree->comm_=comm;
+	  tree->shm_=NULL;
 	  tree->msgSize_=msgSize;
 	  MPI_Comm_rank(comm,&tree->myRank_);
       tree->myRoot_= -1; 
       tree->tag_=-1;
       tree->destCnt_=0;
-      tree->myDests_[0]=-1;
-      tree->myDests_[1]=-1;
-	  tree->sendRequests_[0]=MPI_REQUEST_NULL;
-	  tree->sendRequests_[1]=MPI_REQUEST_NULL;
+      for (int ii=0;ii<MAX_DEG_TREE;ii++){
+          tree->myDests_[ii]=-1;
+          tree->sendRequests_[ii]=MPI_REQUEST_NULL;
+      }
       tree->empty_= NO;  // non-empty if rank_cnt>1
 	  if(precision=='d'){
 	  tree->type_=MPI_DOUBLE;
@@ -32,29 +204,9 @@
 	     tree->type_=MPI_C_COMPLEX;
 	 }
 
-      tree->myIdx = 0;
-      int ii=0;
-	  int child,root;
-	  //printf("Tree,rank_cnt=%d\n",rank_cnt);
-        for (ii=0;ii<rank_cnt;ii++)
-		  if(tree->myRank_ == ranks[ii]){
-			  tree->myIdx = ii;
-              //printf("Tree,tree->myIdx=%d\n",tree->myIdx);
-			  break;
-		  }
-	  for (ii=0;ii<DEG_TREE;ii++){
-		  if((tree->myIdx)*DEG_TREE+1+ii<rank_cnt){
-			   child = ranks[(tree->myIdx)*DEG_TREE+1+ii];
-			   tree->myDests_[tree->destCnt_++]=child;
-               //*mysendmsg_num+=1;
-                //printf("Tree,destCnt=%d,mymsg=%d\n",tree->destCnt_,*mysendmsg_num);
-		  }
-	  }
-	  if(tree->myIdx!=0){
-		  tree->myRoot_ = ranks[(int)floor((double)(tree->myIdx-1.0)/(double)DEG_TREE)];
+	  C_Tree_setDests(tree, ranks, rank_cnt, topo);
+	  if(tree->myRoot_ != tree->myRank_){
 		  *needrecv=1;
-	  }else{
-		  tree->myRoot_ = tree->myRank_;
 	  }
 
        // int myIdx = 0;
@@ -133,12 +285,13 @@
       tree->myRoot_= -1; 
       tree->tag_=-1;
       tree->destCnt_=0;
-      tree->myDests_[0]=-1;
-      tree->myDests_[1]=-1;
-	  tree->sendRequests_[0]=MPI_REQUEST_NULL;
-	  tree->sendRequests_[1]=MPI_REQUEST_NULL;
+      for (int ii=0;ii<MAX_DEG_TREE;ii++){
+          tree->myDests_[ii]=-1;
+          tree->sendRequests_[ii]=MPI_REQUEST_NULL;
+      }
       tree->empty_= YES; 
 	  tree->comm_=MPI_COMM_NULL;
+	  tree->shm_=NULL;
 	  tree->type_=MPI_DATATYPE_NULL; 
 	}	
 
@@ -151,6 +304,11 @@
 		int flag;
 		for( int idxRecv = 0; idxRecv < tree->destCnt_; ++idxRecv ){
           int iProc = tree->myDests_[idxRecv];
+          if ( tree->shm_ && tree->shm_->comm == tree->comm_ &&
+               superlu_shm_send(tree->shm_, iProc, tree->tag_, localBuffer, msgSize, tree->type_) ) {
+              tree->sendRequests_[idxRecv] = MPI_REQUEST_NULL;
+              continue;
+          }
           // Use Isend to send to multiple targets
           int error_code = MPI_Isend( localBuffer, msgSize, tree->type_, 
               iProc, tree->tag_,tree->comm_, &tree->sendRequests_[idxRecv] );
@@ -226,20 +384,25 @@
     // }
 
 void C_RdTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, int msgSize, char precision, int* needrecvrd,int* needsendrd){
+    C_RdTree_Create_topo(tree, comm, ranks, rank_cnt, msgSize, precision, needrecvrd, needsendrd, NULL);
+}
+
+void C_RdTree_Create_topo(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, int msgSize, char precision, int* needrecvrd, int* needsendrd, C_TreeTopo* topo){
     assert(msgSize>0);
 
     int nprocs = 0;
     MPI_Comm_size(comm, &nprocs);
     tree->comm_=comm;
+    tree->shm_=NULL;
     tree->msgSize_=msgSize;
     MPI_Comm_rank(comm,&tree->myRank_);
     tree->myRoot_= -1;
     tree->tag_=-1;
     tree->destCnt_=0;
-    tree->myDests_[0]=-1;
-    tree->myDests_[1]=-1;
-    tree->sendRequests_[0]=MPI_REQUEST_NULL;
-    tree->sendRequests_[1]=MPI_REQUEST_NULL;
+    for (int ii=0;ii<MAX_DEG_TREE;ii++){
+        tree->myDests_[ii]=-1;
+        tree->sendRequests_[ii]=MPI_REQUEST_NULL;
+    }
     tree->empty_= NO;  // non-empty if rank_cnt>1
     
 	if(precision=='d'){
@@ -251,28 +414,11 @@ void C_RdTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, i
 	if(precision=='s'){
 	    tree->type_=MPI_FLOAT;
 	}
-    //int myIdx = 0;
-    int ii=0;
-    int child,root;
-    for (ii=0;ii<rank_cnt;ii++)
-        if(tree->myRank_ == ranks[ii]){
-            tree->myIdx = ii;
-            break;
-        }
-
-    for (ii=0;ii<DEG_TREE;ii++){
-        if(tree->myIdx*DEG_TREE+1+ii<rank_cnt){
-            child = ranks[tree->myIdx*DEG_TREE+1+ii];
-            tree->myDests_[tree->destCnt_++]=child;
-        }
-    }
+    C_Tree_setDests(tree, ranks, rank_cnt, topo);
     *needrecvrd=tree->destCnt_;
 
-    if(tree->myIdx!=0){
-        tree->myRoot_ = ranks[(int)floor((double)(tree->myIdx-1.0)/(double)DEG_TREE)];
+    if(tree->myRoot_ != tree->myRank_){
         *needsendrd+=1;
-    }else{
-        tree->myRoot_ = tree->myRank_;
     }
     //*mysendmsg_num_rd+=1;
 }
@@ -283,12 +429,13 @@ void C_RdTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, i
       tree->myRoot_= -1; 
       tree->tag_=-1;
       tree->destCnt_=0;
-      tree->myDests_[0]=-1;
-      tree->myDests_[1]=-1;
-	  tree->sendRequests_[0]=MPI_REQUEST_NULL;
-	  tree->sendRequests_[1]=MPI_REQUEST_NULL;
+      for (int ii=0;ii<MAX_DEG_TREE;ii++){
+          tree->myDests_[ii]=-1;
+          tree->sendRequests_[ii]=MPI_REQUEST_NULL;
+      }
       tree->empty_= YES; 
 	  tree->comm_=MPI_COMM_NULL;
+	  tree->shm_=NULL;
 	  tree->type_=MPI_DATATYPE_NULL; 
 	}	
 
@@ -304,6 +451,11 @@ void C_RdTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, i
 		if(Tree->myRank_!=Tree->myRoot_){	
 			  //forward to my root if I have reseived everything
 			  int iProc = Tree->myRoot_;
+			  if ( Tree->shm_ && Tree->shm_->comm == Tree->comm_ &&
+			       superlu_shm_send(Tree->shm_, iProc, Tree->tag_, localBuffer, msgSize, Tree->type_) ) {
+				  Tree->sendRequests_[0] = MPI_REQUEST_NULL;
+				  return;
+			  }
 			  // Use Isend to send to multiple targets
 
 			  int error_code = MPI_Isend(localBuffer, msgSize, Tree->type_, 
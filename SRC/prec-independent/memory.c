@@ -60,7 +60,7 @@ long int superlu_malloc_total = 0;
 #define PAD_FACTOR  2
 #define DWORD  (sizeof(double)) /* Be sure it's no smaller than double. */
 
-void *superlu_malloc_dist(size_t size)
+static void *sys_malloc_dist(size_t size)
 {
     char *buf;
     int iam;
@@ -91,7 +91,7 @@ void *superlu_malloc_dist(size_t size)
     return (void *) (buf + DWORD);
 }
 
-void superlu_free_dist(void *addr)
+static void sys_free_dist(void *addr)
 {
     char *p = ((char *) addr) - DWORD;
 
@@ -124,40 +124,40 @@ void superlu_free_dist(void *addr)
   
 // #ifdef GPU_ACC  // Yang: use gpuMallocManaged seems to make the code much slower  
 #if 0  // Yang: use system malloc (for managed memory access, this requires HMM (x86) or ATS (p9) supports) 
-void *superlu_malloc_dist(size_t size) {
+static void *sys_malloc_dist(size_t size) {
     void *buf;
 	gpuMallocManaged(&buf, size, gpuMemAttachGlobal);
 	// printf("%15d %15d\n",buf,size);
     return (buf);
 }
-void superlu_free_dist(void *addr) { gpuError_t error = gpuFree(addr);}
+static void sys_free_dist(void *addr) { gpuError_t error = gpuFree(addr);}
 
 #else 
 
 #if  0 
 // #if (__STDC_VERSION__ >= 201112L)   // cannot compile on Summit, also this is very slow on tulip
 
-void * superlu_malloc_dist(size_t size) {void* ptr;int alignment=1<<12;if(size>1<<19){alignment=1<<21;}posix_memalign( (void**)&(ptr), alignment, size );return(ptr);}
-void   superlu_free_dist(void * ptr)    {free(ptr);}
+static void * sys_malloc_dist(size_t size) {void* ptr;int alignment=1<<12;if(size>1<<19){alignment=1<<21;}posix_memalign( (void**)&(ptr), alignment, size );return(ptr);}
+static void   sys_free_dist(void * ptr)    {free(ptr);}
 
 #elif defined (__INTEL_COMPILER)
 #include <immintrin.h>
-void * superlu_malloc_dist(size_t size) {
+static void * sys_malloc_dist(size_t size) {
     void* ptr;
     int alignment = 1<<12; // align at 4K page
     if (size > 1<<19 ) { alignment=1<<21; }
     return (_mm_malloc(size, alignment));
 }
-void  superlu_free_dist(void * ptr)  { _mm_free(ptr); }
+static void  sys_free_dist(void * ptr)  { _mm_free(ptr); }
 
 #else // normal malloc/free 
 
-void *superlu_malloc_dist(size_t size) {
+static void *sys_malloc_dist(size_t size) {
     void *buf;
     buf = (void *) malloc(size);
     return (buf);
 }
-void superlu_free_dist(void *addr) { free (addr); }
+static void sys_free_dist(void *addr) { free (addr); }
 
 #endif
 #endif
@@ -167,6 +167,24 @@ void superlu_free_dist(void *addr) { free (addr); }
 
 #endif  /* End debug malloc/free. */
 
+/* The system allocator above, in debug mode or not, or the pooled
+   allocator of superlu_pool.c if SUPERLU_MALLOC_POOL is set.
+   superlu_pool_state is -1 until the environment is read, see
+   superlu_pool_init(). */
+int superlu_pool_state = -1;
+
+void *superlu_malloc_dist(size_t size)
+{
+    if ( superlu_pool_enabled() ) return superlu_pool_malloc(size);
+    return sys_malloc_dist(size);
+}
+
+void superlu_free_dist(void *addr)
+{
+    if ( superlu_pool_enabled() ) superlu_pool_free(addr);
+    else sys_free_dist(addr);
+}
+
 
 
 static void
@@ -513,7 +513,7 @@ void slu_SCT_print3D(gridinfo3d_t *grid3d, SCT_t* SCT)
     
     char funName[100];
 
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     for (int i = maxLvl-1; i >-1; --i)
     {
@@ -536,7 +536,7 @@ void treeImbalance3D(gridinfo3d_t *grid3d, SCT_t* SCT)
     gridinfo_t* grid = &(grid3d->grid2d);
     char funName[100];
 
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     for (int i = maxLvl-1; i >-1; --i)
     {
@@ -547,7 +547,7 @@ void treeImbalance3D(gridinfo3d_t *grid3d, SCT_t* SCT)
         double tmax;
         MPI_Reduce( &SCT->tFactor3D[i], &tmax,  1, MPI_DOUBLE, MPI_MAX, 0, grid3d->zscp.comm );
         
-        double tavg = tsum /(grid3d->zscp.Np>>i);
+        double tavg = tsum /((grid3d->zscp.Np + (1 << i) - 1) >> i);
         double lLmb =  100*(tmax-tavg)/tavg;
         sprintf( funName, "Imbalance Factor:Level-%d    ",  (int) maxLvl-1-i);
         if(!grid3d->zscp.Iam)
@@ -708,7 +708,7 @@ void printTRStimer(xtrsTimer_t *xtrsTimer, gridinfo3d_t *grid3d)
     DistPrint3D("forwardSolve-compute ",  xtrsTimer->tfs_compute, "seconds", grid3d);
     DistPrint3D("forwardSolve-comm    ",  xtrsTimer->tfs_comm, "seconds", grid3d);
 
-    int maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     char funName[100];
     for (int i = maxLvl-1; i >-1; --i)
     {
@@ -59,6 +59,10 @@ at the top-level directory.
 	    = 9: number of GPU streams
 	    = 10: whether to offload computations to GPU or not
 	    = 11: whether to offload triangular solve to GPU or not
+	    = 12: the maximum value of the product M*N*K for a block update
+	         of the Schur complement to be done by the fused GEMM and
+	         scatter kernel, without a buffer for the product; 0 turns
+	         the fused kernel off.
 
    options (input) superlu_dist_options_t*
            The structure defines the input parameters to control
@@ -153,6 +157,12 @@ sp_ienv_dist(int ispec, superlu_dist_options_t *options)
                 return atoi (ttemp);
             else
                 return 0;  // default
+         case 12:
+	    ttemp = getenv ("SUPERLU_FUSED_GEMM");
+            if (ttemp)
+                return atoi (ttemp);
+            else
+                return 512;  // default, 8 x 8 x 8
     }
 
     /* Invalid value for ISPEC */
@@ -0,0 +1,213 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file superlu_LUfile.c
+ * \brief Precision-independent helpers for the on-disk LU factor format
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * Each process writes its part of the distributed factors to its own
+ * file "<prefix>.<iam>". The layout is described by
+ * superlu_LUfile_header_t in superlu_defs.h; the precision-dependent
+ * writers and readers are in p[dsz]LUfile.c.
+ * </pre>
+ */
+
+#define _FILE_OFFSET_BITS 64 /* off_t and fseeko() beyond 2 GB */
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "superlu_defs.h"
+
+/* Seek to byte position off of the file. */
+static int LUfile_seek(FILE *fp, int64_t off)
+{
+#ifdef _WIN32
+    return _fseeki64(fp, off, SEEK_SET);
+#else
+    return fseeko(fp, (off_t) off, SEEK_SET);
+#endif
+}
+
+/*! \brief Open the LU file of process 'iam', named "<prefix>.<iam>".
+ */
+FILE *superlu_LUfile_open(const char *prefix, int iam, const char *mode)
+{
+    char fname[1024];
+
+    snprintf(fname, sizeof(fname), "%s.%d", prefix, iam);
+    return fopen(fname, mode);
+}
+
+/*! \brief Fill in the identification part of the LU file header.
+ *
+ * The section lengths are left at zero; the caller sets sect_len[]
+ * and then calls superlu_LUfile_layout().
+ */
+void superlu_LUfile_init_header(superlu_LUfile_header_t *hdr, char dtype,
+                                int_t n, int_t nsupers, gridinfo_t *grid)
+{
+    memset(hdr, 0, sizeof(superlu_LUfile_header_t));
+    memcpy(hdr->magic, SLU_LUFILE_MAGIC, sizeof(hdr->magic));
+    hdr->version = SLU_LUFILE_VERSION;
+    hdr->hdr_size = (int32_t) sizeof(superlu_LUfile_header_t);
+    hdr->dtype = dtype;
+    hdr->int_t_size = (int32_t) sizeof(int_t);
+    hdr->long_size = (int32_t) sizeof(long int);
+    hdr->nprow = grid->nprow;
+    hdr->npcol = grid->npcol;
+    hdr->iam = grid->iam;
+    hdr->n = n;
+    hdr->nsupers = nsupers;
+}
+
+/*! \brief Place the sections one after another behind the header,
+ *  each starting at a multiple of SLU_LUFILE_ALIGN bytes.
+ */
+void superlu_LUfile_layout(superlu_LUfile_header_t *hdr)
+{
+    int64_t off = sizeof(superlu_LUfile_header_t);
+    int i;
+
+    for (i = 0; i < LUFILE_NSECT; ++i) {
+	off = CEILING(off, SLU_LUFILE_ALIGN) * SLU_LUFILE_ALIGN;
+	hdr->sect_off[i] = off;
+	off += hdr->sect_len[i];
+    }
+}
+
+/*! \brief Check that a header read from disk can be loaded by this process.
+ *
+ * <pre>
+ * Return value
+ * ============
+ *   = 0: the file matches
+ *   = 3: not an LU file, or written by an incompatible version
+ *   = 4: precision, sizeof(int_t) or sizeof(long int) differs
+ *   = 5: written on a different process grid or by a different rank
+ *   = 6: dimension of the matrix differs
+ * </pre>
+ */
+int superlu_LUfile_check_header(superlu_LUfile_header_t *hdr, char dtype,
+                                int_t n, gridinfo_t *grid)
+{
+    if ( memcmp(hdr->magic, SLU_LUFILE_MAGIC, sizeof(hdr->magic))
+	 || hdr->version != SLU_LUFILE_VERSION
+	 || hdr->hdr_size != (int32_t) sizeof(superlu_LUfile_header_t) )
+	return 3;
+    if ( hdr->dtype != dtype || hdr->int_t_size != (int32_t) sizeof(int_t)
+	 || hdr->long_size != (int32_t) sizeof(long int) )
+	return 4;
+    if ( hdr->nprow != grid->nprow || hdr->npcol != grid->npcol
+	 || hdr->iam != grid->iam )
+	return 5;
+    if ( hdr->n != n || hdr->nsupers < 1 || hdr->nsupers > n )
+	return 6;
+    return 0;
+}
+
+/*! \brief Check that every section of the header lies within the file.
+ *  Returns 0 if so, 2 if the file is truncated or the header is corrupt.
+ */
+int superlu_LUfile_check_sections(FILE *fp, superlu_LUfile_header_t *hdr)
+{
+    int64_t size;
+    int i;
+
+#ifdef _WIN32
+    if ( _fseeki64(fp, 0, SEEK_END) ) return 2;
+    size = _ftelli64(fp);
+#else
+    struct stat st;
+
+    if ( fstat(fileno(fp), &st) ) return 2;
+    size = (int64_t) st.st_size;
+#endif
+    for (i = 0; i < LUFILE_NSECT; ++i)
+	if ( hdr->sect_len[i] < 0 || hdr->sect_off[i] < hdr->hdr_size
+	     || hdr->sect_off[i] > size
+	     || hdr->sect_len[i] > size - hdr->sect_off[i] )
+	    return 2;
+    return 0;
+}
+
+/*! \brief Write nbytes from buf at byte position pos within a section.
+ *  Returns 0 on success, 2 on I/O error.
+ */
+int superlu_LUfile_write(FILE *fp, superlu_LUfile_header_t *hdr, int sect,
+                         int64_t pos, const void *buf, size_t nbytes)
+{
+    if ( nbytes == 0 ) return 0;
+    if ( pos < 0 || (int64_t) nbytes > hdr->sect_len[sect] - pos ) return 2;
+    if ( LUfile_seek(fp, hdr->sect_off[sect] + pos) ) return 2;
+    if ( fwrite(buf, 1, nbytes, fp) != nbytes ) return 2;
+    return 0;
+}
+
+/*! \brief Read nbytes into buf from byte position pos within a section.
+ *  Returns 0 on success, 2 on I/O error or a truncated file.
+ */
+int superlu_LUfile_read(FILE *fp, superlu_LUfile_header_t *hdr, int sect,
+                        int64_t pos, void *buf, size_t nbytes)
+{
+    if ( nbytes == 0 ) return 0;
+    if ( pos < 0 || (int64_t) nbytes > hdr->sect_len[sect] - pos ) return 2;
+    if ( LUfile_seek(fp, hdr->sect_off[sect] + pos) ) return 2;
+    if ( fread(buf, 1, nbytes, fp) != nbytes ) return 2;
+    return 0;
+}
+
+/*! \brief Map the LU file of process 'iam' into memory.
+ *
+ * The mapping is private and copy-on-write: pages are read lazily from
+ * the file (or shared through the page cache with other processes
+ * mapping the same file), and modifications are never written back.
+ * Returns the base address and sets *size, or returns NULL on failure
+ * or if mmap() is not available.
+ */
+void *superlu_LUfile_map(const char *prefix, int iam, size_t *size)
+{
+#ifdef _WIN32
+    return NULL;
+#else
+    char fname[1024];
+    struct stat st;
+    void *base;
+    int fd;
+
+    snprintf(fname, sizeof(fname), "%s.%d", prefix, iam);
+    if ( (fd = open(fname, O_RDONLY)) < 0 ) return NULL;
+    if ( fstat(fd, &st) || st.st_size < (off_t) sizeof(superlu_LUfile_header_t) ) {
+	close(fd);
+	return NULL;
+    }
+    base = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE, fd, 0);
+    close(fd); /* The mapping stays valid. */
+    if ( base == MAP_FAILED ) return NULL;
+    *size = (size_t) st.st_size;
+    return base;
+#endif
+}
+
+/*! \brief Release a mapping created by superlu_LUfile_map().
+ */
+void superlu_LUfile_unmap(void *base, size_t size)
+{
+#ifndef _WIN32
+    if ( base ) munmap(base, size);
+#endif
+}
@@ -0,0 +1,201 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file superlu_binary_io.c
+ * \brief Precision-independent helpers for the binary sparse matrix format
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * The layout is described by superlu_binmat_header_t in superlu_defs.h;
+ * the precision-dependent writers and readers are in [sdz]binary_io.c.
+ * </pre>
+ */
+
+#include <string.h>
+#include "superlu_defs.h"
+
+/*! \brief Fill in the header of a binary matrix file and place the
+ *  sections behind it, each starting at a multiple of SLU_BINMAT_ALIGN.
+ *  The indices are stored with the width of int_t.
+ */
+void superlu_binmat_init_header(superlu_binmat_header_t *hdr, char dtype,
+                                size_t value_size, int64_t m, int64_t n,
+                                int64_t nnz)
+{
+    int64_t off;
+
+    memset(hdr, 0, sizeof(superlu_binmat_header_t));
+    memcpy(hdr->magic, SLU_BINMAT_MAGIC, sizeof(hdr->magic));
+    hdr->version = SLU_BINMAT_VERSION;
+    hdr->hdr_size = (int32_t) sizeof(superlu_binmat_header_t);
+    hdr->dtype = dtype;
+    hdr->format = 'R';
+    hdr->index_size = (int32_t) sizeof(int_t);
+    hdr->value_size = (int32_t) value_size;
+    hdr->m = m;
+    hdr->n = n;
+    hdr->nnz = nnz;
+
+    off = CEILING((int64_t) sizeof(superlu_binmat_header_t), SLU_BINMAT_ALIGN)
+          * SLU_BINMAT_ALIGN;
+    hdr->rowptr_off = off;
+    off += (m + 1) * hdr->index_size;
+    off = CEILING(off, SLU_BINMAT_ALIGN) * SLU_BINMAT_ALIGN;
+    hdr->colind_off = off;
+    off += nnz * hdr->index_size;
+    off = CEILING(off, SLU_BINMAT_ALIGN) * SLU_BINMAT_ALIGN;
+    hdr->nzval_off = off;
+}
+
+/*! \brief Check that a header read from disk describes a matrix of
+ *  precision dtype that can be read by this build.
+ *
+ * <pre>
+ * Return value
+ * ============
+ *   = 0: the file matches
+ *   = 3: not a binary matrix file, or written by an incompatible version
+ *   = 4: precision differs, or the indices do not fit in int_t
+ * </pre>
+ */
+int superlu_binmat_check_header(superlu_binmat_header_t *hdr, char dtype)
+{
+    if ( memcmp(hdr->magic, SLU_BINMAT_MAGIC, sizeof(hdr->magic))
+	 || hdr->version != SLU_BINMAT_VERSION
+	 || hdr->hdr_size != (int32_t) sizeof(superlu_binmat_header_t)
+	 || hdr->format != 'R'
+	 || (hdr->index_size != 4 && hdr->index_size != 8)
+	 || hdr->m < 0 || hdr->n < 0 || hdr->nnz < 0 )
+	return 3;
+    if ( hdr->dtype != dtype )
+	return 4;
+    if ( sizeof(int_t) < 8 && (hdr->m > INT_MAX || hdr->n > INT_MAX
+			       || hdr->nnz > INT_MAX) )
+	return 4;
+    return 0;
+}
+
+/*! \brief Write nbytes from buf at byte offset off.
+ *  Returns 0 on success, 2 on I/O error.
+ */
+int superlu_binmat_fwrite(FILE *fp, int64_t off, const void *buf, size_t nbytes)
+{
+    if ( nbytes == 0 ) return 0;
+    if ( fseek(fp, (long) off, SEEK_SET) ) return 2;
+    if ( fwrite(buf, 1, nbytes, fp) != nbytes ) return 2;
+    return 0;
+}
+
+/*! \brief Read nbytes into buf from byte offset off.
+ *  Returns 0 on success, 2 on I/O error or a truncated file.
+ */
+int superlu_binmat_fread(FILE *fp, int64_t off, void *buf, size_t nbytes)
+{
+    if ( nbytes == 0 ) return 0;
+    if ( fseek(fp, (long) off, SEEK_SET) ) return 2;
+    if ( fread(buf, 1, nbytes, fp) != nbytes ) return 2;
+    return 0;
+}
+
+/* Widen or narrow count indices stored with hdr->index_size bytes in
+   tmp[] to int_t in buf[]. Returns 4 if an index does not fit. */
+static int binmat_convert_index(superlu_binmat_header_t *hdr, int64_t count,
+                                void *tmp, int_t *buf)
+{
+    int64_t i;
+
+    if ( hdr->index_size == 4 ) {
+	int32_t *t = (int32_t *) tmp;
+	for (i = 0; i < count; ++i) buf[i] = t[i];
+    } else {
+	int64_t *t = (int64_t *) tmp;
+	for (i = 0; i < count; ++i) {
+	    if ( (int_t) t[i] != t[i] ) return 4;
+	    buf[i] = (int_t) t[i];
+	}
+    }
+    return 0;
+}
+
+/*! \brief Read count indices starting at byte offset off into the int_t
+ *  array buf, converting from the index width recorded in the header.
+ *  Returns 0 on success, 2 on I/O error, 4 if an index does not fit.
+ */
+int superlu_binmat_fread_index(FILE *fp, superlu_binmat_header_t *hdr,
+                               int64_t off, int64_t count, int_t *buf)
+{
+    void *tmp;
+    int info;
+
+    if ( hdr->index_size == (int32_t) sizeof(int_t) )
+	return superlu_binmat_fread(fp, off, buf, count * sizeof(int_t));
+    if ( count == 0 ) return 0;
+    if ( !(tmp = SUPERLU_MALLOC(count * hdr->index_size)) )
+	ABORT("Malloc fails for tmp[].");
+    info = superlu_binmat_fread(fp, off, tmp, count * hdr->index_size);
+    if ( !info ) info = binmat_convert_index(hdr, count, tmp, buf);
+    SUPERLU_FREE(tmp);
+    return info;
+}
+
+/*! \brief Collective read of nbytes into buf from byte offset off.
+ *
+ * The read is split into pieces of at most SLU_BINMAT_CHUNK bytes, so
+ * that the count passed to MPI stays within an int. All processes in
+ * comm must call this routine; nbytes may differ among them, and may
+ * be zero. Returns 0 on success, 2 on I/O error or a truncated file.
+ */
+int superlu_binmat_read_at_all(MPI_File fh, MPI_Offset off, void *buf,
+                               int64_t nbytes, MPI_Comm comm)
+{
+    int64_t nchunk = CEILING(nbytes, SLU_BINMAT_CHUNK), maxchunk, k, len;
+    MPI_Status status;
+    int count, info = 0;
+
+    MPI_Allreduce(&nchunk, &maxchunk, 1, MPI_INT64_T, MPI_MAX, comm);
+    for (k = 0; k < maxchunk; ++k) {
+	len = nbytes - k * SLU_BINMAT_CHUNK;
+	len = SUPERLU_MAX(0, SUPERLU_MIN(len, SLU_BINMAT_CHUNK));
+	if ( MPI_File_read_at_all(fh, off + k * SLU_BINMAT_CHUNK,
+				  (char *) buf + (len ? k * SLU_BINMAT_CHUNK : 0),
+				  (int) len, MPI_BYTE, &status) != MPI_SUCCESS ) {
+	    info = 2;
+	    continue;
+	}
+	MPI_Get_count(&status, MPI_BYTE, &count);
+	if ( count != len ) info = 2;
+    }
+    return info;
+}
+
+/*! \brief Collective read of count indices starting at byte offset off
+ *  into the int_t array buf, converting from the index width recorded
+ *  in the header. Returns 0 on success, 2 on I/O error, 4 if an index
+ *  does not fit.
+ */
+int superlu_binmat_read_index_at_all(MPI_File fh, superlu_binmat_header_t *hdr,
+                                     int64_t off, int64_t count, int_t *buf,
+                                     MPI_Comm comm)
+{
+    void *tmp;
+    int info;
+
+    if ( hdr->index_size == (int32_t) sizeof(int_t) )
+	return superlu_binmat_read_at_all(fh, off, buf, count * sizeof(int_t),
+					  comm);
+    if ( !(tmp = SUPERLU_MALLOC(SUPERLU_MAX(count, 1) * hdr->index_size)) )
+	ABORT("Malloc fails for tmp[].");
+    info = superlu_binmat_read_at_all(fh, off, tmp, count * hdr->index_size, comm);
+    if ( !info ) info = binmat_convert_index(hdr, count, tmp, buf);
+    SUPERLU_FREE(tmp);
+    return info;
+}
@@ -0,0 +1,365 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file superlu_pool.c
+ * \brief Pooled allocator behind SUPERLU_MALLOC, and arenas
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * The pool is enabled by setting the environment variable
+ * SUPERLU_MALLOC_POOL=1; the variable is read at the first call to
+ * SUPERLU_MALLOC, and the choice holds for the rest of the run. This is
+ * the same in debug builds (DEBUGlevel>=1), where the pool replaces the
+ * checking allocator of memory.c.
+ *
+ * With the pool, a block of up to POOL_MAXSIZE bytes is rounded up to
+ * one of the size classes (4 per power of 2), and is kept on the free
+ * list of its class when it is freed, to be handed out again by the
+ * next SUPERLU_MALLOC of the same class. Larger blocks go to malloc.
+ * superlu_pool_trim() returns the cached blocks to the system.
+ *
+ * An arena hands out blocks from large chunks with a bump pointer;
+ * SUPERLU_FREE of such a block does nothing, and superlu_arena_reset()
+ * makes all the memory of the arena available again in O(1), keeping
+ * the chunks. Without the pool, an arena is just SUPERLU_MALLOC, so
+ * every block must still be freed with SUPERLU_FREE.
+ *
+ * With SUPERLU_MALLOC_HUGEPAGE=1, the large blocks and the arena chunks
+ * of at least 2 MB are aligned to 2 MB and advised to be backed by
+ * transparent huge pages. The pool never touches the memory it hands
+ * out, so the pages are placed on the NUMA node of the thread that
+ * first writes them.
+ *
+ * superlu_malloc_total counts the bytes requested and not yet freed;
+ * the blocks of an arena are counted until the arena is reset.
+ * </pre>
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+#include "superlu_defs.h"
+
+#define POOL_HDR     16                 /* header in front of each block  */
+#define POOL_MINSIZE 32                 /* smallest class, with header    */
+#define POOL_MAXSIZE (1 << 20)          /* largest class, with header     */
+#define POOL_NCLASS  (1 + 4 * 15)       /* classes from 2^5 to 2^20 bytes */
+#define POOL_LARGE   POOL_NCLASS        /* kind of a block not in a class */
+#define POOL_ARENA   (POOL_NCLASS + 1)  /* kind of a block of an arena    */
+#define POOL_MAGIC   0x51u
+#define ARENA_CHUNK  (1 << 20)
+#define HUGE_PAGE    (1 << 21)
+#define POOL_ON       1                 /* bits of superlu_pool_state     */
+#define POOL_HUGEPAGE 2
+
+typedef struct {
+    size_t size;        /* bytes requested                              */
+    int kind;           /* size class, POOL_LARGE or POOL_ARENA          */
+    unsigned magic;     /* POOL_MAGIC while the block is in use          */
+} pool_hdr_t;
+
+typedef struct pool_link {
+    struct pool_link *next;
+} pool_link_t;
+
+struct superlu_arena_chunk {
+    struct superlu_arena_chunk *next;
+    size_t size;        /* bytes after this header                      */
+};
+
+static pool_link_t *pool_list[POOL_NCLASS];
+static size_t pool_cached = 0; /* bytes on the free lists */
+
+extern long int superlu_malloc_total;
+extern int superlu_pool_state;   /* defined in memory.c */
+
+/*! \brief Read the environment to decide whether the pool is used.
+ *
+ * superlu_pool_state is -1 until then, and afterwards holds the
+ * POOL_ON and POOL_HUGEPAGE bits. It is set once, in a critical
+ * section, but read by any thread at any time, so every access to it is
+ * atomic. Returns the state.
+ */
+int superlu_pool_init(void)
+{
+    char *s;
+    int state;
+
+#ifdef _OPENMP
+#pragma omp critical (superlu_pool_init)
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+	state = superlu_pool_state;
+	if ( state < 0 ) {
+	    state = 0;
+	    if ( (s = getenv("SUPERLU_MALLOC_POOL")) && atoi(s) > 0 )
+		state |= POOL_ON;
+	    if ( (s = getenv("SUPERLU_MALLOC_HUGEPAGE")) && atoi(s) > 0 )
+		state |= POOL_HUGEPAGE;
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+	    superlu_pool_state = state;
+	}
+    }
+    return state;
+}
+
+/* The pool state, read from the environment at the first call. */
+static int pool_state(void)
+{
+    int state;
+
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+    state = superlu_pool_state;
+    return state < 0 ? superlu_pool_init() : state;
+}
+
+/*! \brief Return nonzero if SUPERLU_MALLOC uses the pool. */
+int superlu_pool_enabled(void)
+{
+    return pool_state() & POOL_ON;
+}
+
+/* Class of a block of size bytes, header included. */
+static int pool_class(size_t size)
+{
+    int k = 0;
+    size_t s;
+
+    if ( size <= POOL_MINSIZE ) return 0;
+    for (s = size - 1; s >> (k + 1); ++k) ;   /* 2^k < size <= 2^(k+1) */
+    return 1 + (k - 5) * 4 + (int) (((size - 1) >> (k - 2)) & 3);
+}
+
+/* Size of the blocks of class c, header included. */
+static size_t pool_class_size(int c)
+{
+    int k;
+
+    if ( c == 0 ) return POOL_MINSIZE;
+    k = 5 + (c - 1) / 4;
+    return ((size_t) 1 << k) + (size_t) ((c - 1) % 4 + 1) * ((size_t) 1 << (k - 2));
+}
+
+/* Memory from the system, on huge pages if asked for and large enough. */
+static void *pool_sysalloc(size_t size)
+{
+#if defined(MADV_HUGEPAGE)
+    void *p;
+
+    if ( (pool_state() & POOL_HUGEPAGE) && size >= HUGE_PAGE ) {
+	if ( posix_memalign(&p, HUGE_PAGE, size) ) return NULL;
+	madvise(p, size, MADV_HUGEPAGE);
+	return p;
+    }
+#endif
+    return malloc(size);
+}
+
+static void *pool_block(pool_hdr_t *h, size_t size, int kind)
+{
+    h->size = size;
+    h->kind = kind;
+    h->magic = POOL_MAGIC;
+    if ( kind != POOL_ARENA ) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+	superlu_malloc_total += size;
+    }
+    return (char *) h + POOL_HDR;
+}
+
+/*! \brief SUPERLU_MALLOC when the pool is on. */
+void *superlu_pool_malloc(size_t size)
+{
+    pool_hdr_t *h = NULL;
+    size_t bytes = size + POOL_HDR;
+    int c;
+
+    if ( bytes > POOL_MAXSIZE ) {
+	if ( !(h = (pool_hdr_t *) pool_sysalloc(bytes)) ) return NULL;
+	return pool_block(h, size, POOL_LARGE);
+    }
+
+    c = pool_class(bytes);
+#ifdef _OPENMP
+#pragma omp critical (superlu_pool)
+#endif
+    {
+	if ( pool_list[c] ) {
+	    h = (pool_hdr_t *) pool_list[c];
+	    pool_list[c] = pool_list[c]->next;
+	    pool_cached -= pool_class_size(c);
+	}
+    }
+    if ( !h && !(h = (pool_hdr_t *) malloc(pool_class_size(c))) ) return NULL;
+    return pool_block(h, size, c);
+}
+
+/*! \brief SUPERLU_FREE when the pool is on. */
+void superlu_pool_free(void *addr)
+{
+    pool_hdr_t *h;
+    pool_link_t *l;
+    int c;
+
+    if ( !addr ) return;
+    h = (pool_hdr_t *) ((char *) addr - POOL_HDR);
+    if ( h->magic != POOL_MAGIC )
+	ABORT("superlu_free: not a block of SUPERLU_MALLOC, or freed twice");
+    h->magic = 0;
+    if ( h->kind == POOL_ARENA ) return; /* reclaimed by superlu_arena_reset */
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    superlu_malloc_total -= h->size;
+
+    if ( h->kind == POOL_LARGE ) {
+	free(h);
+	return;
+    }
+    c = h->kind;
+    l = (pool_link_t *) h;
+#ifdef _OPENMP
+#pragma omp critical (superlu_pool)
+#endif
+    {
+	l->next = pool_list[c];
+	pool_list[c] = l;
+	pool_cached += pool_class_size(c);
+    }
+}
+
+/*! \brief Return the blocks cached by the pool to the system.
+ *
+ * Returns the number of bytes released.
+ */
+size_t superlu_pool_trim(void)
+{
+    pool_link_t *l, *next[POOL_NCLASS];
+    size_t bytes;
+    int c;
+
+#ifdef _OPENMP
+#pragma omp critical (superlu_pool)
+#endif
+    {
+	for (c = 0; c < POOL_NCLASS; ++c) {
+	    next[c] = pool_list[c];
+	    pool_list[c] = NULL;
+	}
+	bytes = pool_cached;
+	pool_cached = 0;
+    }
+    for (c = 0; c < POOL_NCLASS; ++c)
+	for (l = next[c]; l; l = next[c]) {
+	    next[c] = l->next;
+	    free(l);
+	}
+    return bytes;
+}
+
+/*! \brief Allocate size bytes from arena a.
+ *
+ * The block is aligned to 16 bytes. It may be freed with SUPERLU_FREE,
+ * which does nothing when the pool is on; its memory is reclaimed by
+ * superlu_arena_reset().
+ */
+void *superlu_arena_malloc(superlu_arena_t *a, size_t size)
+{
+    superlu_arena_chunk_t *c;
+    pool_hdr_t *h = NULL;
+    size_t need = POOL_HDR + ((size + 15) & ~(size_t) 15), csize;
+
+    if ( !superlu_pool_enabled() ) return superlu_malloc_dist(size);
+
+#ifdef _OPENMP
+#pragma omp critical (superlu_arena)
+#endif
+    {
+	while ( a->cur && a->off + need > a->cur->size ) {
+	    a->cur = a->cur->next;
+	    a->off = 0;
+	}
+	if ( !a->cur ) {
+	    csize = SUPERLU_MAX(ARENA_CHUNK, need);
+	    if ( (c = (superlu_arena_chunk_t *)
+		  pool_sysalloc(sizeof(superlu_arena_chunk_t) + csize)) ) {
+		c->next = NULL;
+		c->size = csize;
+		if ( a->tail ) a->tail->next = c;
+		else a->head = c;
+		a->tail = a->cur = c;
+		a->off = 0;
+	    }
+	}
+	if ( a->cur ) {
+	    h = (pool_hdr_t *) ((char *) (a->cur + 1) + a->off);
+	    a->off += need;
+	    a->used += size;
+	}
+    }
+    if ( !h ) return NULL;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    superlu_malloc_total += size;
+    return pool_block(h, size, POOL_ARENA);
+}
+
+/*! \brief Allocate size bytes, set to zero, from arena a. */
+void *superlu_arena_calloc(superlu_arena_t *a, size_t size)
+{
+    void *p = superlu_arena_malloc(a, size);
+
+    if ( p ) memset(p, 0, size);
+    return p;
+}
+
+/*! \brief Make all the memory of arena a available again.
+ *
+ * The blocks handed out by a must no longer be used. The chunks are
+ * kept for the next allocations.
+ */
+void superlu_arena_reset(superlu_arena_t *a)
+{
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    superlu_malloc_total -= a->used;
+    a->cur = a->head;
+    a->off = 0;
+    a->used = 0;
+}
+
+/*! \brief Reset arena a and return its chunks to the system. */
+void superlu_arena_free(superlu_arena_t *a)
+{
+    superlu_arena_chunk_t *c, *next;
+
+    superlu_arena_reset(a);
+    for (c = a->head; c; c = next) {
+	next = c->next;
+	free(c);
+    }
+    a->head = a->tail = a->cur = NULL;
+}
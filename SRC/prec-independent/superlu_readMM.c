@@ -0,0 +1,140 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file superlu_readMM.c
+ * \brief Precision-independent helpers for the parallel Matrix Market reader
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * The file is split into byte ranges of equal size, one per process.
+ * A line belongs to the process whose range contains its first byte,
+ * so every process can find its lines without reading the others.
+ * The precision-dependent readers are in p[sdz]readMM.c.
+ * </pre>
+ */
+
+#include <ctype.h>
+#include <string.h>
+#include "superlu_defs.h"
+
+/*! \brief Read the banner and the size line of a Matrix Market file.
+ *
+ * <pre>
+ * arith is the expected field, "real" or "complex". On return, *expand
+ * tells whether the matrix is symmetric and stored by its lower (or
+ * upper) triangle, and *data_off is the byte offset of the first line
+ * after the size line.
+ *
+ * Return value
+ * ============
+ *   = 0: successful exit
+ *   = 3: not a Matrix Market coordinate matrix, or a rectangular one
+ *   = 4: the field is not arith
+ * </pre>
+ */
+int superlu_readMM_header(FILE *fp, const char *arith, int_t *m, int_t *n,
+                          int_t *nnz, int *expand, int64_t *data_off)
+{
+    char *p, line[512], banner[64], mtx[64], crd[64], field[64], sym[64];
+    long long lm, ln, lnnz;
+
+    if ( !fgets(line, 512, fp) ) return 3;
+    for (p = line; *p != '\0'; *p = tolower(*p), p++);
+    if ( sscanf(line, "%63s %63s %63s %63s %63s",
+		banner, mtx, crd, field, sym) != 5 )
+	return 3;
+    if ( strcmp(banner, "%%matrixmarket") || strcmp(mtx, "matrix")
+	 || strcmp(crd, "coordinate") )
+	return 3;
+    if ( strcmp(field, arith) ) return 4;
+    *expand = strcmp(sym, "general") != 0;
+
+    /* Skip comments and blank lines. */
+    do {
+	if ( !fgets(line, 512, fp) ) return 3;
+    } while ( line[0] == '%' || sscanf(line, "%63s", banner) != 1 );
+
+    if ( sscanf(line, "%lld%lld%lld", &lm, &ln, &lnnz) != 3
+	 || lm != ln || lm <= 0 || lnnz < 0 )
+	return 3;
+    *m = lm;
+    *n = ln;
+    *nnz = lnnz;
+    *data_off = ftell(fp);
+    return 0;
+}
+
+/* Return the offset of the first line starting at or after pos. */
+static int64_t readMM_line_start(FILE *fp, int64_t pos, int64_t data_off,
+                                 int64_t fsize)
+{
+    int c;
+
+    if ( pos <= data_off ) return data_off;
+    if ( pos >= fsize ) return fsize;
+    fseek(fp, (long) (pos - 1), SEEK_SET);
+    while ( (c = getc(fp)) != EOF && c != '\n' ) ;
+    return c == EOF ? fsize : (int64_t) ftell(fp);
+}
+
+/*! \brief Read the lines of the data part of fname owned by process iam.
+ *
+ * Returns a '\0'-terminated buffer, to be freed with SUPERLU_FREE, and
+ * its length in *len; returns NULL if the file cannot be read.
+ */
+char *superlu_readMM_chunk(const char *fname, int64_t data_off, int iam,
+                           int nprocs, int64_t *len)
+{
+    FILE *fp;
+    int64_t fsize, per, beg, end;
+    char *buf;
+
+    if ( !(fp = fopen(fname, "rb")) ) return NULL;
+    fseek(fp, 0, SEEK_END);
+    fsize = ftell(fp);
+    per = (fsize - data_off) / nprocs;
+    beg = readMM_line_start(fp, data_off + iam * per, data_off, fsize);
+    end = (iam == nprocs - 1) ? fsize
+	  : readMM_line_start(fp, data_off + (iam + 1) * per, data_off, fsize);
+    *len = SUPERLU_MAX(end - beg, 0);
+
+    if ( !(buf = (char *) SUPERLU_MALLOC(*len + 1)) )
+	ABORT("Malloc fails for buf[].");
+    if ( *len > 0 && (fseek(fp, (long) beg, SEEK_SET)
+		      || fread(buf, 1, *len, fp) != (size_t) *len) ) {
+	SUPERLU_FREE(buf);
+	fclose(fp);
+	return NULL;
+    }
+    buf[*len] = '\0';
+    fclose(fp);
+    return buf;
+}
+
+/*! \brief Parse a decimal integer at *p, skipping blanks before it.
+ *  Advances *p past the number. Returns 0 on success, 1 if there is
+ *  no number at *p.
+ */
+int superlu_readMM_int(char **p, int_t *v)
+{
+    char *s = *p;
+    int_t x = 0;
+    int neg = 0;
+
+    while ( *s == ' ' || *s == '\t' ) ++s;
+    if ( *s == '-' || *s == '+' ) neg = (*s++ == '-');
+    if ( *s < '0' || *s > '9' ) return 1;
+    while ( *s >= '0' && *s <= '9' ) x = 10 * x + (*s++ - '0');
+    *v = neg ? -x : x;
+    *p = s;
+    return 0;
+}
@@ -0,0 +1,237 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file superlu_shm.c
+ * \brief Shared-memory channel for the messages of the triangular solve
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * The processes of a communicator that share a node allocate one MPI-3
+ * shared window. Each process owns a ring of message slots in it; a
+ * sender on the same node reserves a slot of the ring of the receiver
+ * with an atomic compare-and-swap on its tail, copies the message, and
+ * publishes it by setting the sequence number of the slot. The receiver
+ * polls its ring and MPI alternately, so messages between nodes still
+ * go through MPI. When the ring of the receiver is full, or the message
+ * does not fit in a slot, the sender falls back to MPI as well, so a
+ * send never waits for the receiver.
+ * </pre>
+ */
+
+#include <string.h>
+#include "superlu_defs.h"
+
+#if !defined(__STDC_NO_ATOMICS__) && defined(__STDC_VERSION__) \
+    && __STDC_VERSION__ >= 201112L
+#define SUPERLU_HAVE_ATOMICS
+#include <stdatomic.h>
+
+#define SHM_LINE 64   /* keep head, tail and slots on separate cache lines */
+
+typedef struct {
+    atomic_llong head;          /* next slot to be read, by the owner   */
+    char pad0[SHM_LINE - sizeof(atomic_llong)];
+    atomic_llong tail;          /* next slot to be reserved, by senders */
+    char pad1[SHM_LINE - sizeof(atomic_llong)];
+} shm_ring_t;
+
+typedef struct {
+    atomic_llong seq;           /* = slot number + 1 when it is full    */
+    int tag, src;
+    long long bytes;
+} shm_slot_t;
+
+#define SHM_SLOT_HDR  ((sizeof(shm_slot_t) + 15) / 16 * 16)
+
+static shm_slot_t *shm_slot(superlu_shm_t *shm, int q, long long t)
+{
+    return (shm_slot_t *) (shm->ring[q] + sizeof(shm_ring_t)
+			   + (t % shm->nslots) * shm->stride);
+}
+#endif
+
+/*! \brief Create the channel over comm, with nslots slots of slotsize
+ *  bytes for each process.
+ *
+ * <pre>
+ * Must be called by all processes in comm. Returns NULL on all the
+ * processes of a node that has only one process of comm, or if the
+ * compiler has no C11 atomics.
+ * </pre>
+ */
+superlu_shm_t *superlu_shm_create(MPI_Comm comm, int nslots, size_t slotsize)
+{
+#ifdef SUPERLU_HAVE_ATOMICS
+    superlu_shm_t *shm;
+    MPI_Comm shmcomm;
+    MPI_Group group, shmgroup;
+    MPI_Info info;
+    MPI_Aint size;
+    int nprocs, nlocal, p, q, disp, *ranks;
+    char *base;
+    shm_ring_t *ring;
+
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &shmcomm);
+    MPI_Comm_size(shmcomm, &nlocal);
+    if ( nlocal == 1 ) {
+	MPI_Comm_free(&shmcomm);
+	return NULL;
+    }
+
+    if ( !(shm = (superlu_shm_t *) SUPERLU_MALLOC(sizeof(superlu_shm_t))) )
+	ABORT("Malloc fails for shm.");
+    MPI_Comm_size(comm, &nprocs);
+    MPI_Comm_rank(comm, &shm->iam);
+    MPI_Comm_rank(shmcomm, &shm->myshm);
+    shm->comm = comm;
+    shm->shmcomm = shmcomm;
+    shm->nslots = nslots;
+    shm->slotsize = slotsize;
+    shm->stride = (SHM_SLOT_HDR + slotsize + SHM_LINE - 1) / SHM_LINE * SHM_LINE;
+
+    /* local[p] is the rank in shmcomm of process p of comm, or -1. */
+    if ( !(shm->local = SUPERLU_MALLOC(nprocs * sizeof(int))) )
+	ABORT("Malloc fails for shm->local[].");
+    if ( !(ranks = SUPERLU_MALLOC(nprocs * sizeof(int))) )
+	ABORT("Malloc fails for ranks[].");
+    for (p = 0; p < nprocs; ++p) ranks[p] = p;
+    MPI_Comm_group(comm, &group);
+    MPI_Comm_group(shmcomm, &shmgroup);
+    MPI_Group_translate_ranks(group, nprocs, ranks, shmgroup, shm->local);
+    for (p = 0; p < nprocs; ++p)
+	if ( shm->local[p] == MPI_UNDEFINED ) shm->local[p] = -1;
+    MPI_Group_free(&group);
+    MPI_Group_free(&shmgroup);
+    SUPERLU_FREE(ranks);
+
+    /* Each ring is allocated close to its owner. */
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "alloc_shared_noncontig", "true");
+    size = sizeof(shm_ring_t) + (MPI_Aint) nslots * shm->stride;
+    MPI_Win_allocate_shared(size, 1, info, shmcomm, &base, &shm->win);
+    MPI_Info_free(&info);
+    ring = (shm_ring_t *) base;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    if ( !(shm->ring = SUPERLU_MALLOC(nlocal * sizeof(char *))) )
+	ABORT("Malloc fails for shm->ring[].");
+    for (q = 0; q < nlocal; ++q)
+	MPI_Win_shared_query(shm->win, q, &size, &disp, &shm->ring[q]);
+    for (p = 0; p < nslots; ++p)
+	atomic_init(&shm_slot(shm, shm->myshm, p)->seq, 0);
+
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, shm->win);
+    MPI_Win_sync(shm->win);
+    MPI_Barrier(shmcomm);
+    return shm;
+#else
+    return NULL;
+#endif
+}
+
+/*! \brief Free the channel. Must be called by all processes in comm. */
+void superlu_shm_free(superlu_shm_t *shm)
+{
+    if ( !shm ) return;
+    MPI_Barrier(shm->shmcomm);
+    MPI_Win_unlock_all(shm->win);
+    MPI_Win_free(&shm->win);
+    MPI_Comm_free(&shm->shmcomm);
+    SUPERLU_FREE(shm->local);
+    SUPERLU_FREE(shm->ring);
+    SUPERLU_FREE(shm);
+}
+
+/*! \brief Send count items of buf to process dest of shm->comm through
+ *  shared memory.
+ *
+ * Returns 1 if the message was delivered, 0 if dest is on another node,
+ * the ring of dest is full or the message does not fit in a slot; the
+ * message must then be sent with MPI.
+ */
+int superlu_shm_send(superlu_shm_t *shm, int dest, int tag, void *buf,
+		     int count, MPI_Datatype type)
+{
+#ifdef SUPERLU_HAVE_ATOMICS
+    shm_ring_t *ring;
+    shm_slot_t *slot;
+    long long t;
+    size_t bytes;
+    int q, tsize;
+
+    if ( !shm || (q = shm->local[dest]) < 0 ) return 0;
+    MPI_Type_size(type, &tsize);
+    bytes = (size_t) count * tsize;
+    if ( bytes > shm->slotsize ) return 0;
+
+    ring = (shm_ring_t *) shm->ring[q];
+    t = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    do {
+	if ( t - atomic_load_explicit(&ring->head, memory_order_acquire)
+	     >= shm->nslots )
+	    return 0;
+    } while ( !atomic_compare_exchange_weak_explicit(&ring->tail, &t, t + 1,
+			 memory_order_acq_rel, memory_order_relaxed) );
+
+    slot = shm_slot(shm, q, t);
+    slot->tag = tag;
+    slot->src = shm->iam;
+    slot->bytes = bytes;
+    memcpy((char *) slot + SHM_SLOT_HDR, buf, bytes);
+    atomic_store_explicit(&slot->seq, t + 1, memory_order_release);
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/*! \brief Receive a message from any process, through shared memory or MPI.
+ *
+ * <pre>
+ * Same as MPI_Recv(buf, count, type, MPI_ANY_SOURCE, MPI_ANY_TAG, comm,
+ * status), where the messages from the same node may also come through
+ * shm. Only the MPI_SOURCE and MPI_TAG fields of status are set for
+ * them. If shm is NULL, this is MPI_Recv.
+ * </pre>
+ */
+void superlu_shm_recv(superlu_shm_t *shm, void *buf, int count,
+		      MPI_Datatype type, MPI_Comm comm, MPI_Status *status)
+{
+#ifdef SUPERLU_HAVE_ATOMICS
+    shm_ring_t *ring;
+    shm_slot_t *slot;
+    MPI_Status st;
+    long long h;
+    int flag;
+
+    if ( shm ) {
+	ring = (shm_ring_t *) shm->ring[shm->myshm];
+	for (;;) {
+	    h = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	    slot = shm_slot(shm, shm->myshm, h);
+	    if ( atomic_load_explicit(&slot->seq, memory_order_acquire) == h + 1 ) {
+		memcpy(buf, (char *) slot + SHM_SLOT_HDR, slot->bytes);
+		status->MPI_SOURCE = slot->src;
+		status->MPI_TAG = slot->tag;
+		atomic_store_explicit(&ring->head, h + 1, memory_order_release);
+		return;
+	    }
+	    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &flag, &st);
+	    if ( flag ) {
+		MPI_Recv(buf, count, type, st.MPI_SOURCE, st.MPI_TAG, comm, status);
+		return;
+	    }
+	}
+    }
+#endif
+    MPI_Recv(buf, count, type, MPI_ANY_SOURCE, MPI_ANY_TAG, comm, status);
+}
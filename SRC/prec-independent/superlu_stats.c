@@ -0,0 +1,151 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file superlu_stats.c
+ * \brief Statistics of a solve gathered over the processes
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * PStatPrint() prints the statistics of process 0. The routines in this
+ * file return them, for all processes, in a superlu_dist_stats_t that a
+ * program can inspect, or write as a JSON object.
+ * </pre>
+ */
+
+#include <stdio.h>
+#include "superlu_defs.h"
+
+static const char *phase_name[NPHASES] = {
+    "COLPERM", "ROWPERM", "RELAX", "ETREE", "EQUIL", "SYMBFAC", "DIST",
+    "FACT", "COMM", "COMM_DIAG", "COMM_RIGHT", "COMM_DOWN", "SOL_COMM",
+    "SOL_GEMM", "SOL_TRSM", "SOL_TOT", "RCOND", "SOLVE", "REFINE", "TRSV",
+    "GEMV", "FERR"
+};
+
+/*! \brief Name of phase i of PhaseType. */
+const char *superlu_phase_name(int i)
+{
+    return ( i >= 0 && i < NPHASES ) ? phase_name[i] : "";
+}
+
+#define NSTATS (2 * NPHASES + 4)
+
+static void set_range(superlu_dist_range_t *r, double *vmin, double *vmax,
+		      double *vsum, int i, int nprocs)
+{
+    r->min = vmin[i];
+    r->max = vmax[i];
+    r->sum = vsum[i];
+    r->avg = vsum[i] / nprocs;
+}
+
+/*! \brief Gather the statistics of all processes in grid.
+ *
+ * <pre>
+ * Must be called by all processes in grid; every process gets the same
+ * result. Glu_persist may be NULL, then the supernode statistics are 0.
+ * Flop counts are summed in double precision.
+ * </pre>
+ */
+void superlu_stats_query(SuperLUStat_t *stat, Glu_persist_t *Glu_persist,
+			 int_t n, gridinfo_t *grid, superlu_dist_stats_t *st)
+{
+    double v[NSTATS], vmin[NSTATS], vmax[NSTATS], vsum[NSTATS];
+    int i, nprocs = grid->nprow * grid->npcol, tiny;
+    int_t k, size, nsupers;
+
+    for (i = 0; i < NPHASES; ++i) {
+	v[i] = stat->utime[i];
+	v[NPHASES + i] = stat->ops[i];
+    }
+    v[2 * NPHASES] = stat->fact_comm_bytes;
+    v[2 * NPHASES + 1] = stat->solve_comm_bytes;
+    v[2 * NPHASES + 2] = stat->peak_buffer;
+    v[2 * NPHASES + 3] = stat->forest_imbalance;
+    MPI_Allreduce(v, vmin, NSTATS, MPI_DOUBLE, MPI_MIN, grid->comm);
+    MPI_Allreduce(v, vmax, NSTATS, MPI_DOUBLE, MPI_MAX, grid->comm);
+    MPI_Allreduce(v, vsum, NSTATS, MPI_DOUBLE, MPI_SUM, grid->comm);
+    MPI_Allreduce(&stat->TinyPivots, &tiny, 1, MPI_INT, MPI_SUM, grid->comm);
+
+    st->nprocs = nprocs;
+    st->nprow = grid->nprow;
+    st->npcol = grid->npcol;
+    for (i = 0; i < NPHASES; ++i) {
+	set_range(&st->utime[i], vmin, vmax, vsum, i, nprocs);
+	set_range(&st->ops[i], vmin, vmax, vsum, NPHASES + i, nprocs);
+    }
+    set_range(&st->fact_comm_bytes, vmin, vmax, vsum, 2 * NPHASES, nprocs);
+    set_range(&st->solve_comm_bytes, vmin, vmax, vsum, 2 * NPHASES + 1, nprocs);
+    set_range(&st->peak_buffer, vmin, vmax, vsum, 2 * NPHASES + 2, nprocs);
+    st->forest_imbalance = vmax[2 * NPHASES + 3];
+    st->TinyPivots = tiny;
+    st->RefineSteps = stat->RefineSteps; /* the same on all processes */
+
+    st->nsupers = st->max_supersize = st->singletons = 0;
+    st->avg_supersize = 0.0;
+    if ( Glu_persist && Glu_persist->supno && n > 0 ) {
+	nsupers = Glu_persist->supno[n - 1] + 1;
+	for (k = 0; k < nsupers; ++k) {
+	    size = Glu_persist->xsup[k + 1] - Glu_persist->xsup[k];
+	    st->max_supersize = SUPERLU_MAX(st->max_supersize, size);
+	    if ( size == 1 ) ++st->singletons;
+	}
+	st->nsupers = nsupers;
+	st->avg_supersize = (double) n / nsupers;
+    }
+}
+
+static void json_range(FILE *fp, const char *name, superlu_dist_range_t *r)
+{
+    fprintf(fp, "\"%s\":{\"min\":%.6e,\"max\":%.6e,\"avg\":%.6e,\"sum\":%.6e}",
+	    name, r->min, r->max, r->avg, r->sum);
+}
+
+/*! \brief Write the statistics as a JSON object to fp.
+ *
+ * Times are in seconds and volumes in bytes. Only the phases with a
+ * nonzero time or flop count are written.
+ */
+void superlu_stats_json(superlu_dist_stats_t *st, FILE *fp)
+{
+    int i, first;
+
+    fprintf(fp, "{\n  \"grid\":{\"nprocs\":%d,\"nprow\":%d,\"npcol\":%d},\n",
+	    st->nprocs, st->nprow, st->npcol);
+    fprintf(fp, "  \"time\":{");
+    for (i = 0, first = 1; i < NPHASES; ++i) {
+	if ( st->utime[i].max == 0.0 ) continue;
+	fprintf(fp, first ? "\n    " : ",\n    ");
+	json_range(fp, phase_name[i], &st->utime[i]);
+	first = 0;
+    }
+    fprintf(fp, "},\n  \"flops\":{");
+    for (i = 0, first = 1; i < NPHASES; ++i) {
+	if ( st->ops[i].max == 0.0 ) continue;
+	fprintf(fp, first ? "\n    " : ",\n    ");
+	json_range(fp, phase_name[i], &st->ops[i]);
+	first = 0;
+    }
+    fprintf(fp, "},\n  \"comm_bytes\":{\n    ");
+    json_range(fp, "FACT", &st->fact_comm_bytes);
+    fprintf(fp, ",\n    ");
+    json_range(fp, "SOLVE", &st->solve_comm_bytes);
+    fprintf(fp, "},\n  ");
+    json_range(fp, "peak_buffer_bytes", &st->peak_buffer);
+    fprintf(fp, ",\n  \"forest_imbalance\":%.3f,\n  \"TinyPivots\":%d,"
+	    "\n  \"RefineSteps\":%d,\n", st->forest_imbalance,
+	    st->TinyPivots, st->RefineSteps);
+    fprintf(fp, "  \"supernodes\":{\"count\":%lld,\"max_size\":%lld,"
+	    "\"avg_size\":%.3f,\"singletons\":%lld}\n}\n",
+	    (long long) st->nsupers, (long long) st->max_supersize,
+	    st->avg_supersize, (long long) st->singletons);
+}
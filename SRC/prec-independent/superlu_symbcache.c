@@ -0,0 +1,331 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file superlu_symbcache.c
+ * \brief Cache of the serial symbolic analysis, keyed by the pattern of Pr*A
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * With options->SymbCache = YES, PxGSSVX looks up the column ordering,
+ * the elimination tree, the supernode partition and the structure of
+ * L and U computed for an earlier matrix with the same pattern, instead
+ * of computing them again with get_perm_c_dist(), sp_colorder() and
+ * symbfact(). The key is a hash of the pattern of Pr*A and of the
+ * options that the analysis depends on. Each process hashes its own rows
+ * of A; the hash of a nonzero does not depend on where it is stored, so
+ * the key does not depend on the distribution of A. An entry is only
+ * used if a second, independent hash of the pattern, the order and the
+ * number of nonzeros of A match as well.
+ *
+ * The entries are kept in memory, the most recently used first. If the
+ * environment variable SUPERLU_SYMBCACHE_DIR is set, they are also
+ * written by process 0 to "<dir>/symb_<key>.bin", and read from there by
+ * all processes when they are not in memory, so that other runs find
+ * them as well.
+ * </pre>
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "superlu_defs.h"
+
+#define SYMBCACHE_MAGIC "SLUSYMB2"
+
+typedef struct {
+    char     magic[8];
+    int32_t  int_t_size;
+    int32_t  pad;
+    uint64_t key, check;
+    int64_t  n, nnz, nzl, nzu, nnzLU;
+} symbcache_header_t;
+
+typedef struct symbcache_entry {
+    symbcache_header_t hdr;
+    /* perm_c[n], etree[n], xsup[n+1], supno[n+1], xlsub[n+1], xusub[n+1],
+       lsub[nzl], usub[nzu] */
+    int_t *data;
+    struct symbcache_entry *next;
+} symbcache_entry_t;
+
+static symbcache_entry_t *symbcache_head = NULL;
+
+static uint64_t symbcache_mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/* Whether the entry with header hdr was computed for the matrix of key. */
+static int symbcache_match(symbcache_header_t *hdr, superlu_symbkey_t *key)
+{
+    return hdr->key == key->key && hdr->check == key->check
+	&& hdr->n == key->n && hdr->nnz == key->nnz;
+}
+
+static size_t symbcache_size(symbcache_header_t *hdr)
+{
+    return (size_t) (6 * hdr->n + 4 + hdr->nzl + hdr->nzu);
+}
+
+static void symbcache_free_entry(symbcache_entry_t *e)
+{
+    SUPERLU_FREE(e->data);
+    SUPERLU_FREE(e);
+}
+
+static void symbcache_fname(char *fname, size_t len, const char *dir,
+			    uint64_t key)
+{
+    snprintf(fname, len, "%s/symb_%016llx.bin", dir, (unsigned long long) key);
+}
+
+/* Put e at the head of the list, and drop the oldest entries. */
+static void symbcache_insert(symbcache_entry_t *e)
+{
+    symbcache_entry_t *p;
+    int k;
+
+    e->next = symbcache_head;
+    symbcache_head = e;
+    for (p = e, k = 1; p->next; ) {
+	if ( p->next->hdr.key == e->hdr.key || k >= SUPERLU_SYMBCACHE_ENTRIES ) {
+	    symbcache_entry_t *q = p->next;
+	    p->next = q->next;
+	    symbcache_free_entry(q);
+	} else {
+	    p = p->next;
+	    ++k;
+	}
+    }
+}
+
+static symbcache_entry_t *symbcache_read(const char *dir,
+					 superlu_symbkey_t *key)
+{
+    symbcache_entry_t *e;
+    char fname[1024];
+    FILE *fp;
+    size_t len;
+
+    symbcache_fname(fname, sizeof(fname), dir, key->key);
+    if ( !(fp = fopen(fname, "rb")) ) return NULL;
+    if ( !(e = (symbcache_entry_t *) SUPERLU_MALLOC(sizeof(symbcache_entry_t))) )
+	ABORT("Malloc fails for symbcache entry.");
+    e->data = NULL;
+    if ( fread(&e->hdr, sizeof(symbcache_header_t), 1, fp) != 1
+	 || memcmp(e->hdr.magic, SYMBCACHE_MAGIC, 8)
+	 || e->hdr.int_t_size != (int32_t) sizeof(int_t)
+	 || !symbcache_match(&e->hdr, key) ) {
+	fclose(fp);
+	SUPERLU_FREE(e);
+	return NULL;
+    }
+    len = symbcache_size(&e->hdr);
+    if ( !(e->data = intMalloc_dist(len)) )
+	ABORT("Malloc fails for symbcache data.");
+    if ( fread(e->data, sizeof(int_t), len, fp) != len ) {
+	fclose(fp);
+	symbcache_free_entry(e);
+	return NULL;
+    }
+    fclose(fp);
+    return e;
+}
+
+static void symbcache_write(const char *dir, symbcache_entry_t *e)
+{
+    char fname[1024], tmpname[1040];
+    FILE *fp;
+    size_t len = symbcache_size(&e->hdr);
+    int ok;
+
+    symbcache_fname(fname, sizeof(fname), dir, e->hdr.key);
+    snprintf(tmpname, sizeof(tmpname), "%s.tmp", fname);
+    if ( !(fp = fopen(tmpname, "wb")) ) return;
+    ok = fwrite(&e->hdr, sizeof(symbcache_header_t), 1, fp) == 1
+	&& fwrite(e->data, sizeof(int_t), len, fp) == len;
+    ok = (fclose(fp) == 0) && ok;
+    /* Readers never see a partially written file. */
+    if ( !ok || rename(tmpname, fname) ) remove(tmpname);
+}
+
+/*! \brief Compute the key of the symbolic analysis of Pr*A.
+ *
+ * <pre>
+ * A is distributed in SLU_NR_loc format. perm_r is the row permutation
+ * already chosen; perm_c is only used if options->ColPerm = MY_PERMC.
+ * Must be called by all processes in the grid, which get the same key.
+ * </pre>
+ */
+void superlu_symbcache_key(superlu_dist_options_t *options, SuperMatrix *A,
+			   int_t *perm_r, int_t *perm_c, gridinfo_t *grid,
+			   superlu_symbkey_t *key)
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    uint64_t loc[3], tot[3], k, n = A->ncol, amalg;
+    int_t i, j, irow;
+
+    loc[0] = 0;
+    loc[1] = 0;
+    loc[2] = Astore->nnz_loc;
+    for (i = 0; i < Astore->m_loc; ++i) {
+	irow = perm_r[i + Astore->fst_row];
+	for (j = Astore->rowptr[i]; j < Astore->rowptr[i+1]; ++j) {
+	    loc[0] += symbcache_mix((uint64_t) irow * n + Astore->colind[j]);
+	    /* The check hashes the transposed position with another seed. */
+	    loc[1] += symbcache_mix(((uint64_t) Astore->colind[j] * n + irow)
+				    ^ 0x5851f42d4c957f2dULL);
+	}
+    }
+    MPI_Allreduce(loc, tot, 3, MPI_UINT64_T, MPI_SUM, grid->comm);
+
+    /* symbfact() amalgamates the supernodes it finds with AmalgFill. */
+    memcpy(&amalg, &options->AmalgFill, sizeof(amalg));
+    k = symbcache_mix(tot[0] ^ symbcache_mix(tot[2]));
+    k = symbcache_mix(k ^ ((uint64_t) A->nrow << 32 ^ n));
+    k = symbcache_mix(k ^ (uint64_t) options->ColPerm);
+    k = symbcache_mix(k ^ (uint64_t) sp_ienv_dist(2, options));
+    k = symbcache_mix(k ^ (uint64_t) sp_ienv_dist(3, options));
+    k = symbcache_mix(k ^ amalg);
+    if ( options->ColPerm == MY_PERMC )
+	for (j = 0; j < n; ++j) k = symbcache_mix(k ^ (uint64_t) perm_c[j]);
+    key->key = k;
+    key->check = tot[1];
+    key->n = n;
+    key->nnz = tot[2];
+}
+
+/*! \brief Look up the symbolic analysis with the given key.
+ *
+ * <pre>
+ * On a hit, perm_c[] and etree[] are overwritten, Glu_persist->xsup and
+ * Glu_persist->supno are allocated, and *Glu_freeable is allocated and
+ * filled in as by symbfact(). Returns 1 on a hit and 0 otherwise.
+ * Must be called by all processes in the grid; the result is the same
+ * on all of them.
+ * </pre>
+ */
+int superlu_symbcache_get(superlu_symbkey_t *key, int_t *perm_c,
+			  int_t *etree, Glu_persist_t *Glu_persist,
+			  Glu_freeable_t **Glu_freeable, gridinfo_t *grid)
+{
+    symbcache_entry_t *e, *prev;
+    Glu_freeable_t *Glu;
+    const char *dir = getenv("SUPERLU_SYMBCACHE_DIR");
+    int_t *d, nzl, nzu, n = key->n;
+    int hit, allhit;
+
+    for (prev = NULL, e = symbcache_head; e; prev = e, e = e->next)
+	if ( symbcache_match(&e->hdr, key) ) break;
+    if ( e && prev ) { /* move to the head */
+	prev->next = e->next;
+	e->next = symbcache_head;
+	symbcache_head = e;
+    }
+    if ( !e && dir && (e = symbcache_read(dir, key)) )
+	symbcache_insert(e);
+
+    hit = (e != NULL);
+    MPI_Allreduce(&hit, &allhit, 1, MPI_INT, MPI_MIN, grid->comm);
+    if ( !allhit ) return 0;
+
+    nzl = e->hdr.nzl;
+    nzu = e->hdr.nzu;
+    d = e->data;
+    memcpy(perm_c, d, n * sizeof(int_t));             d += n;
+    memcpy(etree, d, n * sizeof(int_t));              d += n;
+    if ( !(Glu_persist->xsup = intMalloc_dist(n+1)) )
+	ABORT("Malloc fails for xsup[].");
+    if ( !(Glu_persist->supno = intMalloc_dist(n+1)) )
+	ABORT("Malloc fails for supno[].");
+    memcpy(Glu_persist->xsup, d, (n+1) * sizeof(int_t));  d += n+1;
+    memcpy(Glu_persist->supno, d, (n+1) * sizeof(int_t)); d += n+1;
+
+    if ( !(Glu = (Glu_freeable_t *) SUPERLU_MALLOC(sizeof(Glu_freeable_t))) )
+	ABORT("Malloc fails for Glu_freeable.");
+    if ( !(Glu->xlsub = intMalloc_dist(n+1)) )
+	ABORT("Malloc fails for xlsub[].");
+    if ( !(Glu->xusub = intMalloc_dist(n+1)) )
+	ABORT("Malloc fails for xusub[].");
+    if ( !(Glu->lsub = intMalloc_dist(SUPERLU_MAX(nzl, 1))) )
+	ABORT("Malloc fails for lsub[].");
+    if ( !(Glu->usub = intMalloc_dist(SUPERLU_MAX(nzu, 1))) )
+	ABORT("Malloc fails for usub[].");
+    memcpy(Glu->xlsub, d, (n+1) * sizeof(int_t)); d += n+1;
+    memcpy(Glu->xusub, d, (n+1) * sizeof(int_t)); d += n+1;
+    memcpy(Glu->lsub, d, nzl * sizeof(int_t));    d += nzl;
+    memcpy(Glu->usub, d, nzu * sizeof(int_t));
+    Glu->nzlmax = nzl;
+    Glu->nzumax = nzu;
+    Glu->MemModel = SYSTEM;
+    Glu->nnzLU = e->hdr.nnzLU;
+    *Glu_freeable = Glu;
+    return 1;
+}
+
+/*! \brief Store the symbolic analysis computed for the given key.
+ *
+ * <pre>
+ * perm_c and etree are those returned by sp_colorder(), Glu_persist and
+ * Glu_freeable those returned by symbfact(). They are copied.
+ * </pre>
+ */
+void superlu_symbcache_put(superlu_symbkey_t *key, int_t *perm_c,
+			   int_t *etree, Glu_persist_t *Glu_persist,
+			   Glu_freeable_t *Glu_freeable, gridinfo_t *grid)
+{
+    symbcache_entry_t *e;
+    const char *dir = getenv("SUPERLU_SYMBCACHE_DIR");
+    int_t n = key->n;
+    int_t *d, nzl = Glu_freeable->xlsub[n], nzu = Glu_freeable->xusub[n];
+
+    if ( !(e = (symbcache_entry_t *) SUPERLU_MALLOC(sizeof(symbcache_entry_t))) )
+	ABORT("Malloc fails for symbcache entry.");
+    memset(&e->hdr, 0, sizeof(symbcache_header_t));
+    memcpy(e->hdr.magic, SYMBCACHE_MAGIC, 8);
+    e->hdr.int_t_size = (int32_t) sizeof(int_t);
+    e->hdr.key = key->key;
+    e->hdr.check = key->check;
+    e->hdr.n = n;
+    e->hdr.nnz = key->nnz;
+    e->hdr.nzl = nzl;
+    e->hdr.nzu = nzu;
+    e->hdr.nnzLU = Glu_freeable->nnzLU;
+    if ( !(e->data = intMalloc_dist(symbcache_size(&e->hdr))) )
+	ABORT("Malloc fails for symbcache data.");
+
+    d = e->data;
+    memcpy(d, perm_c, n * sizeof(int_t));                     d += n;
+    memcpy(d, etree, n * sizeof(int_t));                      d += n;
+    memcpy(d, Glu_persist->xsup, (n+1) * sizeof(int_t));      d += n+1;
+    memcpy(d, Glu_persist->supno, (n+1) * sizeof(int_t));     d += n+1;
+    memcpy(d, Glu_freeable->xlsub, (n+1) * sizeof(int_t));    d += n+1;
+    memcpy(d, Glu_freeable->xusub, (n+1) * sizeof(int_t));    d += n+1;
+    memcpy(d, Glu_freeable->lsub, nzl * sizeof(int_t));       d += nzl;
+    memcpy(d, Glu_freeable->usub, nzu * sizeof(int_t));
+
+    if ( dir && grid->iam == 0 ) symbcache_write(dir, e);
+    symbcache_insert(e);
+}
+
+/*! \brief Free all the entries kept in memory. The files are kept. */
+void superlu_symbcache_clear(void)
+{
+    symbcache_entry_t *e;
+
+    while ( (e = symbcache_head) ) {
+	symbcache_head = e->next;
+	symbcache_free_entry(e);
+    }
+}
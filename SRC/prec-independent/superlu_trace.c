@@ -0,0 +1,174 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file superlu_trace.c
+ * \brief Per-process trace of the factorization and the solve
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * Each OpenMP thread records its events into its own ring buffer, so no
+ * lock is taken when an event is recorded; when a ring is full, the
+ * oldest events are overwritten. At the end of the traced call each
+ * process writes its events in the Chrome trace-event format, which can
+ * be loaded in chrome://tracing or https://ui.perfetto.dev, to the file
+ * <prefix>.<rank>.json. The prefix is the value of the environment
+ * variable SUPERLU_TRACE_PREFIX, or "superlu_trace".
+ * </pre>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "superlu_defs.h"
+
+typedef struct {
+    double ts, dur;     /* start and duration, in seconds              */
+    int64_t arg;        /* supernode number, or -1                     */
+    int ev;             /* trace_event_t                               */
+} trace_rec_t;
+
+typedef struct {
+    trace_rec_t *rec;   /* ring of SUPERLU_TRACE_EVENTS events         */
+    int64_t cnt;        /* number of events recorded                   */
+    char pad[64 - sizeof(trace_rec_t *) - sizeof(int64_t)];
+} trace_ring_t;
+
+int superlu_trace_on = 0;
+
+static trace_ring_t *trace_ring = NULL;
+static int trace_nthreads = 0;
+static double trace_t0;
+
+static const char *trace_name[TR_NEVENTS] = {
+    "distribute", "factor", "panel L(:,k)", "panel U(k,:)",
+    "look-ahead update", "Schur update", "wait send", "wait L(:,k)",
+    "wait U(k,:)", "solve", "L-solve", "U-solve", "solve X(k)",
+    "lsum update", "recv"
+};
+
+static const char *trace_cat[TR_NEVENTS] = {
+    "phase", "phase", "fact", "fact", "fact", "fact", "comm", "comm",
+    "comm", "phase", "solve", "solve", "solve", "solve", "comm"
+};
+
+static void trace_free(void)
+{
+    int t;
+
+    if ( !trace_ring ) return;
+    for (t = 0; t < trace_nthreads; ++t) SUPERLU_FREE(trace_ring[t].rec);
+    SUPERLU_FREE(trace_ring);
+    trace_ring = NULL;
+    trace_nthreads = 0;
+}
+
+/*! \brief Start recording the events of all the threads.
+ *
+ * Must be called by all processes in grid. The time stamps are relative
+ * to the barrier in this routine, so that the traces of the processes
+ * can be put on a common time line.
+ */
+void superlu_trace_start(gridinfo_t *grid)
+{
+    int i, nthreads = 1;
+
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    superlu_trace_on = 0;
+    trace_free();
+    if ( !(trace_ring = (trace_ring_t *)
+	   SUPERLU_MALLOC(nthreads * sizeof(trace_ring_t))) )
+	ABORT("Malloc fails for trace_ring[].");
+    for (i = 0; i < nthreads; ++i) {
+	if ( !(trace_ring[i].rec = (trace_rec_t *)
+	       SUPERLU_MALLOC(SUPERLU_TRACE_EVENTS * sizeof(trace_rec_t))) )
+	    ABORT("Malloc fails for trace_ring[].rec[].");
+	trace_ring[i].cnt = 0;
+    }
+    trace_nthreads = nthreads;
+
+    MPI_Barrier(grid->comm);
+    trace_t0 = SuperLU_timer_();
+    superlu_trace_on = 1;
+}
+
+/*! \brief Record event ev of the calling thread, from t0 until now. */
+void superlu_trace_event(int ev, double t0, int64_t arg)
+{
+    double t1 = SuperLU_timer_();
+    trace_ring_t *ring;
+    trace_rec_t *r;
+    int tid = 0;
+
+#ifdef _OPENMP
+    tid = omp_get_thread_num();
+#endif
+    if ( tid >= trace_nthreads ) return;
+    ring = &trace_ring[tid];
+    r = &ring->rec[ring->cnt % SUPERLU_TRACE_EVENTS];
+    r->ts = t0 - trace_t0;
+    r->dur = t1 - t0;
+    r->arg = arg;
+    r->ev = ev;
+    ++ring->cnt;
+}
+
+/*! \brief Stop recording, write the events of this process to
+ *  <prefix>.<rank>.json and free the rings.
+ */
+void superlu_trace_dump(gridinfo_t *grid)
+{
+    char *prefix, fname[256];
+    trace_ring_t *ring;
+    trace_rec_t *r;
+    int64_t i, first;
+    int t, wrapped = 0;
+    FILE *fp;
+
+    if ( !trace_ring ) return;
+    superlu_trace_on = 0;
+
+    if ( !(prefix = getenv("SUPERLU_TRACE_PREFIX")) ) prefix = "superlu_trace";
+    snprintf(fname, sizeof(fname), "%s.%d.json", prefix, grid->iam);
+    if ( !(fp = fopen(fname, "w")) ) {
+	fprintf(stderr, "superlu_trace_dump: cannot open %s\n", fname);
+    } else {
+	fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+		"\"args\":{\"name\":\"rank %d (%d,%d)\"}}",
+		grid->iam, grid->iam, MYROW(grid->iam, grid),
+		MYCOL(grid->iam, grid));
+	fprintf(fp, ",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,"
+		"\"args\":{\"sort_index\":%d}}", grid->iam, grid->iam);
+	for (t = 0; t < trace_nthreads; ++t) {
+	    ring = &trace_ring[t];
+	    first = SUPERLU_MAX(0, ring->cnt - SUPERLU_TRACE_EVENTS);
+	    for (i = first; i < ring->cnt; ++i) {
+		r = &ring->rec[i % SUPERLU_TRACE_EVENTS];
+		fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+			"\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,"
+			"\"args\":{\"%s\":%lld}}",
+			trace_name[r->ev], trace_cat[r->ev], 1e6 * r->ts,
+			1e6 * r->dur, grid->iam, t,
+			r->ev == TR_RECV ? "source" : "k", (long long) r->arg);
+	    }
+	    if ( first > 0 ) wrapped = 1;
+	}
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+	if ( wrapped )
+	    fprintf(stderr, "superlu_trace_dump: %s holds only the last %d "
+		    "events of each thread\n", fname, SUPERLU_TRACE_EVENTS);
+    }
+
+    trace_free();
+}
@@ -0,0 +1,421 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file superlu_tune.c
+ * \brief Advice on relax, maxsuper, look-ahead and process grid shape,
+ *  from a cost model of the factorization
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * After the symbolic factorization, the supernode sizes and the number
+ * of rows of L(:,k) and columns of U(k,:) give the time of the
+ * factorization on a Pr x Pc (x Pz) grid, as
+ *
+ *   T = cf * sum_k flops(k) / (P * eff(s_k))                 computation
+ *     + cw * sum_k (r_k s_k log2(Pc) / Pr + u_k s_k log2(Pr) / Pc)  volume
+ *     + cl * sum_k (log2(Pr) + log2(Pc) + 1)                 latency
+ *
+ * where s_k is the size of supernode k, eff(s) = s / (s + TUNE_S_HALF) is
+ * the efficiency of a GEMM of inner dimension s, and the communication is
+ * divided by 1 + num_lookaheads, the panels that are sent ahead of the
+ * update. With Pz > 1 layers, the supernodes whose subtree has fewer than
+ * n/Pz columns are spread over the layers, and the others are factored
+ * by a Pr x Pc grid after a reduction of their blocks between the layers.
+ *
+ * A candidate relax merges the subtrees of the supernodal etree with at
+ * most relax columns into one supernode; a candidate maxsuper splits the
+ * supernodes larger than maxsuper, and merges back the chains of
+ * supernodes that were split by the current maxsuper. The supernodes of
+ * the current partition are otherwise kept, so a relax smaller than the
+ * current one is not seen by the model.
+ *
+ * superlu_tune_update() compares the measured factorization time and
+ * communication time with the prediction for the current settings, and
+ * rescales cf and (cw, cl); the next advice uses the new scales.
+ *
+ * The scales, the last advice and the relax and maxsuper waiting for the
+ * next analysis are kept in a superlu_tune_state_t owned by the caller,
+ * the tune field of the LUstruct in p[dsz]gssvx(). They describe one
+ * matrix: superlu_tune_check() drops them when the order or the number
+ * of nonzeros of A changes, and superlu_tune_reset() at any time.
+ * </pre>
+ */
+
+#include <math.h>
+#include "superlu_defs.h"
+
+#define TUNE_S_HALF   16.0    /* inner dimension at half the GEMM speed  */
+#define TUNE_CF       5.0e-10 /* seconds per flop at full speed          */
+#define TUNE_CW       2.0e-9  /* seconds per word sent                   */
+#define TUNE_CL       2.0e-6  /* seconds per message                     */
+#define TUNE_CLA      1.0e-7  /* seconds per supernode and look-ahead    */
+#define TUNE_SMOOTH   0.5     /* weight of the last measure in the scales */
+
+static const int tune_relax[] = {20, 40, 60, 100, 150, 250};
+static const int tune_maxsup[] = {64, 128, 256, 512};
+static const int tune_lookahead[] = {0, 2, 5, 10, 20};
+
+/* A supernode of a candidate partition: size s, rows r below the
+   diagonal block in L, columns u right of it in U. */
+typedef struct {
+    double s, r, u;
+} tune_snode_t;
+
+static double lg2(int p)
+{
+    return p > 1 ? log2((double) p) : 0.0;
+}
+
+/* Computation and communication time of the supernodes sn[lo..hi) on a
+   pr x pc grid. */
+static void tune_time2d(tune_snode_t *sn, int_t lo, int_t hi, int pr, int pc,
+			int nla, double *tf, double *tc)
+{
+    double P = (double) pr * pc, f, w = 0.0, m = 0.0;
+    int_t k;
+
+    *tf = 0.0;
+    for (k = lo; k < hi; ++k) {
+	double s = sn[k].s, r = sn[k].r, u = sn[k].u;
+	f = 2.0 * s * r * u + s * s * (r + u) + 2.0 / 3.0 * s * s * s;
+	*tf += TUNE_CF * f / (P * s / (s + TUNE_S_HALF));
+	w += r * s * lg2(pc) / pr + u * s * lg2(pr) / pc;
+	m += lg2(pr) + lg2(pc) + 1.0;
+    }
+    *tf += TUNE_CLA * nla * (hi - lo);
+    *tc = (TUNE_CW * w + TUNE_CL * m) / (1.0 + nla);
+}
+
+/* Time of the candidate partition sn[0..ns) on a pr x pc x pz grid.
+   top[k] is nonzero for the supernodes above the pz-way split. */
+static double tune_time(superlu_tune_state_t *ts, tune_snode_t *sn,
+			int_t ns, int *top, int pr, int pc, int pz, int nla,
+			double *tf, double *tc)
+{
+    double f1, c1, f2, c2, red = 0.0;
+    int_t k;
+
+    if ( pz == 1 ) {
+	tune_time2d(sn, 0, ns, pr, pc, nla, tf, tc);
+    } else {
+	/* The bottom part: the subtrees below the split are spread over
+	   the layers. Supernodes are in postorder, so the top part is not
+	   contiguous; time the two parts separately. */
+	*tf = *tc = 0.0;
+	for (k = 0; k < ns; ++k) {
+	    tune_time2d(sn, k, k+1, pr, pc, nla, &f1, &c1);
+	    if ( top[k] ) {
+		f2 = f1; c2 = c1;
+		red += sn[k].s * (sn[k].s + sn[k].r + sn[k].u);
+	    } else {
+		f2 = f1 / pz; c2 = c1 / pz;
+	    }
+	    *tf += f2;
+	    *tc += c2;
+	}
+	*tc += (TUNE_CW * red / (pr * pc) + TUNE_CL * ns) * lg2(pz);
+    }
+    *tf *= ts->kf;
+    *tc *= ts->kc;
+    return *tf + *tc;
+}
+
+/* Builds the candidate partition for relax and maxsup from the current
+   one, given by s0[], r0[], u0[], the supernodal etree sparent[] and the
+   column counts cols[] of the subtrees. Returns the number of supernodes
+   in sn[], and sets top[] for the pz-way split. */
+static int_t tune_partition(int_t nsupers, double *s0, double *r0,
+			    double *u0, int_t *sparent, double *cols,
+			    int relax, int maxsup, int curmax, int_t n,
+			    int pz, tune_snode_t *sn, int *top,
+			    tune_snode_t *tmp, int *chain)
+{
+    int_t k, ns = 0, nt = 0;
+    double s, r, u, rem;
+
+    /* relaxed supernodes: subtrees with at most relax columns */
+    for (k = 0; k < nsupers; ++k) {
+	int_t p = sparent[k];
+	if ( cols[k] <= relax && p < nsupers && cols[p] <= relax )
+	    continue;  /* merged into an ancestor */
+	if ( cols[k] <= relax ) {
+	    tmp[nt].s = cols[k];
+	    tmp[nt].r = r0[k];
+	    tmp[nt].u = u0[k];
+	} else {
+	    tmp[nt].s = s0[k];
+	    tmp[nt].r = r0[k];
+	    tmp[nt].u = u0[k];
+	}
+	/* a chain split by the current maxsup: the next supernode is the
+	   parent and has exactly the rows of k below its diagonal block */
+	chain[nt] = ( s0[k] == curmax && p == k+1
+		      && r0[k] == s0[p] + r0[p] );
+	top[nt] = cols[k] > (double) n / pz;
+	++nt;
+    }
+
+    /* merge the chains up to maxsup, and split above maxsup */
+    for (k = 0; k < nt; ) {
+	int_t j = k;
+	s = tmp[k].s;
+	while ( chain[j] && j+1 < nt && s + tmp[j+1].s <= maxsup ) {
+	    ++j;
+	    s += tmp[j].s;
+	}
+	r = tmp[j].r;
+	u = tmp[j].u;
+	for (rem = s; rem > 0; rem -= maxsup) {
+	    double piece = SUPERLU_MIN(rem, maxsup);
+	    sn[ns].s = piece;
+	    sn[ns].r = r + rem - piece;
+	    sn[ns].u = u + rem - piece;
+	    top[ns] = top[j];
+	    ++ns;
+	}
+	k = j + 1;
+    }
+    return ns;
+}
+
+/*! \brief Advice on the parameters of the factorization.
+ *
+ * <pre>
+ * Must be called by all processes in grid after the serial symbolic
+ * factorization; Glu_persist and Glu_freeable are replicated, so every
+ * process gets the same advice. etree is the column elimination tree.
+ *
+ * The candidates are relax in tune_relax[], maxsuper in tune_maxsup[],
+ * num_lookaheads in tune_lookahead[], all grids Pr x Pc with
+ * Pr * Pc = P, and the 3D grids Pr x Pc x Pz with Pz a power of two,
+ * where P is the number of processes of grid. The current settings
+ * win the ties. The advice is also kept in ts for superlu_tune_last().
+ * </pre>
+ */
+void superlu_tune_advise(superlu_tune_state_t *ts,
+			 superlu_dist_options_t *options, int_t n,
+			 int_t *etree, Glu_persist_t *Glu_persist,
+			 Glu_freeable_t *Glu_freeable, gridinfo_t *grid,
+			 superlu_tune_t *advice)
+{
+    int_t *xsup = Glu_persist->xsup, *supno = Glu_persist->supno;
+    int_t *xlsub = Glu_freeable->xlsub, *xusub = Glu_freeable->xusub;
+    int_t *usub = Glu_freeable->usub;
+    int_t nsupers = supno[n-1] + 1, k, j, i, ns, *sparent;
+    int P = grid->nprow * grid->npcol, curmax = sp_ienv_dist(3, options);
+    int ir, im, il, pz, pr, *top, *chain;
+    double *s0, *r0, *u0, *cols, best, t, tf, tc, tf_cur, tc_cur;
+    tune_snode_t *sn, *tmp;
+
+    if ( !(s0 = SUPERLU_MALLOC(4 * (nsupers + 1) * sizeof(double))) )
+	ABORT("Malloc fails for s0[].");
+    r0 = s0 + nsupers + 1;
+    u0 = r0 + nsupers + 1;
+    cols = u0 + nsupers + 1;
+    if ( !(sparent = intMalloc_dist(nsupers)) )
+	ABORT("Malloc fails for sparent[].");
+    /* a maxsup split produces at most n / 64 + nsupers supernodes */
+    ns = 2 * nsupers + n / tune_maxsup[0] + 1;
+    if ( !(sn = SUPERLU_MALLOC(2 * ns * sizeof(tune_snode_t))) )
+	ABORT("Malloc fails for sn[].");
+    tmp = sn + ns;
+    if ( !(top = int32Malloc_dist(2 * ns)) )
+	ABORT("Malloc fails for top[].");
+    chain = top + ns;
+
+    /* the current partition */
+    for (k = 0; k < nsupers; ++k) {
+	int_t fsupc = xsup[k];
+	s0[k] = xsup[k+1] - fsupc;
+	r0[k] = xlsub[fsupc+1] - xlsub[fsupc] - s0[k];
+	u0[k] = 0.0;
+	j = etree[xsup[k+1] - 1];
+	sparent[k] = ( j >= n ) ? nsupers : supno[j];
+    }
+    for (j = 0; j < n; ++j)  /* usub[] has the leading row of each
+				supernode segment of column j of U */
+	for (i = xusub[j]; i < xusub[j+1]; ++i)
+	    if ( supno[usub[i]] != supno[j] ) u0[supno[usub[i]]] += 1.0;
+    for (k = 0; k < nsupers; ++k) cols[k] = s0[k];
+    for (k = 0; k < nsupers; ++k)  /* postorder: the parent comes later */
+	if ( sparent[k] < nsupers ) cols[sparent[k]] += cols[k];
+
+    /* the current settings */
+    advice->superlu_relax = sp_ienv_dist(2, options);
+    advice->superlu_maxsup = curmax;
+    advice->num_lookaheads = options->num_lookaheads;
+    advice->nprow = grid->nprow;
+    advice->npcol = grid->npcol;
+    advice->npdep = 1;
+    ns = tune_partition(nsupers, s0, r0, u0, sparent, cols,
+			0, curmax, curmax, n, 1, sn, top, tmp, chain);
+    best = tune_time(ts, sn, ns, top, grid->nprow, grid->npcol, 1,
+		     options->num_lookaheads, &tf, &tc);
+    advice->time_cur = best;
+
+    for (pz = 1; pz <= P; pz *= 2) {
+	if ( P % pz ) break;
+	for (ir = 0; ir < sizeof(tune_relax) / sizeof(int); ++ir)
+	for (im = 0; im < sizeof(tune_maxsup) / sizeof(int); ++im) {
+	    if ( tune_maxsup[im] > MAX_SUPER_SIZE ) continue;
+	    ns = tune_partition(nsupers, s0, r0, u0, sparent, cols,
+				tune_relax[ir], tune_maxsup[im], curmax, n,
+				pz, sn, top, tmp, chain);
+	    for (il = 0; il < sizeof(tune_lookahead) / sizeof(int); ++il)
+	    for (pr = 1; pr <= P / pz; ++pr) {
+		if ( (P / pz) % pr ) continue;
+		t = tune_time(ts, sn, ns, top, pr, P / pz / pr, pz,
+			      tune_lookahead[il], &tf, &tc);
+		if ( t < best ) {
+		    best = t;
+		    advice->superlu_relax = tune_relax[ir];
+		    advice->superlu_maxsup = tune_maxsup[im];
+		    advice->num_lookaheads = tune_lookahead[il];
+		    advice->nprow = pr;
+		    advice->npcol = P / pz / pr;
+		    advice->npdep = pz;
+		}
+	    }
+	}
+    }
+    advice->Algo3d = advice->npdep > 1 ? YES : NO;
+    advice->time = best;
+
+    /* The factorization that follows uses the current partition and
+       grid, with the advised look-ahead; its unscaled prediction is
+       the reference of superlu_tune_update(). */
+    ns = tune_partition(nsupers, s0, r0, u0, sparent, cols,
+			0, curmax, curmax, n, 1, sn, top, tmp, chain);
+    tune_time(ts, sn, ns, top, grid->nprow, grid->npcol, 1,
+	      advice->num_lookaheads, &tf_cur, &tc_cur);
+    ts->last_tf = tf_cur / ts->kf;
+    ts->last_tc = tc_cur / ts->kc;
+    ts->last = *advice;
+    ts->have_last = 1;
+
+    SUPERLU_FREE(s0);
+    SUPERLU_FREE(sparent);
+    SUPERLU_FREE(sn);
+    SUPERLU_FREE(top);
+}
+
+/*! \brief Refine the model with the measured factorization.
+ *
+ * <pre>
+ * t_fact and t_comm are the factorization time and the part of it spent
+ * in communication, on this process (stat->utime[FACT] and
+ * stat->utime[COMM]). They are compared, as maxima over grid, with the
+ * prediction of the last superlu_tune_advise() for the current partition
+ * and grid with the advised look-ahead, which superlu_tune_apply() sets
+ * for the factorization. Must be called by all processes in grid.
+ * </pre>
+ */
+void superlu_tune_update(superlu_tune_state_t *ts, double t_fact,
+			 double t_comm, gridinfo_t *grid)
+{
+    double t[2] = {t_fact, t_comm}, kf, kc;
+
+    if ( !ts->have_last ) return;
+    MPI_Allreduce(MPI_IN_PLACE, t, 2, MPI_DOUBLE, MPI_MAX, grid->comm);
+    if ( ts->last_tf > 0 && t[0] > t[1] ) {
+	kf = (t[0] - t[1]) / ts->last_tf;
+	ts->kf = (1 - TUNE_SMOOTH) * ts->kf + TUNE_SMOOTH * kf;
+    }
+    if ( ts->last_tc > 0 && t[1] > 0 ) {
+	kc = t[1] / ts->last_tc;
+	ts->kc = (1 - TUNE_SMOOTH) * ts->kc + TUNE_SMOOTH * kc;
+    }
+}
+
+/*! \brief Set in options the advised look-ahead, and keep the advised
+ *  relax and maxsuper for the next analysis.
+ *
+ * <pre>
+ * The look-ahead is used by the next numerical factorization. Relax and
+ * maxsuper are only set in options by superlu_tune_prepare(), before the
+ * next symbolic factorization: the distribution, factorization and solve
+ * of the current one size their buffers with sp_ienv_dist(3, options),
+ * which must stay at least the width of its supernodes. The grid shape
+ * and Algo3d are only advice: the grid is created by the application.
+ * </pre>
+ */
+void superlu_tune_apply(superlu_tune_state_t *ts, superlu_tune_t *advice,
+			superlu_dist_options_t *options)
+{
+    options->num_lookaheads = advice->num_lookaheads;
+    ts->relax = advice->superlu_relax;
+    ts->maxsup = advice->superlu_maxsup;
+    ts->have_pending = 1;
+}
+
+/*! \brief Set in options the relax and maxsuper kept by the last
+ *  superlu_tune_apply(). Called before a new symbolic factorization.
+ */
+void superlu_tune_prepare(superlu_tune_state_t *ts,
+			  superlu_dist_options_t *options)
+{
+    if ( !ts->have_pending ) return;
+    options->superlu_relax = ts->relax;
+    options->superlu_maxsup = ts->maxsup;
+    ts->have_pending = 0;
+}
+
+/*! \brief The last advice; returns 0 if there is none. */
+int superlu_tune_last(superlu_tune_state_t *ts, superlu_tune_t *advice)
+{
+    if ( ts->have_last ) *advice = ts->last;
+    return ts->have_last;
+}
+
+/*! \brief Forget the advice and the scales learned from the measures. */
+void superlu_tune_reset(superlu_tune_state_t *ts)
+{
+    ts->n = ts->nnz = -1;
+    ts->kf = ts->kc = 1.0;
+    ts->last_tf = ts->last_tc = 0.0;
+    ts->have_last = 0;
+    ts->have_pending = 0;
+}
+
+/*! \brief Reset ts if A is not the matrix it was learned on.
+ *
+ * <pre>
+ * A is identified by its order n and its number of nonzeros, the sum
+ * over grid of nnz_loc. Must be called by all processes in grid before
+ * the other routines of a factorization, so that they all agree on the
+ * state.
+ * </pre>
+ */
+void superlu_tune_check(superlu_tune_state_t *ts, int_t n, int_t nnz_loc,
+			gridinfo_t *grid)
+{
+    int64_t nnz = nnz_loc;
+
+    MPI_Allreduce(MPI_IN_PLACE, &nnz, 1, MPI_INT64_T, MPI_SUM, grid->comm);
+    if ( ts->n != n || ts->nnz != nnz ) {
+	superlu_tune_reset(ts);
+	ts->n = n;
+	ts->nnz = nnz;
+    }
+}
+
+/*! \brief Print the advice and its predicted time. */
+void superlu_tune_print(superlu_tune_t *advice)
+{
+    printf(".. AutoTune: relax %d, maxsuper %d, lookahead %d, "
+	   "grid %d x %d x %d (Algo3d %s): predicted %.3e s, "
+	   "%.3e s with the current settings\n",
+	   advice->superlu_relax, advice->superlu_maxsup,
+	   advice->num_lookaheads, advice->nprow, advice->npcol,
+	   advice->npdep, advice->Algo3d == YES ? "YES" : "NO",
+	   advice->time, advice->time_cur);
+}
@@ -26,9 +26,17 @@ int_t calcTopInfoForest(sForest_t *forest,
                         int_t nsupers, int_t* setree);
 
 
-sForest_t**  getForests( int_t maxLvl, int_t nsupers, int_t*setree, treeList_t* treeList)
+/* The partitioner is chosen by the environment variable SUPERLU_LBS:
+   ND (nested dissection), GD (greedy load balance, the default) or
+   CM (cost model, see getCostModelForests()). ND and GD split each forest
+   in halves, so CM is used when nLayers is not a power of two. */
+sForest_t**  getForests( int_t maxLvl, int_t nLayers, int_t nsupers, int_t*setree, treeList_t* treeList)
 {
 	// treePartStrat tps;
+	if (nLayers != (1 << (maxLvl - 1)))
+	{
+		return getCostModelForests( maxLvl, nLayers, nsupers, setree, treeList);
+	}
 	if (getenv("SUPERLU_LBS"))
 	{
 		if (strcmp(getenv("SUPERLU_LBS"), "ND" ) == 0)
@@ -39,6 +47,10 @@ sForest_t**  getForests( int_t maxLvl, int_t nsupers, int_t*setree, treeList_t*
 		{
 			return getGreedyLoadBalForests( maxLvl, nsupers, setree, treeList);
 		}
+		if (strcmp(getenv("SUPERLU_LBS"), "CM" ) == 0)
+		{
+			return getCostModelForests( maxLvl, nLayers, nsupers, setree, treeList);
+		}
 	}
 	else
 	{
@@ -254,7 +266,7 @@ int_t** getNodeListFr(int_t maxLvl, sForest_t**  sForests)
 
 int_t* getNodeToForstMap(int_t nsupers, sForest_t**  sForests, gridinfo3d_t* grid3d)
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t numForests = (1 << maxLvl) - 1;
 	int_t* gNodeToForstMap = INT_T_ALLOC (nsupers);
 	
@@ -292,7 +304,7 @@ int_t* getMyNodeCountsFr(int_t maxLvl, int_t* myTreeIdxs, sForest_t**  sForests)
 int_t** getTreePermFr( int_t* myTreeIdxs,
                        sForest_t**  sForests, gridinfo3d_t* grid3d)
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
 	int_t** treePerm = (int_t** ) SUPERLU_MALLOC(sizeof(int_t*)*maxLvl);
 	for (int_t lvl = 0; lvl < maxLvl; lvl++)
@@ -354,7 +366,7 @@ void printGantt(int root, int numForests, char* nodename, double scale, double*
 void printForestWeightCost(sForest_t**  sForests, SCT_t* SCT, gridinfo3d_t* grid3d)
 {
 	gridinfo_t* grid = &(grid3d->grid2d);
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t numForests = (1 << maxLvl) - 1;
 	double* gFrstCost = DOUBLE_ALLOC(numForests);
 	double* gFrstCostAcc = DOUBLE_ALLOC(numForests);
@@ -1010,6 +1022,419 @@ sForest_t**  getOneLevelBalForests( int_t maxLvl, int_t nsupers, int_t * setree,
 }
 
 
+/* Cost-model partitioning (SUPERLU_LBS=CM)
+ *
+ * The greedy partitioner above splits the heaviest subtree until the two
+ * halves are within ACCEPTABLE_TREE_IMBALANCE, whatever it costs. Each split
+ * moves a chain of supernodes into the ancestor forest, which is factored
+ * by all the Z-layers below it, and whose L and U blocks are reduced
+ * between them. Here a partition of a forest over nLayers layers into
+ * nparts parts, part p going to layers[p] of the layers, is given the
+ * predicted time
+ *
+ *     T = sum_{k in ancestors} ( cmFlops(k) + beta * log2(nLayers) * cmWords(k) )
+ *         + max_p ( flops of part p ) / layers[p],
+ *
+ * and the split sequence of the greedy partitioner is cut at the step
+ * that minimizes T. The subtrees are assigned to the parts in decreasing
+ * order of weight, each to the part that would finish first with it.
+ *
+ * The layers are the first nLayers leaves of the binary Z-tree, so each
+ * forest is split in two parts that get the layers below the two children.
+ * When nLayers is not a power of two the parts may get different numbers
+ * of layers, and a part with none is left empty. The other partitioners
+ * split in halves, so getForests() uses this one for such an nLayers.
+ *
+ * beta is the cost of a word reduced between two layers, in flops; it is
+ * CM_BETA or the value of the environment variable SUPERLU_CM_BETA.
+ */
+#define CM_BETA 32.0
+#define CM_MIN_IMBALANCE 0.01
+#define CM_MAX_STEPS_NO_GAIN 64
+
+static double getCmBeta()
+{
+	char* ttemp = getenv("SUPERLU_CM_BETA");
+	return ttemp ? atof(ttemp) : CM_BETA;
+}
+
+/* Number of layers below the Z-tree node tr, among the first nLayers
+   leaves of a tree with maxLvl levels. */
+static int_t zTreeLayers(int_t tr, int_t maxLvl, int_t nLayers)
+{
+	int_t lvl = log2i(tr + 1);
+	int_t width = (int_t) 1 << (maxLvl - 1 - lvl);
+	int_t first = (tr + 1 - ((int_t) 1 << lvl)) * width;
+
+	return SUPERLU_MAX(0, SUPERLU_MIN(width, nLayers - first));
+}
+
+/* k-way version of oneLeveltreeFrPartition(), part p having layers[p]
+   layers; the load of each part is returned in load[]. trList may be NULL
+   if only the loads are needed. */
+static void kWayTreeFrPartition(int_t nTrees, int nparts, int_t * layers,
+                                int_t * trCount, int_t** trList,
+                                int_t * treeSet, double * sWeightArr,
+                                double * load)
+{
+	for (int p = 0; p < nparts; ++p)
+	{
+		trCount[p] = 0;
+		load[p] = 0.0;
+	}
+	if (nTrees < 1) return;
+
+	int_t* wSortIdx = getSortIndexDouble(nTrees, sWeightArr);
+
+	for (int_t i = nTrees - 1; i > -1; --i)
+	{
+		double w = sWeightArr[wSortIdx[i]];
+		int pmin = 0;
+		for (int p = 1; p < nparts; ++p)
+			if ((load[p] + w) * layers[pmin] < (load[pmin] + w) * layers[p])
+				pmin = p;
+
+		load[pmin] += w;
+		if (trList) trList[pmin][trCount[pmin]] = treeSet[wSortIdx[i]];
+		trCount[pmin]++;
+	}
+
+	SUPERLU_FREE(wSortIdx);
+} /* kWayTreeFrPartition */
+
+/* returns the predicted time T, and the imbalance of the times of the
+   parts in *imb */
+static double cmPredictTime(int_t nTreeSet, int_t* treeSet, double* weightArr,
+                            int nparts, int_t* layers, double ancCost,
+                            int_t* trCount, double* load, double* imb)
+{
+	double tmax, tmin;
+
+	kWayTreeFrPartition(nTreeSet, nparts, layers, trCount, NULL, treeSet,
+	                    weightArr, load);
+	tmax = tmin = load[0] / layers[0];
+	for (int p = 1; p < nparts; ++p)
+	{
+		tmax = SUPERLU_MAX(tmax, load[p] / layers[p]);
+		tmin = SUPERLU_MIN(tmin, load[p] / layers[p]);
+	}
+	*imb = (tmax + tmin > 0) ? (tmax - tmin) / (tmax + tmin) : 0.0;
+
+	return ancCost + tmax;
+}
+
+/* Splits rforest into an ancestor forest *Ans and nparts root forests S[],
+   S[p] for layers[p] > 0 layers. */
+static void costModelFrPartitioning(rForest_t* rforest, int nparts, int_t* layers,
+                                    double* subFlops, double beta,
+                                    int_t nsupers, int_t * setree, treeList_t* treeList,
+                                    sForest_t** Ans, rForest_t* S)
+{
+	int_t nTreeSet, nAnc, step, bestStep = 0, nLayers = 0;
+	int treeArrSize = SUPERLU_MAX( 2 * rforest->ntrees, NUM_TREE_LOWERB);
+	int_t* ancTreeCount = intMalloc_dist(treeArrSize);
+	int_t** ancNodeLists = SUPERLU_MALLOC(treeArrSize * sizeof(int_t*));
+	double * weightArr = doubleMalloc_dist(treeArrSize);
+	int_t* treeSet = intMalloc_dist(treeArrSize);
+	int_t* trCount = intMalloc_dist(nparts);
+	double* load = doubleMalloc_dist(nparts);
+	double commFactor, T, bestT, imb, ancCost;
+
+	for (int p = 0; p < nparts; ++p) nLayers += layers[p];
+	commFactor = beta * log2i_ceil(nLayers);
+
+	/* Pass 0 follows the greedy splits and finds the best step; pass 1
+	   replays the splits up to that step. */
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		nTreeSet = rforest->ntrees;
+		for (int i = 0; i < nTreeSet; ++i)
+		{
+			treeSet[i] = rforest->treeHeads[i];
+			weightArr[i] = subFlops[treeSet[i]];
+		}
+		nAnc = 0;
+		ancCost = 0.0;
+		step = 0;
+		bestT = cmPredictTime(nTreeSet, treeSet, weightArr, nparts, layers,
+		                      ancCost, trCount, load, &imb);
+
+		while (pass == 1 ? step < bestStep : (imb > CM_MIN_IMBALANCE
+		                   && step - bestStep < CM_MAX_STEPS_NO_GAIN))
+		{
+			/* split the heaviest subtree */
+			int_t idx = 0;
+			for (int i = 1; i < nTreeSet; ++i)
+				if (weightArr[i] > weightArr[idx]) idx = i;
+
+			int_t MaxTree = treeSet[idx];
+			int_t numSubtrees;
+			int_t* sroots = getSubTreeRoots(MaxTree, &numSubtrees, treeList);
+			if (numSubtrees == 0)
+			{
+				SUPERLU_FREE(sroots);
+				break;
+			}
+
+			int_t acount = getCommonAncsCount(MaxTree, treeList);
+			int_t* alist = intMalloc_dist(acount);
+			getCommonAncestorList(MaxTree, alist, setree, treeList);
+			for (int_t i = 0; i < acount; ++i)
+				ancCost += treeList[alist[i]].cmFlops
+				           + commFactor * treeList[alist[i]].cmWords;
+
+			int newNumTrees = nTreeSet - 1 + numSubtrees;
+			if (newNumTrees > treeArrSize || nAnc == treeArrSize)
+			{
+				int newSize = 2 * SUPERLU_MAX(newNumTrees, nAnc + 1);
+				resizeArr( (void**) &ancTreeCount, treeArrSize, newSize, sizeof(int_t));
+				resizeArr( (void**) &ancNodeLists, treeArrSize, newSize, sizeof(int_t*));
+				resizeArr( (void**) &weightArr, treeArrSize, newSize, sizeof(double));
+				resizeArr( (void**) &treeSet, treeArrSize, newSize, sizeof(int_t));
+				treeArrSize = newSize;
+			}
+			if (pass == 1)
+			{
+				ancTreeCount[nAnc] = acount;
+				ancNodeLists[nAnc] = alist;
+				nAnc++;
+			}
+			else SUPERLU_FREE(alist);
+
+			treeSet[idx] = treeSet[nTreeSet - 1];
+			weightArr[idx] = weightArr[nTreeSet - 1];
+			for (int j = 0; j < numSubtrees; j++)
+			{
+				treeSet[nTreeSet - 1 + j] = sroots[j];
+				weightArr[nTreeSet - 1 + j] = subFlops[sroots[j]];
+			}
+			nTreeSet = newNumTrees;
+			SUPERLU_FREE(sroots);
+			++step;
+
+			T = cmPredictTime(nTreeSet, treeSet, weightArr, nparts, layers,
+			                  ancCost, trCount, load, &imb);
+			if (pass == 0 && T < bestT)
+			{
+				bestT = T;
+				bestStep = step;
+			}
+		}
+	}
+
+	*Ans = createForestNew(nAnc, nsupers, ancTreeCount, ancNodeLists, setree, treeList);
+
+	int_t** trList = SUPERLU_MALLOC(nparts * sizeof(int_t*));
+	for (int p = 0; p < nparts; ++p)
+		trList[p] = intMalloc_dist(SUPERLU_MAX(nTreeSet, 1));
+	kWayTreeFrPartition(nTreeSet, nparts, layers, trCount, trList, treeSet,
+	                    weightArr, load);
+	for (int p = 0; p < nparts; ++p)
+	{
+		S[p].ntrees = trCount[p];
+		S[p].treeHeads = trList[p];
+	}
+
+	for (int i = 0; i < nAnc ; ++i)
+		SUPERLU_FREE(ancNodeLists[i]);
+	SUPERLU_FREE(ancTreeCount);
+	SUPERLU_FREE(ancNodeLists);
+	SUPERLU_FREE(weightArr);
+	SUPERLU_FREE(treeSet);
+	SUPERLU_FREE(trCount);
+	SUPERLU_FREE(load);
+	SUPERLU_FREE(trList);
+} /* costModelFrPartitioning */
+
+/* Same layout of the forests as getGreedyLoadBalForests(), with the
+   splits chosen by costModelFrPartitioning() for nLayers layers. */
+sForest_t**  getCostModelForests( int_t maxLvl, int_t nLayers, int_t nsupers,
+                                  int_t * setree, treeList_t* treeList)
+{
+	int_t numForests = (1 << maxLvl) - 1;
+	sForest_t**  sForests = (sForest_t** ) SUPERLU_MALLOC (numForests * sizeof (sForest_t*));
+
+	int_t numRForests = SUPERLU_MAX( (1 << (maxLvl - 1)) - 1, 1) ;
+	rForest_t*  rForests = SUPERLU_MALLOC (numRForests * sizeof (rForest_t));
+	double beta = getCmBeta();
+
+	/* flops of the subtree rooted at each supernode */
+	double* subFlops = doubleMalloc_dist(nsupers + 1);
+	for (int_t i = 0; i < nsupers; ++i) subFlops[i] = treeList[i].cmFlops;
+	subFlops[nsupers] = 0.0;
+	for (int_t i = 0; i < nsupers; ++i) subFlops[setree[i]] += subFlops[i];
+
+	int_t nRootTrees = 0;
+	for (int i = 0; i < nsupers; ++i)
+		if (setree[i] == nsupers) nRootTrees++;
+
+	rForests[0].ntrees = nRootTrees;
+	rForests[0].treeHeads = INT_T_ALLOC(nRootTrees);
+
+	nRootTrees = 0;
+	for (int i = 0; i < nsupers; ++i)
+		if (setree[i] == nsupers) rForests[0].treeHeads[nRootTrees++] = i;
+
+	if (maxLvl == 1)
+	{
+		sForests[0] = r2sForest(&rForests[0], nsupers, setree, treeList);
+	}
+	else
+	{
+		for (int_t lvl = 0; lvl < maxLvl - 1; ++lvl)
+		{
+			int_t lvlSt = (1 << lvl) - 1;
+			int_t lvlEnd = (1 << (lvl + 1)) - 1;
+
+			for (int_t tr = lvlSt; tr < lvlEnd; ++tr)
+			{
+				rForest_t S[2];
+				int_t layers[2] = {zTreeLayers(2 * tr + 1, maxLvl, nLayers),
+				                   zTreeLayers(2 * tr + 2, maxLvl, nLayers)};
+
+				if (layers[1] == 0)
+				{
+					/* all the layers below tr are below its first
+					   child, which gets the whole forest */
+					sForests[tr] = NULL;
+					S[0] = rForests[tr];
+					S[1].ntrees = 0;
+					S[1].treeHeads = INT_T_ALLOC(1);
+					rForests[tr].treeHeads = INT_T_ALLOC(1);
+					rForests[tr].ntrees = 0;
+				}
+				else
+					costModelFrPartitioning(&rForests[tr], 2, layers, subFlops,
+					                        beta, nsupers, setree, treeList,
+					                        &sForests[tr], S);
+
+				if (lvl == maxLvl - 2)
+				{
+					sForests[2 * tr + 1] = r2sForest(&S[0], nsupers, setree, treeList);
+					sForests[2 * tr + 2] = r2sForest(&S[1], nsupers, setree, treeList);
+					freeRforest(&S[0]);
+					freeRforest(&S[1]);
+				}
+				else
+				{
+					rForests[2 * tr + 1] = S[0];
+					rForests[2 * tr + 2] = S[1];
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < numRForests; ++i)
+		freeRforest(&rForests[i]);
+	SUPERLU_FREE(rForests);
+	SUPERLU_FREE(subFlops);
+
+	return sForests;
+} /* getCostModelForests */
+
+/* Predicted cost of each forest, and of the critical path below it. */
+static void cmForestCosts(int_t maxLvl, sForest_t** sForests, treeList_t* treeList,
+                          double beta, double* frCost, double* frWeight,
+                          double* crPathCost)
+{
+	int_t numForests = (1 << maxLvl) - 1;
+
+	for (int_t lvl = 0; lvl < maxLvl; ++lvl)
+	{
+		double commFactor = beta * (maxLvl - 1 - lvl);
+		for (int_t i = (1 << lvl) - 1; i < (1 << (lvl + 1)) - 1; ++i)
+		{
+			frCost[i] = frWeight[i] = 0.0;
+			if (sForests[i] == NULL) continue;
+			frWeight[i] = sForests[i]->weight;
+			for (int_t nd = 0; nd < sForests[i]->nNodes; ++nd)
+			{
+				int_t k = sForests[i]->nodeList[nd];
+				frCost[i] += treeList[k].cmFlops + commFactor * treeList[k].cmWords;
+			}
+		}
+	}
+	for (int_t i = numForests - 1; i > -1; --i)
+	{
+		crPathCost[i] = frCost[i];
+		if (2 * i + 1 < numForests)
+			crPathCost[i] += SUPERLU_MAX(crPathCost[2 * i + 1], crPathCost[2 * i + 2]);
+	}
+}
+
+/* Largest imbalance between the critical paths of sibling subtrees with
+   layers at level lvl of the Z-tree, or at all levels if lvl < 0. */
+static double cmLevelImbalance(int_t lvl, int_t maxLvl, int_t nLayers,
+                               double* crPathCost)
+{
+	double maxImb = 0.0;
+	int_t idx[2] = {0, 1};
+	int_t lvlSt = lvl < 0 ? 0 : lvl, lvlEnd = lvl < 0 ? maxLvl - 1 : lvl + 1;
+
+	for (int_t l = lvlSt; l < lvlEnd; ++l)
+		for (int_t i = (1 << l) - 1; i < (1 << (l + 1)) - 1; ++i)
+		{
+			double pair[2] = {crPathCost[2 * i + 1], crPathCost[2 * i + 2]};
+			if (zTreeLayers(2 * i + 2, maxLvl, nLayers) > 0
+			    && pair[0] + pair[1] > 0)
+				maxImb = SUPERLU_MAX(maxImb, getLoadImbalance(2, idx, pair));
+		}
+	return maxImb;
+}
+
+/* Returns the largest imbalance between sibling subtrees of the Z-tree
+   predicted by the cost model of getCostModelForests(), in [0, 1]; see
+   SuperLUStat_t.forest_imbalance. */
+double getForestImbalance(int_t maxLvl, int_t nLayers, sForest_t** sForests,
+                          treeList_t* treeList)
+{
+	int_t numForests = (1 << maxLvl) - 1;
+	double* frCost = DOUBLE_ALLOC(numForests);
+	double* frWeight = DOUBLE_ALLOC(numForests);
+	double* crPathCost = DOUBLE_ALLOC(numForests);
+	double imb;
+
+	cmForestCosts(maxLvl, sForests, treeList, getCmBeta(), frCost, frWeight,
+	              crPathCost);
+	imb = cmLevelImbalance(-1, maxLvl, nLayers, crPathCost);
+
+	SUPERLU_FREE(frCost);
+	SUPERLU_FREE(frWeight);
+	SUPERLU_FREE(crPathCost);
+	return imb;
+}
+
+/* Prints, before the factorization, the time of each forest predicted by
+   the cost model of getCostModelForests(), the largest imbalance between
+   sibling subtrees at each level of the Z-tree, and the Pearson
+   coefficient between the predicted times and the forest weights. */
+void printForestPrediction(int_t maxLvl, int_t nLayers, sForest_t** sForests,
+                           treeList_t* treeList, gridinfo3d_t* grid3d)
+{
+	if (grid3d->iam) return;
+
+	int_t numForests = (1 << maxLvl) - 1;
+	double* frCost = DOUBLE_ALLOC(numForests);
+	double* frWeight = DOUBLE_ALLOC(numForests);
+	double* crPathCost = DOUBLE_ALLOC(numForests);
+	double beta = getCmBeta();
+
+	cmForestCosts(maxLvl, sForests, treeList, beta, frCost, frWeight,
+	              crPathCost);
+
+	printf(".. Predicted forest costs (flops, comm. at %.1f flops/word)\n", beta);
+	printf("|Level | max imbalance |\n");
+	for (int_t lvl = 0; lvl < maxLvl - 1; ++lvl)
+		printf("|%d   | %.3f   |\n", (int) lvl,
+		       cmLevelImbalance(lvl, maxLvl, nLayers, crPathCost));
+	printf("|CritcalPath   | %.2e   |\n", crPathCost[0]);
+	printf("|Pearsoncoefficient |  %.3f |\n", pearsonCoeff(numForests, frCost, frWeight));
+
+	SUPERLU_FREE(frCost);
+	SUPERLU_FREE(frWeight);
+	SUPERLU_FREE(crPathCost);
+} /* printForestPrediction */
+
 int* getBrecvTree(int_t nlb, sForest_t* sforest,  int* bmod, gridinfo_t * grid)
 {
     int_t nnodes =   sforest->nNodes ;      // number of nodes in the tree
@@ -21,6 +21,17 @@ int_t log2i(int_t index)
 	return targetlevel;
 }
 
+/* Smallest l such that 2^l >= index. The Np layers of a 3D grid are the
+   first Np leaves of a binary tree with log2i_ceil(Np) + 1 levels; when
+   Np is not a power of two, the forests of the other leaves, and of the
+   tree nodes with only such leaves below them, are empty. */
+int_t log2i_ceil(int_t index)
+{
+	int_t targetlevel = log2i(index);
+	if (((int_t) 1 << targetlevel) < index) ++targetlevel;
+	return targetlevel;
+}
+
 /**
  * Returns Supernodal Elimination Tree
  * @param  nsuper Number of Supernodes
@@ -252,6 +263,17 @@ int_t calcTreeWeight(int_t nsupers, int_t*setree, treeList_t* treeList, int_t* x
 		treeList[i].iWeight = treeList[i].weight;
 	}
 
+	/* Cost model of getCostModelForests(): the rows of L(:,k) and the
+	   columns of U(k,:) are bounded by the depth of k. */
+	for (int i = 0; i < nsupers; ++i)
+	{
+		double dep = 1.0 * treeList[i].depth ;
+		double sz = 1.0 *  SuperSize(i);
+		treeList[i].cmFlops = 2.0 * sz * dep * dep + 2.0 * sz * sz * dep
+		                      + 2.0 / 3.0 * sz * sz * sz;
+		treeList[i].cmWords = sz * (sz + 2.0 * dep);
+	}
+
 
 	for (int i = 0; i < nsupers; ++i)
 	{
@@ -839,9 +861,9 @@ int_t** getNodeList(int_t maxLvl, int_t* setree, int_t* nnodes,
 
 int_t* getGridTrees( gridinfo3d_t* grid3d)
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t* myTreeIdx = (int_t*) SUPERLU_MALLOC (maxLvl * sizeof (int_t));
-	myTreeIdx[0] = grid3d->zscp.Np - 1 + grid3d->zscp.Iam ;
+	myTreeIdx[0] = (1 << (maxLvl - 1)) - 1 + grid3d->zscp.Iam ;
 	for (int i = 1; i < maxLvl; ++i)
 	{
 		/* code */
@@ -852,7 +874,7 @@ int_t* getGridTrees( gridinfo3d_t* grid3d)
 
 int_t* getReplicatedTrees( gridinfo3d_t* grid3d)
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t* myZeroTrIdxs = (int_t*) SUPERLU_MALLOC (maxLvl * sizeof (int_t));
 	for (int i = 0; i < maxLvl; ++i)
 	{
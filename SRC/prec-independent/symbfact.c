@@ -43,6 +43,8 @@ at the top-level directory.
  * Internal protypes
  */
 static void  relax_snode(int_t, int_t *, int_t, int_t *, int_t *);
+static int_t amalg_snode(const int_t, int_t *, const double, const int_t,
+			 Glu_persist_t *, Glu_freeable_t *);
 static int_t snode_dfs(SuperMatrix *, const int_t, const int_t, int_t *,
 		       int_t *,	Glu_persist_t *, Glu_freeable_t *);
 static int_t column_dfs(superlu_dist_options_t *, SuperMatrix *,
@@ -97,6 +99,7 @@ int_t symbfact
     int_t relax, *desc, *relax_end;
     int_t nnzLU, nnzLSUB;
     int_t nnzL, nnzU;
+    int_t namalg = 0;
 
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(pnum, "Enter symbfact()");
@@ -186,6 +189,11 @@ int_t symbfact
     /* Apply perm_r to L; Compress LSUB array. */
     nnzLSUB = fixupL_dist(min_mn, perm_r, Glu_persist, Glu_freeable);
 
+    /* Merge interior supernodes into their parents. */
+    if ( options->AmalgFill > 0.0 && min_mn > 1 )
+	namalg = amalg_snode(min_mn, etree, options->AmalgFill,
+			     sp_ienv_dist(3, options), Glu_persist, Glu_freeable);
+
     if ( !pnum && (options->PrintStat == YES)) {
 	nnzLU = nnzL + nnzU - min_mn;				   
 	printf("\tMatrix size min_mn  " IFMT "\n", min_mn);
@@ -193,6 +201,9 @@ int_t symbfact
 	printf("\tNonzeros in U       " IFMT "\n", nnzU);
 	printf("\tnonzeros in L+U     " IFMT "\n", nnzLU);
 	printf("\tnonzeros in LSUB    " IFMT "\n", nnzLSUB);
+	if ( namalg )
+	    printf("\tAmalgamated snodes  " IFMT ", nonzeros in L+U " IFMT "\n",
+		   namalg, (int_t) Glu_freeable->nnzLU);
     }
     SUPERLU_FREE(iwork);
 
@@ -215,6 +226,218 @@ int_t symbfact
 
 } /* SYMBFACT */
 
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   amalg_snode() merges supernodes into their parent in the supernodal
+ *   etree, after the symbolic factorization. relax_snode() only merges
+ *   the small subtrees at the leaves; this also merges the narrow
+ *   supernodes of the interior of the etree, so that the Schur-complement
+ *   updates and the triangular solves work on wider blocks.
+ *
+ *   A group of supernodes that ends right before the supernode holding
+ *   the etree parent of its last column is merged with that supernode,
+ *   if the rows of L below the group and the columns of U right of it
+ *   are also in the parent, the merged supernode has at most maxsup
+ *   columns, and the explicit zeros it adds to L and U are at most fill
+ *   times the entries of the supernodes merged. The structure then stays
+ *   closed under the elimination: the updates from the merged supernode
+ *   reach the same entries as the updates from the parent.
+ *
+ *   On entry, the structure is the one set by fixupL_dist(): supernode k
+ *   has the rows lsub[xlsub[xsup[k]] : xlsub[xsup[k]+1]-1] of P*A, and
+ *   usub[xusub[j] : xusub[j+1]-1] has the first row of each supernode
+ *   segment of U(:,j). On exit, xsup, supno, xlsub, lsub, xusub, usub
+ *   and nnzLU describe the merged supernodes; lsub and usub are
+ *   compressed in place.
+ *
+ * Return value
+ * ============
+ *   The number of supernodes removed.
+ * </pre>
+ */
+static int_t amalg_snode
+/************************************************************************/
+(
+ const int_t n,      /* number of columns in the matrix (input) */
+ int_t       *etree, /* column elimination tree (input) */
+ const double fill,  /* max. ratio of explicit zeros added (input) */
+ const int_t maxsup, /* max. no of columns in a supernode (input) */
+ Glu_persist_t *Glu_persist,  /* global LU data structures (modified) */
+ Glu_freeable_t *Glu_freeable
+ )
+{
+    int_t *xsup, *supno, *xlsub, *lsub, *xusub, *usub;
+    int_t *iwork, *marker, *umark, *gstart, *grows, *nrows, *gcols;
+    int_t *uptr, *ucol, *ufst;
+    int_t nsupers, k, i, j, a, e = 0, e2 = 0, sk, ng, nr, nc, nm, ns, nextl, nextu;
+    int_t irow, kfnz, nzu, *tmp, closed;
+    int64_t gorig = 0, gcost = 0, kcost = 0, mcost;
+
+    xsup   = Glu_persist->xsup;
+    supno  = Glu_persist->supno;
+    xlsub  = Glu_freeable->xlsub;
+    lsub   = Glu_freeable->lsub;
+    xusub  = Glu_freeable->xusub;
+    usub   = Glu_freeable->usub;
+    nsupers = supno[n] + 1;
+    nzu    = xusub[n];
+    if ( nsupers == 1 ) return 0;
+
+    if ( !(iwork = intMalloc_dist(6*n + nsupers + 1 + 2*nzu)) )
+	ABORT("Malloc fails for iwork[]");
+    marker = iwork;
+    umark  = marker + n;
+    gstart = umark + n;
+    grows  = gstart + n;
+    nrows  = grows + n;
+    gcols  = nrows + n;
+    uptr   = gcols + n;
+    ucol   = uptr + nsupers + 1;
+    ufst   = ucol + nzu;
+    ifill_dist(marker, n, SLU_EMPTY);
+    ifill_dist(umark, n, SLU_EMPTY);
+    ifill_dist(gstart, n, SLU_EMPTY);
+
+    /* U by supernode rows: columns ucol[] and first rows ufst[] of the
+       segments of supernode k are at uptr[k] : uptr[k+1]-1. */
+    ifill_dist(uptr, nsupers + 1, 0);
+    for (i = 0; i < nzu; ++i) ++uptr[supno[usub[i]] + 1];
+    for (k = 0; k < nsupers; ++k) uptr[k+1] += uptr[k];
+    for (j = 0; j < n; ++j)
+	for (i = xusub[j]; i < xusub[j+1]; ++i) {
+	    k = supno[usub[i]];
+	    ucol[uptr[k]] = j;
+	    ufst[uptr[k]++] = usub[i];
+	}
+    for (k = nsupers; k > 0; --k) uptr[k] = uptr[k-1];
+    uptr[0] = 0;
+
+    /* The current group is columns a : e-1, with the rows grows[0:ng-1]
+       below them in L, and the columns gcols[0:nc-1] of U right of them,
+       whose segments start at gstart[]. gorig counts the entries of its
+       supernodes before merging, gcost after. */
+    ns = nextl = 0;
+    nm = 0;
+    a = e = 0;
+    ng = nc = 0;
+    gorig = gcost = 0;
+    for (k = 0; k <= nsupers; ++k) {
+	if ( k < nsupers ) {
+	    e2 = xsup[k+1];
+	    sk = e2 - e;
+	    /* Rows of supernode k below its diagonal block. */
+	    nr = 0;
+	    for (i = xlsub[e]; i < xlsub[e+1]; ++i)
+		if ( (irow = lsub[i]) >= e2 ) {
+		    nrows[nr++] = irow;
+		    marker[irow] = k;
+		}
+	    kcost = (int64_t) sk * (sk + nr);
+	    for (i = uptr[k]; i < uptr[k+1]; ++i) kcost += e2 - ufst[i];
+
+	    if ( k > 0 && etree[e-1] < n && supno[etree[e-1]] == k
+		 && e2 - a <= maxsup ) {
+		/* The rows below the group and the columns right of it
+		   must be in supernode k. */
+		closed = 1;
+		for (i = 0; i < ng && closed; ++i)
+		    if ( grows[i] >= e2 && marker[grows[i]] != k ) closed = 0;
+		for (i = uptr[k]; i < uptr[k+1]; ++i) umark[ucol[i]] = k;
+		for (i = 0; i < nc && closed; ++i)
+		    if ( gcols[i] >= e2 && umark[gcols[i]] != k ) closed = 0;
+
+		/* Entries of the group merged with supernode k; the U
+		   segments start in the group where it has them. */
+		mcost = (int64_t) (e2 - a) * (e2 - a + nr);
+		for (i = uptr[k]; i < uptr[k+1]; ++i) {
+		    j = ucol[i];
+		    mcost += e2 - (gstart[j] == SLU_EMPTY ? ufst[i] : gstart[j]);
+		}
+
+		if ( closed && mcost - gorig - kcost <= fill * (gorig + kcost) ) {
+		    tmp = grows; grows = nrows; nrows = tmp;
+		    ng = nr;
+		    for (i = 0; i < nc; ++i)
+			if ( gcols[i] < e2 ) gstart[gcols[i]] = SLU_EMPTY;
+		    nc = 0;
+		    for (i = uptr[k]; i < uptr[k+1]; ++i) {
+			j = ucol[i];
+			if ( gstart[j] == SLU_EMPTY ) gstart[j] = ufst[i];
+			gcols[nc++] = j;
+		    }
+		    e = e2;
+		    gorig += kcost;
+		    gcost = mcost;
+		    ++nm;
+		    continue;
+		}
+	    }
+	}
+
+	if ( k > 0 ) {
+	    /* Close the group as supernode ns. It is written over its
+	       own old rows, which start at or after nextl. */
+	    xsup[ns] = a;
+	    xlsub[a] = nextl;
+	    for (j = a; j < e; ++j) {
+		supno[j] = ns;
+		lsub[nextl++] = j;
+	    }
+	    for (i = 0; i < ng; ++i) lsub[nextl++] = grows[i];
+	    for (j = a+1; j < e; ++j) xlsub[j] = nextl;
+	    Glu_freeable->nnzLU += gcost - gorig;
+	    ++ns;
+	}
+	if ( k == nsupers ) break;
+
+	/* Supernode k starts a new group. */
+	tmp = grows; grows = nrows; nrows = tmp;
+	ng = nr;
+	for (i = 0; i < nc; ++i) gstart[gcols[i]] = SLU_EMPTY;
+	nc = 0;
+	for (i = uptr[k]; i < uptr[k+1]; ++i) {
+	    gstart[ucol[i]] = ufst[i];
+	    gcols[nc++] = ucol[i];
+	}
+	a = e;
+	e = e2;
+	gorig = gcost = kcost;
+    }
+    xsup[ns] = n;
+    supno[n] = ns - 1;
+    xlsub[n] = nextl;
+
+    /* One segment per merged supernode in each column of U; the segments
+       inside the diagonal block are dropped. */
+    ifill_dist(marker, ns, SLU_EMPTY);
+    nextu = 0;
+    for (j = 0; j < n; ++j) {
+	i = xusub[j];
+	e = xusub[j+1];
+	xusub[j] = nextu;
+	for (; i < e; ++i) {
+	    kfnz = usub[i];
+	    k = supno[kfnz];
+	    if ( k == supno[j] ) continue;
+	    if ( marker[k] == j ) {
+		if ( kfnz < usub[gstart[k]] ) usub[gstart[k]] = kfnz;
+	    } else {
+		marker[k] = j;
+		gstart[k] = nextu;
+		usub[nextu++] = kfnz;
+	    }
+	}
+    }
+    xusub[n] = nextu;
+
+    SUPERLU_FREE(iwork);
+    return nm;
+} /* AMALG_SNODE */
+
 /************************************************************************/
 /*! \brief
  *
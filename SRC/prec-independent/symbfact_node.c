@@ -0,0 +1,199 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file symbfact_node.c
+ * \brief Serial symbolic analysis done once per node
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * With options->NodeSymbFact = YES and ParSymbFact = NO, PxGSSVX gathers
+ * the global matrix GA only on one process per node, the leader, and
+ * only the leaders compute the column ordering and the symbolic
+ * factorization. The other processes of the node get perm_c, etree and
+ * the supernode partition by a broadcast, and read the structure of L
+ * and U (xlsub, lsub, xusub, usub) from an MPI-3 shared window of the
+ * leader. The memory for the analysis on a node is then that of one
+ * process, instead of one copy per process.
+ * </pre>
+ */
+
+#include <string.h>
+#include "superlu_defs.h"
+
+/*! \brief Split grid->comm into nodes, and choose one leader per node.
+ *
+ * <pre>
+ * Must be called by all processes in grid->comm. The leader of a node is
+ * the process with the lowest rank in grid->comm, so process 0 is
+ * always a leader.
+ * </pre>
+ */
+void superlu_node_init(superlu_node_t *node, gridinfo_t *grid)
+{
+    int nprocs = grid->nprow * grid->npcol;
+    int myshm, ids[2];
+
+    MPI_Comm_split_type(grid->comm, MPI_COMM_TYPE_SHARED, grid->iam,
+			MPI_INFO_NULL, &node->shmcomm);
+    MPI_Comm_rank(node->shmcomm, &myshm);
+    node->leader = (myshm == 0);
+    MPI_Comm_split(grid->comm, node->leader ? 0 : MPI_UNDEFINED, grid->iam,
+		   &node->leadcomm);
+
+    /* ids[] = {rank in leadcomm, rank in grid->comm} of my leader */
+    if ( node->leader ) {
+	MPI_Comm_rank(node->leadcomm, &ids[0]);
+	ids[1] = grid->iam;
+    }
+    MPI_Bcast(ids, 2, MPI_INT, 0, node->shmcomm);
+    node->lead_iam = ids[1];
+
+    if ( !(node->lead_of = SUPERLU_MALLOC(nprocs * sizeof(int))) )
+	ABORT("Malloc fails for node->lead_of[].");
+    MPI_Allgather(&ids[0], 1, MPI_INT, node->lead_of, 1, MPI_INT, grid->comm);
+    node->win = MPI_WIN_NULL;
+}
+
+void superlu_node_free(superlu_node_t *node)
+{
+    if ( node->leadcomm != MPI_COMM_NULL ) MPI_Comm_free(&node->leadcomm);
+    MPI_Comm_free(&node->shmcomm);
+    SUPERLU_FREE(node->lead_of);
+}
+
+/*! \brief MPI_Allgatherv over grid->comm, in which only the leaders
+ *  receive.
+ *
+ * <pre>
+ * recvbuf, recvcnts[] and displs[] are only used on the leaders. The
+ * piece of each process is sent to the leader of its node, which
+ * broadcasts it to the other leaders, so no memory is needed besides
+ * recvbuf. If node is NULL, this is MPI_Allgatherv over grid->comm.
+ * </pre>
+ */
+void superlu_node_allgatherv(superlu_node_t *node, void *sendbuf,
+			     int sendcnt, void *recvbuf, int *recvcnts,
+			     int *displs, MPI_Datatype type, gridinfo_t *grid)
+{
+    int nprocs = grid->nprow * grid->npcol;
+    int p, mylead;
+    MPI_Aint lb, extent;
+    char *dest;
+
+    if ( !node ) {
+	MPI_Allgatherv(sendbuf, sendcnt, type, recvbuf, recvcnts, displs,
+		       type, grid->comm);
+	return;
+    }
+    if ( !node->leader ) {
+	MPI_Send(sendbuf, sendcnt, type, node->lead_iam, 0, grid->comm);
+	return;
+    }
+
+    MPI_Type_get_extent(type, &lb, &extent);
+    mylead = node->lead_of[grid->iam];
+    for (p = 0; p < nprocs; ++p) {
+	dest = (char *) recvbuf + (MPI_Aint) displs[p] * extent;
+	if ( p == grid->iam )
+	    memcpy(dest, sendbuf, (size_t) sendcnt * extent);
+	else if ( node->lead_of[p] == mylead )
+	    MPI_Recv(dest, recvcnts[p], type, p, 0, grid->comm,
+		     MPI_STATUS_IGNORE);
+	MPI_Bcast(dest, recvcnts[p], type, node->lead_of[p], node->leadcomm);
+    }
+}
+
+/*! \brief Give the result of the serial symbolic factorization of the
+ *  leader to the other processes of its node.
+ *
+ * <pre>
+ * On the leader, linfo is the value returned by symbfact(), and perm_c,
+ * etree, Glu_persist and Glu_freeable are the outputs of sp_colorder()
+ * and symbfact(). On return they are set on all the processes of the
+ * node; perm_c and etree must be allocated with n entries everywhere.
+ * The structure of L and U is moved into a shared window of the leader,
+ * which the processes of the node read in place. It must be released
+ * with superlu_node_free_symbfact(), not with symbfact_SubFree().
+ *
+ * Returns linfo of the leader. If it is positive (symbfact() ran out of
+ * memory), nothing is shared.
+ * </pre>
+ */
+int_t superlu_node_share_symbfact(superlu_node_t *node, int_t linfo,
+				  int_t n, int_t *perm_c, int_t *etree,
+				  Glu_persist_t *Glu_persist,
+				  Glu_freeable_t *Glu_freeable)
+{
+    int_t hdr[3], nzl, nzu, *base;
+    int64_t nnzLU;
+    MPI_Aint size;
+    int disp;
+
+    if ( node->leader ) {
+	hdr[0] = linfo;
+	hdr[1] = linfo > 0 ? 0 : Glu_freeable->xlsub[n];
+	hdr[2] = linfo > 0 ? 0 : Glu_freeable->xusub[n];
+	nnzLU = Glu_freeable->nnzLU;
+    }
+    MPI_Bcast(hdr, 3, mpi_int_t, 0, node->shmcomm);
+    if ( (linfo = hdr[0]) > 0 ) return linfo;
+    nzl = hdr[1];
+    nzu = hdr[2];
+    MPI_Bcast(&nnzLU, 1, MPI_INT64_T, 0, node->shmcomm);
+
+    MPI_Bcast(perm_c, n, mpi_int_t, 0, node->shmcomm);
+    MPI_Bcast(etree, n, mpi_int_t, 0, node->shmcomm);
+    if ( !node->leader ) {
+	if ( !(Glu_persist->xsup = intMalloc_dist(n+1)) )
+	    ABORT("Malloc fails for xsup[].");
+	if ( !(Glu_persist->supno = intMalloc_dist(n+1)) )
+	    ABORT("Malloc fails for supno[].");
+    }
+    MPI_Bcast(Glu_persist->xsup, n+1, mpi_int_t, 0, node->shmcomm);
+    MPI_Bcast(Glu_persist->supno, n+1, mpi_int_t, 0, node->shmcomm);
+
+    /* The window holds xlsub, xusub, lsub and usub, in this order. */
+    size = node->leader ? (MPI_Aint) (2 * (n+1) + nzl + nzu) * sizeof(int_t) : 0;
+    MPI_Win_allocate_shared(size, sizeof(int_t), MPI_INFO_NULL,
+			    node->shmcomm, &base, &node->win);
+    if ( node->leader ) {
+	memcpy(base, Glu_freeable->xlsub, (n+1) * sizeof(int_t));
+	memcpy(base + n+1, Glu_freeable->xusub, (n+1) * sizeof(int_t));
+	memcpy(base + 2*(n+1), Glu_freeable->lsub, nzl * sizeof(int_t));
+	memcpy(base + 2*(n+1) + nzl, Glu_freeable->usub, nzu * sizeof(int_t));
+	symbfact_SubFree(Glu_freeable);
+    } else {
+	MPI_Win_shared_query(node->win, 0, &size, &disp, &base);
+    }
+    MPI_Win_fence(0, node->win); /* the copy is visible to all */
+
+    Glu_freeable->xlsub = base;
+    Glu_freeable->xusub = base + n+1;
+    Glu_freeable->lsub = base + 2*(n+1);
+    Glu_freeable->usub = base + 2*(n+1) + nzl;
+    Glu_freeable->nzlmax = nzl;
+    Glu_freeable->nzumax = nzu;
+    Glu_freeable->MemModel = SYSTEM;
+    Glu_freeable->nnzLU = nnzLU;
+    return linfo;
+}
+
+/*! \brief Release the structure of L and U shared by
+ *  superlu_node_share_symbfact(). Collective on the node.
+ */
+void superlu_node_free_symbfact(superlu_node_t *node,
+				Glu_freeable_t *Glu_freeable)
+{
+    MPI_Win_free(&node->win);
+    Glu_freeable->xlsub = Glu_freeable->xusub = NULL;
+    Glu_freeable->lsub = Glu_freeable->usub = NULL;
+}
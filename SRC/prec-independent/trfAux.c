@@ -2771,10 +2771,10 @@ sForest_t **compute_sForests(int_t nsupers,  Glu_persist_t *Glu_persist, int_t *
     calcTreeWeight(nsupers, setree, treeList, Glu_persist->xsup);
 
     // Calculation of maximum level
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     // Generation of forests
-    sForest_t **sForests = getForests(maxLvl, nsupers, setree, treeList);
+    sForest_t **sForests = getForests(maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
 
     // Allocate trf3d data structure
     // LUstruct->trf3Dpart = (dtrf3Dpartition_t *)SUPERLU_MALLOC(sizeof(dtrf3Dpartition_t));
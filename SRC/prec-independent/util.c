@@ -238,6 +238,15 @@ void set_default_options_dist(superlu_dist_options_t *options)
     options->batchCount = 0;
     options->SymPattern = NO;
     options->Algo3d = NO;
+    options->CommTree = BINARY_TREE;
+    options->IntraNodeShm = NO;
+    options->SymbCache = NO;
+    options->Trace = NO;
+    options->SchurTasks = NO;
+    options->MixedPrecLU = NO;
+    options->NodeSymbFact = NO;
+    options->AutoTune = NO;
+    options->AmalgFill = 0.0;
 #ifdef SLU_HAVE_LAPACK
     options->DiagInv = YES;
 #else
@@ -270,6 +279,15 @@ void print_options_dist(superlu_dist_options_t *options)
     printf("**    lookahead_etree           : %4d\n", options->lookahead_etree);
     printf("**    Use_TensorCore            : %4d\n", options->Use_TensorCore);
     printf("**    Use 3D algorithm          : %4d\n", options->Algo3d);
+    printf("**    CommTree                  : %4d\n", options->CommTree);
+    printf("**    IntraNodeShm              : %4d\n", options->IntraNodeShm);
+    printf("**    SymbCache                 : %4d\n", options->SymbCache);
+    printf("**    Trace                     : %4d\n", options->Trace);
+    printf("**    SchurTasks                : %4d\n", options->SchurTasks);
+    printf("**    MixedPrecLU               : %4d\n", options->MixedPrecLU);
+    printf("**    NodeSymbFact              : %4d\n", options->NodeSymbFact);
+    printf("**    AutoTune                  : %4d\n", options->AutoTune);
+    printf("**    AmalgFill                 : %4.2f\n", options->AmalgFill);
     printf("** parameters that can be altered by environment variables:\n");
     printf("**    superlu_relax             : %4d\n", sp_ienv_dist(2, options));
     printf("**    superlu_maxsup            : %4d\n", sp_ienv_dist(3, options));
@@ -324,6 +342,26 @@ void pxgstrs_finalize(pxgstrs_comm_t *gstrs_comm)
     SUPERLU_FREE(gstrs_comm);
 }
 
+/*! \brief Set the *_nrhs counts and displacements of B_to_X_SendCnt and
+ *  X_to_B_SendCnt for nrhs right-hand sides, so that a solve can use a
+ *  number of right-hand sides other than the one given to p[sdz]gstrs_init().
+ */
+void pxgstrs_comm_set_nrhs(pxgstrs_comm_t *gstrs_comm, int procs, int nrhs)
+{
+    int *cnt[2], i, p;
+
+    cnt[0] = gstrs_comm->B_to_X_SendCnt;
+    cnt[1] = gstrs_comm->X_to_B_SendCnt;
+    for (i = 0; i < 2; ++i)
+        for (p = 0; p < procs; ++p) {
+            cnt[i][  procs + p] = cnt[i][        p] * nrhs; /* SendCnt */
+            cnt[i][3*procs + p] = cnt[i][2*procs + p] * nrhs; /* RecvCnt */
+            cnt[i][5*procs + p] = cnt[i][4*procs + p] * nrhs; /* sdispls */
+            cnt[i][7*procs + p] = cnt[i][6*procs + p] * nrhs; /* rdispls */
+        }
+    gstrs_comm->nrhs = nrhs;
+}
+
 /*! \brief Diagnostic print of segment info after panel_dfs().
  */
 void print_panel_seg_dist(int_t n, int_t w, int_t jcol, int_t nseg,
@@ -356,6 +394,8 @@ void PStatInit(SuperLUStat_t *stat)
     stat->TinyPivots = stat->RefineSteps = 0;
     stat->current_buffer = stat->peak_buffer = 0.0;
     stat->gpu_buffer = 0.0;
+    stat->fact_comm_bytes = stat->solve_comm_bytes = 0.0;
+    stat->forest_imbalance = 0.0;
 }
 
 void PStatClear(SuperLUStat_t *stat)
@@ -370,6 +410,8 @@ void PStatClear(SuperLUStat_t *stat)
     stat->TinyPivots = stat->RefineSteps = 0;
     stat->current_buffer = stat->peak_buffer = 0.0;
     stat->gpu_buffer = 0.0;
+    stat->fact_comm_bytes = stat->solve_comm_bytes = 0.0;
+    stat->forest_imbalance = 0.0;
 }
 
 void PStatPrint(superlu_dist_options_t *options, SuperLUStat_t *stat, gridinfo_t *grid)
@@ -377,7 +419,7 @@ void PStatPrint(superlu_dist_options_t *options, SuperLUStat_t *stat, gridinfo_t
     double *utime = stat->utime;
     flops_t *ops = stat->ops;
     int_t iam = grid->iam;
-    flops_t factflop, solveflop;
+    double flop, factflop, solveflop;
 
     if (options->PrintStat == NO)
         return;
@@ -396,7 +438,9 @@ void PStatPrint(superlu_dist_options_t *options, SuperLUStat_t *stat, gridinfo_t
 	printf("\tDISTRIBUTE time    %8.3f\n", utime[DIST]);
     }
 
-    MPI_Reduce(&ops[FACT], &factflop, 1, MPI_FLOAT, MPI_SUM,
+    /* Sum in double precision; flops_t is float. */
+    flop = ops[FACT];
+    MPI_Reduce(&flop, &factflop, 1, MPI_DOUBLE, MPI_SUM,
                0, grid->comm);
     if ( !iam && options->Fact != FACTORED ) {
 	printf("\tFACTOR time        %8.3f\n", utime[FACT]);
@@ -404,9 +448,13 @@ void PStatPrint(superlu_dist_options_t *options, SuperLUStat_t *stat, gridinfo_t
 	    printf("\tFactor flops\t%e\tMflops \t%8.2f\n",
 		   factflop,
 		   factflop*1e-6/utime[FACT]);
+	if ( stat->forest_imbalance > 0.0 )
+	    printf("\tForest imbalance   %8.3f (predicted)\n",
+		   stat->forest_imbalance);
     }
 
-    MPI_Reduce(&ops[SOLVE], &solveflop, 1, MPI_FLOAT, MPI_SUM,
+    flop = ops[SOLVE];
+    MPI_Reduce(&flop, &solveflop, 1, MPI_DOUBLE, MPI_SUM,
                0, grid->comm);
     if (!iam)
     {
@@ -1303,7 +1351,7 @@ int_t **getTreePerm(int_t *myTreeIdxs, int_t *myZeroTrIdxs,
                     int_t *perm_c_supno, int_t *iperm_c_supno,
                     gridinfo3d_t *grid3d)
 {
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t **treePerm = SUPERLU_MALLOC(sizeof(int_t *) * maxLvl);
     for (int_t lvl = 0; lvl < maxLvl; lvl++)
@@ -1369,8 +1417,8 @@ int_t reduceStat(PhaseType PHASE,
 {
     flops_t *ops = stat->ops;
 
-    flops_t flopcnt;
-    MPI_Reduce(&ops[PHASE], &flopcnt, 1, MPI_FLOAT, MPI_SUM, 0, grid3d->zscp.comm);
+    double flop = ops[PHASE], flopcnt;
+    MPI_Reduce(&flop, &flopcnt, 1, MPI_DOUBLE, MPI_SUM, 0, grid3d->zscp.comm);
 
     if (!grid3d->zscp.Iam)
     {
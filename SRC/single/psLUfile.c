@@ -0,0 +1,764 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+/*! @file
+ * \brief Save the distributed LU factors to disk and load them back
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * Each process writes its local part of L and U, the supernode
+ * partition, the permutations and scalings, and the communication
+ * schedule of the triangular solves to the file "<prefix>.<iam>".
+ * See superlu_LUfile_header_t in superlu_defs.h for the layout.
+ * </pre>
+ */
+
+#include "superlu_sdefs.h"
+
+/* Release what psLoadLU() or psMapLU() allocated before it failed. */
+static void sLUfile_free(int_t nsupers, gridinfo_t *grid,
+                         sScalePermstruct_t *ScalePermstruct,
+                         sLUstruct_t *LUstruct)
+{
+    Glu_persist_t *Glu_persist = LUstruct->Glu_persist;
+    sLocalLU_t *Llu = LUstruct->Llu;
+    int_t i, nlb = CEILING(nsupers, grid->nprow);
+
+    SUPERLU_FREE(Glu_persist->xsup);
+    SUPERLU_FREE(Glu_persist->supno);
+    if ( ScalePermstruct->DiagScale == ROW || ScalePermstruct->DiagScale == BOTH )
+	SUPERLU_FREE(ScalePermstruct->R);
+    if ( ScalePermstruct->DiagScale == COL || ScalePermstruct->DiagScale == BOTH )
+	SUPERLU_FREE(ScalePermstruct->C);
+    ScalePermstruct->DiagScale = NOEQUIL;
+
+    SUPERLU_FREE(Llu->ilsum);
+    SUPERLU_FREE(Llu->ToRecv);
+    SUPERLU_FREE(Llu->ToSendD);
+    SUPERLU_FREE(Llu->ToSendR[0]);
+    SUPERLU_FREE(Llu->ToSendR);
+    SUPERLU_FREE(Llu->fmod);
+    SUPERLU_FREE(Llu->bmod);
+    SUPERLU_FREE(Llu->fsendx_plist[0]);
+    SUPERLU_FREE(Llu->fsendx_plist);
+    SUPERLU_FREE(Llu->bsendx_plist[0]);
+    SUPERLU_FREE(Llu->bsendx_plist);
+    SUPERLU_FREE(Llu->Unnz);
+
+    SUPERLU_FREE(Llu->Lrowind_bc_ptr);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Lrowind_bc_dat);
+    SUPERLU_FREE(Llu->Lrowind_bc_offset);
+    SUPERLU_FREE(Llu->Lnzval_bc_ptr);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Lnzval_bc_dat);
+    SUPERLU_FREE(Llu->Lnzval_bc_offset);
+    SUPERLU_FREE(Llu->Lindval_loc_bc_ptr);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Lindval_loc_bc_dat);
+    SUPERLU_FREE(Llu->Lindval_loc_bc_offset);
+    SUPERLU_FREE(Llu->Linv_bc_ptr);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Linv_bc_dat);
+    SUPERLU_FREE(Llu->Linv_bc_offset);
+    SUPERLU_FREE(Llu->Uinv_bc_ptr);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Uinv_bc_dat);
+    SUPERLU_FREE(Llu->Uinv_bc_offset);
+
+    for (i = 0; i < nlb && !Llu->LUfile_map; ++i) {
+	if ( Llu->Ufstnz_br_ptr[i] ) SUPERLU_FREE(Llu->Ufstnz_br_ptr[i]);
+	if ( Llu->Unzval_br_ptr[i] ) SUPERLU_FREE(Llu->Unzval_br_ptr[i]);
+    }
+    SUPERLU_FREE(Llu->Ufstnz_br_ptr);
+    SUPERLU_FREE(Llu->Unzval_br_ptr);
+
+    superlu_LUfile_unmap(Llu->LUfile_map, Llu->LUfile_map_size);
+    Llu->LUfile_map = NULL;
+}
+
+/* Allocate one flattened L array and, if no error occurred so far,
+   read it: the offset[nub] section followed by the data section.
+   The data array gets one extra entry as safe guard, the same as in
+   psflatten_LDATA(). If the file is mapped at 'map', the data section
+   is used in place. */
+static int sLUfile_read_flat(FILE *fp, char *map, superlu_LUfile_header_t *hdr,
+                             int sect, size_t esize, int_t nub, int info,
+                             long int **offset, void **dat, long int *cnt)
+{
+    *cnt = hdr->sect_len[sect+1] / esize;
+    if ( !(*offset = (long int *) SUPERLU_MALLOC(nub * sizeof(long int))) )
+	ABORT("Malloc fails for offset[].");
+    if ( map )
+	*dat = map + hdr->sect_off[sect+1];
+    else if ( !(*dat = SUPERLU_MALLOC((*cnt + 1) * esize)) )
+	ABORT("Malloc fails for dat[].");
+    if ( !info )
+	info = superlu_LUfile_read(fp, hdr, sect, 0, *offset, nub * sizeof(long int));
+    if ( !info && !map )
+	info = superlu_LUfile_read(fp, hdr, sect+1, 0, *dat, *cnt * esize);
+    return info;
+}
+
+/*! \brief Save the distributed LU factors of this process to disk.
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * psSaveLU() writes the output of a factorization by psgssvx() to the
+ * file "<prefix>.<iam>" of each process, so that a later run on the same
+ * process grid can call psLoadLU() and then psgssvx() with
+ * options->Fact = FACTORED, without refactoring A.
+ *
+ * This routine must be called by all processes in the grid.
+ *
+ * Arguments
+ * =========
+ *
+ * prefix (input) char*
+ *        Name of the per-process files, which are "<prefix>.<iam>".
+ *
+ * n      (input) int_t
+ *        Dimension of the matrix.
+ *
+ * ScalePermstruct (input) sScalePermstruct_t*
+ *        Scaling and permutations computed by psgssvx().
+ *
+ * LUstruct (input) sLUstruct_t*
+ *        Distributed L and U factors computed by psgssvx().
+ *
+ * grid   (input) gridinfo_t*
+ *        The 2D process mesh.
+ *
+ * Return value
+ * ============
+ *   = 0: successful exit
+ *   = 1: a process could not create its file
+ *   = 2: I/O error on some process
+ *   = 7: LUstruct does not hold factors in the layout of psgssvx()
+ * The same value is returned on all processes.
+ * </pre>
+ */
+int psSaveLU(char *prefix, int_t n, sScalePermstruct_t *ScalePermstruct,
+             sLUstruct_t *LUstruct, gridinfo_t *grid)
+{
+    Glu_persist_t *Glu_persist = LUstruct->Glu_persist;
+    sLocalLU_t *Llu = LUstruct->Llu;
+    superlu_LUfile_header_t hdr;
+    FILE *fp = NULL;
+    long int *Ufstnz_offset, *Unzval_offset, Ufstnz_cnt = 0, Unzval_cnt = 0;
+    int_t nsupers, nlb, nub, lk, *usub;
+    int_t nprow = grid->nprow, npcol = grid->npcol;
+    size_t isz = sizeof(int_t), dsz = sizeof(float), nsz = sizeof(int);
+    size_t lsz = sizeof(long int), rsz = sizeof(ScalePermstruct->R[0]);
+    DiagScale_t DiagScale = ScalePermstruct->DiagScale;
+    int i, info = 0, ginfo;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Enter psSaveLU()");
+#endif
+
+    nsupers = Glu_persist->supno[n-1] + 1;
+    nlb = CEILING( nsupers, nprow ); /* Number of local block rows */
+    nub = CEILING( nsupers, npcol ); /* Number of local block columns */
+
+    if ( !Llu->Lrowind_bc_offset || !Llu->Lnzval_bc_offset ) info = 7;
+
+    /* Offsets of the U blocks in the concatenated U sections. */
+    if ( !(Ufstnz_offset = (long int *) SUPERLU_MALLOC(2 * nlb * lsz)) )
+	ABORT("Malloc fails for Ufstnz_offset[].");
+    Unzval_offset = Ufstnz_offset + nlb;
+    for (lk = 0; lk < nlb; ++lk) {
+	if ( (usub = Llu->Ufstnz_br_ptr[lk]) ) {
+	    Ufstnz_offset[lk] = Ufstnz_cnt;
+	    Unzval_offset[lk] = Unzval_cnt;
+	    Ufstnz_cnt += usub[2]; /* Total length of index[] */
+	    Unzval_cnt += usub[1]; /* Total length of nzval[] */
+	} else {
+	    Ufstnz_offset[lk] = -1;
+	    Unzval_offset[lk] = -1;
+	}
+    }
+
+    superlu_LUfile_init_header(&hdr, 's', n, nsupers, grid);
+    hdr.DiagScale = DiagScale;
+    hdr.inv = Llu->inv;
+    hdr.nfrecvx = Llu->nfrecvx;
+    hdr.nfsendx = Llu->nfsendx;
+    hdr.nbrecvx = Llu->nbrecvx;
+    hdr.nbsendx = Llu->nbsendx;
+    hdr.ldalsum = Llu->ldalsum;
+    for (i = 0; i < NBUFFERS; ++i) hdr.bufmax[i] = Llu->bufmax[i];
+
+    hdr.sect_len[LUFILE_XSUP] = (nsupers + 1) * isz;
+    hdr.sect_len[LUFILE_SUPNO] = n * isz;
+    hdr.sect_len[LUFILE_ETREE] = n * isz;
+    hdr.sect_len[LUFILE_PERM_R] = n * isz;
+    hdr.sect_len[LUFILE_PERM_C] = n * isz;
+    if ( DiagScale == ROW || DiagScale == BOTH )
+	hdr.sect_len[LUFILE_R] = n * rsz;
+    if ( DiagScale == COL || DiagScale == BOTH )
+	hdr.sect_len[LUFILE_C] = n * rsz;
+    hdr.sect_len[LUFILE_ILSUM] = (nlb + 1) * isz;
+    hdr.sect_len[LUFILE_TORECV] = nsupers * nsz;
+    hdr.sect_len[LUFILE_TOSENDD] = nlb * nsz;
+    hdr.sect_len[LUFILE_TOSENDR] = nub * npcol * nsz;
+    hdr.sect_len[LUFILE_FMOD] = nlb * nsz;
+    hdr.sect_len[LUFILE_BMOD] = nlb * nsz;
+    hdr.sect_len[LUFILE_FSENDX] = nub * nprow * nsz;
+    hdr.sect_len[LUFILE_BSENDX] = nub * nprow * nsz;
+    hdr.sect_len[LUFILE_UNNZ] = nub * isz;
+    if ( !info ) {
+	hdr.sect_len[LUFILE_LROWIND_OFF] = nub * lsz;
+	hdr.sect_len[LUFILE_LROWIND] = Llu->Lrowind_bc_cnt * isz;
+	hdr.sect_len[LUFILE_LNZVAL_OFF] = nub * lsz;
+	hdr.sect_len[LUFILE_LNZVAL] = Llu->Lnzval_bc_cnt * dsz;
+	hdr.sect_len[LUFILE_LINDVAL_OFF] = nub * lsz;
+	hdr.sect_len[LUFILE_LINDVAL] = Llu->Lindval_loc_bc_cnt * isz;
+	hdr.sect_len[LUFILE_LINV_OFF] = nub * lsz;
+	hdr.sect_len[LUFILE_LINV] = Llu->Linv_bc_cnt * dsz;
+	hdr.sect_len[LUFILE_UINV_OFF] = nub * lsz;
+	hdr.sect_len[LUFILE_UINV] = Llu->Uinv_bc_cnt * dsz;
+    }
+    hdr.sect_len[LUFILE_UFSTNZ_OFF] = nlb * lsz;
+    hdr.sect_len[LUFILE_UFSTNZ] = Ufstnz_cnt * isz;
+    hdr.sect_len[LUFILE_UNZVAL_OFF] = nlb * lsz;
+    hdr.sect_len[LUFILE_UNZVAL] = Unzval_cnt * dsz;
+    superlu_LUfile_layout(&hdr);
+
+    if ( !info && !(fp = superlu_LUfile_open(prefix, grid->iam, "wb")) )
+	info = 1;
+
+    if ( !info ) {
+	if ( fwrite(&hdr, sizeof(hdr), 1, fp) != 1 ) info = 2;
+#define WRITE_SECT(sect, buf) \
+	if ( !info ) info = superlu_LUfile_write(fp, &hdr, sect, 0, buf, hdr.sect_len[sect])
+	WRITE_SECT(LUFILE_XSUP, Glu_persist->xsup);
+	WRITE_SECT(LUFILE_SUPNO, Glu_persist->supno);
+	WRITE_SECT(LUFILE_ETREE, LUstruct->etree);
+	WRITE_SECT(LUFILE_PERM_R, ScalePermstruct->perm_r);
+	WRITE_SECT(LUFILE_PERM_C, ScalePermstruct->perm_c);
+	WRITE_SECT(LUFILE_R, ScalePermstruct->R);
+	WRITE_SECT(LUFILE_C, ScalePermstruct->C);
+	WRITE_SECT(LUFILE_ILSUM, Llu->ilsum);
+	WRITE_SECT(LUFILE_TORECV, Llu->ToRecv);
+	WRITE_SECT(LUFILE_TOSENDD, Llu->ToSendD);
+	WRITE_SECT(LUFILE_TOSENDR, Llu->ToSendR[0]);
+	WRITE_SECT(LUFILE_FMOD, Llu->fmod);
+	WRITE_SECT(LUFILE_BMOD, Llu->bmod);
+	WRITE_SECT(LUFILE_FSENDX, Llu->fsendx_plist[0]);
+	WRITE_SECT(LUFILE_BSENDX, Llu->bsendx_plist[0]);
+	WRITE_SECT(LUFILE_UNNZ, Llu->Unnz);
+	WRITE_SECT(LUFILE_LROWIND_OFF, Llu->Lrowind_bc_offset);
+	WRITE_SECT(LUFILE_LROWIND, Llu->Lrowind_bc_dat);
+	WRITE_SECT(LUFILE_LNZVAL_OFF, Llu->Lnzval_bc_offset);
+	WRITE_SECT(LUFILE_LNZVAL, Llu->Lnzval_bc_dat);
+	WRITE_SECT(LUFILE_LINDVAL_OFF, Llu->Lindval_loc_bc_offset);
+	WRITE_SECT(LUFILE_LINDVAL, Llu->Lindval_loc_bc_dat);
+	WRITE_SECT(LUFILE_LINV_OFF, Llu->Linv_bc_offset);
+	WRITE_SECT(LUFILE_LINV, Llu->Linv_bc_dat);
+	WRITE_SECT(LUFILE_UINV_OFF, Llu->Uinv_bc_offset);
+	WRITE_SECT(LUFILE_UINV, Llu->Uinv_bc_dat);
+	WRITE_SECT(LUFILE_UFSTNZ_OFF, Ufstnz_offset);
+	WRITE_SECT(LUFILE_UNZVAL_OFF, Unzval_offset);
+#undef WRITE_SECT
+
+	/* U is stored block by block. */
+	for (lk = 0; lk < nlb && !info; ++lk) {
+	    if ( (usub = Llu->Ufstnz_br_ptr[lk]) ) {
+		info = superlu_LUfile_write(fp, &hdr, LUFILE_UFSTNZ,
+			   Ufstnz_offset[lk] * isz, usub, usub[2] * isz);
+		if ( !info )
+		    info = superlu_LUfile_write(fp, &hdr, LUFILE_UNZVAL,
+			       Unzval_offset[lk] * dsz, Llu->Unzval_br_ptr[lk],
+			       usub[1] * dsz);
+	    }
+	}
+	if ( fclose(fp) && !info ) info = 2;
+    }
+
+    SUPERLU_FREE(Ufstnz_offset);
+
+    MPI_Allreduce(&info, &ginfo, 1, MPI_INT, MPI_MAX, grid->comm);
+#if ( PRNTlevel>=1 )
+    if ( info ) printf("(%d) psSaveLU: error %d writing %s.%d\n",
+		       grid->iam, info, prefix, grid->iam);
+#endif
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Exit psSaveLU()");
+#endif
+    return ginfo;
+} /* psSaveLU */
+
+/* Common part of psLoadLU() and psMapLU(). */
+static int sLUfile_load(char *prefix, int_t n, superlu_dist_options_t *options,
+                        sScalePermstruct_t *ScalePermstruct,
+                        sLUstruct_t *LUstruct, gridinfo_t *grid,
+                        SuperLUStat_t *stat, int map_file)
+{
+    Glu_persist_t *Glu_persist = LUstruct->Glu_persist;
+    sLocalLU_t *Llu = LUstruct->Llu;
+    superlu_LUfile_header_t hdr;
+    FILE *fp;
+    long int *Ufstnz_offset, *Unzval_offset;
+    int_t nsupers, nlb, nub, lk, lb, ljb, k, i, j;
+    int_t *usub1, *Urbs, *Urbs1, *xsup, usub_hdr[BR_HEADER];
+    Ucb_indptr_t **Ucb_indptr;
+    int_t **Ucb_valptr;
+    int_t nprow = grid->nprow, npcol = grid->npcol;
+    size_t isz = sizeof(int_t), dsz = sizeof(float), nsz = sizeof(int);
+    size_t lsz = sizeof(long int);
+    int *index1, *supernodeMask;
+    int info = 0, ginfo;
+    char *map = NULL;
+    size_t map_size = 0;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Enter sLUfile_load()");
+#endif
+
+    if ( !(fp = superlu_LUfile_open(prefix, grid->iam, "rb")) ) info = 1;
+    else if ( fread(&hdr, sizeof(hdr), 1, fp) != 1 ) info = 2;
+    else info = superlu_LUfile_check_header(&hdr, 's', n, grid);
+    if ( !info ) info = superlu_LUfile_check_sections(fp, &hdr);
+    if ( !info && map_file ) {
+	if ( !(map = (char *) superlu_LUfile_map(prefix, grid->iam, &map_size)) )
+	    info = 1;
+	else if ( hdr.sect_off[LUFILE_NSECT-1] + hdr.sect_len[LUFILE_NSECT-1]
+		  > (int64_t) map_size )
+	    info = 2;
+    }
+
+    MPI_Allreduce(&info, &ginfo, 1, MPI_INT, MPI_MAX, grid->comm);
+    if ( ginfo ) {
+#if ( PRNTlevel>=1 )
+	if ( info ) printf("(%d) psLoadLU: error %d reading %s.%d\n",
+			   grid->iam, info, prefix, grid->iam);
+#endif
+	if ( fp ) fclose(fp);
+	superlu_LUfile_unmap(map, map_size);
+	return ginfo;
+    }
+    Llu->LUfile_map = map;
+    Llu->LUfile_map_size = map_size;
+
+    nsupers = hdr.nsupers;
+    nlb = CEILING( nsupers, nprow ); /* Number of local block rows */
+    nub = CEILING( nsupers, npcol ); /* Number of local block columns */
+
+    /* Supernode partition, permutations and scalings. */
+    if ( !(Glu_persist->xsup = intMalloc_dist(nsupers+1)) )
+	ABORT("Malloc fails for xsup[].");
+    if ( !(Glu_persist->supno = intMalloc_dist(n)) )
+	ABORT("Malloc fails for supno[].");
+    info = superlu_LUfile_read(fp, &hdr, LUFILE_XSUP, 0, Glu_persist->xsup,
+			       (nsupers + 1) * isz);
+    if ( !info ) info = superlu_LUfile_read(fp, &hdr, LUFILE_SUPNO, 0,
+					    Glu_persist->supno, n * isz);
+    if ( !info ) info = superlu_LUfile_read(fp, &hdr, LUFILE_ETREE, 0,
+					    LUstruct->etree, n * isz);
+    if ( !info ) info = superlu_LUfile_read(fp, &hdr, LUFILE_PERM_R, 0,
+					    ScalePermstruct->perm_r, n * isz);
+    if ( !info ) info = superlu_LUfile_read(fp, &hdr, LUFILE_PERM_C, 0,
+					    ScalePermstruct->perm_c, n * isz);
+    ScalePermstruct->DiagScale = (DiagScale_t) hdr.DiagScale;
+    if ( hdr.DiagScale == ROW || hdr.DiagScale == BOTH ) {
+	if ( !(ScalePermstruct->R = floatMalloc_dist(n)) )
+	    ABORT("Malloc fails for R[].");
+	if ( !info ) info = superlu_LUfile_read(fp, &hdr, LUFILE_R, 0,
+		     ScalePermstruct->R, n * sizeof(ScalePermstruct->R[0]));
+    }
+    if ( hdr.DiagScale == COL || hdr.DiagScale == BOTH ) {
+	if ( !(ScalePermstruct->C = floatMalloc_dist(n)) )
+	    ABORT("Malloc fails for C[].");
+	if ( !info ) info = superlu_LUfile_read(fp, &hdr, LUFILE_C, 0,
+		     ScalePermstruct->C, n * sizeof(ScalePermstruct->C[0]));
+    }
+
+    /* Communication schedule. */
+    if ( !(Llu->ilsum = intMalloc_dist(nlb+1)) )
+	ABORT("Malloc fails for ilsum[].");
+    if ( !(Llu->ToRecv = int32Malloc_dist(nsupers)) )
+	ABORT("Malloc fails for ToRecv[].");
+    if ( !(Llu->ToSendD = int32Malloc_dist(nlb)) )
+	ABORT("Malloc fails for ToSendD[].");
+    if ( !(Llu->ToSendR = (int **) SUPERLU_MALLOC(nub*sizeof(int*))) )
+	ABORT("Malloc fails for ToSendR[].");
+    if ( !(index1 = int32Malloc_dist(nub * npcol)) )
+	ABORT("Malloc fails for ToSendR[0]");
+    for (lk = 0; lk < nub; ++lk) Llu->ToSendR[lk] = &index1[lk * npcol];
+    if ( !(Llu->fmod = int32Malloc_dist(nlb)) )
+	ABORT("Malloc fails for fmod[].");
+    if ( !(Llu->bmod = int32Malloc_dist(nlb)) )
+	ABORT("Malloc fails for bmod[].");
+    if ( !(Llu->fsendx_plist = (int **) SUPERLU_MALLOC(nub*sizeof(int*))) )
+	ABORT("Malloc fails for fsendx_plist[].");
+    if ( !(index1 = int32Malloc_dist(nub * nprow)) )
+	ABORT("Malloc fails for fsendx_plist[0]");
+    for (lk = 0; lk < nub; ++lk) Llu->fsendx_plist[lk] = &index1[lk * nprow];
+    if ( !(Llu->bsendx_plist = (int **) SUPERLU_MALLOC(nub*sizeof(int*))) )
+	ABORT("Malloc fails for bsendx_plist[].");
+    if ( !(index1 = int32Malloc_dist(nub * nprow)) )
+	ABORT("Malloc fails for bsendx_plist[0]");
+    for (lk = 0; lk < nub; ++lk) Llu->bsendx_plist[lk] = &index1[lk * nprow];
+    if ( !(Llu->Unnz = intMalloc_dist(nub)) )
+	ABORT("Malloc fails for Unnz[].");
+
+#define READ_SECT(sect, buf, nbytes) \
+    if ( !info ) info = superlu_LUfile_read(fp, &hdr, sect, 0, buf, nbytes)
+    READ_SECT(LUFILE_ILSUM, Llu->ilsum, (nlb + 1) * isz);
+    READ_SECT(LUFILE_TORECV, Llu->ToRecv, nsupers * nsz);
+    READ_SECT(LUFILE_TOSENDD, Llu->ToSendD, nlb * nsz);
+    READ_SECT(LUFILE_TOSENDR, Llu->ToSendR[0], nub * npcol * nsz);
+    READ_SECT(LUFILE_FMOD, Llu->fmod, nlb * nsz);
+    READ_SECT(LUFILE_BMOD, Llu->bmod, nlb * nsz);
+    READ_SECT(LUFILE_FSENDX, Llu->fsendx_plist[0], nub * nprow * nsz);
+    READ_SECT(LUFILE_BSENDX, Llu->bsendx_plist[0], nub * nprow * nsz);
+    READ_SECT(LUFILE_UNNZ, Llu->Unnz, nub * isz);
+#undef READ_SECT
+
+    /* L is stored in the flattened form of psflatten_LDATA(). */
+    info = sLUfile_read_flat(fp, map, &hdr, LUFILE_LROWIND_OFF, isz, nub, info,
+			     &Llu->Lrowind_bc_offset, (void **) &Llu->Lrowind_bc_dat,
+			     &Llu->Lrowind_bc_cnt);
+    info = sLUfile_read_flat(fp, map, &hdr, LUFILE_LNZVAL_OFF, dsz, nub, info,
+			     &Llu->Lnzval_bc_offset, (void **) &Llu->Lnzval_bc_dat,
+			     &Llu->Lnzval_bc_cnt);
+    info = sLUfile_read_flat(fp, map, &hdr, LUFILE_LINDVAL_OFF, isz, nub, info,
+			     &Llu->Lindval_loc_bc_offset,
+			     (void **) &Llu->Lindval_loc_bc_dat,
+			     &Llu->Lindval_loc_bc_cnt);
+    info = sLUfile_read_flat(fp, map, &hdr, LUFILE_LINV_OFF, dsz, nub, info,
+			     &Llu->Linv_bc_offset, (void **) &Llu->Linv_bc_dat,
+			     &Llu->Linv_bc_cnt);
+    info = sLUfile_read_flat(fp, map, &hdr, LUFILE_UINV_OFF, dsz, nub, info,
+			     &Llu->Uinv_bc_offset, (void **) &Llu->Uinv_bc_dat,
+			     &Llu->Uinv_bc_cnt);
+    if ( !(Llu->Lrowind_bc_ptr = (int_t**)SUPERLU_MALLOC(nub * sizeof(int_t*))) )
+	ABORT("Malloc fails for Lrowind_bc_ptr[].");
+    if ( !(Llu->Lnzval_bc_ptr = (float**)SUPERLU_MALLOC(nub * sizeof(float*))) )
+	ABORT("Malloc fails for Lnzval_bc_ptr[].");
+    if ( !(Llu->Lindval_loc_bc_ptr = (int_t**)SUPERLU_MALLOC(nub * sizeof(int_t*))) )
+	ABORT("Malloc fails for Lindval_loc_bc_ptr[].");
+    if ( !(Llu->Linv_bc_ptr = (float**)SUPERLU_MALLOC(nub * sizeof(float*))) )
+	ABORT("Malloc fails for Linv_bc_ptr[].");
+    if ( !(Llu->Uinv_bc_ptr = (float**)SUPERLU_MALLOC(nub * sizeof(float*))) )
+	ABORT("Malloc fails for Uinv_bc_ptr[].");
+    for (lk = 0; lk < nub; ++lk) {
+	Llu->Lrowind_bc_ptr[lk] = NULL;
+	Llu->Lnzval_bc_ptr[lk] = NULL;
+	Llu->Lindval_loc_bc_ptr[lk] = NULL;
+	Llu->Linv_bc_ptr[lk] = NULL;
+	Llu->Uinv_bc_ptr[lk] = NULL;
+	if ( info ) continue;
+	if ( Llu->Lrowind_bc_offset[lk] >= Llu->Lrowind_bc_cnt
+	     || Llu->Lnzval_bc_offset[lk] >= Llu->Lnzval_bc_cnt
+	     || Llu->Lindval_loc_bc_offset[lk] >= Llu->Lindval_loc_bc_cnt
+	     || Llu->Linv_bc_offset[lk] >= Llu->Linv_bc_cnt
+	     || Llu->Uinv_bc_offset[lk] >= Llu->Uinv_bc_cnt ) {
+	    info = 2;
+	    continue;
+	}
+	if ( Llu->Lrowind_bc_offset[lk] >= 0 )
+	    Llu->Lrowind_bc_ptr[lk] = &Llu->Lrowind_bc_dat[Llu->Lrowind_bc_offset[lk]];
+	if ( Llu->Lnzval_bc_offset[lk] >= 0 )
+	    Llu->Lnzval_bc_ptr[lk] = &Llu->Lnzval_bc_dat[Llu->Lnzval_bc_offset[lk]];
+	if ( Llu->Lindval_loc_bc_offset[lk] >= 0 )
+	    Llu->Lindval_loc_bc_ptr[lk] = &Llu->Lindval_loc_bc_dat[Llu->Lindval_loc_bc_offset[lk]];
+	if ( Llu->Linv_bc_offset[lk] >= 0 )
+	    Llu->Linv_bc_ptr[lk] = &Llu->Linv_bc_dat[Llu->Linv_bc_offset[lk]];
+	if ( Llu->Uinv_bc_offset[lk] >= 0 )
+	    Llu->Uinv_bc_ptr[lk] = &Llu->Uinv_bc_dat[Llu->Uinv_bc_offset[lk]];
+    }
+
+    /* U is allocated block by block, as in psdistribute(), unless
+       the blocks are used in place in the mapped file. */
+    if ( !(Llu->Ufstnz_br_ptr = (int_t**)SUPERLU_MALLOC(nlb * sizeof(int_t*))) )
+	ABORT("Malloc fails for Ufstnz_br_ptr[].");
+    if ( !(Llu->Unzval_br_ptr = (float**)SUPERLU_MALLOC(nlb * sizeof(float*))) )
+	ABORT("Malloc fails for Unzval_br_ptr[].");
+    if ( !(Ufstnz_offset = (long int *) SUPERLU_MALLOC(2 * nlb * lsz)) )
+	ABORT("Malloc fails for Ufstnz_offset[].");
+    Unzval_offset = Ufstnz_offset + nlb;
+    if ( !info ) info = superlu_LUfile_read(fp, &hdr, LUFILE_UFSTNZ_OFF, 0,
+					    Ufstnz_offset, nlb * lsz);
+    if ( !info ) info = superlu_LUfile_read(fp, &hdr, LUFILE_UNZVAL_OFF, 0,
+					    Unzval_offset, nlb * lsz);
+    for (lk = 0; lk < nlb; ++lk) {
+	Llu->Ufstnz_br_ptr[lk] = NULL;
+	Llu->Unzval_br_ptr[lk] = NULL;
+	if ( info || Ufstnz_offset[lk] < 0 ) continue;
+	if ( Ufstnz_offset[lk] >= hdr.sect_len[LUFILE_UFSTNZ] / (int64_t) isz
+	     || Unzval_offset[lk] < 0
+	     || Unzval_offset[lk] >= hdr.sect_len[LUFILE_UNZVAL] / (int64_t) dsz ) {
+	    info = 2;
+	    continue;
+	}
+	info = superlu_LUfile_read(fp, &hdr, LUFILE_UFSTNZ, Ufstnz_offset[lk] * isz,
+				   usub_hdr, BR_HEADER * isz);
+	if ( info ) continue;
+	if ( usub_hdr[2] < BR_HEADER || usub_hdr[1] < 0
+	     || usub_hdr[2] > hdr.sect_len[LUFILE_UFSTNZ] / (int64_t) isz
+			      - Ufstnz_offset[lk]
+	     || usub_hdr[1] > hdr.sect_len[LUFILE_UNZVAL] / (int64_t) dsz
+			      - Unzval_offset[lk] ) {
+	    info = 2;
+	    continue;
+	}
+	if ( map ) {
+	    Llu->Ufstnz_br_ptr[lk] = (int_t *) (map + hdr.sect_off[LUFILE_UFSTNZ])
+				     + Ufstnz_offset[lk];
+	    Llu->Unzval_br_ptr[lk] = (float *) (map + hdr.sect_off[LUFILE_UNZVAL])
+				     + Unzval_offset[lk];
+	    continue;
+	}
+	if ( !(Llu->Ufstnz_br_ptr[lk] = intMalloc_dist(usub_hdr[2])) )
+	    ABORT("Malloc fails for Uindex[]");
+	if ( !(Llu->Unzval_br_ptr[lk] = floatMalloc_dist(usub_hdr[1])) )
+	    ABORT("Malloc fails for Unzval_br_ptr[*][]");
+	info = superlu_LUfile_read(fp, &hdr, LUFILE_UFSTNZ, Ufstnz_offset[lk] * isz,
+				   Llu->Ufstnz_br_ptr[lk], usub_hdr[2] * isz);
+	if ( !info )
+	    info = superlu_LUfile_read(fp, &hdr, LUFILE_UNZVAL,
+			 Unzval_offset[lk] * dsz, Llu->Unzval_br_ptr[lk],
+			 usub_hdr[1] * dsz);
+    }
+    SUPERLU_FREE(Ufstnz_offset);
+    fclose(fp);
+
+    MPI_Allreduce(&info, &ginfo, 1, MPI_INT, MPI_MAX, grid->comm);
+    if ( ginfo ) {
+#if ( PRNTlevel>=1 )
+	if ( info ) printf("(%d) psLoadLU: error %d reading %s.%d\n",
+			   grid->iam, info, prefix, grid->iam);
+#endif
+	sLUfile_free(nsupers, grid, ScalePermstruct, LUstruct);
+	return ginfo;
+    }
+
+    Llu->inv = hdr.inv;
+    Llu->nfrecvx = hdr.nfrecvx;
+    Llu->nfsendx = hdr.nfsendx;
+    Llu->nbrecvx = hdr.nbrecvx;
+    Llu->nbsendx = hdr.nbsendx;
+    Llu->ldalsum = hdr.ldalsum;
+    for (i = 0; i < NBUFFERS; ++i) Llu->bufmax[i] = hdr.bufmax[i];
+    if ( !(Llu->mod_bit = int32Malloc_dist(nlb)) )
+	ABORT("Malloc fails for mod_bit[].");
+
+    /* Set up the vertical linked lists for the row blocks of U,
+       the same as in psdistribute(). */
+    xsup = Glu_persist->xsup;
+    if ( !(Urbs = (int_t *) intCalloc_dist(2*nub)) )
+	ABORT("Malloc fails for Urbs[]");
+    Urbs1 = Urbs + nub;
+    if ( !(Ucb_indptr = SUPERLU_MALLOC(nub * sizeof(Ucb_indptr_t *))) )
+	ABORT("Malloc fails for Ucb_indptr[]");
+    if ( !(Ucb_valptr = SUPERLU_MALLOC(nub * sizeof(int_t *))) )
+	ABORT("Malloc fails for Ucb_valptr[]");
+    for (lk = 0; lk < nlb; ++lk) {
+	usub1 = Llu->Ufstnz_br_ptr[lk];
+	if ( usub1 ) { /* Not an empty block row. */
+	    i = BR_HEADER; /* Pointer in index array. */
+	    for (lb = 0; lb < usub1[0]; ++lb) { /* For all column blocks. */
+		k = usub1[i];            /* Global block number */
+		++Urbs[LBj(k,grid)];
+		i += UB_DESCRIPTOR + SuperSize( k );
+	    }
+	}
+    }
+    for (lb = 0; lb < nub; ++lb) {
+	if ( Urbs[lb] ) { /* Not an empty block column. */
+	    if ( !(Ucb_indptr[lb]
+		   = SUPERLU_MALLOC(Urbs[lb] * sizeof(Ucb_indptr_t))) )
+		ABORT("Malloc fails for Ucb_indptr[lb][]");
+	    if ( !(Ucb_valptr[lb] = (int_t *) intMalloc_dist(Urbs[lb])) )
+		ABORT("Malloc fails for Ucb_valptr[lb][]");
+	} else {
+	    Ucb_valptr[lb] = NULL;
+	    Ucb_indptr[lb] = NULL;
+	}
+    }
+    for (lk = 0; lk < nlb; ++lk) { /* For each block row. */
+	usub1 = Llu->Ufstnz_br_ptr[lk];
+	if ( usub1 ) { /* Not an empty block row. */
+	    i = BR_HEADER; /* Pointer in index array. */
+	    j = 0;         /* Pointer in nzval array. */
+	    for (lb = 0; lb < usub1[0]; ++lb) { /* For all column blocks. */
+		k = usub1[i];          /* Global block number, column-wise. */
+		ljb = LBj( k, grid ); /* Local block number, column-wise. */
+		Ucb_indptr[ljb][Urbs1[ljb]].lbnum = lk;
+		Ucb_indptr[ljb][Urbs1[ljb]].indpos = i;
+		Ucb_valptr[ljb][Urbs1[ljb]] = j;
+		++Urbs1[ljb];
+		j += usub1[i+1];
+		i += UB_DESCRIPTOR + SuperSize( k );
+	    }
+	}
+    }
+    Llu->Urbs = Urbs;
+    Llu->Ucb_indptr = Ucb_indptr;
+    Llu->Ucb_valptr = Ucb_valptr;
+
+    LUstruct->trf3Dpart = NULL;
+    LUstruct->dt = 's';
+
+    /* Rebuild the broadcast and reduction trees of the solve. */
+    supernodeMask = int32Malloc_dist(nsupers);
+    for (i = 0; i < nsupers; ++i) supernodeMask[i] = 1;
+    strs_compute_communication_structure(options, n, LUstruct,
+					 ScalePermstruct, supernodeMask, grid, stat);
+    SUPERLU_FREE(supernodeMask);
+
+#ifdef GPU_ACC
+    if ( get_acc_solve() && Llu->inv ) {
+	psconvertU(options, grid, LUstruct, stat, n);
+	checkGPU(gpuMemcpy(Llu->d_Linv_bc_dat, Llu->Linv_bc_dat,
+			   (Llu->Linv_bc_cnt) * sizeof(float), gpuMemcpyHostToDevice));
+	checkGPU(gpuMemcpy(Llu->d_Uinv_bc_dat, Llu->Uinv_bc_dat,
+			   (Llu->Uinv_bc_cnt) * sizeof(float), gpuMemcpyHostToDevice));
+	checkGPU(gpuMemcpy(Llu->d_Lnzval_bc_dat, Llu->Lnzval_bc_dat,
+			   (Llu->Lnzval_bc_cnt) * sizeof(float), gpuMemcpyHostToDevice));
+    }
+#endif
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Exit sLUfile_load()");
+#endif
+    return 0;
+} /* sLUfile_load */
+
+/*! \brief Load the distributed LU factors saved by psSaveLU().
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * psLoadLU() restores ScalePermstruct and LUstruct from the files
+ * "<prefix>.<iam>" written by psSaveLU(), and rebuilds the communication
+ * trees of the triangular solves. On return, psgssvx() can be called
+ * with options->Fact = FACTORED to solve systems with the saved factors.
+ *
+ * The process grid must have the same shape as the one used by
+ * psSaveLU(). This routine must be called by all processes in the grid.
+ *
+ * Arguments
+ * =========
+ *
+ * prefix (input) char*
+ *        Name of the per-process files, which are "<prefix>.<iam>".
+ *
+ * n      (input) int_t
+ *        Dimension of the matrix.
+ *
+ * options (input) superlu_dist_options_t*
+ *        The options used by the subsequent calls to psgssvx().
+ *
+ * ScalePermstruct (input/output) sScalePermstruct_t*
+ *        On entry, initialized by sScalePermstructInit().
+ *        On exit, the saved scaling and permutations.
+ *
+ * LUstruct (input/output) sLUstruct_t*
+ *        On entry, initialized by sLUstructInit().
+ *        On exit, the saved L and U factors, which are released by
+ *        sDestroy_LU() as usual.
+ *
+ * grid   (input) gridinfo_t*
+ *        The 2D process mesh.
+ *
+ * stat   (output) SuperLUStat_t*
+ *        Record the statistics.
+ *
+ * Return value
+ * ============
+ *   = 0: successful exit
+ *   = 1: a process could not open its file
+ *   = 2: I/O error or truncated file on some process
+ *   = 3: not an LU file, or written by an incompatible version
+ *   = 4: precision, sizeof(int_t) or sizeof(long int) differs
+ *   = 5: written on a different process grid
+ *   = 6: dimension of the matrix differs
+ * The same value is returned on all processes. On error, nothing is
+ * allocated in ScalePermstruct and LUstruct.
+ * </pre>
+ */
+int psLoadLU(char *prefix, int_t n, superlu_dist_options_t *options,
+             sScalePermstruct_t *ScalePermstruct, sLUstruct_t *LUstruct,
+             gridinfo_t *grid, SuperLUStat_t *stat)
+{
+    return sLUfile_load(prefix, n, options, ScalePermstruct, LUstruct,
+			grid, stat, 0);
+}
+
+/*! \brief Map the distributed LU factors saved by psSaveLU() into memory.
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * psMapLU() is the same as psLoadLU(), except that the files are mapped
+ * with mmap() instead of being read, and the L and U blocks point
+ * directly into the mapping. No copy of the factors is made: the pages
+ * are read on demand when the triangular solves first touch a
+ * supernode, and processes on the same node mapping the same file
+ * share it through the page cache. The mapping is private, so the file
+ * is never modified; it must not be truncated or rewritten while the
+ * factors are in use.
+ *
+ * LUstruct->Llu->LUfile_map records the mapping, and sDestroy_LU()
+ * unmaps it instead of freeing the L and U blocks. The arguments and
+ * return values are the same as for psLoadLU().
+ * </pre>
+ */
+int psMapLU(char *prefix, int_t n, superlu_dist_options_t *options,
+            sScalePermstruct_t *ScalePermstruct, sLUstruct_t *LUstruct,
+            gridinfo_t *grid, SuperLUStat_t *stat)
+{
+    return sLUfile_load(prefix, n, options, ScalePermstruct, LUstruct,
+			grid, stat, 1);
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * psScalePermA_LUfile() applies the scaling and column permutation in
+ * ScalePermstruct to a freshly read distributed matrix A, giving
+ * diag(R)*A*diag(C)*Pc^T. This is the form in which psgssvx() leaves A
+ * after the factorization, and in which it expects A with
+ * options->Fact = FACTORED when iterative refinement is requested.
+ * Call it after psLoadLU() or psMapLU() and before the first solve.
+ * </pre>
+ */
+void psScalePermA_LUfile(SuperMatrix *A, sScalePermstruct_t *ScalePermstruct)
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    int_t *rowptr = Astore->rowptr, *colind = Astore->colind;
+    int_t *perm_c = ScalePermstruct->perm_c;
+    float *a = (float *) Astore->nzval;
+    float *R = ScalePermstruct->R, *C = ScalePermstruct->C;
+    int_t i, j, irow = Astore->fst_row;
+    int rowequ, colequ;
+
+    rowequ = (ScalePermstruct->DiagScale == ROW) ||
+	     (ScalePermstruct->DiagScale == BOTH);
+    colequ = (ScalePermstruct->DiagScale == COL) ||
+	     (ScalePermstruct->DiagScale == BOTH);
+
+    for (j = 0; j < Astore->m_loc; ++j, ++irow) {
+	for (i = rowptr[j]; i < rowptr[j+1]; ++i) {
+	    if ( rowequ ) a[i] *= R[irow];
+	    if ( colequ ) a[i] *= C[colind[i]];
+	}
+    }
+    for (i = 0; i < Astore->nnz_loc; ++i) colind[i] = perm_c[colind[i]];
+}
@@ -325,6 +325,250 @@ sReDistribute_A(SuperMatrix *A, sScalePermstruct_t *ScalePermstruct,
     return 0;
 } /* sReDistribute_A */
 
+/*! \brief Build the map of the local nonzeros of A into the L and U
+ *  factors, for the refactorizations with Fact = SamePattern_SameRowPerm.
+ *
+ * <pre>
+ * The nonzeros are routed as in sReDistribute_A(): the entry A(i,j) goes
+ * to the process owning block (BlockNum(perm_c[perm_r[i]]), BlockNum(j)).
+ * Their (row, column) indices are sent once here, and their positions
+ * in Lnzval_bc_ptr[] and Unzval_br_ptr[] are found on the receiver,
+ * so that sAmap_scatter() only needs to send the values.
+ * </pre>
+ */
+static sAmap_t *
+sAmap_build(SuperMatrix *A, sScalePermstruct_t *ScalePermstruct,
+            sLUstruct_t *LUstruct, gridinfo_t *grid)
+{
+    Glu_persist_t *Glu_persist = LUstruct->Glu_persist;
+    sLocalLU_t *Llu = LUstruct->Llu;
+    int_t  *xsup = Glu_persist->xsup;
+    int_t  *supno = Glu_persist->supno;
+    int_t  *perm_r = ScalePermstruct->perm_r;
+    int_t  *perm_c = ScalePermstruct->perm_c;
+    int_t  *ilsum = Llu->ilsum;
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    sAmap_t *Amap;
+    int_t  i, j, k, irow, jcol, gb, jb, lb, ljb, n, nnz_loc, nsupers, nrbu;
+    int_t  fsupc, fsupc1, istart, len, jj, nrbl, nsupc;
+    int_t  *ptr, *sidx, *ridx, *colptr, *order, *index, *rpos;
+    int_t  *Urb_length, *Urb_indptr;
+    int    iam, p, procs, mycol, *cnt2, *displs2;
+
+    iam = grid->iam;
+    mycol = MYCOL( iam, grid );
+    procs = grid->nprow * grid->npcol;
+    n = A->ncol;
+    nnz_loc = Astore->nnz_loc;
+    nsupers = supno[n-1] + 1;
+
+    if ( !(Amap = (sAmap_t *) SUPERLU_MALLOC(sizeof(sAmap_t))) )
+	ABORT("Malloc fails for Amap.");
+    Amap->nnz_loc = nnz_loc;
+    Amap->m_loc = Astore->m_loc;
+    Amap->fst_row = Astore->fst_row;
+    if ( !(Amap->sendcnt = int32Calloc_dist(4*procs)) )
+	ABORT("Calloc fails for Amap->sendcnt[].");
+    Amap->sdispls = Amap->sendcnt + procs;
+    Amap->recvcnt = Amap->sdispls + procs;
+    Amap->rdispls = Amap->recvcnt + procs;
+    if ( !(Amap->sendpos = intMalloc_dist(SUPERLU_MAX(nnz_loc, 1))) )
+	ABORT("Malloc fails for Amap->sendpos[].");
+    if ( !(Amap->sendbuf = floatMalloc_dist(SUPERLU_MAX(nnz_loc, 1))) )
+	ABORT("Malloc fails for Amap->sendbuf[].");
+
+    /* Count the nonzeros to be sent to each process. */
+    for (i = 0; i < Astore->m_loc; ++i) {
+	irow = perm_c[perm_r[i+Astore->fst_row]];  /* Row number in Pc*Pr*A */
+	for (j = Astore->rowptr[i]; j < Astore->rowptr[i+1]; ++j) {
+	    jcol = Astore->colind[j];
+	    p = PNUM( PROW(BlockNum(irow),grid), PCOL(BlockNum(jcol),grid), grid );
+	    ++Amap->sendcnt[p];
+	}
+    }
+    MPI_Alltoall(Amap->sendcnt, 1, MPI_INT, Amap->recvcnt, 1, MPI_INT,
+		 grid->comm);
+    for (p = 1; p < procs; ++p) {
+	Amap->sdispls[p] = Amap->sdispls[p-1] + Amap->sendcnt[p-1];
+	Amap->rdispls[p] = Amap->rdispls[p-1] + Amap->recvcnt[p-1];
+    }
+    Amap->nrecv = Amap->rdispls[procs-1] + Amap->recvcnt[procs-1];
+
+    /* Send the (row, column) indices, in the order of the values. */
+    if ( !(ptr = intMalloc_dist(procs)) )
+	ABORT("Malloc fails for ptr[].");
+    if ( !(cnt2 = int32Malloc_dist(4*procs)) )
+	ABORT("Malloc fails for cnt2[].");
+    displs2 = cnt2 + procs;
+    for (p = 0; p < procs; ++p) ptr[p] = Amap->sdispls[p];
+    if ( !(sidx = intMalloc_dist(2*SUPERLU_MAX(nnz_loc, 1))) )
+	ABORT("Malloc fails for sidx[].");
+    for (i = 0; i < Astore->m_loc; ++i) {
+	irow = perm_c[perm_r[i+Astore->fst_row]];
+	for (j = Astore->rowptr[i]; j < Astore->rowptr[i+1]; ++j) {
+	    jcol = Astore->colind[j];
+	    p = PNUM( PROW(BlockNum(irow),grid), PCOL(BlockNum(jcol),grid), grid );
+	    k = ptr[p]++;
+	    Amap->sendpos[j] = k;
+	    sidx[2*k] = irow;
+	    sidx[2*k+1] = jcol;
+	}
+    }
+    for (p = 0; p < procs; ++p) {
+	cnt2[p] = 2 * Amap->sendcnt[p];
+	displs2[p] = 2 * Amap->sdispls[p];
+	cnt2[2*procs+p] = 2 * Amap->recvcnt[p];
+	cnt2[3*procs+p] = 2 * Amap->rdispls[p];
+    }
+    if ( !(ridx = intMalloc_dist(2*SUPERLU_MAX(Amap->nrecv, 1))) )
+	ABORT("Malloc fails for ridx[].");
+    MPI_Alltoallv(sidx, cnt2, displs2, mpi_int_t,
+		  ridx, &cnt2[2*procs], &cnt2[3*procs], mpi_int_t, grid->comm);
+    SUPERLU_FREE(sidx);
+    SUPERLU_FREE(cnt2);
+    SUPERLU_FREE(ptr);
+
+    if ( !(Amap->recvbuf = floatMalloc_dist(SUPERLU_MAX(Amap->nrecv, 1))) )
+	ABORT("Malloc fails for Amap->recvbuf[].");
+    if ( !(Amap->blk = intMalloc_dist(2*SUPERLU_MAX(Amap->nrecv, 1))) )
+	ABORT("Malloc fails for Amap->blk[].");
+    Amap->off = Amap->blk + Amap->nrecv;
+
+    /* Sort the received entries by column. */
+    if ( !(colptr = intCalloc_dist(n+1)) )
+	ABORT("Calloc fails for colptr[].");
+    if ( !(order = intMalloc_dist(SUPERLU_MAX(Amap->nrecv, 1))) )
+	ABORT("Malloc fails for order[].");
+    for (k = 0; k < Amap->nrecv; ++k) ++colptr[ridx[2*k+1] + 1];
+    for (j = 0; j < n; ++j) colptr[j+1] += colptr[j];
+    for (k = 0; k < Amap->nrecv; ++k) order[colptr[ridx[2*k+1]]++] = k;
+    for (j = n; j > 0; --j) colptr[j] = colptr[j-1];
+    colptr[0] = 0;
+
+    /* Find the position of each entry in L or U, walking the block
+       columns in increasing order as in psdistribute(). */
+    nrbu = CEILING( nsupers, grid->nprow );
+    if ( !(Urb_length = intCalloc_dist(2*nrbu)) )
+	ABORT("Calloc fails for Urb_length[].");
+    Urb_indptr = Urb_length + nrbu;
+    for (lb = 0; lb < nrbu; ++lb) Urb_indptr[lb] = BR_HEADER;
+    if ( !(rpos = intMalloc_dist(SUPERLU_MAX(Llu->ldalsum, 1))) )
+	ABORT("Malloc fails for rpos[].");
+
+    for (jb = 0; jb < nsupers; ++jb) {
+	if ( mycol != PCOL( jb, grid ) ) continue;
+	fsupc = FstBlockC( jb );
+	nsupc = SuperSize( jb );
+	ljb = LBj( jb, grid );
+
+	/* rpos[] gives the row of lusup[] of each row of the L block column. */
+	index = Llu->Lrowind_bc_ptr[ljb];
+	if ( index ) {
+	    nrbl = index[0];
+	    for (jj = 0, i = BC_HEADER, k = 0; jj < nrbl; ++jj) {
+		gb = index[i];
+		len = index[i+1];
+		lb = LBi( gb, grid );
+		for (i += LB_DESCRIPTOR; len > 0; --len, ++i, ++k)
+		    rpos[ilsum[lb] + index[i] - FstBlockC( gb )] = k;
+	    }
+	}
+
+	for (j = fsupc; j < fsupc + nsupc; ++j) {
+	    for (i = colptr[j]; i < colptr[j+1]; ++i) {
+		k = order[i];
+		irow = ridx[2*k];
+		gb = BlockNum( irow );
+		lb = LBi( gb, grid );
+		if ( gb < jb ) { /* in U */
+		    index = Llu->Ufstnz_br_ptr[lb];
+		    while ( (jj = index[Urb_indptr[lb]]) < jb ) {
+			Urb_length[lb] += index[Urb_indptr[lb]+1];
+			Urb_indptr[lb] += UB_DESCRIPTOR + SuperSize( jj );
+		    }
+		    istart = Urb_indptr[lb] + UB_DESCRIPTOR;
+		    len = Urb_length[lb];
+		    fsupc1 = FstBlockC( gb+1 );
+		    for (jj = 0; jj < j - fsupc; ++jj)
+			len += fsupc1 - index[istart++];
+		    Amap->blk[k] = -lb - 1;
+		    Amap->off[k] = len + irow - index[istart];
+		} else { /* in L */
+		    Amap->blk[k] = ljb;
+		    Amap->off[k] = rpos[ilsum[lb] + irow - FstBlockC( gb )]
+			+ (j - fsupc) * Llu->Lrowind_bc_ptr[ljb][1];
+		}
+	    }
+	}
+    }
+
+    SUPERLU_FREE(rpos);
+    SUPERLU_FREE(Urb_length);
+    SUPERLU_FREE(order);
+    SUPERLU_FREE(colptr);
+    SUPERLU_FREE(ridx);
+    return Amap;
+} /* sAmap_build */
+
+/*! \brief Move the values of A into L and U along Amap; all the other
+ *  entries of L and U are set to zero.
+ */
+static void
+sAmap_scatter(SuperMatrix *A, sAmap_t *Amap, sLUstruct_t *LUstruct,
+              gridinfo_t *grid)
+{
+    Glu_persist_t *Glu_persist = LUstruct->Glu_persist;
+    sLocalLU_t *Llu = LUstruct->Llu;
+    int_t  *xsup = Glu_persist->xsup;
+    int_t  *supno = Glu_persist->supno;
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    float *nzval = (float *) Astore->nzval;
+    float **Lnzval_bc_ptr = Llu->Lnzval_bc_ptr;
+    float **Unzval_br_ptr = Llu->Unzval_br_ptr;
+    float zero = 0.0;
+    int_t  i, k, len, lb, nsupers;
+    int    mycol;
+
+    mycol = MYCOL( grid->iam, grid );
+    nsupers = supno[A->ncol-1] + 1;
+
+    for (i = 0; i < Amap->nnz_loc; ++i) Amap->sendbuf[Amap->sendpos[i]] = nzval[i];
+    MPI_Alltoallv(Amap->sendbuf, Amap->sendcnt, Amap->sdispls, MPI_FLOAT,
+		  Amap->recvbuf, Amap->recvcnt, Amap->rdispls, MPI_FLOAT,
+		  grid->comm);
+
+    for (lb = 0; lb < CEILING( nsupers, grid->npcol ); ++lb) {
+	if ( Llu->Lrowind_bc_ptr[lb] ) {
+	    len = Llu->Lrowind_bc_ptr[lb][1] * SuperSize( lb * grid->npcol + mycol );
+	    for (i = 0; i < len; ++i) Lnzval_bc_ptr[lb][i] = zero;
+	}
+    }
+    for (lb = 0; lb < CEILING( nsupers, grid->nprow ); ++lb) {
+	if ( Llu->Ufstnz_br_ptr[lb] ) {
+	    len = Llu->Ufstnz_br_ptr[lb][1];
+	    for (i = 0; i < len; ++i) Unzval_br_ptr[lb][i] = zero;
+	}
+    }
+
+    for (k = 0; k < Amap->nrecv; ++k) {
+	lb = Amap->blk[k];
+	if ( lb >= 0 ) Lnzval_bc_ptr[lb][Amap->off[k]] = Amap->recvbuf[k];
+	else Unzval_br_ptr[-lb-1][Amap->off[k]] = Amap->recvbuf[k];
+    }
+} /* sAmap_scatter */
+
+/*! \brief Free the map built by psdistribute(). */
+void sAmapFree(sAmap_t *Amap)
+{
+    if ( !Amap ) return;
+    SUPERLU_FREE(Amap->sendpos);
+    SUPERLU_FREE(Amap->sendcnt);
+    SUPERLU_FREE(Amap->blk);
+    SUPERLU_FREE(Amap->sendbuf);
+    SUPERLU_FREE(Amap->recvbuf);
+    SUPERLU_FREE(Amap);
+}
+
 float
 psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 	     sScalePermstruct_t *ScalePermstruct,
@@ -378,7 +622,7 @@ psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 {
     Glu_persist_t *Glu_persist = LUstruct->Glu_persist;
     sLocalLU_t *Llu = LUstruct->Llu;
-    int_t bnnz, fsupc, fsupc1, i, ii, irow, istart, j, ib, jb, jj, k, k1,
+    int_t fsupc, fsupc1, i, ii, irow, istart, j, ib, jb, jj, k, k1,
           len, len1, nsupc;
 	int_t lib;  /* local block row number */
 	int_t nlb;  /* local block rows*/
@@ -402,8 +646,10 @@ psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
     int_t next_lval;      /* next available position in nzval[*] */
     int_t *index;         /* indices consist of headers and row subscripts */
 	int_t *index_srt;         /* indices consist of headers and row subscripts */
+    int_t *Lindex_buf;    /* index[] of one block column, unsorted */
 	int   *index1;        /* temporary pointer to array of int */
     float *lusup, *lusup_srt, *uval; /* nonzero values in L and U */
+    float *Lnzval_buf;   /* nzval[] of one block column, unsorted */
     float **Lnzval_bc_ptr;  /* size ceil(NSUPERS/Pc) */
     float *Lnzval_bc_dat;  /* size: sum of sizes of Lnzval_bc_ptr[lk])  */
     long int *Lnzval_bc_offset;  /* size ceil(NSUPERS/Pc)                 */
@@ -525,151 +771,49 @@ psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(iam, "Enter psdistribute()");
 #endif
-#if ( PROFlevel>=1 )
-    t = SuperLU_timer_();
-#endif
-
-    sReDistribute_A(A, ScalePermstruct, Glu_freeable, xsup, supno,
-		      grid, &xa, &asub, &a);
-
-#if ( PROFlevel>=1 )
-    t = SuperLU_timer_() - t;
-    if ( !iam ) printf("--------\n"
-		       ".. Phase 1 - ReDistribute_A time: %.2f\t\n", t);
-#endif
-
     if ( options->Fact == SamePattern_SameRowPerm ) {
-
+	/* The L and U data structures, the communication metadata and
+	   the trees are kept. Only the new values of A are moved into L
+	   and U, along the map built on the first such call; A must have
+	   the same local nonzero structure as on that call.   */
+	if ( Llu->Amap && (Llu->Amap->nnz_loc != Astore->nnz_loc
+			   || Llu->Amap->m_loc != Astore->m_loc
+			   || Llu->Amap->fst_row != Astore->fst_row) ) {
+	    sAmapFree(Llu->Amap);
+	    Llu->Amap = NULL;
+	}
 #if ( PROFlevel>=1 )
-	t_l = t_u = 0; u_blks = 0;
+	t = SuperLU_timer_();
 #endif
-	/* We can propagate the new values of A into the existing
-	   L and U data structures.            */
-	ilsum = Llu->ilsum;
-	ldaspa = Llu->ldalsum;
-	if ( !(dense = floatCalloc_dist(ldaspa * sp_ienv_dist(3, options))) )
-	    ABORT("Calloc fails for SPA dense[].");
-	nrbu = CEILING( nsupers, grid->nprow ); /* No. of local block rows */
-	if ( !(Urb_length = intCalloc_dist(nrbu)) )
-	    ABORT("Calloc fails for Urb_length[].");
-	if ( !(Urb_indptr = intMalloc_dist(nrbu)) )
-	    ABORT("Malloc fails for Urb_indptr[].");
-	Lrowind_bc_ptr = Llu->Lrowind_bc_ptr;
-	Lindval_loc_bc_ptr = Llu->Lindval_loc_bc_ptr;
-	Lnzval_bc_ptr = Llu->Lnzval_bc_ptr;
-	Ufstnz_br_ptr = Llu->Ufstnz_br_ptr;
-	Unzval_br_ptr = Llu->Unzval_br_ptr;
-	Unnz = Llu->Unnz;
-
-	mem_use += 2.0*nrbu*iword + ldaspa*sp_ienv_dist(3, options)*dword;
-
+	if ( !Llu->Amap )
+	    Llu->Amap = sAmap_build(A, ScalePermstruct, LUstruct, grid);
+	sAmap_scatter(A, Llu->Amap, LUstruct, grid);
 #if ( PROFlevel>=1 )
-	t = SuperLU_timer_();
+	t = SuperLU_timer_() - t;
+	if ( !iam ) printf(".. 2nd distribute time: %.2f\n", t);
 #endif
 
-	/* Initialize Uval to zero. */
-	for (lb = 0; lb < nrbu; ++lb) {
-	    Urb_indptr[lb] = BR_HEADER; /* Skip header in U index[]. */
-	    index = Ufstnz_br_ptr[lb];
-	    if ( index ) {
-		uval = Unzval_br_ptr[lb];
-		len = index[1];
-		for (i = 0; i < len; ++i) uval[i] = zero;
-	    } /* if index != NULL */
-	} /* for lb ... */
-
-	for (jb = 0; jb < nsupers; ++jb) { /* Loop through each block column */
-	    pc = PCOL( jb, grid );
-	    if ( mycol == pc ) { /* Block column jb in my process column */
-		fsupc = FstBlockC( jb );
-		nsupc = SuperSize( jb );
-
- 		/* Scatter A into SPA (for L), or into U directly. */
-		for (j = fsupc, dense_col = dense; j < FstBlockC(jb+1); ++j) {
-		    for (i = xa[j]; i < xa[j+1]; ++i) {
-			irow = asub[i];
-			gb = BlockNum( irow );
-			if ( myrow == PROW( gb, grid ) ) {
-			    lb = LBi( gb, grid );
- 			    if ( gb < jb ) { /* in U */
- 				index = Ufstnz_br_ptr[lb];
- 				uval = Unzval_br_ptr[lb];
- 				while (  (k = index[Urb_indptr[lb]]) < jb ) {
- 				    /* Skip nonzero values in this block */
- 				    Urb_length[lb] += index[Urb_indptr[lb]+1];
- 				    /* Move pointer to the next block */
- 				    Urb_indptr[lb] += UB_DESCRIPTOR
- 					+ SuperSize( k );
- 				}
- 				/*assert(k == jb);*/
- 				/* start fstnz */
- 				istart = Urb_indptr[lb] + UB_DESCRIPTOR;
- 				len = Urb_length[lb];
- 				fsupc1 = FstBlockC( gb+1 );
- 				k = j - fsupc;
- 				/* Sum the lengths of the leading columns */
- 				for (jj = 0; jj < k; ++jj)
-				    len += fsupc1 - index[istart++];
-				/*assert(irow>=index[istart]);*/
-				uval[len + irow - index[istart]] = a[i];
-			    } else { /* in L; put in SPA first */
-  				irow = ilsum[lb] + irow - FstBlockC( gb );
-  				dense_col[irow] = a[i];
-  			    }
-  			}
-		    } /* for i ... */
-  		    dense_col += ldaspa;
-		} /* for j ... */
+    } else { /* options->Fact is not SamePattern_SameRowPerm */
+        /* ------------------------------------------------------------
+	   FIRST TIME CREATING THE L AND U DATA STRUCTURES.
+	   ------------------------------------------------------------*/
 
 #if ( PROFlevel>=1 )
-		t_u += SuperLU_timer_() - t;
-		t = SuperLU_timer_();
+	t = SuperLU_timer_();
 #endif
 
-		/* Gather the values of A from SPA into Lnzval[]. */
-		ljb = LBj( jb, grid ); /* Local block number */
-		index = Lrowind_bc_ptr[ljb];
-		if ( index ) {
-		    nrbl = index[0];   /* Number of row blocks. */
-		    len = index[1];    /* LDA of lusup[]. */
-		    lusup = Lnzval_bc_ptr[ljb];
-		    next_lind = BC_HEADER;
-		    next_lval = 0;
-		    for (jj = 0; jj < nrbl; ++jj) {
-			gb = index[next_lind++];
-			len1 = index[next_lind++]; /* Rows in the block. */
-			lb = LBi( gb, grid );
-			for (bnnz = 0; bnnz < len1; ++bnnz) {
-			    irow = index[next_lind++]; /* Global index. */
-			    irow = ilsum[lb] + irow - FstBlockC( gb );
-			    k = next_lval++;
-			    for (j = 0, dense_col = dense; j < nsupc; ++j) {
-				lusup[k] = dense_col[irow];
-				dense_col[irow] = zero;
-				k += len;
-				dense_col += ldaspa;
-			    }
-			} /* for bnnz ... */
-		    } /* for jj ... */
-		} /* if index ... */
-#if ( PROFlevel>=1 )
-		t_l += SuperLU_timer_() - t;
-#endif
-	    } /* if mycol == pc */
-	} /* for jb ... */
+	sReDistribute_A(A, ScalePermstruct, Glu_freeable, xsup, supno,
+		      grid, &xa, &asub, &a);
 
-	SUPERLU_FREE(dense);
-	SUPERLU_FREE(Urb_length);
-	SUPERLU_FREE(Urb_indptr);
 #if ( PROFlevel>=1 )
-	if ( !iam ) printf(".. 2nd distribute time: L %.2f\tU %.2f\tu_blks %d\tnrbu %d\n",
-			   t_l, t_u, u_blks, nrbu);
+	t = SuperLU_timer_() - t;
+	if ( !iam ) printf("--------\n"
+		       ".. Phase 1 - ReDistribute_A time: %.2f\t\n", t);
 #endif
 
-    } else { /* options->Fact is not SamePattern_SameRowPerm */
-        /* ------------------------------------------------------------
-	   FIRST TIME CREATING THE L AND U DATA STRUCTURES.
-	   ------------------------------------------------------------*/
+	/* The map for the refactorizations is built again when needed. */
+	sAmapFree(Llu->Amap);
+	Llu->Amap = NULL;
 
 #if ( PROFlevel>=1 )
 	t_l = t_u = 0; u_blks = 0;
@@ -939,14 +1083,96 @@ psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 	memTRS += k*sizeof(int_t*) + 2.0*k*sizeof(double*) + k*iword;  //acount for Lindval_loc_bc_ptr, Unnz, Linv_bc_ptr,Uinv_bc_ptr
 
 	/*------------------------------------------------------------
-	  PROPAGATE ROW SUBSCRIPTS AND VALUES OF A INTO L AND U BLOCKS.
-	  THIS ACCOUNTS FOR ONE-PASS PROCESSING OF A, L AND U.
+	  COUNT THE LENGTH OF EACH BLOCK COLUMN OF L, SO THAT L IS
+	  ALLOCATED ONCE, IN THE FLATTENED FORM OF psflatten_LDATA().
 	  ------------------------------------------------------------*/
 	long int Linv_bc_cnt=0;
 	long int Uinv_bc_cnt=0;
 	long int Lrowind_bc_cnt=0;
 	long int Lnzval_bc_cnt=0;
 	long int Lindval_loc_bc_cnt=0;
+	int_t maxlen1 = 0, maxlen2 = 0;
+
+	if ( !(Lrowind_bc_offset = (long int*)SUPERLU_MALLOC(k * sizeof(long int))) )
+	    ABORT("Malloc fails for Lrowind_bc_offset[].");
+	if ( !(Lnzval_bc_offset = (long int*)SUPERLU_MALLOC(k * sizeof(long int))) )
+	    ABORT("Malloc fails for Lnzval_bc_offset[].");
+	if ( !(Lindval_loc_bc_offset = (long int*)SUPERLU_MALLOC(k * sizeof(long int))) )
+	    ABORT("Malloc fails for Lindval_loc_bc_offset[].");
+	if ( !(Linv_bc_offset = (long int*)SUPERLU_MALLOC(k * sizeof(long int))) )
+	    ABORT("Malloc fails for Linv_bc_offset[].");
+	if ( !(Uinv_bc_offset = (long int*)SUPERLU_MALLOC(k * sizeof(long int))) )
+	    ABORT("Malloc fails for Uinv_bc_offset[].");
+	for (ljb = 0; ljb < k; ++ljb) {
+	    Lrowind_bc_offset[ljb] = Lnzval_bc_offset[ljb] = -1;
+	    Lindval_loc_bc_offset[ljb] = -1;
+	    Linv_bc_offset[ljb] = Uinv_bc_offset[ljb] = -1;
+	}
+	for (lb = 0; lb < nrbu; ++lb) Lrb_indptr[lb] = SLU_EMPTY; /* marker */
+
+	for (jb = 0; jb < nsupers; ++jb) {
+	    if ( mycol != PCOL( jb, grid ) ) continue;
+	    fsupc = FstBlockC( jb );
+	    nsupc = SuperSize( jb );
+	    ljb = LBj( jb, grid );
+	    nrbl = 0;
+	    len = 0;
+	    for (i = xlsub[fsupc]; i < xlsub[fsupc+1]; ++i) {
+		gb = BlockNum( lsub[i] );
+		if ( myrow == PROW( gb, grid ) ) {
+		    lb = LBi( gb, grid );
+		    if ( Lrb_indptr[lb] != jb ) {
+			Lrb_indptr[lb] = jb;
+			++nrbl;
+		    }
+		    ++len;
+		}
+	    }
+	    if ( nrbl ) {
+		len1 = len + BC_HEADER + nrbl * LB_DESCRIPTOR;
+		Lrowind_bc_offset[ljb] = Lrowind_bc_cnt;
+		Lrowind_bc_cnt += len1;
+		Lnzval_bc_offset[ljb] = Lnzval_bc_cnt;
+		Lnzval_bc_cnt += len * nsupc;
+		Lindval_loc_bc_offset[ljb] = Lindval_loc_bc_cnt;
+		Lindval_loc_bc_cnt += nrbl * 3;
+		if ( myrow == PROW( jb, grid ) ) { /* diagonal block */
+		    Linv_bc_offset[ljb] = Linv_bc_cnt;
+		    Linv_bc_cnt += nsupc * nsupc;
+		    Uinv_bc_offset[ljb] = Uinv_bc_cnt;
+		    Uinv_bc_cnt += nsupc * nsupc;
+		}
+		maxlen1 = SUPERLU_MAX( maxlen1, len1 );
+		maxlen2 = SUPERLU_MAX( maxlen2, len * nsupc );
+	    }
+	}
+
+	/* One extra entry in each array as safe guard, the same as in
+	   psflatten_LDATA(). The blocks are written directly in place,
+	   so the pages land on the NUMA node of this process.  */
+	if ( !(Lrowind_bc_dat = intMalloc_dist(Lrowind_bc_cnt + 1)) )
+	    ABORT("Malloc fails for Lrowind_bc_dat[].");
+	if ( !(Lnzval_bc_dat = floatMalloc_dist(Lnzval_bc_cnt + 1)) )
+	    ABORT("Malloc fails for Lnzval_bc_dat[].");
+	if ( !(Lindval_loc_bc_dat = intMalloc_dist(Lindval_loc_bc_cnt + 1)) )
+	    ABORT("Malloc fails for Lindval_loc_bc_dat[].");
+	if ( !(Linv_bc_dat = floatMalloc_dist(Linv_bc_cnt + 1)) )
+	    ABORT("Malloc fails for Linv_bc_dat[].");
+	if ( !(Uinv_bc_dat = floatMalloc_dist(Uinv_bc_cnt + 1)) )
+	    ABORT("Malloc fails for Uinv_bc_dat[].");
+
+	/* A block column is set up in these buffers, then copied into
+	   the arrays above with its row blocks sorted. */
+	if ( !(Lindex_buf = intMalloc_dist(maxlen1 + 1)) )
+	    ABORT("Malloc fails for Lindex_buf[].");
+	if ( !(Lnzval_buf = floatMalloc_dist(maxlen2 + 1)) )
+	    ABORT("Malloc fails for Lnzval_buf[].");
+	mem_use += (maxlen1 + 1.0) * iword + (maxlen2 + 1.0) * dword;
+
+	/*------------------------------------------------------------
+	  PROPAGATE ROW SUBSCRIPTS AND VALUES OF A INTO L AND U BLOCKS.
+	  THIS ACCOUNTS FOR ONE-PASS PROCESSING OF A, L AND U.
+	  ------------------------------------------------------------*/
 
 	for (jb = 0; jb < nsupers; ++jb) { /* for each block column ... */
 	    pc = PCOL( jb, grid );
@@ -1087,32 +1313,17 @@ psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 		       index[] and nzval[]. */
 		    /* Add room for descriptors */
 		    len1 = len + BC_HEADER + nrbl * LB_DESCRIPTOR;
-		    if ( !(index = intMalloc_dist(len1)) )
-			ABORT("Malloc fails for index[]");
-		    // Lrowind_bc_offset[ljb]=len1;
-   		    // Lrowind_bc_cnt += Lrowind_bc_offset[ljb];
+		    index = Lindex_buf;
 
-		    if (!(lusup = (float*)SUPERLU_MALLOC(len*nsupc * sizeof(float))))
-			ABORT("Malloc fails for lusup[]");
-		    // Lnzval_bc_offset[ljb]=len*nsupc;
-     		// Lnzval_bc_cnt += Lnzval_bc_offset[ljb];
-		    if ( !(Lindval_loc_bc_ptr[ljb] = intCalloc_dist(nrbl*3)) )
-			ABORT("Malloc fails for Lindval_loc_bc_ptr[ljb][]");
-		    // Lindval_loc_bc_offset[ljb]=nrbl*3;
-    		// Lindval_loc_bc_cnt += Lindval_loc_bc_offset[ljb];
+		    lusup = Lnzval_buf;
+		    Lindval_loc_bc_ptr[ljb] =
+			&Lindval_loc_bc_dat[Lindval_loc_bc_offset[ljb]];
 
 		    myrow = MYROW( iam, grid );
 		    krow = PROW( jb, grid );
 		    if(myrow==krow){   /* diagonal block */
-  		        if (!(Linv_bc_ptr[ljb] = (float*)SUPERLU_MALLOC(nsupc*nsupc * sizeof(float))))
-			    ABORT("Malloc fails for Linv_bc_ptr[ljb][]");
-			// Linv_bc_offset[ljb]=nsupc*nsupc;
-			// Linv_bc_cnt += Linv_bc_offset[ljb];
-
-		        if (!(Uinv_bc_ptr[ljb] = (float*)SUPERLU_MALLOC(nsupc*nsupc * sizeof(float))))
-			    ABORT("Malloc fails for Uinv_bc_ptr[ljb][]");
-			// Uinv_bc_offset[ljb]=nsupc*nsupc;
-			// Uinv_bc_cnt += Uinv_bc_offset[ljb];
+			Linv_bc_ptr[ljb] = &Linv_bc_dat[Linv_bc_offset[ljb]];
+			Uinv_bc_ptr[ljb] = &Uinv_bc_dat[Uinv_bc_offset[ljb]];
 		    }else{
 			Linv_bc_ptr[ljb] = NULL;
 			// Linv_bc_offset[ljb] = -1;
@@ -1164,9 +1375,6 @@ psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 			}
 		    } /* for i ... */
 
-		    Lrowind_bc_ptr[ljb] = index;
-		    Lnzval_bc_ptr[ljb] = lusup;
-
 			/* sort Lindval_loc_bc_ptr[ljb], Lrowind_bc_ptr[ljb]
                            and Lnzval_bc_ptr[ljb] here.  */
 			if(nrbl>1){
@@ -1182,10 +1390,8 @@ psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 			}
 
 
-			if ( !(index_srt = intMalloc_dist(len1)) )
-				ABORT("Malloc fails for index_srt[]");
-			if (!(lusup_srt = (float*)SUPERLU_MALLOC(len*nsupc * sizeof(float))))
-				ABORT("Malloc fails for lusup_srt[]");
+			index_srt = &Lrowind_bc_dat[Lrowind_bc_offset[ljb]];
+			lusup_srt = &Lnzval_bc_dat[Lnzval_bc_offset[ljb]];
 
 			idx_indx = BC_HEADER;
 			idx_lusup = 0;
@@ -1213,9 +1419,6 @@ psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 				Lindval_loc_bc_ptr[ljb][i+nrbl*2] = idx_lusup - nbrow;
 			}
 
-			SUPERLU_FREE(lusup);
-			SUPERLU_FREE(index);
-
 			Lrowind_bc_ptr[ljb] = index_srt;
 			Lnzval_bc_ptr[ljb] = lusup_srt;
 
@@ -1248,6 +1451,9 @@ psdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 
 	} /* for jb ... */
 
+	SUPERLU_FREE(Lindex_buf);
+	SUPERLU_FREE(Lnzval_buf);
+
 #if 0
 	Linv_bc_cnt +=1; // safe guard
 	Uinv_bc_cnt +=1;
@@ -2211,19 +2417,19 @@ if ( !iam) printf(".. Construct Reduce tree for U: %.2f\t\n", t);
 	////////////////////////////////////////////////////////
 
 	Llu->Lrowind_bc_ptr = Lrowind_bc_ptr;
-	// Llu->Lrowind_bc_dat = Lrowind_bc_dat;
-	// Llu->Lrowind_bc_offset = Lrowind_bc_offset;
-	// Llu->Lrowind_bc_cnt = Lrowind_bc_cnt;
+	Llu->Lrowind_bc_dat = Lrowind_bc_dat;
+	Llu->Lrowind_bc_offset = Lrowind_bc_offset;
+	Llu->Lrowind_bc_cnt = Lrowind_bc_cnt;
 
 	Llu->Lindval_loc_bc_ptr = Lindval_loc_bc_ptr;
-	// Llu->Lindval_loc_bc_dat = Lindval_loc_bc_dat;
-	// Llu->Lindval_loc_bc_offset = Lindval_loc_bc_offset;
-	// Llu->Lindval_loc_bc_cnt = Lindval_loc_bc_cnt;
+	Llu->Lindval_loc_bc_dat = Lindval_loc_bc_dat;
+	Llu->Lindval_loc_bc_offset = Lindval_loc_bc_offset;
+	Llu->Lindval_loc_bc_cnt = Lindval_loc_bc_cnt;
 
 	Llu->Lnzval_bc_ptr = Lnzval_bc_ptr;
-	// Llu->Lnzval_bc_dat = Lnzval_bc_dat;
-	// Llu->Lnzval_bc_offset = Lnzval_bc_offset;
-	// Llu->Lnzval_bc_cnt = Lnzval_bc_cnt;
+	Llu->Lnzval_bc_dat = Lnzval_bc_dat;
+	Llu->Lnzval_bc_offset = Lnzval_bc_offset;
+	Llu->Lnzval_bc_cnt = Lnzval_bc_cnt;
 
 	Llu->Ufstnz_br_ptr = Ufstnz_br_ptr;
    	// Llu->Ufstnz_br_dat = Ufstnz_br_dat;
@@ -2256,14 +2462,14 @@ if ( !iam) printf(".. Construct Reduce tree for U: %.2f\t\n", t);
 	// Llu->UBtree_ptr = UBtree_ptr;
 
 	Llu->Linv_bc_ptr = Linv_bc_ptr;
-	// Llu->Linv_bc_dat = Linv_bc_dat;
-	// Llu->Linv_bc_offset = Linv_bc_offset;
-	// Llu->Linv_bc_cnt = Linv_bc_cnt;
+	Llu->Linv_bc_dat = Linv_bc_dat;
+	Llu->Linv_bc_offset = Linv_bc_offset;
+	Llu->Linv_bc_cnt = Linv_bc_cnt;
 
 	Llu->Uinv_bc_ptr = Uinv_bc_ptr;
-	// Llu->Uinv_bc_dat = Uinv_bc_dat;
-	// Llu->Uinv_bc_offset = Uinv_bc_offset;
-	// Llu->Uinv_bc_cnt = Uinv_bc_cnt;
+	Llu->Uinv_bc_dat = Uinv_bc_dat;
+	Llu->Uinv_bc_offset = Uinv_bc_offset;
+	Llu->Uinv_bc_cnt = Uinv_bc_cnt;
 
 	Llu->Urbs = Urbs;
 	Llu->Ucb_indptr = Ucb_indptr;
@@ -2308,13 +2514,14 @@ if ( !iam) printf(".. Construct Reduce tree for U: %.2f\t\n", t);
   			   t_l, t_u, u_blks, nrbu);
 #endif
 
+	if ( xa[A->ncol] > 0 ) { /* may not have any entries on this process. */
+	    SUPERLU_FREE(asub);
+	    SUPERLU_FREE(a);
+	}
+	SUPERLU_FREE(xa);
+
     } /* else fact != SamePattern_SameRowPerm */
 
-    if ( xa[A->ncol] > 0 ) { /* may not have any entries on this process. */
-        SUPERLU_FREE(asub);
-        SUPERLU_FREE(a);
-    }
-    SUPERLU_FREE(xa);
 	LUstruct->trf3Dpart=NULL;
 
 #if ( DEBUGlevel>=1 )
@@ -342,6 +342,10 @@ at the top-level directory.
  *                        off-diagonal.
  *           = MY_PERMR:  use the ordering given in ScalePermstruct->perm_r
  *                        input by the user.
+ *           = LargeDiag_AUCTION: use a distributed auction algorithm to
+ *                        find an approximate maximum-product matching and
+ *                        the scalings of LargeDiag_MC64, without gathering
+ *                        A on one process.
  *
  *         o ColPerm (colperm_t)
  *           Specifies what type of column permutation to use to reduce fill.
@@ -569,6 +573,10 @@ void psgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
 
     strf3Dpartition_t *trf3Dpartition=LUstruct->trf3Dpart;
     int gpu3dVersion = 1; // default is to use C++ code in CplusplusFactor/ directory
+    int cpu3dVersion = 0; // 1: use C++ code in CplusplusFactor/ on CPU too
+    if (getenv("CPU3DVERSION")) {
+       cpu3dVersion = atoi(getenv("CPU3DVERSION"));
+    }
 #ifdef GPU_ACC
     if (getenv("GPU3DVERSION")) {
        gpu3dVersion = atoi(getenv("GPU3DVERSION"));
@@ -597,6 +605,7 @@ void psgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
     Fact = options->Fact;
 
     validateInput_psgssvx3d(options, A, ldb, nrhs, grid3d, info);
+    if ( *info ) return;
 
     /* Initialization. */
 
@@ -719,7 +728,8 @@ void psgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
 	     * for large diagonal is sought after.
 	     */
 	    if (Fact != SamePattern_SameRowPerm &&
-			(parSymbFact == NO || options->RowPerm != NO))
+			(parSymbFact == NO || (options->RowPerm != NO &&
+					       options->RowPerm != LargeDiag_AUCTION)))
 	    {
 		int need_value = (options->RowPerm == LargeDiag_MC64);
 		psCompRow_loc_to_CompCol_global(need_value, A, grid, &GA);
@@ -849,7 +859,8 @@ void psgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
 		}
 
 		/* Destroy GA */
-		if (parSymbFact == NO || options->RowPerm != NO)
+		if (parSymbFact == NO || (options->RowPerm != NO &&
+					  options->RowPerm != LargeDiag_AUCTION))
 		    Destroy_CompCol_Matrix_dist(&GA);
 
 	    } /* end if Fact not SamePattern_SameRowPerm */
@@ -1013,6 +1024,7 @@ void psgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
         if ( options->SolveOnly != YES ) { // Now we need factorization
 
 		t = SuperLU_timer_();
+		stat->forest_imbalance = trf3Dpartition->imbalance;
 
 		/*factorize in grid 1*/
 		// if(grid3d->zscp.Iam)
@@ -1063,7 +1075,7 @@ sLUgpu_Handle sLUgpu = sCreateLUgpuHandle(nsupers, ldt, trf3Dpartition, LUstruct
 
 			double setup_time = SuperLU_timer_() - tic;
 
-			int maxLvl = log2i(grid3d->zscp.Np) + 1;
+			int maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
 			tic = SuperLU_timer_();
 			for (int ilvl = 0; ilvl < maxLvl; ++ilvl) {
@@ -1099,6 +1111,12 @@ sLUgpu_Handle sLUgpu = sCreateLUgpuHandle(nsupers, ldt, trf3Dpartition, LUstruct
 		}
 		else /* gpu3dVersion==0, this is the old C code, with less GPU offload */
 #endif /* matching ifdef GPU_ACC */
+		if (cpu3dVersion == 1)
+		{ /* the templated C++ code in CplusplusFactor/, on CPU */
+			psgstrf3d_v100(options, m, n, anorm, trf3Dpartition, SCT,
+				       LUstruct, grid3d, stat, info);
+		}
+		else
 		{
 
 			psgstrf3d(options, m, n, anorm, trf3Dpartition, SCT, LUstruct,
@@ -1639,6 +1657,7 @@ if (get_acc_solve()){
 					SOLVEstruct1->diag_len = SOLVEstruct->diag_len;
 					SOLVEstruct1->gsmv_comm = SOLVEstruct->gsmv_comm;
 					SOLVEstruct1->A_colind_gsmv = SOLVEstruct->A_colind_gsmv;
+					SOLVEstruct1->gstrs_work = SOLVEstruct->gstrs_work;
 
 					/* Initialize the *gstrs_comm for 1 RHS. */
 					if (!(SOLVEstruct1->gstrs_comm = (pxgstrs_comm_t *)
@@ -1809,6 +1828,7 @@ if (get_acc_solve()){
 					SOLVEstruct1->diag_len = SOLVEstruct->diag_len;
 					SOLVEstruct1->gsmv_comm = SOLVEstruct->gsmv_comm;
 					SOLVEstruct1->A_colind_gsmv = SOLVEstruct->A_colind_gsmv;
+					SOLVEstruct1->gstrs_work = SOLVEstruct->gstrs_work;
 
 					/* Initialize the *gstrs_comm for 1 RHS. */
 					if (!(SOLVEstruct1->gstrs_comm = (pxgstrs_comm_t *)
@@ -166,6 +166,20 @@ psgssvx3d_csc_batch(
     CHECK_MALLOC(grid3d->iam, "Enter psgssvx3d_csc_batch()");
 #endif
 
+#ifdef GPU_ACC
+    if ( !sp_ienv_dist(10, options) )
+#endif
+    {
+	/* Without GPU offload, fall back to the batched CPU engine: the
+	   batch is split among the processes of grid3d, each sharing one
+	   symbolic factorization over its block, and the results are
+	   broadcast. No block diagonal matrix is formed. */
+	return psgssvx_batch_cpu(options, batchCount, m, n, nnz, nrhs,
+				 SparseMatrix_handles, RHSptr, ldRHS, ReqPtr,
+				 CeqPtr, RpivPtr, CpivPtr, DiagScale, Xptr, ldX,
+				 Berrs, grid3d, stat, info);
+    }
+
     int colequ, Equil, factored, job, notran, rowequ, need_value;
     int_t i, iinfo, j, k, irow;
     int ldx; /* LDA for matrix X (local). */
@@ -108,6 +108,35 @@ _fcd ftcs3;
 #endif
 			//TODO: sreadMM_dist_intoL_CSR not implemented
 
+/* Return in gw the send/receive buffers of the B <-> X redistribution,
+   enlarged to hold ni indices and nd values, and the request and status
+   arrays for procs processes. They are kept across calls like the other
+   work arrays of psgstrs(). */
+static void sgstrs_redist_workspace(sgstrs_work_t *gw, int procs,
+                                     size_t ni, size_t nd)
+{
+    if ( ni > gw->redist_isize ) {
+	if ( gw->redist_ibuf ) SUPERLU_FREE(gw->redist_ibuf);
+	if ( !(gw->redist_ibuf = intMalloc_dist(ni)) )
+	    ABORT("Malloc fails for redist_ibuf[].");
+	gw->redist_isize = ni;
+    }
+    if ( nd > gw->redist_dsize ) {
+	if ( gw->redist_dbuf ) SUPERLU_FREE(gw->redist_dbuf);
+	if ( !(gw->redist_dbuf = floatMalloc_dist(nd)) )
+	    ABORT("Malloc fails for redist_dbuf[].");
+	gw->redist_dsize = nd;
+    }
+    if ( !gw->redist_req ) {
+	if ( !(gw->redist_req = (MPI_Request*)
+	       SUPERLU_MALLOC(2*procs*sizeof(MPI_Request))) )
+	    ABORT("Malloc fails for redist_req[].");
+	if ( !(gw->redist_status = (MPI_Status*)
+	       SUPERLU_MALLOC(2*procs*sizeof(MPI_Status))) )
+	    ABORT("Malloc fails for redist_status[].");
+    }
+}
+
 /*! \brief
  *
  * <pre>
@@ -194,6 +223,7 @@ psReDistribute_B_to_X(float *B, int_t m_loc, int nrhs, int_t ldb,
     procs = grid->nprow * grid->npcol;
     xsup = Glu_persist->xsup;
     supno = Glu_persist->supno;
+    if ( gstrs_comm->nrhs != nrhs ) pxgstrs_comm_set_nrhs(gstrs_comm, procs, nrhs);
     SendCnt      = gstrs_comm->B_to_X_SendCnt;
     SendCnt_nrhs = gstrs_comm->B_to_X_SendCnt +   procs;
     RecvCnt      = gstrs_comm->B_to_X_SendCnt + 2*procs;
@@ -244,20 +274,16 @@ psReDistribute_B_to_X(float *B, int_t m_loc, int nrhs, int_t ldb,
 	}else{
 		k = sdispls[procs-1] + SendCnt[procs-1]; /* Total number of sends */
 		l = rdispls[procs-1] + RecvCnt[procs-1]; /* Total number of receives */
-		if ( !(send_ibuf = intMalloc_dist(k + l)) )
-			ABORT("Malloc fails for send_ibuf[].");
+		sgstrs_redist_workspace(SOLVEstruct->gstrs_work, procs, k + l,
+					(size_t)(k + l) * nrhs);
+		send_ibuf = SOLVEstruct->gstrs_work->redist_ibuf;
+		send_dbuf = SOLVEstruct->gstrs_work->redist_dbuf;
+		req_send = SOLVEstruct->gstrs_work->redist_req;
+		req_recv = req_send + procs;
+		status_send = SOLVEstruct->gstrs_work->redist_status;
+		status_recv = status_send + procs;
 		recv_ibuf = send_ibuf + k;
-		if ( !(send_dbuf = floatMalloc_dist((k + l)* (size_t)nrhs)) )
-			ABORT("Malloc fails for send_dbuf[].");
 		recv_dbuf = send_dbuf + k * nrhs;
-		if ( !(req_send = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_send[].");
-		if ( !(req_recv = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_recv[].");
-		if ( !(status_send = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_send[].");
-		if ( !(status_recv = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_recv[].");
 
 		for (p = 0; p < procs; ++p) {
 			ptr_to_ibuf[p] = sdispls[p];
@@ -389,12 +415,6 @@ psReDistribute_B_to_X(float *B, int_t m_loc, int nrhs, int_t ldb,
 		// t = SuperLU_timer_() - t;
 		// printf(".. copy to x time\t%8.4f\n", t);
 
-		SUPERLU_FREE(send_ibuf);
-		SUPERLU_FREE(send_dbuf);
-		SUPERLU_FREE(req_send);
-		SUPERLU_FREE(req_recv);
-		SUPERLU_FREE(status_send);
-		SUPERLU_FREE(status_recv);
 	}
 
 
@@ -454,6 +474,7 @@ psReDistribute_X_to_B(int_t n, float *B, int_t m_loc, int_t ldb, int_t fst_row,
     iam = grid->iam;
     procs = grid->nprow * grid->npcol;
 
+    if ( gstrs_comm->nrhs != nrhs ) pxgstrs_comm_set_nrhs(gstrs_comm, procs, nrhs);
     SendCnt      = gstrs_comm->X_to_B_SendCnt;
     SendCnt_nrhs = gstrs_comm->X_to_B_SendCnt +   procs;
     RecvCnt      = gstrs_comm->X_to_B_SendCnt + 2*procs;
@@ -498,19 +519,15 @@ psReDistribute_X_to_B(int_t n, float *B, int_t m_loc, int_t ldb, int_t fst_row,
 	}else{
 		k = sdispls[procs-1] + SendCnt[procs-1]; /* Total number of sends */
 		l = rdispls[procs-1] + RecvCnt[procs-1]; /* Total number of receives */
-		if ( !(send_ibuf = intMalloc_dist(k + l)) )
-			ABORT("Malloc fails for send_ibuf[].");
+		sgstrs_redist_workspace(SOLVEstruct->gstrs_work, procs, k + l,
+					(size_t)(k + l) * nrhs);
+		send_ibuf = SOLVEstruct->gstrs_work->redist_ibuf;
+		send_dbuf = SOLVEstruct->gstrs_work->redist_dbuf;
+		req_send = SOLVEstruct->gstrs_work->redist_req;
+		req_recv = req_send + procs;
+		status_send = SOLVEstruct->gstrs_work->redist_status;
+		status_recv = status_send + procs;
 		recv_ibuf = send_ibuf + k;
-		if ( !(send_dbuf = floatMalloc_dist((k + l)*nrhs)) )
-			ABORT("Malloc fails for send_dbuf[].");
-		if ( !(req_send = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_send[].");
-		if ( !(req_recv = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_recv[].");
-		if ( !(status_send = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_send[].");
-		if ( !(status_recv = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_recv[].");
 		recv_dbuf = send_dbuf + k * nrhs;
 		for (p = 0; p < procs; ++p) {
 			ptr_to_ibuf[p] = sdispls[p];
@@ -633,12 +650,6 @@ psReDistribute_X_to_B(int_t n, float *B, int_t m_loc, int_t ldb, int_t fst_row,
 		}
 		}
 
-    SUPERLU_FREE(send_ibuf);
-    SUPERLU_FREE(send_dbuf);
-	SUPERLU_FREE(req_send);
-	SUPERLU_FREE(req_recv);
-	SUPERLU_FREE(status_send);
-	SUPERLU_FREE(status_recv);
 }
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Exit psReDistribute_X_to_B()");
@@ -780,6 +791,20 @@ psCompute_Diag_Inv(int_t n, sLUstruct_t *LUstruct,gridinfo_t *grid,
 #endif /* SLU_HAVE_LAPACK */
 }
 
+/* Return the work array *ws of psgstrs(), enlarged to hold at least
+   need entries. The arrays are kept in SOLVEstruct->gstrs_work across
+   calls, so that repeated solves do not allocate them again. */
+static float *sgstrs_workspace(float **ws, size_t *size, size_t need)
+{
+    if ( need > *size ) {
+	if ( *ws ) SUPERLU_FREE(*ws);
+	if ( !(*ws = (float *) SUPERLU_MALLOC(need * sizeof(float))) )
+	    ABORT("Malloc fails for psgstrs() workspace.");
+	*size = need;
+    }
+    return *ws;
+}
+
 
 /*! \brief
  *
@@ -842,9 +867,9 @@ psCompute_Diag_Inv(int_t n, sLUstruct_t *LUstruct,gridinfo_t *grid,
  * nrhs   (input) int (global)
  *        Number of right-hand sides.
  *
- * SOLVEstruct (input) sSOLVEstruct_t* (global)
+ * SOLVEstruct (input/output) sSOLVEstruct_t* (global)
  *        Contains the information for the communication during the
- *        solution phase.
+ *        solution phase, and the work arrays kept between calls.
  *
  * stat   (output) SuperLUStat_t*
  *        Record the statistics about the triangular solves.
@@ -949,6 +974,7 @@ psgstrs(superlu_dist_options_t *options, int_t n,
     int_t *LBTree_active, *LRTree_active, *LBTree_finish, *LRTree_finish, *leafsups, *rootsups;
     int_t TAG;
     double t1_sol, t2_sol, t;
+    double tts;  /* start of the L- or U-solve, for the trace */
 #if ( DEBUGlevel>=2 )
     int_t Ublocks = 0;
 #endif
@@ -974,6 +1000,7 @@ psgstrs(superlu_dist_options_t *options, int_t n,
     int dword = sizeof (float);
     int Nwork;
     int_t procs = grid->nprow * grid->npcol;
+    superlu_shm_t *shm = NULL; /* intra-node channel, or NULL */
     yes_no_t done;
     yes_no_t startforward;
     int nbrow;
@@ -983,6 +1010,7 @@ psgstrs(superlu_dist_options_t *options, int_t n,
     int thread_id = 0;
     yes_no_t empty;
     int_t sizelsum,sizertemp,aln_d,aln_i;
+    superlu_arena_t *arena; /* work arrays of this call */
     aln_d = 1; //ceil(CACHELINE/(double)dword);
     aln_i = 1; //ceil(CACHELINE/(double)iword);
     int num_thread = 1;
@@ -1082,9 +1110,11 @@ psgstrs(superlu_dist_options_t *options, int_t n,
     stat->ops[SOLVE] = 0.0;
     Llu->SolveMsgSent = 0;
 
+    arena = &SOLVEstruct->gstrs_work->arena;
+
     /* Save the count to be altered so it can be used by
        subsequent call to PSGSTRS. */
-    if ( !(fmod = int32Malloc_dist(nlb*aln_i)) )
+    if ( !(fmod = SUPERLU_ARENA_MALLOC(arena, nlb*aln_i, int)) )
 	ABORT("Malloc fails for fmod[].");
     for (i = 0; i < nlb; ++i) fmod[i*aln_i] = Llu->fmod[i];
 
@@ -1137,14 +1167,14 @@ psgstrs(superlu_dist_options_t *options, int_t n,
 	SUPERLU_FREE(order);
 #endif
 
-    if ( !(frecv = int32Calloc_dist(nlb)) )
+    if ( !(frecv = SUPERLU_ARENA_CALLOC(arena, nlb, int)) )
 	ABORT("Calloc fails for frecv[].");
     Llu->frecv = frecv;
 
-    if ( !(leaf_send = intMalloc_dist((CEILING( nsupers, Pr )+CEILING( nsupers, Pc ))*aln_i)) )
+    if ( !(leaf_send = SUPERLU_ARENA_MALLOC(arena, (CEILING( nsupers, Pr )+CEILING( nsupers, Pc ))*aln_i, int_t)) )
 	ABORT("Malloc fails for leaf_send[].");
     nleaf_send=0;
-    if ( !(root_send = intMalloc_dist((CEILING( nsupers, Pr )+CEILING( nsupers, Pc ))*aln_i)) )
+    if ( !(root_send = SUPERLU_ARENA_MALLOC(arena, (CEILING( nsupers, Pr )+CEILING( nsupers, Pc ))*aln_i, int_t)) )
 	ABORT("Malloc fails for root_send[].");
     nroot_send=0;
 
@@ -1162,12 +1192,36 @@ psgstrs(superlu_dist_options_t *options, int_t n,
     /* Allocate working storage. */
     knsupc = sp_ienv_dist(3, options);
     maxrecvsz = knsupc * nrhs + SUPERLU_MAX( XK_H, LSUM_H );
+
+    /* Messages between processes on the same node go through shared
+       memory. The channel is kept with the work arrays across calls.
+       Creating it is collective over grid->comm, and it is NULL on the
+       nodes with one process, so all the processes decide together from
+       the agreed slot size whether to (re)create it. */
+    if ( options->IntraNodeShm == YES && !get_acc_solve() ) {
+	sgstrs_work_t *gw = SOLVEstruct->gstrs_work;
+	long long slotsize = maxrecvsz * sizeof(float);
+	MPI_Allreduce(MPI_IN_PLACE, &slotsize, 1, MPI_LONG_LONG, MPI_MAX,
+		      grid->comm);
+	if ( !gw->shm_tried || gw->shm_slotsize < (size_t) slotsize ) {
+	    superlu_shm_free(gw->shm);
+	    gw->shm = superlu_shm_create(grid->comm, SUPERLU_SHM_SLOTS,
+					 (size_t) slotsize);
+	    gw->shm_slotsize = slotsize;
+	    gw->shm_tried = 1;
+	}
+	shm = gw->shm;
+    }
+    C_Tree_SetShm(LBtree_ptr, CEILING(nsupers, grid->npcol), shm);
+    C_Tree_SetShm(UBtree_ptr, CEILING(nsupers, grid->npcol), shm);
+    C_Tree_SetShm(LRtree_ptr, CEILING(nsupers, grid->nprow), shm);
+    C_Tree_SetShm(URtree_ptr, CEILING(nsupers, grid->nprow), shm);
     sizelsum = (((size_t)ldalsum)*nrhs + nlb*LSUM_H);
     sizelsum = ((sizelsum + (aln_d - 1)) / aln_d) * aln_d;
 
 #ifdef _OPENMP
-    if ( !(lsum = (float*)SUPERLU_MALLOC(sizelsum*num_thread * sizeof(float))))
-	ABORT("Malloc fails for lsum[].");
+    lsum = sgstrs_workspace(&SOLVEstruct->gstrs_work->lsum, &SOLVEstruct->gstrs_work->lsum_size,
+			     sizelsum*num_thread);
 #pragma omp parallel default(shared) private(ii)
     {
 	int thread_id = omp_get_thread_num(); //mjc
@@ -1175,19 +1229,21 @@ psgstrs(superlu_dist_options_t *options, int_t n,
     	    lsum[thread_id*sizelsum+ii]=zero;
     }
 #else
-    if ( !(lsum = (float*)SUPERLU_MALLOC(sizelsum*num_thread * sizeof(float))))
-  	    ABORT("Malloc fails for lsum[].");
+    lsum = sgstrs_workspace(&SOLVEstruct->gstrs_work->lsum, &SOLVEstruct->gstrs_work->lsum_size,
+			     sizelsum*num_thread);
     for ( ii=0; ii < sizelsum*num_thread; ii++ )
 	lsum[ii]=zero;
 #endif
     /* intermediate solution x[] vector has same structure as lsum[], see leading comment */
-    if ( !(x = floatCalloc_dist(ldalsum * nrhs + nlb * XK_H)) )
-	ABORT("Calloc fails for x[].");
+    x = sgstrs_workspace(&SOLVEstruct->gstrs_work->x, &SOLVEstruct->gstrs_work->x_size,
+			  ldalsum * nrhs + nlb * XK_H);
+    for ( ii=0; ii < ldalsum * nrhs + nlb * XK_H; ii++ )
+	x[ii]=zero;
 
     sizertemp=ldalsum * nrhs;
     sizertemp = ((sizertemp + (aln_d - 1)) / aln_d) * aln_d;
-    if ( !(rtemp = (float*)SUPERLU_MALLOC((sizertemp*num_thread + 1) * sizeof(float))) )
-	ABORT("Malloc fails for rtemp[].");
+    rtemp = sgstrs_workspace(&SOLVEstruct->gstrs_work->rtemp, &SOLVEstruct->gstrs_work->rtemp_size,
+			      sizertemp*num_thread + 1);
 #ifdef _OPENMP
 #pragma omp parallel default(shared) private(ii)
     {
@@ -1200,11 +1256,11 @@ psgstrs(superlu_dist_options_t *options, int_t n,
 	rtemp[ii]=zero;
 #endif
 
-    if ( !(stat_loc = (SuperLUStat_t**) SUPERLU_MALLOC(num_thread*sizeof(SuperLUStat_t*))) )
+    if ( !(stat_loc = SUPERLU_ARENA_MALLOC(arena, num_thread, SuperLUStat_t*)) )
 	ABORT("Malloc fails for stat_loc[].");
 
     for ( i=0; i<num_thread; i++) {
-	stat_loc[i] = (SuperLUStat_t*)SUPERLU_MALLOC(sizeof(SuperLUStat_t));
+	stat_loc[i] = SUPERLU_ARENA_MALLOC(arena, 1, SuperLUStat_t);
 	PStatInit(stat_loc[i]);
     }
 
@@ -1216,6 +1272,7 @@ psgstrs(superlu_dist_options_t *options, int_t n,
     /*---------------------------------------------------
      * Forward solve Ly = b.
      *---------------------------------------------------*/
+    tts = SUPERLU_TRACE_TIC();
     /* Redistribute B into X on the diagonal processes. */
     psReDistribute_B_to_X(B, m_loc, nrhs, ldb, fst_row, ilsum, x,
 			  ScalePermstruct, Glu_persist, grid, SOLVEstruct);
@@ -1254,7 +1311,7 @@ psgstrs(superlu_dist_options_t *options, int_t n,
 	}
 
 	nsupers_i = CEILING( nsupers, grid->nprow ); /* Number of local block rows */
-	if ( !(	leafsups = (int_t*)intCalloc_dist(nsupers_i)) )
+	if ( !(	leafsups = SUPERLU_ARENA_CALLOC(arena, nsupers_i, int_t)) )
 		ABORT("Calloc fails for leafsups.");
 
 	nrtree = 0;
@@ -1296,8 +1353,9 @@ if(procs==1){
 
 	for (i = 0; i < nlb; ++i) fmod[i*aln_i] += frecv[i];
 
-	if ( !(recvbuf_BC_fwd = (float*)SUPERLU_MALLOC(maxrecvsz*(nfrecvx+1) * sizeof(float))) )  // this needs to be optimized for 1D row mapping
-		ABORT("Malloc fails for recvbuf_BC_fwd[].");
+	recvbuf_BC_fwd = sgstrs_workspace(&SOLVEstruct->gstrs_work->recvbuf,
+				    &SOLVEstruct->gstrs_work->recvbuf_size,
+				    maxrecvsz*(nfrecvx+1));  // this needs to be optimized for 1D row mapping
 	nfrecvx_buf=0;
 
 	log_memory(nlb*aln_i*iword+nlb*iword+(CEILING( nsupers, Pr )+CEILING( nsupers, Pc ))*aln_i*2.0*iword+ nsupers_i*iword + sizelsum*num_thread * dword + (ldalsum * nrhs + nlb * XK_H) *dword + (sizertemp*num_thread + 1)*dword+maxrecvsz*(nfrecvx+1)*dword, stat);	//account for fmod, frecv, leaf_send, root_send, leafsups, recvbuf_BC_fwd	, lsum, x, rtemp
@@ -1440,6 +1498,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 #endif
 		for (jj=0;jj<nleaf;jj++){
 		    k=leafsups[jj];
+		    double ttx = SUPERLU_TRACE_TIC();
 
 // #ifdef _OPENMP
 // #pragma omp task firstprivate (k,nrhs,beta,alpha,x,rtemp,ldalsum) private (ii,knsupc,lk,luptr,lsub,nsupr,lusup,thread_id,t1,t2,Linv,i,lib,rtemp_loc)
@@ -1492,6 +1551,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 #endif
 
 			stat_loc[thread_id]->ops[SOLVE] += knsupc * (knsupc - 1) * nrhs;
+			SUPERLU_TRACE(TR_X, ttx, k);
 			// --nleaf;
 #if ( DEBUGlevel>=2 )
 			printf("(%2d) Solve X[%2d]\n", iam, k);
@@ -1519,6 +1579,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 #endif
 	    for (jj=0;jj<nleaf;jj++) {
 		k=leafsups[jj];
+		double ttx = SUPERLU_TRACE_TIC();
 		{
 
 #if ( PROFlevel>=1 )
@@ -1554,6 +1615,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 #endif
 
 		    stat_loc[thread_id]->ops[SOLVE] += knsupc * (knsupc - 1) * nrhs;
+		    SUPERLU_TRACE(TR_X, ttx, k);
 
 		    // --nleaf;
 #if ( DEBUGlevel>=2 )
@@ -1618,7 +1680,9 @@ if (get_acc_solve()){  /* GPU trisolve*/
 			/*
 			 * Perform local block modifications: lsum[i] -= L_i,k * X[k]
 			 */
+			double ttx = SUPERLU_TRACE_TIC();
 			slsum_fmod_inv(lsum, x, &x[ii], rtemp, nrhs, k, fmod, xsup, grid, Llu, stat_loc, leaf_send, &nleaf_send,sizelsum,sizertemp,0,maxsuper,thread_id,num_thread);
+			SUPERLU_TRACE(TR_LSUM, ttx, k);
 		    }
 		} /* for jj ... */
 	    }
@@ -1674,9 +1738,11 @@ if (get_acc_solve()){  /* GPU trisolve*/
 
 			recvbuf0 = &recvbuf_BC_fwd[nfrecvx_buf*maxrecvsz];
 
+			double ttr = SUPERLU_TRACE_TIC();
 			/* Receive a message. */
-			MPI_Recv( recvbuf0, maxrecvsz, MPI_FLOAT,
-				MPI_ANY_SOURCE, MPI_ANY_TAG, grid->comm, &status );
+			superlu_shm_recv( shm, recvbuf0, maxrecvsz, MPI_FLOAT,
+				grid->comm, &status );
+			SUPERLU_TRACE(TR_RECV, ttr, status.MPI_SOURCE);
 			// MPI_Irecv(recvbuf0,maxrecvsz,MPI_FLOAT,MPI_ANY_SOURCE,MPI_ANY_TAG,grid->comm,&req);
 			// ready=0;
 			// while(ready==0){
@@ -1695,6 +1761,8 @@ if (get_acc_solve()){  /* GPU trisolve*/
 			{
 
 			k = *recvbuf0;
+			stat->solve_comm_bytes += (double) sizeof(float) * (SuperSize( k ) * nrhs
+			    + (status.MPI_TAG == BC_L ? XK_H : LSUM_H));
 
 #if ( DEBUGlevel>=2 )
 			printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, status.MPI_TAG);
@@ -1732,9 +1800,11 @@ if (get_acc_solve()){  /* GPU trisolve*/
 					    knsupc = SuperSize( k );
 					    xin = &recvbuf0[XK_H] ;
 					}
+					double ttl = SUPERLU_TRACE_TIC();
 					slsum_fmod_inv_master(lsum, x, xin, rtemp, nrhs, knsupc, k,
 					    fmod, nb, xsup, grid, Llu,
 					    stat_loc,sizelsum,sizertemp,0,maxsuper,thread_id,num_thread);
+					SUPERLU_TRACE(TR_LSUM, ttl, k);
 
 				} /* if lsub */
 			    }
@@ -1840,9 +1910,11 @@ if (get_acc_solve()){  /* GPU trisolve*/
 						knsupc = SuperSize( k );
 						ii = X_BLK( LBi( k, grid ) );
 						xin = &x[ii];
+						double ttl = SUPERLU_TRACE_TIC();
 						slsum_fmod_inv_master(lsum, x, xin, rtemp, nrhs, knsupc, k,
 							fmod, nb, xsup, grid, Llu,
 							stat_loc,sizelsum,sizertemp,0,maxsuper,thread_id,num_thread);
+						SUPERLU_TRACE(TR_LSUM, ttl, k);
 					} /* if lsub */
 					// }
 
@@ -1883,6 +1955,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 		MPI_Barrier( grid->comm );
 
 	}  /* end CPU trisolve */
+	SUPERLU_TRACE(TR_LSOLVE, tts, -1);
 #if ( PROFlevel>=1 )
 	t3 = SuperLU_timer_() - t3;
 	stat->utime[SOL_TOT] += t3;
@@ -1923,7 +1996,6 @@ if (get_acc_solve()){  /* GPU trisolve*/
 	SUPERLU_FREE(frecv);
 	SUPERLU_FREE(leaf_send);
 	SUPERLU_FREE(leafsups);
-	SUPERLU_FREE(recvbuf_BC_fwd);
 	log_memory(-nlb*aln_i*iword-nlb*iword-(CEILING( nsupers, Pr )+CEILING( nsupers, Pc ))*aln_i*iword- nsupers_i*iword -maxrecvsz*(nfrecvx+1)*dword, stat);	//account for fmod, frecv, leaf_send, leafsups, recvbuf_BC_fwd
 
 
@@ -1939,13 +2011,14 @@ if (get_acc_solve()){  /* GPU trisolve*/
 	 * The Y components from the forward solve is already
 	 * on the diagonal processes.
 	 *---------------------------------------------------*/
+	tts = SUPERLU_TRACE_TIC();
 
 	/* Save the count to be altered so it can be used by
 	   subsequent call to PSGSTRS. */
-	if ( !(bmod = int32Malloc_dist(nlb*aln_i)) )
+	if ( !(bmod = SUPERLU_ARENA_MALLOC(arena, nlb*aln_i, int)) )
 		ABORT("Malloc fails for bmod[].");
 	for (i = 0; i < nlb; ++i) bmod[i*aln_i] = Llu->bmod[i];
-	if ( !(brecv = int32Calloc_dist(nlb)) )
+	if ( !(brecv = SUPERLU_ARENA_CALLOC(arena, nlb, int)) )
 		ABORT("Calloc fails for brecv[].");
 	Llu->brecv = brecv;
 
@@ -2043,7 +2116,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 	}
 
 	nsupers_i = CEILING( nsupers, grid->nprow ); /* Number of local block rows */
-	if ( !(	rootsups = (int_t*)intCalloc_dist(nsupers_i)) )
+	if ( !(	rootsups = SUPERLU_ARENA_CALLOC(arena, nsupers_i, int_t)) )
 		ABORT("Calloc fails for rootsups.");
 
 	nrtree = 0;
@@ -2073,8 +2146,9 @@ if (get_acc_solve()){  /* GPU trisolve*/
 	for (i = 0; i < nlb; ++i) bmod[i*aln_i] += brecv[i];
 	// for (i = 0; i < nlb; ++i)printf("bmod[i]: %5d\n",bmod[i]);
 
-	if ( !(recvbuf_BC_fwd = (float*)SUPERLU_MALLOC(maxrecvsz*(nbrecvx+1) * sizeof(float))) )  // this needs to be optimized for 1D row mapping
-		ABORT("Malloc fails for recvbuf_BC_fwd[].");
+	recvbuf_BC_fwd = sgstrs_workspace(&SOLVEstruct->gstrs_work->recvbuf,
+				    &SOLVEstruct->gstrs_work->recvbuf_size,
+				    maxrecvsz*(nbrecvx+1));  // this needs to be optimized for 1D row mapping
 	nbrecvx_buf=0;
 
 	log_memory(nlb*aln_i*iword+nlb*iword + nsupers_i*iword + maxrecvsz*(nbrecvx+1)*dword, stat);	//account for bmod, brecv, rootsups, recvbuf_BC_fwd
@@ -2204,6 +2278,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 #endif
 		for (jj=0;jj<nroot;jj++){
 			k=rootsups[jj];
+			double ttx = SUPERLU_TRACE_TIC();
 #if ( PROFlevel>=1 )
 			TIC(t1);
 #endif
@@ -2261,6 +2336,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 			stat_loc[thread_id]->utime[SOL_TRSM] += t2;
 #endif
 			stat_loc[thread_id]->ops[SOLVE] += knsupc * (knsupc + 1) * nrhs;
+			SUPERLU_TRACE(TR_X, ttx, k);
 
 #if ( DEBUGlevel>=2 )
 			printf("(%2d) Solve X[%2d]\n", iam, k);
@@ -2298,6 +2374,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 #endif
 		for (jj=0;jj<nroot;jj++){
 			k=rootsups[jj];
+			double ttx = SUPERLU_TRACE_TIC();
 			lk = LBi( k, grid ); /* Local block number, row-wise. */
 			ii = X_BLK( lk );
 			lk = LBj( k, grid ); /* Local block number, column-wise */
@@ -2313,6 +2390,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 			    slsum_bmod_inv(lsum, x, &x[ii], rtemp, nrhs, k, bmod, Urbs,
 					Ucb_indptr, Ucb_valptr, xsup, grid, Llu,
 					stat_loc, root_send, &nroot_send, sizelsum,sizertemp,thread_id,num_thread);
+			SUPERLU_TRACE(TR_LSUM, ttx, k);
 
 		} /* for jj ... */
 
@@ -2361,9 +2439,11 @@ for (i=0;i<nroot_send;i++){
 
 		recvbuf0 = &recvbuf_BC_fwd[nbrecvx_buf*maxrecvsz];
 
+		double ttr = SUPERLU_TRACE_TIC();
 		/* Receive a message. */
-		MPI_Recv( recvbuf0, maxrecvsz, MPI_FLOAT,
-			MPI_ANY_SOURCE, MPI_ANY_TAG, grid->comm, &status );
+		superlu_shm_recv( shm, recvbuf0, maxrecvsz, MPI_FLOAT,
+			grid->comm, &status );
+		SUPERLU_TRACE(TR_RECV, ttr, status.MPI_SOURCE);
 
 #if ( PROFlevel>=1 )
 			TOC(t2, t1);
@@ -2373,6 +2453,8 @@ for (i=0;i<nroot_send;i++){
 #endif
 
 		k = *recvbuf0;
+		stat->solve_comm_bytes += (double) sizeof(float) * (SuperSize( k ) * nrhs
+		    + (status.MPI_TAG == BC_U ? XK_H : LSUM_H));
 #if ( DEBUGlevel>=2 )
 		printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, status.MPI_TAG);
 		fflush(stdout);
@@ -2393,9 +2475,11 @@ for (i=0;i<nroot_send;i++){
 		     */
 
 		    lk = LBj( k, grid ); /* Local block number, column-wise. */
+		    double ttl = SUPERLU_TRACE_TIC();
 		    slsum_bmod_inv_master(lsum, x, &recvbuf0[XK_H], rtemp, nrhs, k, bmod, Urbs,
 				Ucb_indptr, Ucb_valptr, xsup, grid, Llu,
 				stat_loc, sizelsum,sizertemp,thread_id,num_thread);
+		    SUPERLU_TRACE(TR_LSUM, ttl, k);
 		}else if(status.MPI_TAG==RD_U){
 
 		    lk = LBi( k, grid ); /* Local block number, row-wise. */
@@ -2490,10 +2574,12 @@ for (i=0;i<nroot_send;i++){
 			     * Perform local block modifications:
 			     *         lsum[i] -= U_i,k * X[k]
 			     */
+			    double ttl = SUPERLU_TRACE_TIC();
 			    if ( Urbs[lk] )
 				slsum_bmod_inv_master(lsum, x, &x[ii], rtemp, nrhs, k, bmod, Urbs,
 					Ucb_indptr, Ucb_valptr, xsup, grid, Llu,
 					stat_loc, sizelsum,sizertemp,thread_id,num_thread);
+			    SUPERLU_TRACE(TR_LSUM, ttl, k);
 
 			    }else{
 				il = LSUM_BLK( lk );
@@ -2528,6 +2614,7 @@ for (lk=0;lk<nsupers_j;++lk){
 	MPI_Barrier( grid->comm );
 }
 
+	SUPERLU_TRACE(TR_USOLVE, tts, -1);
 #if ( PROFlevel>=1 )
 		t3 = SuperLU_timer_() - t3;
 	stat->utime[SOL_TOT] += t3;
@@ -2602,16 +2689,13 @@ for (lk=0;lk<nsupers_j;++lk){
 		SUPERLU_FREE(stat_loc[i]);
 	}
 	SUPERLU_FREE(stat_loc);
-	SUPERLU_FREE(rtemp);
-	SUPERLU_FREE(lsum);
-	SUPERLU_FREE(x);
 
 	SUPERLU_FREE(bmod);
 	SUPERLU_FREE(brecv);
 	SUPERLU_FREE(root_send);
 
 	SUPERLU_FREE(rootsups);
-	SUPERLU_FREE(recvbuf_BC_fwd);
+	superlu_arena_reset(arena);
 
 	log_memory(-nlb*aln_i*iword-nlb*iword - nsupers_i*iword - (CEILING( nsupers, Pr )+CEILING( nsupers, Pc ))*aln_i*iword - maxrecvsz*(nbrecvx+1)*dword - sizelsum*num_thread * dword - (ldalsum * nrhs + nlb * XK_H) *dword - (sizertemp*num_thread + 1)*dword, stat);	//account for bmod, brecv, root_send, rootsups, recvbuf_BC_fwd,rtemp,lsum,x
 
@@ -2638,7 +2722,12 @@ for (lk=0;lk<nsupers_j;++lk){
 	}
 #endif
 
+    C_Tree_SetShm(LBtree_ptr, CEILING(nsupers, grid->npcol), NULL);
+    C_Tree_SetShm(UBtree_ptr, CEILING(nsupers, grid->npcol), NULL);
+    C_Tree_SetShm(LRtree_ptr, CEILING(nsupers, grid->nprow), NULL);
+    C_Tree_SetShm(URtree_ptr, CEILING(nsupers, grid->nprow), NULL);
     stat->utime[SOLVE] = SuperLU_timer_() - t1_sol;
+    SUPERLU_TRACE(TR_SOLVE, t1_sol, -1);
 
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(iam, "Exit psgstrs()");
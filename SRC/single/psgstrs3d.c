@@ -77,7 +77,7 @@ int_t strs_B_init3d_newsolve(int_t nsupers, float* x, int nrhs, sLUstruct_t * LU
 	int_t mycol = MYCOL( iam, grid );
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
     float zero = 0.0;
     float* xtmp;
     sForest_t** sForests = trf3Dpartition->sForests;
@@ -227,6 +227,15 @@ int strs_compute_communication_structure(superlu_dist_options_t *options, int_t
     int *h_recv_cnt;
     int *h_recv_cnt_u;
 
+    /* Shape of the broadcast and reduction trees. The device code of the
+       NVSHMEM solve assumes binary trees. */
+    C_TreeTopo topo;
+#ifdef HAVE_NVSHMEM
+    C_TreeTopo_Init(&topo, BINARY_TREE, grid->comm);
+#else
+    C_TreeTopo_Init(&topo, options->CommTree, grid->comm);
+#endif
+
     /* Reconstruct the global L structure and compute the communication metadata */
 
     if ( !(tmpglo = intCalloc_dist(nsupers)) )
@@ -407,7 +416,7 @@ int strs_compute_communication_structure(superlu_dist_options_t *options, int_t
 
                         msgsize = SuperSize( jb );
                         int needrecv=0;
-                        C_BcTree_Create_nv(&LBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 's',&needrecv);
+                        C_BcTree_Create_topo(&LBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 's',&needrecv, &topo);
                         //C_BcTree_Create(&LBtree_ptr[ljb], grid->comm, ranks, rank_cnt, msgsize, 's');
                         //printf("(%d) HOST create:ljb=%d,msg=%d,needrecv=%d\n",iam,ljb,mysendmsg_num,needrecv);
                         #ifdef GPU_ACC
@@ -521,7 +530,7 @@ int strs_compute_communication_structure(superlu_dist_options_t *options, int_t
 
                         int needrecvrd=0;
                         int needsendrd=0;
-                        C_RdTree_Create_nv(&LRtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 's', &needrecvrd, &needsendrd);
+                        C_RdTree_Create_topo(&LRtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 's', &needrecvrd, &needsendrd, &topo);
                         //C_RdTree_Create(&LRtree_ptr[lib], grid->comm, ranks, rank_cnt, msgsize, 's');
                         #ifdef GPU_ACC
                         #ifdef HAVE_NVSHMEM
@@ -737,7 +746,7 @@ int strs_compute_communication_structure(superlu_dist_options_t *options, int_t
                         // C_BcTree_Create(&UBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 's');
 
                         int needrecv=0;
-                        C_BcTree_Create_nv(&UBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 's',&needrecv);
+                        C_BcTree_Create_topo(&UBtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 's',&needrecv, &topo);
                         //C_BcTree_Create(&UBtree_ptr[ljb], grid->comm, ranks, rank_cnt, msgsize, 's');
                         #ifdef GPU_ACC
                         #ifdef HAVE_NVSHMEM
@@ -848,7 +857,7 @@ int strs_compute_communication_structure(superlu_dist_options_t *options, int_t
 
                         int needrecvrd=0;
                         int needsendrd=0;
-                        C_RdTree_Create_nv(&URtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 's', &needrecvrd,&needsendrd);
+                        C_RdTree_Create_topo(&URtree_ptr[lk], grid->comm, ranks, rank_cnt, msgsize, 's', &needrecvrd,&needsendrd, &topo);
                         //C_RdTree_Create(&URtree_ptr[lib], grid->comm, ranks, rank_cnt, msgsize, 's');
                         #ifdef GPU_ACC
                         #ifdef HAVE_NVSHMEM
@@ -1398,6 +1407,7 @@ int strs_compute_communication_structure(superlu_dist_options_t *options, int_t
     //     }
     // }
 
+    C_TreeTopo_Free(&topo);
     return 0;
 } // end strs_compute_communication_structure
 
@@ -1406,7 +1416,7 @@ int strs_compute_communication_structure(superlu_dist_options_t *options, int_t
 int_t strs_x_reduction_newsolve(int_t nsupers, float* x, int nrhs, sLUstruct_t * LUstruct, gridinfo3d_t *grid3d, strf3Dpartition_t*  trf3Dpartition, float* recvbuf, xtrsTimer_t *xtrsTimer)
 
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
 	int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
@@ -1450,7 +1460,7 @@ int_t strs_x_reduction_newsolve(int_t nsupers, float* x, int nrhs, sLUstruct_t *
 int_t strs_x_broadcast_newsolve(int_t nsupers, float* x, int nrhs, sLUstruct_t * LUstruct, gridinfo3d_t *grid3d, strf3Dpartition_t*  trf3Dpartition, float* recvbuf, xtrsTimer_t *xtrsTimer)
 
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
 	int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
@@ -1495,6 +1505,8 @@ int_t sreduceSolvedX_newsolve(int_t treeId, int_t sender, int_t receiver, float*
 {
 	sForest_t** sForests = trf3Dpartition->sForests;
 	sForest_t* sforest = sForests[treeId];
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
 	if (!sforest) return 0;
 	int_t nnodes = sforest->nNodes ;
 	int_t *nodeList = sforest->nodeList ;
@@ -1554,7 +1566,7 @@ int_t strs_X_gather3d(float* x, int nrhs, strf3Dpartition_t*  trf3Dpartition,
                      gridinfo3d_t* grid3d, xtrsTimer_t *xtrsTimer)
 
 {
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	int_t myGrid = grid3d->zscp.Iam;
 	int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
 
@@ -1599,6 +1611,8 @@ int_t sp2pSolvedX3d(int_t treeId, int_t sender, int_t receiver, float* x, int nr
 {
 	sForest_t** sForests = trf3Dpartition->sForests;
 	sForest_t* sforest = sForests[treeId];
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
 	if (!sforest) return 0;
 	int_t nnodes = sforest->nNodes ;
 	int_t *nodeList = sforest->nodeList ;
@@ -1650,6 +1664,8 @@ int_t sfsolveReduceLsum3d(int_t treeId, int_t sender, int_t receiver, float* lsu
 {
 	sForest_t** sForests = trf3Dpartition->sForests;
 	sForest_t* sforest = sForests[treeId];
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
 	if (!sforest) return 0;
 	int_t nnodes = sforest->nNodes ;
 	int_t *nodeList = sforest->nodeList ;
@@ -1726,7 +1742,7 @@ int_t sbsolve_Xt_bcast(int_t ilvl, sxT_struct *xT_s, int nrhs, strf3Dpartition_t
     int_t *ilsum = Llu->ilsum;
     int_t* xsup = Glu_persist->xsup;
 
-	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+	int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	gridinfo_t * grid = &(grid3d->grid2d);
 	int_t myGrid = grid3d->zscp.Iam;
 		int_t iam = grid->iam;
@@ -1752,6 +1768,9 @@ int_t sbsolve_Xt_bcast(int_t ilvl, sxT_struct *xT_s, int nrhs, strf3Dpartition_t
 		sender = myGrid - (1 << ilvl);
 	}
 
+	/* a layer beyond the last one has nothing to exchange */
+	if (sender >= grid3d->zscp.Np || receiver >= grid3d->zscp.Np) return 0;
+
 	for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
 	{
 		/* code */
@@ -6771,7 +6790,7 @@ psgstrs3d (superlu_dist_options_t *options, int_t n, sLUstruct_t * LUstruct,
 
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -6811,7 +6830,7 @@ psgstrs3d (superlu_dist_options_t *options, int_t n, sLUstruct_t * LUstruct,
 
 
 
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -6854,7 +6873,7 @@ psgstrs3d (superlu_dist_options_t *options, int_t n, sLUstruct_t * LUstruct,
                        recvbuf, send_req,  nrhs, SOLVEstruct,  stat, &xtrsTimer);
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7105,7 +7124,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7145,7 +7164,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 
     // printf("Llu->SolveMsgSent %10d size %10d\n",Llu->SolveMsgSent,SUPERLU_MAX (Llu->nfsendx, Llu->nbsendx) + nlb);
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7183,7 +7202,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
     xtrsTimer.trs_comm_z += SuperLU_timer_() - tx;
 
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7228,7 +7247,7 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 
     // printf("psgsTrBackSolve3d_newsolve Llu->SolveMsgSent %10d size %10d\n",Llu->SolveMsgSent,SUPERLU_MAX (Llu->nfsendx, Llu->nbsendx) + nlb);
     // {
-    // int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    // int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 	// for (int_t ilvl = 0; ilvl < maxLvl ; ++ilvl)
 	// {
     //     int_t tree = trf3Dpartition->myTreeIdxs[ilvl];
@@ -7336,7 +7355,7 @@ int_t psgsTrForwardSolve3d(superlu_dist_options_t *options, int_t n, sLUstruct_t
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -7481,7 +7500,7 @@ int_t psgsTrForwardSolve3d_newsolve(superlu_dist_options_t *options, int_t n, sL
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -7590,7 +7609,7 @@ int_t psgsTrBackSolve3d(superlu_dist_options_t *options, int_t n, sLUstruct_t *
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -7624,8 +7643,8 @@ int_t psgsTrBackSolve3d(superlu_dist_options_t *options, int_t n, sLUstruct_t *
     int_t nsupc = sp_ienv_dist (3,options);
     sinitLsumBmod_buff(nsupc, nrhs, &lbmod_buf);
 
-    int_t numTrees = 2 * grid3d->zscp.Np - 1;
-    int_t nLeafTrees = grid3d->zscp.Np;
+    int_t numTrees = (1 << maxLvl) - 1;
+    int_t nLeafTrees = 1 << (maxLvl - 1);
     Llu->SolveMsgSent = 0;
     for (int_t ilvl = maxLvl - 1; ilvl >= 0  ; --ilvl)
     {
@@ -7715,7 +7734,7 @@ int_t psgsTrBackSolve3d_newsolve(superlu_dist_options_t *options, int_t n, sLUst
     int_t* myZeroTrIdxs = trf3Dpartition->myZeroTrIdxs;
     sForest_t** sForests = trf3Dpartition->sForests;
     int_t* myTreeIdxs = trf3Dpartition->myTreeIdxs;
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     int_t *ilsum = Llu->ilsum;
 
@@ -0,0 +1,234 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+/*! @file
+ * \brief Read a matrix in Matrix Market format in parallel
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <stdlib.h>
+#include "superlu_sdefs.h"
+
+/* Parse one value at *p and advance *p past it. Returns 1 if there is
+   no number at *p. */
+static int sreadMM_value(char **p, float *v)
+{
+    char *end;
+
+    *v = (float) strtod(*p, &end);
+    if ( end == *p ) return 1;
+    *p = end;
+    return 0;
+}
+
+/*! \brief Read a matrix in Matrix Market format in parallel.
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * psreadMM_dist() reads the file fname into the distributed matrix A in
+ * NR_loc format, without going through a global copy of the matrix.
+ * The data part of the file is split into byte ranges of equal size;
+ * each process reads one range, parses the triplets in it, and sends
+ * each of them to the process that owns its row with MPI_Alltoallv.
+ * The rows are distributed as in screate_matrix(): m/P rows per process,
+ * the last process also takes the remainder. As in sreadMM_dist(),
+ * a symmetric matrix is expanded, and the indices are zero-based if
+ * any of them is zero. This routine must be called by all processes
+ * in the grid; every process must be able to read fname.
+ *
+ * Return value
+ * ============
+ *   = 0: successful exit
+ *   = 1: the file could not be opened
+ *   = 2: parse error, or an index out of range, or a wrong count of
+ *        nonzeros
+ *   = 3: not a square Matrix Market coordinate matrix
+ *   = 4: the values are not real
+ * The same value is returned on all processes. On error, A is not
+ * created.
+ * </pre>
+ */
+int
+psreadMM_dist(char *fname, SuperMatrix *A, gridinfo_t *grid)
+{
+    FILE *fp;
+    MPI_Comm comm = grid->comm;
+    int iam = grid->iam, nprocs = grid->nprow * grid->npcol;
+    int_t hdr[4], m, n, nnz, m_loc, m_loc_fst, fst_row, nnz_loc, nz, cap;
+    int_t i, j, k, r, base, lbase, *row, *col, *rowptr, *colind, *isend, *irecv;
+    int64_t data_off = 0, len, nnz_read, gnnz;
+    float *val, *nzval, *vsend, *vrecv;
+    char *buf, *p;
+    int expand = 0, info = 0, ginfo, q;
+    int *sendcnts, *recvcnts, *sdispls, *rdispls, *ptr;
+
+    /* Process 0 reads the header and broadcasts it. */
+    if ( !iam ) {
+	if ( !(fp = fopen(fname, "r")) ) info = 1;
+	else {
+	    info = superlu_readMM_header(fp, "real", &m, &n, &nnz, &expand,
+					 &data_off);
+	    fclose(fp);
+	}
+	hdr[0] = info ? 0 : m;
+	hdr[1] = nnz;
+	hdr[2] = expand;
+	hdr[3] = info;
+    }
+    MPI_Bcast(hdr, 4, mpi_int_t, 0, comm);
+    MPI_Bcast(&data_off, 1, MPI_INT64_T, 0, comm);
+    if ( hdr[3] ) return (int) hdr[3];
+    m = n = hdr[0];
+    nnz = hdr[1];
+    expand = (int) hdr[2];
+
+    /* Read and parse my part of the file. */
+    if ( !(buf = superlu_readMM_chunk(fname, data_off, iam, nprocs, &len)) ) {
+	len = 0;
+	info = 1;
+	if ( !(buf = (char *) SUPERLU_MALLOC(1)) ) ABORT("Malloc fails for buf[].");
+	buf[0] = '\0';
+    }
+    for (cap = 0, p = buf; p < buf + len; ++p) cap += (*p == '\n');
+    cap = (cap + 1) * (expand ? 2 : 1);
+    if ( !(row = intMalloc_dist(cap)) ) ABORT("Malloc fails for row[].");
+    if ( !(col = intMalloc_dist(cap)) ) ABORT("Malloc fails for col[].");
+    if ( !(val = floatMalloc_dist(cap)) ) ABORT("Malloc fails for val[].");
+
+    lbase = 1;
+    for (nz = 0, nnz_read = 0, p = buf; *p != '\0' && !info; ) {
+	while ( *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' ) ++p;
+	if ( *p == '\0' ) break;
+	if ( *p == '%' ) {                       /* Skip a comment line. */
+	    while ( *p != '\0' && *p != '\n' ) ++p;
+	    continue;
+	}
+	if ( superlu_readMM_int(&p, &row[nz]) || superlu_readMM_int(&p, &col[nz])
+	     || sreadMM_value(&p, &val[nz]) ) {
+	    info = 2;
+	    break;
+	}
+	while ( *p != '\0' && *p != '\n' ) ++p;
+	if ( row[nz] == 0 || col[nz] == 0 ) lbase = 0;
+	++nz;
+	++nnz_read;
+    }
+    SUPERLU_FREE(buf);
+
+    /* The indices are zero-based if any process saw a zero. */
+    MPI_Allreduce(&lbase, &base, 1, mpi_int_t, MPI_MIN, comm);
+    MPI_Allreduce(&nnz_read, &gnnz, 1, MPI_INT64_T, MPI_SUM, comm);
+    if ( !info && gnnz != nnz ) info = 2;
+
+    for (k = 0, j = nz; k < j && !info; ++k) {
+	row[k] -= base;
+	col[k] -= base;
+	if ( row[k] < 0 || row[k] >= m || col[k] < 0 || col[k] >= n ) info = 2;
+	else if ( expand && row[k] != col[k] ) {  /* Excluding diagonal */
+	    row[nz] = col[k];
+	    col[nz] = row[k];
+	    val[nz] = val[k];
+	    ++nz;
+	}
+    }
+    MPI_Allreduce(&info, &ginfo, 1, MPI_INT, MPI_MAX, comm);
+    if ( ginfo ) {
+	SUPERLU_FREE(row);
+	SUPERLU_FREE(col);
+	SUPERLU_FREE(val);
+	return ginfo;
+    }
+
+    /* Same row distribution as in screate_matrix(). */
+    m_loc_fst = m / nprocs;
+    fst_row = iam * m_loc_fst;
+    m_loc = (iam == nprocs - 1) ? m - m_loc_fst * (nprocs - 1) : m_loc_fst;
+#define MM_OWNER(r) ( m_loc_fst ? SUPERLU_MIN((r) / m_loc_fst, nprocs - 1) \
+                                : nprocs - 1 )
+
+    /* Send each triplet to the owner of its row. */
+    if ( !(sendcnts = SUPERLU_MALLOC(5 * nprocs * sizeof(int))) )
+	ABORT("Malloc fails for sendcnts[].");
+    recvcnts = sendcnts + nprocs;
+    sdispls = recvcnts + nprocs;
+    rdispls = sdispls + nprocs;
+    ptr = rdispls + nprocs;
+    for (q = 0; q < nprocs; ++q) sendcnts[q] = 0;
+    for (k = 0; k < nz; ++k) ++sendcnts[MM_OWNER(row[k])];
+    MPI_Alltoall(sendcnts, 1, MPI_INT, recvcnts, 1, MPI_INT, comm);
+    sdispls[0] = rdispls[0] = 0;
+    for (q = 1; q < nprocs; ++q) {
+	sdispls[q] = sdispls[q-1] + sendcnts[q-1];
+	rdispls[q] = rdispls[q-1] + recvcnts[q-1];
+    }
+    nnz_loc = rdispls[nprocs-1] + recvcnts[nprocs-1];
+
+    if ( !(isend = intMalloc_dist(2 * SUPERLU_MAX(nz, 1))) )
+	ABORT("Malloc fails for isend[].");
+    if ( !(vsend = floatMalloc_dist(SUPERLU_MAX(nz, 1))) )
+	ABORT("Malloc fails for vsend[].");
+    if ( !(irecv = intMalloc_dist(2 * SUPERLU_MAX(nnz_loc, 1))) )
+	ABORT("Malloc fails for irecv[].");
+    if ( !(vrecv = floatMalloc_dist(SUPERLU_MAX(nnz_loc, 1))) )
+	ABORT("Malloc fails for vrecv[].");
+    for (q = 0; q < nprocs; ++q) ptr[q] = sdispls[q];
+    for (k = 0; k < nz; ++k) {
+	i = ptr[MM_OWNER(row[k])]++;
+	isend[2*i] = row[k];
+	isend[2*i+1] = col[k];
+	vsend[i] = val[k];
+    }
+    SUPERLU_FREE(row);
+    SUPERLU_FREE(col);
+    SUPERLU_FREE(val);
+
+    MPI_Alltoallv(vsend, sendcnts, sdispls, MPI_FLOAT,
+		  vrecv, recvcnts, rdispls, MPI_FLOAT, comm);
+    for (q = 0; q < nprocs; ++q) {
+	sendcnts[q] *= 2; sdispls[q] *= 2;
+	recvcnts[q] *= 2; rdispls[q] *= 2;
+    }
+    MPI_Alltoallv(isend, sendcnts, sdispls, mpi_int_t,
+		  irecv, recvcnts, rdispls, mpi_int_t, comm);
+    SUPERLU_FREE(isend);
+    SUPERLU_FREE(vsend);
+    SUPERLU_FREE(sendcnts);
+#undef MM_OWNER
+
+    /* Build the local rows in compressed row format. */
+    rowptr = intMalloc_dist(m_loc+1);
+    colind = intMalloc_dist(SUPERLU_MAX(nnz_loc, 1));
+    nzval = floatMalloc_dist(SUPERLU_MAX(nnz_loc, 1));
+    for (i = 0; i <= m_loc; ++i) rowptr[i] = 0;
+    for (k = 0; k < nnz_loc; ++k) ++rowptr[irecv[2*k] - fst_row + 1];
+    for (i = 0; i < m_loc; ++i) rowptr[i+1] += rowptr[i];
+    for (k = 0; k < nnz_loc; ++k) {
+	r = irecv[2*k] - fst_row;
+	j = rowptr[r]++;
+	colind[j] = irecv[2*k+1];
+	nzval[j] = vrecv[k];
+    }
+    for (i = m_loc; i > 0; --i) rowptr[i] = rowptr[i-1];
+    rowptr[0] = 0;
+    SUPERLU_FREE(irecv);
+    SUPERLU_FREE(vrecv);
+
+    sCreate_CompRowLoc_Matrix_dist(A, m, n, nnz_loc, m_loc, fst_row,
+				   nzval, colind, rowptr,
+				   SLU_NR_loc, SLU_S, SLU_GE);
+    return 0;
+}
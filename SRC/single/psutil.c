@@ -38,6 +38,21 @@ int psCompRow_loc_to_CompCol_global
  gridinfo_t *grid, /* Input */
  SuperMatrix *GA   /* Output */
 )
+{
+    return psCompRow_loc_to_CompCol_node(need_value, A, grid, NULL, GA);
+}
+
+/*! \brief As psCompRow_loc_to_CompCol_global(), but if node is not NULL, only the
+ *  leader of each node gets GA; GA->Store is NULL on the other processes.
+ */
+int psCompRow_loc_to_CompCol_node
+(
+ int_t need_value, /* Input. Whether need to gather numerical values */
+ SuperMatrix *A,   /* Input. Distributed matrix in NRformat_loc format. */
+ gridinfo_t *grid, /* Input */
+ superlu_node_t *node, /* Input. Nodes of grid->comm, or NULL */
+ SuperMatrix *GA   /* Output */
+)
 {
     NRformat_loc *Astore;
     NCformat *GAstore;
@@ -60,6 +75,7 @@ int psCompRow_loc_to_CompCol_global
     int_t *fst_rows, *n_locs;
     int   *sendcnts, *sdispls, *recvcnts, *rdispls, *itemp_32;
     int   it, n_loc, procs;
+    int   have_GA = !node || node->leader;
 
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Enter psCompRow_loc_to_CompCol_global");
@@ -227,10 +243,14 @@ int psCompRow_loc_to_CompCol_global
     for (i = 0, nnz = 0; i < procs; ++i) nnz += itemp[i];
     GAstore->nnz = nnz;
 
-    if ( !(GAstore->rowind = (int_t *) intMalloc_dist (nnz)) )
-        ABORT ("SUPERLU_MALLOC fails for GAstore->rowind[]");
-    if ( !(GAstore->colptr = (int_t *) intMalloc_dist (n+1)) )
-        ABORT ("SUPERLU_MALLOC fails for GAstore->colptr[]");
+    GAstore->rowind = GAstore->colptr = NULL;
+    GAstore->nzval = NULL;
+    if ( have_GA ) {
+      if ( !(GAstore->rowind = (int_t *) intMalloc_dist (nnz)) )
+          ABORT ("SUPERLU_MALLOC fails for GAstore->rowind[]");
+      if ( !(GAstore->colptr = (int_t *) intMalloc_dist (n+1)) )
+          ABORT ("SUPERLU_MALLOC fails for GAstore->colptr[]");
+    }
 
     /* Allgatherv for row indices. */
     rdispls[0] = 0;
@@ -240,14 +260,14 @@ int psCompRow_loc_to_CompCol_global
     }
     itemp_32[procs-1] = itemp[procs-1];
     it = nnz_loc;
-    MPI_Allgatherv(rowind_buf, it, mpi_int_t, GAstore->rowind,
-		   itemp_32, rdispls, mpi_int_t, grid->comm);
+    superlu_node_allgatherv(node, rowind_buf, it, GAstore->rowind,
+			    itemp_32, rdispls, mpi_int_t, grid);
     if ( need_value ) {
-      if ( !(GAstore->nzval = (float *) floatMalloc_dist (nnz)) )
+      if ( have_GA && !(GAstore->nzval = (float *) floatMalloc_dist (nnz)) )
           ABORT ("SUPERLU_MALLOC fails for GAstore->rnzval[]");
-      MPI_Allgatherv(a_buf, it, MPI_FLOAT, GAstore->nzval,
-		     itemp_32, rdispls, MPI_FLOAT, grid->comm);
-    } else GAstore->nzval = NULL;
+      superlu_node_allgatherv(node, a_buf, it, GAstore->nzval,
+			      itemp_32, rdispls, MPI_FLOAT, grid);
+    }
 
     /* Now gather the column pointers. */
     rdispls[0] = 0;
@@ -256,16 +276,21 @@ int psCompRow_loc_to_CompCol_global
         itemp_32[i] = n_locs[i];
     }
     itemp_32[procs-1] = n_locs[procs-1];
-    MPI_Allgatherv(colptr_loc, n_loc, mpi_int_t, GAstore->colptr,
-		   itemp_32, rdispls, mpi_int_t, grid->comm);
+    superlu_node_allgatherv(node, colptr_loc, n_loc, GAstore->colptr,
+			    itemp_32, rdispls, mpi_int_t, grid);
 
     /* Recompute column pointers. */
-    for (i = 1; i < procs; ++i) {
+    if ( have_GA ) {
+      for (i = 1; i < procs; ++i) {
         k = rdispls[i];
 	for (j = 0; j < n_locs[i]; ++j) GAstore->colptr[k++] += itemp[i-1];
 	itemp[i] += itemp[i-1]; /* prefix sum */
+      }
+      GAstore->colptr[n] = nnz;
+    } else {
+      SUPERLU_FREE(GAstore);
+      GA->Store = NULL;
     }
-    GAstore->colptr[n] = nnz;
 
 #if ( DEBUGlevel>=2 )
     if ( !grid->iam ) {
@@ -416,6 +441,9 @@ void sLUstructInit(const int_t n, sLUstruct_t *LUstruct)
 	   SUPERLU_MALLOC(sizeof(sLocalLU_t))) )
 	ABORT("Malloc fails for LocalLU_t.");
 	LUstruct->Llu->inv = 0;
+	LUstruct->Llu->LUfile_map = NULL;
+	LUstruct->Llu->Amap = NULL;
+	superlu_tune_reset(&LUstruct->tune);
 }
 
 /*! \brief Deallocate LUstruct */
@@ -468,15 +496,15 @@ sDestroy_LU(int_t n, gridinfo_t *grid, sLUstruct_t *LUstruct)
     //	}
 
     SUPERLU_FREE (Llu->Lrowind_bc_ptr);
-    SUPERLU_FREE (Llu->Lrowind_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE (Llu->Lrowind_bc_dat);
     SUPERLU_FREE (Llu->Lrowind_bc_offset);
     SUPERLU_FREE (Llu->Lnzval_bc_ptr);
-    SUPERLU_FREE (Llu->Lnzval_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE (Llu->Lnzval_bc_dat);
     SUPERLU_FREE (Llu->Lnzval_bc_offset);
 
     /* Following are free'd in distribution routines */
     nb = CEILING(nsupers, grid->nprow);
-    for (i = 0; i < nb; ++i)
+    for (i = 0; i < nb && !Llu->LUfile_map; ++i)
     	if ( Llu->Ufstnz_br_ptr[i] ) {
     	    SUPERLU_FREE (Llu->Ufstnz_br_ptr[i]);
     	    SUPERLU_FREE (Llu->Unzval_br_ptr[i]);
@@ -511,7 +539,7 @@ sDestroy_LU(int_t n, gridinfo_t *grid, sLUstruct_t *LUstruct)
     //	    SUPERLU_FREE (Llu->Lindval_loc_bc_ptr[i]);
     //	}
     SUPERLU_FREE(Llu->Lindval_loc_bc_ptr);
-    SUPERLU_FREE(Llu->Lindval_loc_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Lindval_loc_bc_dat);
     SUPERLU_FREE(Llu->Lindval_loc_bc_offset);
 
     /* Following are free'd in distribution routines */
@@ -525,13 +553,22 @@ sDestroy_LU(int_t n, gridinfo_t *grid, sLUstruct_t *LUstruct)
     //	}
     // }
     SUPERLU_FREE(Llu->Linv_bc_ptr);
-    SUPERLU_FREE(Llu->Linv_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Linv_bc_dat);
     SUPERLU_FREE(Llu->Linv_bc_offset);
     SUPERLU_FREE(Llu->Uinv_bc_ptr);
-    SUPERLU_FREE(Llu->Uinv_bc_dat);
+    if ( !Llu->LUfile_map ) SUPERLU_FREE(Llu->Uinv_bc_dat);
     SUPERLU_FREE(Llu->Uinv_bc_offset);
     SUPERLU_FREE(Llu->Unnz);
 
+    /* The L and U data mapped by psMapLU() are released by unmapping. */
+    if ( Llu->LUfile_map ) {
+	superlu_LUfile_unmap(Llu->LUfile_map, Llu->LUfile_map_size);
+	Llu->LUfile_map = NULL;
+    }
+
+    sAmapFree(Llu->Amap);
+    Llu->Amap = NULL;
+
     /* Following are free'd in distribution routines */
     nb = CEILING(nsupers, grid->npcol);
     for (i = 0; i < nb; ++i)
@@ -769,6 +806,7 @@ psgstrs_init(int_t n, int_t m_loc, int_t nrhs, int_t fst_row,
         ABORT("Malloc fails for ptr_to_ibuf[].");
     gstrs_comm->ptr_to_ibuf = ptr_to_ibuf;
     gstrs_comm->ptr_to_dbuf = ptr_to_ibuf + procs;
+    gstrs_comm->nrhs = nrhs;
 
     return 0;
 } /* PSGSTRS_INIT */
@@ -1187,6 +1225,11 @@ int sSolveInit(superlu_dist_options_t *options, SuperMatrix *A,
         ABORT("Malloc fails for gsmv_comm[]");
     SOLVEstruct->A_colind_gsmv = NULL;
 
+    if ( !(SOLVEstruct->gstrs_work = (sgstrs_work_t *)
+           SUPERLU_MALLOC(sizeof(sgstrs_work_t))) )
+        ABORT("Malloc fails for gstrs_work[]");
+    memset(SOLVEstruct->gstrs_work, 0, sizeof(sgstrs_work_t));
+
     options->SolveInitialized = YES;
     return 0;
 } /* sSolveInit */
@@ -1209,6 +1252,25 @@ void sSolveFinalize(superlu_dist_options_t *options, sSOLVEstruct_t *SOLVEstruct
         SUPERLU_FREE(SOLVEstruct->diag_len);
         if ( SOLVEstruct->A_colind_gsmv )
 	    SUPERLU_FREE(SOLVEstruct->A_colind_gsmv);
+        if ( SOLVEstruct->gstrs_work->lsum )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->lsum);
+        if ( SOLVEstruct->gstrs_work->x )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->x);
+        if ( SOLVEstruct->gstrs_work->rtemp )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->rtemp);
+        if ( SOLVEstruct->gstrs_work->recvbuf )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->recvbuf);
+        superlu_shm_free(SOLVEstruct->gstrs_work->shm);
+        superlu_arena_free(&SOLVEstruct->gstrs_work->arena);
+        if ( SOLVEstruct->gstrs_work->redist_ibuf )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_ibuf);
+        if ( SOLVEstruct->gstrs_work->redist_dbuf )
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_dbuf);
+        if ( SOLVEstruct->gstrs_work->redist_req ) {
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_req);
+            SUPERLU_FREE(SOLVEstruct->gstrs_work->redist_status);
+        }
+        SUPERLU_FREE(SOLVEstruct->gstrs_work);
         options->SolveInitialized = NO;
     }
 } /* sSolveFinalize */
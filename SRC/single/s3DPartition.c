@@ -35,10 +35,13 @@ void snewTrfPartitionInit(int_t nsupers,  sLUstruct_t *LUstruct, gridinfo3d_t *g
     calcTreeWeight(nsupers, setree, treeList, LUstruct->Glu_persist->xsup);
 
     // Calculation of maximum level
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     // Generation of forests
-    sForest_t **sForests = getForests(maxLvl, nsupers, setree, treeList);
+    sForest_t **sForests = getForests(maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
+#if ( PRNTlevel>=1 )
+    printForestPrediction(maxLvl, grid3d->zscp.Np, sForests, treeList, grid3d);
+#endif
 
     strf3Dpartition_t *trf3Dpart = LUstruct->trf3Dpart;
     trf3Dpart->sForests = sForests;
@@ -162,6 +165,8 @@ void snewTrfPartitionInit(int_t nsupers,  sLUstruct_t *LUstruct, gridinfo3d_t *g
     trf3Dpart->sForests = sForests;
     trf3Dpart->treePerm = treePerm;
     trf3Dpart->maxLvl = maxLvl;
+    trf3Dpart->imbalance = getForestImbalance(maxLvl, grid3d->zscp.Np,
+                                              sForests, treeList);
     // trf3Dpart->LUvsb = LUvsb;
     trf3Dpart->supernode2treeMap = createSupernode2TreeMap(nsupers, maxLvl, gNodeCount, gNodeLists);
     trf3Dpart->superGridMap = createSuperGridMap(nsupers, maxLvl, myTreeIdxs, myZeroTrIdxs, gNodeCount, gNodeLists);
@@ -514,7 +514,7 @@ void SCT_print3D(gridinfo3d_t *grid3d, SCT_t* SCT)
     
     char funName[100];
 
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     for (int i = maxLvl-1; i >-1; --i)
     {
@@ -537,7 +537,7 @@ void treeImbalance3D(gridinfo3d_t *grid3d, SCT_t* SCT)
     gridinfo_t* grid = &(grid3d->grid2d);
     char funName[100];
 
-    int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+    int_t maxLvl = log2i_ceil(grid3d->zscp.Np) + 1;
 
     for (int i = maxLvl-1; i >-1; --i)
     {
@@ -548,7 +548,7 @@ void treeImbalance3D(gridinfo3d_t *grid3d, SCT_t* SCT)
         double tmax;
         MPI_Reduce( &SCT->tFactor3D[i], &tmax,  1, MPI_DOUBLE, MPI_MAX, 0, grid3d->zscp.comm );
         
-        double tavg = tsum /(grid3d->zscp.Np>>i);
+        double tavg = tsum /((grid3d->zscp.Np + (1 << i) - 1) >> i);
         double lLmb =  100*(tmax-tavg)/tavg;
         sprintf( funName, "Imbalance Factor:Level-%d    ",  (int) maxLvl-1-i);
         if(!grid3d->zscp.Iam)